@@ -87,6 +87,95 @@ STDAPI XblMemGetFunctions(
     _Out_ XblMemFreeFunction* memFreeFunc
     ) XBL_NOEXCEPT;
 
+/// <summary>
+/// The parts of the library that memory allocations are attributed to.
+/// </summary>
+typedef enum XblMemorySubsystem
+{
+    /// <summary>Allocations not made on behalf of a specific subsystem.</summary>
+    XblMemorySubsystem_General,
+
+    /// <summary>Social Manager.</summary>
+    XblMemorySubsystem_Social,
+
+    /// <summary>Multiplayer Manager.</summary>
+    XblMemorySubsystem_Multiplayer,
+
+    /// <summary>HTTP requests and responses.</summary>
+    XblMemorySubsystem_Http,
+
+    /// <summary>Real Time Activity messages.</summary>
+    XblMemorySubsystem_Rta
+} XblMemorySubsystem;
+
+/// <summary>
+/// Controls how the library counts its allocations for XblMemGetStats.
+/// </summary>
+typedef enum XblMemoryTrackingMode
+{
+    /// <summary>Allocations are not counted.  This is the default.</summary>
+    XblMemoryTrackingMode_Disabled,
+
+    /// <summary>One in every 64 allocations is counted and the totals are scaled up to estimate the rest.
+    /// Cheap enough to leave on in retail builds.</summary>
+    XblMemoryTrackingMode_Sampled,
+
+    /// <summary>Every allocation is counted.</summary>
+    XblMemoryTrackingMode_Full
+} XblMemoryTrackingMode;
+
+/// <summary>
+/// Memory statistics for one subsystem.  In sampled mode the values are estimates.
+/// </summary>
+typedef struct XblMemoryStats
+{
+    /// <summary>
+    /// Bytes requested by allocations that have not been freed yet.
+    /// </summary>
+    uint64_t liveBytes;
+
+    /// <summary>
+    /// Number of allocations that have not been freed yet.
+    /// </summary>
+    uint64_t liveAllocationCount;
+
+    /// <summary>
+    /// Number of allocations made since tracking was enabled.
+    /// </summary>
+    uint64_t totalAllocationCount;
+
+    /// <summary>
+    /// Largest value liveBytes has reached since tracking was enabled or XblMemResetHighWaterMarks was called.
+    /// </summary>
+    uint64_t highWaterBytes;
+} XblMemoryStats;
+
+/// <summary>
+/// Sets how the library counts its allocations.  May be called at any time; allocations made while
+/// tracking is on stay counted until they are freed.
+/// </summary>
+/// <param name="mode">The tracking mode to use.</param>
+/// <returns>HRESULT return code for this API operation.</returns>
+STDAPI XblMemSetTrackingMode(
+    _In_ XblMemoryTrackingMode mode
+    ) XBL_NOEXCEPT;
+
+/// <summary>
+/// Gets the memory statistics for a subsystem.
+/// </summary>
+/// <param name="subsystem">The subsystem to report.</param>
+/// <param name="stats">Set to the subsystem's statistics.</param>
+/// <returns>HRESULT return code for this API operation.</returns>
+STDAPI XblMemGetStats(
+    _In_ XblMemorySubsystem subsystem,
+    _Out_ XblMemoryStats* stats
+    ) XBL_NOEXCEPT;
+
+/// <summary>
+/// Resets the high water mark of every subsystem to its current live bytes.
+/// </summary>
+STDAPI_(void) XblMemResetHighWaterMarks() XBL_NOEXCEPT;
+
 /////////////////////////////////////////////////////////////////////////////////////////
 // Global APIs
 // 
@@ -105,3 +194,111 @@ STDAPI XblInitialize() XBL_NOEXCEPT;
 /// It is the responsibility of the game to wait for any outstanding Async calls to complete before calling XblCleanup.
 /// </summary>
 STDAPI_(void) XblCleanup() XBL_NOEXCEPT;
+
+/////////////////////////////////////////////////////////////////////////////////////////
+// HTTP Metrics APIs
+//
+
+/// <summary>
+/// Aggregated HTTP metrics for a single Xbox Live service API.
+/// </summary>
+typedef struct XblHttpCallApiMetrics
+{
+    /// <summary>
+    /// UTF-8 encoded name of the Xbox Live service API, for example "get_current_session".
+    /// The string is owned by the library and remains valid until XblCleanup is called.
+    /// </summary>
+    _Field_z_ const char* apiName;
+
+    /// <summary>
+    /// Number of requests sent to the service, including retries.
+    /// </summary>
+    uint64_t requestCount;
+
+    /// <summary>
+    /// Number of responses that completed with a network error or an HTTP error status.
+    /// </summary>
+    uint64_t failureCount;
+
+    /// <summary>
+    /// Number of requests that were reissued after the first attempt.
+    /// </summary>
+    uint64_t retryCount;
+
+    /// <summary>
+    /// Number of times a 401 response caused the token to be refreshed.
+    /// </summary>
+    uint64_t tokenRefreshCount;
+
+    /// <summary>
+    /// Number of 429 (Too Many Requests) responses.
+    /// </summary>
+    uint64_t throttledCount;
+
+    /// <summary>
+    /// Total request body bytes sent.
+    /// </summary>
+    uint64_t bytesSent;
+
+    /// <summary>
+    /// Total response body bytes received.
+    /// </summary>
+    uint64_t bytesReceived;
+
+    /// <summary>
+    /// Median request latency in microseconds.
+    /// </summary>
+    uint64_t latencyP50InMicroseconds;
+
+    /// <summary>
+    /// 90th percentile request latency in microseconds.
+    /// </summary>
+    uint64_t latencyP90InMicroseconds;
+
+    /// <summary>
+    /// 99th percentile request latency in microseconds.
+    /// </summary>
+    uint64_t latencyP99InMicroseconds;
+
+    /// <summary>
+    /// Largest request latency recorded in microseconds.
+    /// </summary>
+    uint64_t latencyMaxInMicroseconds;
+} XblHttpCallApiMetrics;
+
+/// <summary>
+/// Enables or disables the collection of per API HTTP metrics.  Collection is enabled by default.
+/// </summary>
+/// <param name="enabled">True to collect metrics, false to stop collecting them.</param>
+/// <returns>HRESULT return code for this API operation.</returns>
+STDAPI XblHttpCallMetricsSetEnabled(
+    _In_ bool enabled
+    ) XBL_NOEXCEPT;
+
+/// <summary>
+/// Gets the number of APIs that currently have HTTP metrics.  Use this to size the array passed
+/// to XblHttpCallMetricsGetSnapshot.
+/// </summary>
+/// <param name="apiCount">Number of APIs with metrics.</param>
+/// <returns>HRESULT return code for this API operation.</returns>
+STDAPI XblHttpCallMetricsGetSnapshotCount(
+    _Out_ uint32_t* apiCount
+    ) XBL_NOEXCEPT;
+
+/// <summary>
+/// Copies a point in time snapshot of the HTTP metrics for every API that has been called.
+/// </summary>
+/// <param name="metricsCount">Size of the caller allocated metrics array.</param>
+/// <param name="metrics">A caller allocated array of XblHttpCallApiMetrics to copy the snapshot into.</param>
+/// <param name="metricsWritten">Number of entries written to the metrics array.</param>
+/// <returns>HRESULT return code for this API operation.</returns>
+STDAPI XblHttpCallMetricsGetSnapshot(
+    _In_ uint32_t metricsCount,
+    _Out_writes_to_(metricsCount, *metricsWritten) XblHttpCallApiMetrics* metrics,
+    _Out_ uint32_t* metricsWritten
+    ) XBL_NOEXCEPT;
+
+/// <summary>
+/// Clears all collected HTTP metrics.
+/// </summary>
+STDAPI_(void) XblHttpCallMetricsReset() XBL_NOEXCEPT;
@@ -0,0 +1,150 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#pragma once
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
+
+class http_call_metrics_internal;
+
+/// <summary>
+/// Aggregated HTTP metrics for a single Xbox Live service API.
+/// </summary>
+class http_call_api_metrics
+{
+public:
+    /// <summary>
+    /// Internal function
+    /// </summary>
+    http_call_api_metrics();
+
+    /// <summary>
+    /// The name of the Xbox Live service API these metrics were collected for, for example "get_current_session".
+    /// </summary>
+    _XSAPIIMP const string_t& api_name() const;
+
+    /// <summary>
+    /// Number of requests sent to the service, including retries.
+    /// </summary>
+    _XSAPIIMP uint64_t request_count() const;
+
+    /// <summary>
+    /// Number of responses that completed with a network error or an HTTP error status.
+    /// </summary>
+    _XSAPIIMP uint64_t failure_count() const;
+
+    /// <summary>
+    /// Number of requests that were reissued after the first attempt.
+    /// </summary>
+    _XSAPIIMP uint64_t retry_count() const;
+
+    /// <summary>
+    /// Number of times a 401 response caused the token to be refreshed.
+    /// </summary>
+    _XSAPIIMP uint64_t token_refresh_count() const;
+
+    /// <summary>
+    /// Number of 429 (Too Many Requests) responses.
+    /// </summary>
+    _XSAPIIMP uint64_t throttled_count() const;
+
+    /// <summary>
+    /// Total request body bytes sent.
+    /// </summary>
+    _XSAPIIMP uint64_t bytes_sent() const;
+
+    /// <summary>
+    /// Total response body bytes received.
+    /// </summary>
+    _XSAPIIMP uint64_t bytes_received() const;
+
+    /// <summary>
+    /// Median request latency.
+    /// </summary>
+    _XSAPIIMP const std::chrono::microseconds& latency_p50() const;
+
+    /// <summary>
+    /// 90th percentile request latency.
+    /// </summary>
+    _XSAPIIMP const std::chrono::microseconds& latency_p90() const;
+
+    /// <summary>
+    /// 99th percentile request latency.
+    /// </summary>
+    _XSAPIIMP const std::chrono::microseconds& latency_p99() const;
+
+    /// <summary>
+    /// Largest request latency recorded.
+    /// </summary>
+    _XSAPIIMP const std::chrono::microseconds& latency_max() const;
+
+    /// <summary>
+    /// Serializes the metrics to a JSON object so they can be exported.
+    /// </summary>
+    _XSAPIIMP web::json::value serialize() const;
+
+private:
+    string_t m_apiName;
+    uint64_t m_requestCount;
+    uint64_t m_failureCount;
+    uint64_t m_retryCount;
+    uint64_t m_tokenRefreshCount;
+    uint64_t m_throttledCount;
+    uint64_t m_bytesSent;
+    uint64_t m_bytesReceived;
+    std::chrono::microseconds m_latencyP50;
+    std::chrono::microseconds m_latencyP90;
+    std::chrono::microseconds m_latencyP99;
+    std::chrono::microseconds m_latencyMax;
+
+    friend class http_call_metrics_internal;
+};
+
+/// <summary>
+/// Provides access to the in-process HTTP metrics collected for every Xbox Live service call.
+/// </summary>
+class http_call_metrics
+{
+public:
+    /// <summary>
+    /// Gets the http_call_metrics singleton instance
+    /// </summary>
+    _XSAPIIMP static std::shared_ptr<http_call_metrics> get_singleton_instance();
+
+    /// <summary>
+    /// Enables the collection of HTTP metrics.  Collection is enabled by default.
+    /// </summary>
+    _XSAPIIMP void enable();
+
+    /// <summary>
+    /// Disables the collection of HTTP metrics.  Metrics collected so far are kept.
+    /// </summary>
+    _XSAPIIMP void disable();
+
+    /// <summary>
+    /// Returns true if HTTP metrics are being collected.
+    /// </summary>
+    _XSAPIIMP bool is_enabled() const;
+
+    /// <summary>
+    /// Returns a point in time snapshot of the metrics for every API that has been called.
+    /// </summary>
+    _XSAPIIMP std::vector<http_call_api_metrics> snapshot() const;
+
+    /// <summary>
+    /// Returns a point in time snapshot of the metrics for every API that has been called as a JSON array.
+    /// </summary>
+    _XSAPIIMP web::json::value serialize_snapshot() const;
+
+    /// <summary>
+    /// Clears all collected metrics.
+    /// </summary>
+    _XSAPIIMP void reset();
+
+private:
+    http_call_metrics();
+    http_call_metrics(const http_call_metrics&);
+    void operator=(const http_call_metrics&);
+};
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
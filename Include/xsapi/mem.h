@@ -9,6 +9,89 @@
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_SYSTEM_CPP_BEGIN
 
+/// <summary>
+/// The parts of the SDK that allocations are attributed to.  Each subsystem is served from its own arena.
+/// </summary>
+enum class xsapi_memory_subsystem
+{
+    general,
+    social,
+    multiplayer,
+    http,
+    rta,
+    count
+};
+
+/// <summary>
+/// Controls how allocations are counted for memory statistics.
+/// </summary>
+enum class xsapi_memory_tracking_mode
+{
+    /// <summary>Allocations are not counted.  This is the default.</summary>
+    disabled,
+
+    /// <summary>One in every 64 allocations is counted and the totals are scaled up to estimate the rest.
+    /// Cheap enough to leave on in retail builds.</summary>
+    sampled,
+
+    /// <summary>Every allocation is counted.</summary>
+    full
+};
+
+/// <summary>
+/// Memory statistics for one subsystem, or for one call site in debug builds.
+/// </summary>
+class xsapi_memory_stats
+{
+public:
+    xsapi_memory_stats() :
+        m_liveBytes(0),
+        m_liveAllocations(0),
+        m_totalAllocations(0),
+        m_highWaterBytes(0)
+    {
+    }
+
+    xsapi_memory_stats(
+        _In_ uint64_t liveBytes,
+        _In_ uint64_t liveAllocations,
+        _In_ uint64_t totalAllocations,
+        _In_ uint64_t highWaterBytes
+        ) :
+        m_liveBytes(liveBytes),
+        m_liveAllocations(liveAllocations),
+        m_totalAllocations(totalAllocations),
+        m_highWaterBytes(highWaterBytes)
+    {
+    }
+
+    /// <summary>
+    /// Bytes requested by allocations that have not been freed yet.
+    /// </summary>
+    uint64_t live_bytes() const { return m_liveBytes; }
+
+    /// <summary>
+    /// Number of allocations that have not been freed yet.
+    /// </summary>
+    uint64_t live_allocations() const { return m_liveAllocations; }
+
+    /// <summary>
+    /// Number of allocations made since tracking was enabled.
+    /// </summary>
+    uint64_t total_allocations() const { return m_totalAllocations; }
+
+    /// <summary>
+    /// Largest value live_bytes has reached since tracking was enabled or the high water marks were reset.
+    /// </summary>
+    uint64_t high_water_bytes() const { return m_highWaterBytes; }
+
+private:
+    uint64_t m_liveBytes;
+    uint64_t m_liveAllocations;
+    uint64_t m_totalAllocations;
+    uint64_t m_highWaterBytes;
+};
+
 class xsapi_memory
 {
 public:
@@ -329,6 +329,8 @@ namespace xbox { namespace services {
 class multiplayer_session_request;
 class multiplayer_session_member_request;
 class multiplayer_service_impl;
+class multiplayer_session_lazy_fields;
+template<typename T> class multiplayer_query_pager;
 
 /// <summary>
 /// Defines values used to indicate status for visibility or accessibility of a session.
@@ -2449,6 +2451,11 @@ public:
     /// </summary>
     void _Set_current_user_members_in_group(_In_ std::vector<std::shared_ptr<multiplayer_session_member>> membersInGroup);
 
+    /// <summary>
+    /// Internal function
+    /// </summary>
+    std::error_code _Resolve_members_in_group(_In_ const std::function<std::shared_ptr<multiplayer_session_member>(uint32_t)>& memberById);
+
     /// <summary>
     /// Internal function
     /// </summary>
@@ -2520,6 +2527,11 @@ public:
     /// </summary>
     static xbox_live_result<multiplayer_session_member> _Deserialize(_In_ const web::json::value& json);
 
+    /// <summary>
+    /// Internal function
+    /// </summary>
+    uint64_t _Custom_properties_hash() const;
+
 private:
     std::error_code convert_measure_json_to_vector();
 
@@ -2530,6 +2542,7 @@ private:
     uint32_t m_memberId;
     web::json::value m_customConstantsJson;
     web::json::value m_customPropertiesJson;
+    uint64_t m_customPropertiesHash;
     string_t m_gamertag;
     string_t m_xboxUserId;
     bool m_isCurrentUser;
@@ -2706,7 +2719,7 @@ public:
     /// </summary>
     void _Initialize(
         _In_ std::shared_ptr<multiplayer_session_request> request,
-        _In_ std::vector<std::shared_ptr<multiplayer_session_member>> members
+        _In_ const std::function<std::shared_ptr<multiplayer_session_member>(uint32_t)>& memberById
         );
 
     /// <summary>
@@ -2736,9 +2749,15 @@ public:
     /// </summary>
     static xbox_live_result<multiplayer_session_properties> _Deserialize(_In_ const web::json::value& json);
 
+    /// <summary>
+    /// Internal function
+    /// </summary>
+    uint64_t _Custom_properties_hash() const;
+
 private:
 
     web::json::value m_customPropertiesJson;
+    uint64_t m_customPropertiesHash;
     std::vector<string_t> m_keywords;
     std::vector<uint32_t> m_sessionOwnerIndices;
     std::vector<std::shared_ptr<multiplayer_session_member>> m_turnCollection;
@@ -3470,6 +3489,16 @@ public:
     /// </summary>
     std::shared_ptr<multiplayer_session> _Create_deep_copy();
 
+    /// <summary>
+    /// Internal function
+    /// </summary>
+    std::shared_ptr<multiplayer_session_member> _Member_by_xbox_user_id(_In_ const string_t& xboxUserId) const;
+
+    /// <summary>
+    /// Internal function
+    /// </summary>
+    std::shared_ptr<multiplayer_session_member> _Member_by_member_id(_In_ uint32_t memberId) const;
+
     /// <summary>
     /// Internal function
     /// </summary>
@@ -3477,6 +3506,13 @@ public:
         int32_t httpStatusCode
         );
 
+    /// <summary>
+    /// Internal function
+    /// </summary>
+    void _Set_date_of_session(
+        _In_ const string_t& responseDate
+        );
+
     /// <summary>
     /// Internal function
     /// </summary>
@@ -3520,7 +3556,7 @@ public:
     /// <summary>
     /// Internal function
     /// </summary>
-    static std::error_code _Populate_members_with_members_list(_In_ std::vector<std::shared_ptr<multiplayer_session_member>> members);
+    std::error_code _Populate_members_with_members_list();
 
     /// <summary>
     /// Internal function
@@ -3566,13 +3602,18 @@ private:
 
     void ensure_session_subscription_id_initialized();
 
+    void index_members();
+    void index_member(_In_ uint32_t slot, _In_ bool indexMemberId);
+
     string_t m_xboxUserId;
     multiplayer_session_reference m_sessionReference;
     xbox::services::tournaments::tournament_arbitration_status m_arbitrationStatus;
     std::shared_ptr<multiplayer_session_constants> m_sessionConstants;
     std::shared_ptr<multiplayer_session_properties> m_multiplayerSessionProperties;
-    std::shared_ptr<multiplayer_session_role_types> m_sessionRoleTypes;
+    std::shared_ptr<multiplayer_session_lazy_fields> m_lazyFields;
     std::vector<std::shared_ptr<multiplayer_session_member>> m_members;
+    std::unordered_map<string_t, uint32_t> m_memberSlotByXboxUserId;
+    std::unordered_map<uint32_t, uint32_t> m_memberSlotByMemberId;
     web::json::value m_servers;
     uint32_t m_membersAccepted;
     string_t m_correlationId;
@@ -3584,10 +3625,7 @@ private:
     bool m_newSession;
     utility::datetime m_startTime;
     utility::datetime m_dateOfSession;
-    multiplayer_session_matchmaking_server m_matchmakingServer;
     multiplayer_session_tournaments_server m_tournamentsServer;
-    multiplayer_session_arbitration_server m_arbitrationServer;
-    bool m_hasMatchmakingServer;
     string_t m_sessionSubscriptionGuid;
     string_t m_branch;
     uint64_t m_changeNumber;
@@ -3957,6 +3995,88 @@ private:
     std::unordered_map<string_t, double> m_numbersMetadata;
 };
 
+/// <summary>
+/// A page of results from multiplayer_service::get_sessions_by_page.
+/// </summary>
+class multiplayer_session_states_result
+{
+public:
+    /// <summary>
+    /// Internal function
+    /// </summary>
+    multiplayer_session_states_result();
+
+    /// <summary>
+    /// Internal function
+    /// </summary>
+    multiplayer_session_states_result(
+        _In_ std::vector<multiplayer_session_states> items,
+        _In_ std::shared_ptr<multiplayer_query_pager<multiplayer_session_states>> nextPage
+        );
+
+    /// <summary>
+    /// The sessions in this page.
+    /// </summary>
+    _XSAPIIMP const std::vector<multiplayer_session_states>& items() const;
+
+    /// <summary>
+    /// Returns a boolean value that indicates if there are more pages of sessions to retrieve.
+    /// </summary>
+    /// <returns>True if there are more pages, otherwise false.</returns>
+    _XSAPIIMP bool has_next() const;
+
+    /// <summary>
+    /// Returns a multiplayer_session_states_result object containing the next page.
+    /// The next page was requested when this one arrived, so it is often already available.
+    /// </summary>
+    _XSAPIIMP pplx::task<xbox_live_result<multiplayer_session_states_result>> get_next();
+
+private:
+    std::vector<multiplayer_session_states> m_items;
+    std::shared_ptr<multiplayer_query_pager<multiplayer_session_states>> m_nextPage;
+};
+
+/// <summary>
+/// A page of results from multiplayer_service::get_activities_for_users_by_page.
+/// </summary>
+class multiplayer_activity_details_result
+{
+public:
+    /// <summary>
+    /// Internal function
+    /// </summary>
+    multiplayer_activity_details_result();
+
+    /// <summary>
+    /// Internal function
+    /// </summary>
+    multiplayer_activity_details_result(
+        _In_ std::vector<multiplayer_activity_details> items,
+        _In_ std::shared_ptr<multiplayer_query_pager<multiplayer_activity_details>> nextPage
+        );
+
+    /// <summary>
+    /// The activities in this page.
+    /// </summary>
+    _XSAPIIMP const std::vector<multiplayer_activity_details>& items() const;
+
+    /// <summary>
+    /// Returns a boolean value that indicates if there are more pages of activities to retrieve.
+    /// </summary>
+    /// <returns>True if there are more pages, otherwise false.</returns>
+    _XSAPIIMP bool has_next() const;
+
+    /// <summary>
+    /// Returns a multiplayer_activity_details_result object containing the next page.
+    /// The next page was requested when this one arrived, so it is often already available.
+    /// </summary>
+    _XSAPIIMP pplx::task<xbox_live_result<multiplayer_activity_details_result>> get_next();
+
+private:
+    std::vector<multiplayer_activity_details> m_items;
+    std::shared_ptr<multiplayer_query_pager<multiplayer_activity_details>> m_nextPage;
+};
+
 /// <summary>
 /// Used to handle interactions with an Xbox Live service endpoint on a server. 
 /// </summary>
@@ -4038,6 +4158,22 @@ public:
         _In_ multiplayer_get_sessions_request getSessionsRequest
         );
 
+    /// <summary>
+    /// Retrieve a list of sessions with various filters, one page at a time.  When the request filters on
+    /// a list of xbox user ids, the list is split into pages of xboxUserIdsPerPage users, each queried separately.
+    /// Each page is requested as soon as the previous one arrives, so it downloads while the caller processes
+    /// the previous page.  No more pages are requested once the request's max_items sessions have been returned.
+    /// </summary>
+    /// <param name="getSessionRequest">A session request object that sends a query for the session </param>
+    /// <param name="xboxUserIdsPerPage">The number of users to query for in each page.  Pass 0 to use 100.</param>
+    /// <returns>The async object for notifying when the operation is completed. With the handler, the first page
+    /// of SessionStates objects is returned.</returns>
+    /// <remarks>Calls V102 GET /serviceconfigs/{scid}/sessions or POST /serviceconfigs/{scid}/batch once per page</remarks>
+    _XSAPIIMP pplx::task<xbox_live_result<multiplayer_session_states_result>> get_sessions_by_page(
+        _In_ multiplayer_get_sessions_request getSessionsRequest,
+        _In_ uint32_t xboxUserIdsPerPage = 0
+        );
+
     /// <summary>
     /// Sets the passed session as the user's current activity, which will be displayed in Xbox 
     /// dashboard user experiences (e.g. friends and gamercard) as associated with the currently 
@@ -4149,6 +4285,24 @@ public:
         _In_ const std::vector<string_t>& xboxUserIds
         );
 
+    /// <summary>
+    /// Queries for the current activity for a set of users specified by xuid, one page at a time.
+    /// The users are split into pages of xboxUserIdsPerPage users, each queried separately.  Each page is
+    /// requested as soon as the previous one arrives, and no more pages are requested once maxItems
+    /// activities have been returned.
+    /// </summary>
+    /// <param name="serviceConfigurationId">The scid within which to query for activities.</param>
+    /// <param name="xboxUserIds">The list of user ids to find activities for.</param>
+    /// <param name="xboxUserIdsPerPage">The number of users to query for in each page.  Pass 0 to use 100.</param>
+    /// <param name="maxItems">The maximum number of activities to return across all pages.  Pass 0 for no limit.</param>
+    /// <returns>The async object for notifying when the operation is completed.  This contains the first page of MultiplayerActivityDetails objects.</returns>
+    _XSAPIIMP pplx::task<xbox_live_result<multiplayer_activity_details_result>> get_activities_for_users_by_page(
+        _In_ const string_t& serviceConfigurationId,
+        _In_ const std::vector<string_t>& xboxUserIds,
+        _In_ uint32_t xboxUserIdsPerPage = 0,
+        _In_ uint32_t maxItems = 0
+        );
+
     /// <summary>
     /// Queries for the all search handles that references the searchable sessions given the specific query.
     /// There is no paging or continuation, and the multiplayer service will limit the number of items returned to 100.
@@ -250,7 +250,7 @@ enum class multiplayer_event_type
     /// <summary>
     /// Fired when a match has been found, and the client has joined the target game session.
     /// When this event occurs, title should provide qos measurement results (via set_quality_of_service_measurements) between itself and a list of remote clients.
-    /// Note: If your title does not require QoS (based on the session template), this event will not be triggered.
+    /// Note: If your title does not require QoS (based on the session template), or has called set_automatic_qos_measurements(), this event will not be triggered.
     /// </summary>
     perform_qos_measurements,
 
@@ -1094,7 +1094,8 @@ public:
     /// </summary>
     member_property_changed_event_args(
         _In_ std::shared_ptr<multiplayer_member> member,
-        _In_ web::json::value jsonProperties
+        _In_ web::json::value jsonProperties,
+        _In_ std::vector<string_t> changedProperties = std::vector<string_t>()
         );
 
     /// <summary>
@@ -1107,9 +1108,15 @@ public:
     /// </summary>
     _XSAPIIMP web::json::value properties();
 
+    /// <summary>
+    /// Names of the top level custom properties that were added, modified or removed.
+    /// </summary>
+    _XSAPIIMP const std::vector<string_t>& changed_properties() const;
+
 private:
     std::shared_ptr<multiplayer_member> m_member;
     web::json::value m_properties;
+    std::vector<string_t> m_changedProperties;
 };
 
 /// <summary>
@@ -1122,16 +1129,23 @@ public:
     /// Internal function
     /// </summary>
     session_property_changed_event_args(
-        _In_ web::json::value jsonProperties
+        _In_ web::json::value jsonProperties,
+        _In_ std::vector<string_t> changedProperties = std::vector<string_t>()
         );
 
     /// <summary>
     /// The JSON of the property that changed.
     /// </summary>
     _XSAPIIMP const web::json::value& properties();
+
+    /// <summary>
+    /// Names of the top level custom properties that were added, modified or removed.
+    /// </summary>
+    _XSAPIIMP const std::vector<string_t>& changed_properties() const;
     
 private:
     web::json::value m_properties;
+    std::vector<string_t> m_changedProperties;
 };
 
 /// <summary>
@@ -1489,6 +1503,21 @@ public:
         _In_ const std::chrono::seconds& timeout = std::chrono::seconds(60)
         );
 
+    /// <summary>
+    /// Sends a matchmaking request that can be satisfied by any of several hoppers.  The hoppers are tried
+    /// one at a time, starting with the one whose statistics show the shortest wait.  If a hopper does not
+    /// find a match within a few times its estimated wait, its ticket is deleted and the next hopper is tried.
+    /// When a match is found, the manager will join the game and notify the title via find_match_completed_event().
+    /// </summary>
+    /// <param name="hopperNames">The names of the hoppers to search.</param>
+    /// <param name="attributes">The ticket attributes for the match. (Optional)</param>
+    /// <param name="timeout">The maximum time to search across all hoppers. (Optional)</param>
+    _XSAPIIMP xbox_live_result<void> find_match(
+        _In_ const std::vector<string_t>& hopperNames,
+        _In_ const web::json::value& attributes = web::json::value(),
+        _In_ const std::chrono::seconds& timeout = std::chrono::seconds(60)
+        );
+
     /// <summary>
     /// Cancels the match request on the server, if one exists.
     /// </summary>
@@ -1519,6 +1548,16 @@ public:
         _In_ bool autoFillMembers
         );
 
+    /// <summary>
+    /// How long a lobby or game change waits before it is written to the service. All changes queued within the
+    /// window are combined into a single write, plus one write for synchronized changes. The default of zero
+    /// combines the changes made between calls to do_work(). Call this after initialize().
+    /// </summary>
+    /// <param name="window">Time to wait after the first change is queued before writing.</param>
+    void set_write_coalescing_window(
+        _In_ std::chrono::milliseconds window
+        );
+
     /// <summary>
     /// Sets a collection of multiplayer_quality_of_service_measurements between itself and a list of remote clients.
     /// This is only used when the title is manually managing QoS.
@@ -1527,6 +1566,24 @@ public:
         _In_ std::shared_ptr<std::vector<xbox::services::multiplayer::multiplayer_quality_of_service_measurements>> measurements
         );
 
+    /// <summary>
+    /// Has the manager perform QoS itself when a match is found, instead of raising perform_qos_measurements.
+    /// UDP probes are sent in parallel to every remote member and measurement server in the game session,
+    /// and the latencies are uploaded in a single write. Each address is passed to resolveEndpoint, which
+    /// returns the "host:port" to probe, or an empty string to skip it; without a resolver the address itself
+    /// is probed. Remote endpoints must echo each 16 byte probe datagram back unchanged. Call this after initialize().
+    /// </summary>
+    /// <param name="enabled">True to measure automatically.</param>
+    /// <param name="probeCount">Number of probes sent to each endpoint. The median round trip is reported.</param>
+    /// <param name="probeTimeout">How long to wait for the answer to a probe.</param>
+    /// <param name="resolveEndpoint">Maps a connection or measurement server address to the endpoint to probe. (Optional)</param>
+    void set_automatic_qos_measurements(
+        _In_ bool enabled,
+        _In_ uint32_t probeCount = 4,
+        _In_ std::chrono::milliseconds probeTimeout = std::chrono::milliseconds(1000),
+        _In_ std::function<string_t(const string_t& address)> resolveEndpoint = nullptr
+        );
+
     /// <summary>
     /// Indicates who can join your game via the lobby.
     /// </summary>
@@ -17,6 +17,7 @@
 #include "xsapi/social_manager.h"
 #include "xsapi/stats_manager.h"
 #include "xsapi/http_call.h"
+#include "xsapi/http_call_metrics.h"
 #include "xsapi/xbox_live_context_settings.h"
 #include "xsapi/title_storage.h"
 #include "xsapi/privacy.h"
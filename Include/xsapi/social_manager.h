@@ -25,6 +25,7 @@ class social_manager_internal;
 class xbox_social_user_group_internal;
 class social_event_internal;
 class social_user_group_loaded_event_args_internal;
+class xbox_social_user_reader;
 struct xbox_social_user_context;
 struct user_group_status_change;
 enum class change_list_enum;
@@ -194,6 +195,9 @@ private:
     bool m_userHasPlayed;
     uint32_t m_titleId;
     utility::datetime m_lastTimeUserPlayed;
+
+
+    friend class xbox_social_user_reader;
 };
 
 /// <summary>
@@ -239,6 +243,9 @@ private:
     char_t m_primaryColor[COLOR_CHAR_SIZE];
     char_t m_secondaryColor[COLOR_CHAR_SIZE];
     char_t m_tertiaryColor[COLOR_CHAR_SIZE];
+
+
+    friend class xbox_social_user_reader;
 };
 
 /// <summary>
@@ -300,6 +307,9 @@ private:
     xbox::services::presence::presence_device_type m_deviceType;
     uint32_t m_titleId;
     char_t m_presenceText[RICH_PRESENCE_CHAR_SIZE];
+
+
+    friend class xbox_social_user_reader;
 };
 
 /// <summary>
@@ -377,6 +387,7 @@ private:
     social_manager_presence_title_record m_presenceVec[NUM_PRESENCE_RECORDS];
 
     friend class user_buffers_holder;
+    friend class xbox_social_user_reader;
 };
 
 /// <summary>
@@ -495,6 +506,7 @@ private:
 
     friend class social_graph;
     friend class user_buffers_holder;
+    friend class xbox_social_user_reader;
 };
 
 /// <summary>
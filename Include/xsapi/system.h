@@ -5,6 +5,7 @@
 
 #include "types.h"
 #include "errors.h"
+#include "xsapi/mem.h"
 #include "xbox_live_context_settings.h"
 #include "xbox_live_app_config.h"
 
@@ -113,6 +114,36 @@ public:
         _In_ const std::function<void(_In_ void* pAddress)>& memFreeHandler
         );
 
+    /// <summary>
+    /// Sets how XSAPI counts its own allocations for memory_stats.  Tracking is disabled by default.
+    /// Sampled tracking counts one allocation in 64 and is cheap enough to leave on in retail builds.
+    /// </summary>
+    /// <param name="mode">The tracking mode to use.</param>
+    _XSAPIIMP void set_memory_tracking_mode(_In_ xsapi_memory_tracking_mode mode);
+
+    /// <summary>
+    /// Gets the current memory tracking mode.
+    /// </summary>
+    _XSAPIIMP xsapi_memory_tracking_mode memory_tracking_mode() const;
+
+    /// <summary>
+    /// Gets the live bytes, allocation counts and high water mark of memory allocated by a subsystem.
+    /// In sampled mode the values are estimates.
+    /// </summary>
+    /// <param name="subsystem">The subsystem to report.</param>
+    _XSAPIIMP xsapi_memory_stats memory_stats(_In_ xsapi_memory_subsystem subsystem) const;
+
+    /// <summary>
+    /// Gets memory statistics for each internal call site that tags its allocations.
+    /// Only collected by debug builds of XSAPI with full tracking; empty otherwise.
+    /// </summary>
+    _XSAPIIMP std::vector<std::pair<std::string, xsapi_memory_stats>> memory_stats_by_call_site() const;
+
+    /// <summary>
+    /// Resets the high water mark of every subsystem to its current live bytes.
+    /// </summary>
+    _XSAPIIMP void reset_memory_high_water_marks();
+
     /// <summary>
     /// Registers to receive logging messages for levels that are enabled.  Event handlers will receive the level, category, and content of the message.
     /// </summary>
@@ -287,6 +287,31 @@ public:
     /// </summary>
     _XSAPIIMP void set_use_crossplatform_qos_servers(_In_ bool value);
 
+    /// <summary>
+    /// Gets whether latency critical reads are hedged.
+    /// </summary>
+    _XSAPIIMP bool use_http_request_hedging() const;
+
+    /// <summary>
+    /// Controls whether latency critical reads, such as fetching the current multiplayer session or matchmaking
+    /// ticket details, are hedged.  When enabled, a duplicate GET is sent if the first one has not completed
+    /// within the 95th percentile latency observed for that API, and whichever response arrives first is used.
+    /// Hedges are limited to a small fraction of the calls made.  Disabled by default.
+    /// </summary>
+    _XSAPIIMP void set_use_http_request_hedging(_In_ bool value);
+
+    /// <summary>
+    /// Gets whether HTTP bodies are compressed.
+    /// </summary>
+    _XSAPIIMP bool use_http_compression() const;
+
+    /// <summary>
+    /// Controls whether large request bodies, such as stats documents and multiplayer session writes, are sent
+    /// gzip encoded, and whether APIs that return large documents, such as catalog, leaderboard and social graph
+    /// reads, ask the service for a gzip or deflate encoded response.  Disabled by default.
+    /// </summary>
+    _XSAPIIMP void set_use_http_compression(_In_ bool value);
+
 public:
     // Internal public function
 #if UWP_API || UNIT_TEST_SERVICES
@@ -313,6 +338,8 @@ private:
     bool m_useCoreDispatcherForEventRouting;
     
     bool m_useXplatQosServer;
+    bool m_useHttpRequestHedging;
+    bool m_useHttpCompression;
 };
 
 
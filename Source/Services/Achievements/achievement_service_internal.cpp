@@ -192,7 +192,7 @@ achievement_service_internal::update_achievement(
     request[_T("userId")] = web::json::value::string(utils::string_t_from_internal_string(xboxUserId));
     request[_T("achievements")] = achievementsJson;
 
-    httpCall->set_request_body(utils::internal_string_from_string_t(request.serialize()));
+    httpCall->set_request_body(utils::json_serialize_utf8(request));
 
     auto xboxLiveContextImpl = m_xboxLiveContextImpl.lock();
     httpCall->get_response_with_auth(
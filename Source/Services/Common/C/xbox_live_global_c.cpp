@@ -2,6 +2,8 @@
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 
 #include "pch.h"
+#include "http_call_metrics.h"
+#include "mem_pool.h"
 
 using namespace xbox::services;
 using namespace xbox::services::system;
@@ -27,6 +29,8 @@ XblMemSetFunctions(
         return hr;
     }
 
+    // Blocks cached by the pool must go back through the hooks that allocated them
+    xsapi_memory_pool::trim();
     if (memAllocFunc != nullptr)
     {
         g_pMemAllocHook = memAllocFunc;
@@ -54,6 +58,48 @@ XblMemGetFunctions(
     return S_OK;
 }
 
+static_assert(XblMemorySubsystem_Rta == static_cast<int>(xsapi_memory_subsystem::rta), "XblMemorySubsystem must match xsapi_memory_subsystem");
+static_assert(XblMemoryTrackingMode_Full == static_cast<int>(xsapi_memory_tracking_mode::full), "XblMemoryTrackingMode must match xsapi_memory_tracking_mode");
+
+STDAPI
+XblMemSetTrackingMode(
+    _In_ XblMemoryTrackingMode mode
+    ) XBL_NOEXCEPT
+{
+    if (mode < XblMemoryTrackingMode_Disabled || mode > XblMemoryTrackingMode_Full)
+    {
+        return E_INVALIDARG;
+    }
+
+    xsapi_memory_pool::set_tracking_mode(static_cast<xsapi_memory_tracking_mode>(mode));
+    return S_OK;
+}
+
+STDAPI
+XblMemGetStats(
+    _In_ XblMemorySubsystem subsystem,
+    _Out_ XblMemoryStats* stats
+    ) XBL_NOEXCEPT
+{
+    if (stats == nullptr || subsystem < XblMemorySubsystem_General || subsystem > XblMemorySubsystem_Rta)
+    {
+        return E_INVALIDARG;
+    }
+
+    auto subsystemStats = xsapi_memory_pool::stats(static_cast<xsapi_memory_subsystem>(subsystem));
+    stats->liveBytes = subsystemStats.live_bytes();
+    stats->liveAllocationCount = subsystemStats.live_allocations();
+    stats->totalAllocationCount = subsystemStats.total_allocations();
+    stats->highWaterBytes = subsystemStats.high_water_bytes();
+    return S_OK;
+}
+
+STDAPI_(void)
+XblMemResetHighWaterMarks() XBL_NOEXCEPT
+{
+    xsapi_memory_pool::reset_high_water_marks();
+}
+
 STDAPI
 XblInitialize() XBL_NOEXCEPT
 try
@@ -124,4 +170,88 @@ XblGetErrorCondition(
             return XblErrorCondition_GenericError;
         }
     }
-}
\ No newline at end of file
+}
+
+STDAPI
+XblHttpCallMetricsSetEnabled(
+    _In_ bool enabled
+    ) XBL_NOEXCEPT
+try
+{
+    verify_global_init();
+    http_call_metrics_internal::get_singleton_instance()->set_enabled(enabled);
+    return S_OK;
+}
+CATCH_RETURN()
+
+STDAPI
+XblHttpCallMetricsGetSnapshotCount(
+    _Out_ uint32_t* apiCount
+    ) XBL_NOEXCEPT
+try
+{
+    RETURN_C_INVALIDARGUMENT_IF(apiCount == nullptr);
+    verify_global_init();
+
+    auto metrics = http_call_metrics_internal::get_singleton_instance();
+    *apiCount = 0;
+    for (uint32_t i = 0; i < XBOX_LIVE_API_COUNT; ++i)
+    {
+        auto counters = metrics->peek_counters(static_cast<xbox_live_api>(i));
+        if (counters != nullptr && counters->requestCount > 0)
+        {
+            ++(*apiCount);
+        }
+    }
+    return S_OK;
+}
+CATCH_RETURN()
+
+STDAPI
+XblHttpCallMetricsGetSnapshot(
+    _In_ uint32_t metricsCount,
+    _Out_writes_to_(metricsCount, *metricsWritten) XblHttpCallApiMetrics* metrics,
+    _Out_ uint32_t* metricsWritten
+    ) XBL_NOEXCEPT
+try
+{
+    RETURN_C_INVALIDARGUMENT_IF(metrics == nullptr || metricsWritten == nullptr);
+    verify_global_init();
+
+    auto httpCallMetrics = http_call_metrics_internal::get_singleton_instance();
+    *metricsWritten = 0;
+    for (uint32_t i = 0; i < XBOX_LIVE_API_COUNT && *metricsWritten < metricsCount; ++i)
+    {
+        auto xboxLiveApi = static_cast<xbox_live_api>(i);
+        auto counters = httpCallMetrics->peek_counters(xboxLiveApi);
+        if (counters == nullptr || counters->requestCount == 0)
+        {
+            continue;
+        }
+
+        XblHttpCallApiMetrics& apiMetrics = metrics[(*metricsWritten)++];
+        apiMetrics.apiName = xbox_live_api_to_string(xboxLiveApi);
+        apiMetrics.requestCount = counters->requestCount;
+        apiMetrics.failureCount = counters->failureCount;
+        apiMetrics.retryCount = counters->retryCount;
+        apiMetrics.tokenRefreshCount = counters->tokenRefreshCount;
+        apiMetrics.throttledCount = counters->throttledCount;
+        apiMetrics.bytesSent = counters->bytesSent;
+        apiMetrics.bytesReceived = counters->bytesReceived;
+        apiMetrics.latencyP50InMicroseconds = counters->latency.value_at_percentile(50.0);
+        apiMetrics.latencyP90InMicroseconds = counters->latency.value_at_percentile(90.0);
+        apiMetrics.latencyP99InMicroseconds = counters->latency.value_at_percentile(99.0);
+        apiMetrics.latencyMaxInMicroseconds = counters->latency.max_value();
+    }
+    return S_OK;
+}
+CATCH_RETURN()
+
+STDAPI_(void)
+XblHttpCallMetricsReset() XBL_NOEXCEPT
+try
+{
+    verify_global_init();
+    http_call_metrics_internal::get_singleton_instance()->reset();
+}
+CATCH_RETURN_WITH(;)
@@ -116,11 +116,11 @@ void xbox_live_context_impl::init()
     init_real_time_activity_service_instance();
 
 #if UWP_API || TV_API
-    AsyncBlock* async = new (xsapi_memory::mem_alloc(sizeof(AsyncBlock))) AsyncBlock{};
+    AsyncBlock* async = utils::allocate_async_block();
     async->queue = get_xsapi_singleton()->m_asyncQueue;
     async->callback = [](AsyncBlock* async)
     {
-        xsapi_memory::mem_free(async);
+        utils::free_async_block(async);
     };
 
     BeginAsync(async, nullptr, nullptr, __FUNCTION__,
@@ -96,8 +96,8 @@ events_service::write_in_game_event(
                 m_userContext->xbox_user_id(),
                 utils::internal_string_from_string_t(eventName),
                 utils::internal_string_from_string_t(m_playSession),
-                utils::internal_string_from_string_t(dimensions.serialize()),
-                utils::internal_string_from_string_t(measurements.serialize()),
+                utils::json_serialize_utf8(dimensions),
+                utils::json_serialize_utf8(measurements),
                 chrono_clock_t::now()
             );
 
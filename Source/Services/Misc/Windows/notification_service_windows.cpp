@@ -94,7 +94,7 @@ notification_service_windows::subscribe_to_notifications(
             payload[_T("locale")] = web::json::value::string(utils::string_t_from_internal_string(utils::get_locales()));
             payload[_T("titleId")] = web::json::value::string(std::to_wstring(appConfig->title_id()));
 
-            httpCall->set_request_body(utils::internal_string_from_string_t(payload.serialize()));
+            httpCall->set_request_body(utils::json_serialize_utf8(payload));
             httpCall->get_response_with_auth(userContext, http_call_response_body_type::json_body, false, queue, 
                 [](std::shared_ptr<http_call_response_internal> response){});
 
@@ -9,10 +9,12 @@ NAMESPACE_MICROSOFT_XBOX_SERVICES_MULTIPLAYER_MANAGER_CPP_BEGIN
 
 member_property_changed_event_args::member_property_changed_event_args(
     _In_ std::shared_ptr<multiplayer_member> member,
-    _In_ web::json::value jsonProperties
+    _In_ web::json::value jsonProperties,
+    _In_ std::vector<string_t> changedProperties
     ):
     m_member(std::move(member)),
-    m_properties(std::move(jsonProperties))
+    m_properties(std::move(jsonProperties)),
+    m_changedProperties(std::move(changedProperties))
 {
 }
 
@@ -28,4 +30,10 @@ member_property_changed_event_args::properties()
     return m_properties;
 }
 
+const std::vector<string_t>&
+member_property_changed_event_args::changed_properties() const
+{
+    return m_changedProperties;
+}
+
 NAMESPACE_MICROSOFT_XBOX_SERVICES_MULTIPLAYER_MANAGER_CPP_END
\ No newline at end of file
@@ -25,7 +25,7 @@ multiplayer_client_manager::multiplayer_client_manager(const multiplayer_client_
     m_subscriptionLostContext = other.m_subscriptionLostContext;
     m_rtaResyncContext = other.m_rtaResyncContext;
     m_primaryXboxLiveContext = other.m_primaryXboxLiveContext == nullptr ? nullptr : other.m_primaryXboxLiveContext;
-    m_lastPendingRead = other.m_lastPendingRead == nullptr ? nullptr : other.m_lastPendingRead;
+    m_lastSnapshot = std::atomic_load(&other.m_lastSnapshot);
     m_latestPendingRead = other.m_latestPendingRead == nullptr ? nullptr : other.m_latestPendingRead;
 }
 
@@ -37,7 +37,8 @@ multiplayer_client_manager::multiplayer_client_manager(
     m_subscriptionLostContext(0),
     m_rtaResyncContext(0),
     m_subscriptionsLostFired(false),
-    m_autoFillMembers(false)
+    m_autoFillMembers(false),
+    m_writeCoalescingWindow(0)
 {
     m_multiplayerLocalUserManager = std::make_shared<multiplayer_local_user_manager>();
 }
@@ -88,9 +89,10 @@ multiplayer_client_manager::initialize()
         m_multiplayerLocalUserManager
         );
 
-    m_lastPendingRead = std::make_shared<multiplayer_client_pending_reader>();
+    std::atomic_store(&m_lastSnapshot, std::shared_ptr<const multiplayer_client_snapshot>(std::make_shared<multiplayer_client_snapshot>()));
     m_subscriptionsLostFired.store(false);
     m_latestPendingRead->set_auto_fill_members_during_matchmaking(m_autoFillMembers);
+    m_latestPendingRead->set_write_coalescing_window(m_writeCoalescingWindow);
 }
 
 void multiplayer_client_manager::shutdown()
@@ -103,7 +105,7 @@ void
 multiplayer_client_manager::destroy()
 {
     m_latestPendingRead.reset();
-    m_lastPendingRead.reset();
+    std::atomic_store(&m_lastSnapshot, std::shared_ptr<const multiplayer_client_snapshot>());
     if (m_multiplayerLocalUserManager != nullptr)
     {
         m_multiplayerLocalUserManager->remove_multiplayer_session_changed_handler(m_sessionChangedContext);
@@ -420,15 +422,12 @@ multiplayer_client_manager::join_game(
             auto result = primaryContext->multiplayer_service().write_session(gameSession, multiplayer_session_write_mode::update_or_create_new).get();
             if (result.err())
             {
-                multiplayer_event multiplayerEvent(
-                    result.err(),
-                    result.err_message(),
+                pThis->add_multiplayer_event(
                     multiplayer_event_type::join_game_completed,
-                    std::make_shared<multiplayer_event_args>(),
-                    multiplayer_session_type::game_session
+                    multiplayer_session_type::game_session,
+                    result.err(),
+                    result.err_message()
                     );
-
-                pThis->add_to_multiplayer_event_queue(multiplayerEvent);
                 return xbox_live_result<void>();
             }
 
@@ -619,11 +618,10 @@ multiplayer_client_manager::latest_pending_read() const
     return m_latestPendingRead;
 }
 
-std::shared_ptr<multiplayer_client_pending_reader>
-multiplayer_client_manager::last_pending_read() const
+std::shared_ptr<const multiplayer_client_snapshot>
+multiplayer_client_manager::last_snapshot() const
 {
-    std::lock_guard<std::mutex> guard(m_clientRequestLock);
-    return m_lastPendingRead;
+    return std::atomic_load(&m_lastSnapshot);
 }
 
 std::shared_ptr<multiplayer_lobby_client>
@@ -647,12 +645,13 @@ multiplayer_client_manager::is_request_in_progress()
 bool
 multiplayer_client_manager::is_update_avaialable()
 {
-    if (m_latestPendingRead == nullptr || m_lastPendingRead == nullptr)
+    auto lastSnapshot = last_snapshot();
+    if (m_latestPendingRead == nullptr || lastSnapshot == nullptr)
     {
         return false;
     }
 
-    if (m_lastPendingRead->is_update_avaialable(*m_latestPendingRead))
+    if (m_latestPendingRead->is_update_avaialable(*lastSnapshot))
     {
         return true;
     }
@@ -671,21 +670,48 @@ multiplayer_client_manager::is_update_avaialable()
 std::vector<multiplayer_event>
 multiplayer_client_manager::do_work()
 {
-    std::lock_guard<std::mutex> guard(m_clientRequestLock);
+    std::shared_ptr<multiplayer_client_pending_reader> latestPendingRead;
+    std::shared_ptr<const multiplayer_client_snapshot> lastSnapshot;
+    {
+        std::lock_guard<std::mutex> guard(m_clientRequestLock);
+        latestPendingRead = m_latestPendingRead;
+        lastSnapshot = last_snapshot();
+    }
 
-    if (m_latestPendingRead == nullptr)
+    if (latestPendingRead == nullptr || lastSnapshot == nullptr)
     {
         return std::vector<multiplayer_event>();
     }
 
-    m_latestPendingRead->do_work();
+    latestPendingRead->do_work();
 
-    process_events(m_latestPendingRead->lobby_client()->session(), m_lastPendingRead->lobby_client()->session(), multiplayer_session_type::lobby_session);
-    process_events(m_latestPendingRead->game_client()->session(), m_lastPendingRead->game_client()->session(), multiplayer_session_type::game_session);
-    process_events(m_latestPendingRead->match_client()->session(), m_lastPendingRead->match_client()->session(), multiplayer_session_type::match_session);
+    // Both snapshots are immutable, so the diff runs without m_clientRequestLock and only
+    // compares sessions whose change number moved since the last frame
+    auto snapshot = latestPendingRead->create_snapshot();
+    process_events(latestPendingRead, snapshot->lobbySession, lastSnapshot->lobbySession, multiplayer_session_type::lobby_session);
+    process_events(latestPendingRead, snapshot->gameSession, lastSnapshot->gameSession, multiplayer_session_type::game_session);
+    process_events(latestPendingRead, snapshot->matchSession, lastSnapshot->matchSession, multiplayer_session_type::match_session);
 
-    m_lastPendingRead->deep_copy_if_updated(*m_latestPendingRead);
-    auto eventQueue = m_lastPendingRead->multiplayer_event_queue();
+    std::lock_guard<std::mutex> guard(m_clientRequestLock);
+    if (m_latestPendingRead != latestPendingRead)
+    {
+        // Shut down while diffing
+        return std::vector<multiplayer_event>();
+    }
+
+    // Published objects are read without a lock, so new ones get their client manager before they are
+    // published; those carried over from the last snapshot already have it
+    if (snapshot->lobby != nullptr && snapshot->lobby != lastSnapshot->lobby)
+    {
+        snapshot->lobby->_Set_multiplayer_client_manager(shared_from_this());
+    }
+    if (snapshot->game != nullptr && snapshot->game != lastSnapshot->game)
+    {
+        snapshot->game->_Set_multiplayer_client_manager(shared_from_this());
+    }
+
+    std::atomic_store(&m_lastSnapshot, snapshot);
+    auto eventQueue = latestPendingRead->take_multiplayer_event_queue();
 
     if (get_xbox_live_context_map().size() == 0 && !is_request_in_progress())
     {
@@ -702,9 +728,6 @@ multiplayer_client_manager::do_work()
         }
     }
 
-    m_latestPendingRead->clear_multiplayer_event_queue();
-    m_lastPendingRead->clear_multiplayer_event_queue();
-
     return eventQueue;
 }
 
@@ -810,8 +833,8 @@ multiplayer_client_manager::add_to_multiplayer_event_queue(
     _In_ multiplayer_event multiplayerEvent
     )
 {
-    // Note: This function does not require a lock. Caller already has a m_clientRequestLock
-
+    // Callers hold m_clientRequestLock, which guards m_latestPendingRead.  The diff in do_work runs
+    // without the lock and queues onto the reader it captured instead.
     if (m_latestPendingRead != nullptr)
     {
         m_latestPendingRead->add_to_multiplayer_event_queue(multiplayerEvent);
@@ -873,6 +896,7 @@ multiplayer_client_manager::get_session_type(
 
 void
 multiplayer_client_manager::process_events(
+    _In_ const std::shared_ptr<multiplayer_client_pending_reader>& latestPendingRead,
     _In_ std::shared_ptr<multiplayer_session> currentSession,
     _In_ std::shared_ptr<multiplayer_session> oldSession,
     _In_ multiplayer_session_type sessionType
@@ -895,22 +919,22 @@ multiplayer_client_manager::process_events(
     {
         if (multiplayer_manager_utils::is_multiplayer_session_change_type(diffType, multiplayer_session_change_types::host_device_token_change))
         {
-            handle_host_changed(currentSession, sessionType);
+            handle_host_changed(latestPendingRead, currentSession, sessionType);
         }
 
         if (multiplayer_manager_utils::is_multiplayer_session_change_type(diffType, multiplayer_session_change_types::member_list_change))
         {
-            handle_member_list_changed(currentSession, oldSession, sessionType);
+            handle_member_list_changed(latestPendingRead, currentSession, oldSession, sessionType);
         }
 
         if (multiplayer_manager_utils::is_multiplayer_session_change_type(diffType, multiplayer_session_change_types::custom_property_change))
         {
-            handle_session_properties_changed(currentSession, oldSession, sessionType);
+            handle_session_properties_changed(latestPendingRead, currentSession, oldSession, sessionType);
         }
 
         if (multiplayer_manager_utils::is_multiplayer_session_change_type(diffType, multiplayer_session_change_types::member_custom_property_change))
         {
-            handle_member_properties_changed(currentSession, oldSession, sessionType);
+            handle_member_properties_changed(latestPendingRead, currentSession, oldSession, sessionType);
         }
     }
     
@@ -919,13 +943,13 @@ multiplayer_client_manager::process_events(
         // Don't need to process these for game. The match will take care of handling these events.
         if (multiplayer_manager_utils::is_multiplayer_session_change_type(diffType, multiplayer_session_change_types::matchmaking_status_change))
         {
-            m_latestPendingRead->match_client()->handle_match_status_changed(currentSession);
+            latestPendingRead->match_client()->handle_match_status_changed(currentSession);
         }
     }
 
     if (multiplayer_manager_utils::is_multiplayer_session_change_type(diffType, multiplayer_session_change_types::tournament_property_change))
     {
-        handle_tournament_properties_changed(currentSession, oldSession, sessionType);
+        handle_tournament_properties_changed(latestPendingRead, currentSession, oldSession, sessionType);
     }
 
     if (multiplayer_manager_utils::is_multiplayer_session_change_type(diffType, multiplayer_session_change_types::arbitration_property_change))
@@ -933,31 +957,25 @@ multiplayer_client_manager::process_events(
         if (currentSession->arbitration_server().result_state() != oldSession->arbitration_server().result_state() &&
             currentSession->arbitration_server().result_state() == tournaments::tournament_arbitration_state::completed)
         {
-            add_multiplayer_event_helper(multiplayer_event_type::arbitration_complete, sessionType);
+            latestPendingRead->add_to_multiplayer_event_queue(multiplayer_event(
+                xbox_live_error_code::no_error,
+                std::string(),
+                multiplayer_event_type::arbitration_complete,
+                std::make_shared<multiplayer_event_args>(),
+                sessionType
+                ));
         }
     }
 }
 
 void
 multiplayer_client_manager::handle_member_list_changed(
+    _In_ const std::shared_ptr<multiplayer_client_pending_reader>& latestPendingRead,
     _In_ std::shared_ptr<multiplayer_session> currentSession,
     _In_ std::shared_ptr<multiplayer_session> oldSession,
     _In_ multiplayer_session_type sessionType
     )
 {
-    std::map<string_t, std::shared_ptr<multiplayer_session_member>> currentSessionMembers;
-    std::map<string_t, std::shared_ptr<multiplayer_session_member>> oldSessionMembers;
-
-    for (const auto& currentSessionMember : currentSession->members())
-    {
-        currentSessionMembers[currentSessionMember->xbox_user_id()] = currentSessionMember;
-    }
-
-    for (const auto& oldSessionMember : oldSession->members())
-    {
-        oldSessionMembers[oldSessionMember->xbox_user_id()] = oldSessionMember;
-    }
-
     bool haveMembersJoined = false;
     bool haveMembersLeft = false;
 
@@ -965,7 +983,7 @@ multiplayer_client_manager::handle_member_list_changed(
     std::vector<std::shared_ptr<multiplayer_session_member>> membersJoined;
     for (const auto& currentSessionMember : currentSession->members())
     {
-        if (oldSessionMembers.find(currentSessionMember->xbox_user_id()) == oldSessionMembers.end())
+        if (oldSession->_Member_by_xbox_user_id(currentSessionMember->xbox_user_id()) == nullptr)
         {
             haveMembersJoined = true;
             membersJoined.push_back(currentSessionMember);
@@ -976,7 +994,7 @@ multiplayer_client_manager::handle_member_list_changed(
     std::vector<std::shared_ptr<multiplayer_session_member>> membersLeft;
     for (const auto& oldSessionMember : oldSession->members())
     {
-        if (currentSessionMembers.find(oldSessionMember->xbox_user_id()) == currentSessionMembers.end())
+        if (currentSession->_Member_by_xbox_user_id(oldSessionMember->xbox_user_id()) == nullptr)
         {
             haveMembersLeft = true;
             membersLeft.push_back(oldSessionMember);
@@ -985,12 +1003,6 @@ multiplayer_client_manager::handle_member_list_changed(
 
     if (haveMembersJoined || haveMembersLeft)
     {
-        auto latestPendingRead = latest_pending_read();
-        if (latestPendingRead == nullptr)
-        {
-            return;
-        }
-
         if (haveMembersJoined)
         {
             std::vector<std::shared_ptr<multiplayer_member>> gameMembers;
@@ -1011,7 +1023,7 @@ multiplayer_client_manager::handle_member_list_changed(
                 sessionType
                 );
 
-            add_to_multiplayer_event_queue(multiplayerEvent);
+            latestPendingRead->add_to_multiplayer_event_queue(multiplayerEvent);
         }
 
         if (haveMembersLeft)
@@ -1034,35 +1046,29 @@ multiplayer_client_manager::handle_member_list_changed(
                 sessionType
                 );
 
-            add_to_multiplayer_event_queue(multiplayerEvent);
+            latestPendingRead->add_to_multiplayer_event_queue(multiplayerEvent);
         }
     }
 }
 
 void
 multiplayer_client_manager::handle_member_properties_changed(
+    _In_ const std::shared_ptr<multiplayer_client_pending_reader>& latestPendingRead,
     _In_ std::shared_ptr<multiplayer_session> currentSession,
     _In_ std::shared_ptr<multiplayer_session> oldSession,
     _In_ multiplayer_session_type sessionType
     )
 {
-    std::map<string_t, std::shared_ptr<multiplayer_session_member>> oldSessionMembers;
-    for (const auto& oldSessionMember : oldSession->members())
-    {
-        oldSessionMembers[oldSessionMember->xbox_user_id()] = oldSessionMember;
-    }
-
     // See if properties changed and add them to the queue.
-    std::vector<std::shared_ptr<multiplayer_session_member>> memberPropertiesChanged;
+    std::vector<std::pair<std::shared_ptr<multiplayer_session_member>, std::shared_ptr<multiplayer_session_member>>> memberPropertiesChanged;
     for (const auto& currentSessionMember : currentSession->members())
     {
-        if (oldSessionMembers.find(currentSessionMember->xbox_user_id()) != oldSessionMembers.end())
+        std::shared_ptr<multiplayer_session_member> oldSessionMember = oldSession->_Member_by_xbox_user_id(currentSessionMember->xbox_user_id());
+        if (oldSessionMember != nullptr)
         {
-            std::shared_ptr<multiplayer_session_member> oldSessionMember = oldSessionMembers[currentSessionMember->xbox_user_id()];
-            if (utils::str_icmp(currentSessionMember->member_custom_properties_json().serialize(),
-                oldSessionMember->member_custom_properties_json().serialize()) != 0)
+            if (currentSessionMember->_Custom_properties_hash() != oldSessionMember->_Custom_properties_hash())
             {
-                memberPropertiesChanged.push_back(currentSessionMember);
+                memberPropertiesChanged.push_back(std::make_pair(currentSessionMember, oldSessionMember));
             }
         }
     }
@@ -1071,8 +1077,9 @@ multiplayer_client_manager::handle_member_properties_changed(
     {
         std::vector<std::shared_ptr<multiplayer_member>> gameMembers;
         const auto& localUsersMap = m_multiplayerLocalUserManager->get_local_user_map();
-        for (const auto& member : memberPropertiesChanged)
+        for (const auto& memberPair : memberPropertiesChanged)
         {
+            const auto& member = memberPair.first;
             auto iter = localUsersMap.find(member->xbox_user_id());
             if (iter != localUsersMap.end())
             {
@@ -1080,14 +1087,10 @@ multiplayer_client_manager::handle_member_properties_changed(
                 continue;
             }
 
-            auto latestPendingRead = latest_pending_read();
-            if (latestPendingRead == nullptr)
-            {
-                continue;
-            }
             std::shared_ptr<member_property_changed_event_args> memberPropertiesChangedArgs = std::make_shared<member_property_changed_event_args>(
                 latestPendingRead->convert_to_game_member(member),
-                member->member_custom_properties_json()
+                member->member_custom_properties_json(),
+                utils::json_changed_keys(member->member_custom_properties_json(), memberPair.second->member_custom_properties_json())
                 );
 
             multiplayer_event multiplayerEvent(
@@ -1098,13 +1101,14 @@ multiplayer_client_manager::handle_member_properties_changed(
                 sessionType
                 );
 
-            add_to_multiplayer_event_queue(multiplayerEvent);
+            latestPendingRead->add_to_multiplayer_event_queue(multiplayerEvent);
         }
     }
 }
 
 void
 multiplayer_client_manager::handle_session_properties_changed(
+    _In_ const std::shared_ptr<multiplayer_client_pending_reader>& latestPendingRead,
     _In_ std::shared_ptr<multiplayer_session> currentSession,
     _In_ std::shared_ptr<multiplayer_session> oldSession,
     _In_ multiplayer_session_type sessionType
@@ -1114,8 +1118,7 @@ multiplayer_client_manager::handle_session_properties_changed(
         m_multiplayerLocalUserManager->is_local_user_game_state(multiplayer_local_user_game_state::pending_join))
     {
         // Don't join the game if matchmaking is in progress.
-        auto latestPendingRead = latest_pending_read();
-        if (latestPendingRead != nullptr && latestPendingRead->match_client()->match_status() == match_status::none)
+        if (latestPendingRead->match_client()->match_status() == match_status::none)
         {
             // If state is completed, or transfer handle was removed.
             if (latestPendingRead->lobby_client()->is_transfer_handle_state(_T("completed")) ||
@@ -1139,7 +1142,11 @@ multiplayer_client_manager::handle_session_properties_changed(
     }
 
     auto gamePropertiesChangedArgs = std::make_shared<session_property_changed_event_args>(
-        currentSession->session_properties()->session_custom_properties_json()
+        currentSession->session_properties()->session_custom_properties_json(),
+        utils::json_changed_keys(
+            currentSession->session_properties()->session_custom_properties_json(),
+            oldSession->session_properties()->session_custom_properties_json()
+            )
         );
 
     multiplayer_event multiplayerEvent(
@@ -1150,11 +1157,12 @@ multiplayer_client_manager::handle_session_properties_changed(
         sessionType
         );
 
-    add_to_multiplayer_event_queue(multiplayerEvent);
+    latestPendingRead->add_to_multiplayer_event_queue(multiplayerEvent);
 }
 
 void
 multiplayer_client_manager::handle_host_changed(
+    _In_ const std::shared_ptr<multiplayer_client_pending_reader>& latestPendingRead,
     _In_ std::shared_ptr<multiplayer_session> currentSession,
     _In_ multiplayer_session_type sessionType
     )
@@ -1164,11 +1172,7 @@ multiplayer_client_manager::handle_host_changed(
     std::shared_ptr<multiplayer_session_member> host = multiplayer_manager_utils::host_member(currentSession);
     if (host != nullptr)
     {
-        auto latestPendingRead = latest_pending_read();
-        if (latestPendingRead != nullptr)
-        {
-            hostMember = latestPendingRead->convert_to_game_member(host);
-        }
+        hostMember = latestPendingRead->convert_to_game_member(host);
     }
 
     std::shared_ptr<host_changed_event_args> hostChangedEventArgs = std::make_shared<host_changed_event_args>(
@@ -1183,11 +1187,12 @@ multiplayer_client_manager::handle_host_changed(
         sessionType
         );
 
-    add_to_multiplayer_event_queue(multiplayerEvent);
+    latestPendingRead->add_to_multiplayer_event_queue(multiplayerEvent);
 }
 
 void
 multiplayer_client_manager::handle_tournament_properties_changed(
+    _In_ const std::shared_ptr<multiplayer_client_pending_reader>& latestPendingRead,
     _In_ std::shared_ptr<multiplayer_session> currentSession,
     _In_ std::shared_ptr<multiplayer_session> oldSession,
     _In_ multiplayer_session_type sessionType
@@ -1211,7 +1216,7 @@ multiplayer_client_manager::handle_tournament_properties_changed(
             sessionType
         );
 
-        add_to_multiplayer_event_queue(multiplayerEvent);
+        latestPendingRead->add_to_multiplayer_event_queue(multiplayerEvent);
     }
 
     auto currentGameSessionRef = currTournamentsServer.next_game_session_reference();
@@ -1220,11 +1225,7 @@ multiplayer_client_manager::handle_tournament_properties_changed(
          !currentGameSessionRef.is_null() &&
          currentGameSessionRef._Serialize() != oldTournamentsServer.next_game_session_reference()._Serialize())
     {
-        auto latestPendingRead = latest_pending_read();
-        if (latestPendingRead != nullptr)
-        {
-            latestPendingRead->lobby_client()->handle_game_session_ready_event(currentSession);
-        }
+        latestPendingRead->lobby_client()->handle_game_session_ready_event(currentSession);
     }
 }
 
@@ -1242,14 +1243,14 @@ multiplayer_client_manager::match_client()
 
 xbox_live_result<void>
 multiplayer_client_manager::find_match(
-    _In_ const string_t& hopperName,
+    _In_ const std::vector<string_t>& hopperNames,
     _In_ const web::json::value& attributes,
     _In_ const std::chrono::seconds& timeout
 )
 {
     auto latestPendingRead = latest_pending_read();
     RETURN_CPP_IF(latestPendingRead == nullptr || latestPendingRead->lobby_client()->session() == nullptr, void, xbox_live_error_code::logic_error, "No local user added. Call add_local_user() first.");
-    return latestPendingRead->find_match(hopperName, attributes, timeout);
+    return latestPendingRead->find_match(hopperNames, attributes, timeout);
 }
 
 void
@@ -1265,4 +1266,17 @@ multiplayer_client_manager::set_auto_fill_members_during_matchmaking(
     }
 }
 
+void
+multiplayer_client_manager::set_write_coalescing_window(
+    _In_ std::chrono::milliseconds window
+    )
+{
+    std::lock_guard<std::mutex> guard(m_clientRequestLock);
+    m_writeCoalescingWindow = window;
+    if (m_latestPendingRead != nullptr)
+    {
+        m_latestPendingRead->set_write_coalescing_window(window);
+    }
+}
+
 NAMESPACE_MICROSOFT_XBOX_SERVICES_MULTIPLAYER_MANAGER_CPP_END
\ No newline at end of file
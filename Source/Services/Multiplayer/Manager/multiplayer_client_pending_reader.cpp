@@ -9,50 +9,6 @@ using namespace xbox::services::multiplayer;
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_MULTIPLAYER_MANAGER_CPP_BEGIN
 
-void multiplayer_client_pending_reader::deep_copy_if_updated(
-    _In_ const multiplayer_client_pending_reader& other
-    )
-{
-    std::lock_guard<std::mutex> lock(other.m_clientRequestLock);
-
-    m_multiplayerEventQueue = other.m_multiplayerEventQueue;
-    if (other.m_lobbyClient == nullptr)
-    {
-        m_lobbyClient = nullptr;
-    }
-    else
-    {
-        m_lobbyClient->deep_copy_if_updated(*other.m_lobbyClient);
-    }
-
-    if (other.m_gameClient == nullptr)
-    {
-        m_gameClient = nullptr;
-    }
-    else
-    {
-        m_gameClient->deep_copy_if_updated(*other.m_gameClient);
-    }
-
-    if (other.m_matchClient == nullptr)
-    {
-        m_matchClient = nullptr;
-    }
-    else
-    {
-        m_matchClient->deep_copy_if_updated(*other.m_matchClient);
-    }
-}
-
-multiplayer_client_pending_reader::multiplayer_client_pending_reader() :
-    m_autoFillMembers(false)
-{
-    m_multiplayerLocalUserManager = std::make_shared<multiplayer_local_user_manager>();
-    m_lobbyClient = std::make_shared<multiplayer_lobby_client>();
-    m_gameClient = std::make_shared<multiplayer_game_client>();
-    m_matchClient = std::make_shared<manager::multiplayer_match_client>(m_multiplayerLocalUserManager);
-}
-
 multiplayer_client_pending_reader::~multiplayer_client_pending_reader()
 {
     m_lobbyClient.reset();
@@ -75,35 +31,44 @@ multiplayer_client_pending_reader::multiplayer_client_pending_reader(
     m_gameClient->initialize();
 }
 
+std::shared_ptr<const multiplayer_client_snapshot>
+multiplayer_client_pending_reader::create_snapshot()
+{
+    auto snapshot = std::make_shared<multiplayer_client_snapshot>();
+    snapshot->lobbySession = m_lobbyClient->session();
+    snapshot->gameSession = m_gameClient->session();
+    snapshot->matchSession = m_matchClient->session();
+
+    // The objects are only rebuilt while a user is signed in, so don't publish them once their session is gone
+    snapshot->lobby = snapshot->lobbySession == nullptr ? nullptr : m_lobbyClient->lobby();
+    snapshot->game = snapshot->gameSession == nullptr ? nullptr : m_gameClient->game();
+    snapshot->lobbyJoinability = m_lobbyClient->joinability();
+    return snapshot;
+}
+
 bool
 multiplayer_client_pending_reader::is_update_avaialable(
-    _In_ const multiplayer_client_pending_reader& other
+    _In_ const multiplayer_client_snapshot& lastSnapshot
     )
 {
-    std::lock_guard<std::mutex> lock(other.m_clientRequestLock);
-
-    if (other.m_lobbyClient->is_pending_lobby_changes() ||
-        other.m_gameClient->is_pending_game_changes())
+    if (m_lobbyClient->is_pending_lobby_changes() ||
+        m_gameClient->is_pending_game_changes())
     {
         return true;
     }
 
-    auto lobbySession = m_lobbyClient->session();
-    auto otherLobbySession = other.m_lobbyClient->session();
-    auto gameSession = m_gameClient->session();
-    auto otherGameSession = other.m_gameClient->session();
-    if ( !multiplayer_manager_utils::compare_sessions(lobbySession, otherLobbySession) ||
-         !multiplayer_manager_utils::compare_sessions(gameSession, otherGameSession) ||
-         !multiplayer_manager_utils::compare_sessions(m_matchClient->session(), other.m_matchClient->session()) ||
-         m_lobbyClient->multiplayer_event_queue().size() != other.m_lobbyClient->multiplayer_event_queue().size() ||
-         m_gameClient->multiplayer_event_queue().size() != other.m_gameClient->multiplayer_event_queue().size() ||
-         m_matchClient->multiplayer_event_queue().size() != other.m_matchClient->multiplayer_event_queue().size() ||
-         m_multiplayerEventQueue.size() != other.m_multiplayerEventQueue.size())
+    if (!multiplayer_manager_utils::compare_sessions(lastSnapshot.lobbySession, m_lobbyClient->session()) ||
+        !multiplayer_manager_utils::compare_sessions(lastSnapshot.gameSession, m_gameClient->session()) ||
+        !multiplayer_manager_utils::compare_sessions(lastSnapshot.matchSession, m_matchClient->session()) ||
+        m_lobbyClient->multiplayer_event_queue().size() > 0 ||
+        m_gameClient->multiplayer_event_queue().size() > 0 ||
+        m_matchClient->multiplayer_event_queue().size() > 0)
     {
         return true;
     }
 
-    return false;
+    std::lock_guard<std::mutex> lock(m_clientRequestLock);
+    return m_multiplayerEventQueue.size() > 0;
 }
 
 std::shared_ptr<multiplayer_lobby_client>
@@ -228,11 +193,13 @@ multiplayer_client_pending_reader::add_to_multiplayer_event_queue(
     }
 }
 
-void
-multiplayer_client_pending_reader::clear_multiplayer_event_queue()
+std::vector<multiplayer_event>
+multiplayer_client_pending_reader::take_multiplayer_event_queue()
 {
+    std::vector<multiplayer_event> eventQueue;
     std::lock_guard<std::mutex> lock(m_clientRequestLock);
-    m_multiplayerEventQueue.clear();
+    eventQueue.swap(m_multiplayerEventQueue);
+    return eventQueue;
 }
 
 void
@@ -341,16 +308,9 @@ multiplayer_client_pending_reader::is_local(
 {
     if(xboxUserId.empty()) return false;
 
-    for(auto& xboxLiveContext : xboxLiveContextMap)
-    {
-        std::shared_ptr<multiplayer_local_user> localUser =  xboxLiveContext.second;
-        if (localUser != nullptr && utils::str_icmp(xboxUserId, localUser->xbox_user_id()) == 0)
-        {
-            return true;
-        }
-    }
-
-    return false;
+    // The map is keyed by xbox user id
+    auto iter = xboxLiveContextMap.find(xboxUserId);
+    return iter != xboxLiveContextMap.end() && iter->second != nullptr;
 }
 
 std::shared_ptr<multiplayer_member>
@@ -427,7 +387,7 @@ multiplayer_client_pending_reader::process_match_events()
 
 xbox_live_result<void>
 multiplayer_client_pending_reader::find_match(
-    _In_ const string_t& hopperName,
+    _In_ const std::vector<string_t>& hopperNames,
     _In_ const web::json::value& attributes,
     _In_ const std::chrono::seconds& timeout
     )
@@ -437,10 +397,10 @@ multiplayer_client_pending_reader::find_match(
 
     if (m_autoFillMembers && m_gameClient->session() != nullptr)
     {
-        return m_matchClient->find_match(hopperName, attributes, timeout, m_gameClient->session(), true);
+        return m_matchClient->find_match(hopperNames, attributes, timeout, m_gameClient->session(), true);
     }
 
-    return m_matchClient->find_match(hopperName, attributes, timeout, m_lobbyClient->session(), false);
+    return m_matchClient->find_match(hopperNames, attributes, timeout, m_lobbyClient->session(), false);
 }
 
 void
@@ -451,4 +411,13 @@ multiplayer_client_pending_reader::set_auto_fill_members_during_matchmaking(
     m_autoFillMembers = autoFillMembers;
 }
 
+void
+multiplayer_client_pending_reader::set_write_coalescing_window(
+    _In_ std::chrono::milliseconds window
+    )
+{
+    m_lobbyClient->set_write_coalescing_window(window);
+    m_gameClient->set_write_coalescing_window(window);
+}
+
 NAMESPACE_MICROSOFT_XBOX_SERVICES_MULTIPLAYER_MANAGER_CPP_END
\ No newline at end of file
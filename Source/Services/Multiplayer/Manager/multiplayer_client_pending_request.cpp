@@ -13,7 +13,8 @@ multiplayer_client_pending_request::multiplayer_client_pending_request() :
     m_joinability(joinability::none),
     m_requestType(pending_request_type::non_synchronized_changes),
     m_localUserLobbyState(multiplayer_local_user_lobby_state::unknown),
-    m_context(nullptr)
+    m_context(nullptr),
+    m_queuedTime(std::chrono::steady_clock::now())
 {
     m_identifier = utils::interlocked_increment(get_xsapi_singleton()->m_multiplayerClientPendingRequestUniqueIdentifier);
 }
@@ -36,6 +37,14 @@ multiplayer_client_pending_request::identifier() const
     return m_identifier;
 }
 
+bool
+multiplayer_client_pending_request::is_coalescing_window_elapsed(
+    _In_ std::chrono::milliseconds window
+    ) const
+{
+    return std::chrono::steady_clock::now() - m_queuedTime >= window;
+}
+
 // Local User properties
 std::shared_ptr<multiplayer_local_user>
 multiplayer_client_pending_request::local_user()
@@ -11,8 +11,8 @@ using namespace xbox::services::multiplayer;
 NAMESPACE_MICROSOFT_XBOX_SERVICES_MULTIPLAYER_MANAGER_CPP_BEGIN
 
 multiplayer_game_client::multiplayer_game_client() :
-    m_updateNumber(0),
-    m_pendingCommitInProgress(false)
+    m_pendingCommitInProgress(false),
+    m_writeCoalescingWindow(0)
 {
     m_sessionWriter = std::make_shared<multiplayer_session_writer>();
 }
@@ -21,8 +21,8 @@ multiplayer_game_client::multiplayer_game_client(
     _In_ std::shared_ptr<multiplayer_local_user_manager> localUserManager
     ) :
     m_multiplayerLocalUserManager(localUserManager),
-    m_updateNumber(0),
-    m_pendingCommitInProgress(false)
+    m_pendingCommitInProgress(false),
+    m_writeCoalescingWindow(0)
 {
     m_sessionWriter = std::make_shared<multiplayer_session_writer>(m_multiplayerLocalUserManager);
 }
@@ -72,35 +72,6 @@ multiplayer_game_client::set_game_session_template(
     m_gameSessionTemplateName = sessionTemplateName;
 }
 
-void
-multiplayer_game_client::deep_copy_if_updated(
-    _In_ const multiplayer_game_client& other
-    )
-{
-    std::lock_guard<std::mutex> lock(other.m_clientRequestLock);
-
-    if (other.m_sessionWriter->session() == nullptr)
-    {
-        m_sessionWriter->update_session(nullptr);
-        m_multiplayerGame = nullptr;
-    }
-    else if (other.m_multiplayerGame == nullptr)
-    {
-        m_multiplayerGame = nullptr;
-    }
-    else if (m_sessionWriter->session() == nullptr ||
-            other.m_sessionWriter->session()->change_number() > m_sessionWriter->session()->change_number() ||
-            other.m_sessionWriter->session()->e_tag() > m_sessionWriter->session()->e_tag())
-    {
-        m_sessionWriter->update_session(other.m_sessionWriter->session()->_Create_deep_copy());
-        m_multiplayerGame = other.m_multiplayerGame->_Create_deep_copy();
-    }
-    else if (m_updateNumber != other.m_updateNumber)
-    {
-        m_multiplayerGame = other.m_multiplayerGame->_Create_deep_copy();
-    }
-}
-
 const std::shared_ptr<multiplayer_session_writer>&
 multiplayer_game_client::session_writer() const
 {
@@ -118,7 +89,6 @@ multiplayer_game_client::update_game(
     _In_ const std::shared_ptr<multiplayer_game_session>& multiplayerGame
     )
 {
-    ++m_updateNumber;
     m_multiplayerGame = multiplayerGame;
 }
 
@@ -265,54 +235,79 @@ multiplayer_game_client::get_processing_queue()
     return m_processingQueue;
 }
 
+void
+multiplayer_game_client::set_write_coalescing_window(
+    _In_ std::chrono::milliseconds window
+    )
+{
+    m_writeCoalescingWindow = window;
+}
+
+bool
+multiplayer_game_client::is_coalescing_window_elapsed()
+{
+    std::lock_guard<std::mutex> lock(m_clientRequestLock);
+    return m_pendingRequestQueue.size() > 0 && m_pendingRequestQueue.front()->is_coalescing_window_elapsed(m_writeCoalescingWindow);
+}
+
 std::vector<multiplayer_event>
 multiplayer_game_client::do_work()
 {
     bool expected = false;
     if (m_pendingCommitInProgress.compare_exchange_strong(expected, true))
     {
-        if (m_pendingRequestQueue.size() > 0)
+        if (is_coalescing_window_elapsed())
         {
+            // Queued requests are coalesced into one update followed by one synchronized write.  Requests are never
+            // reordered, so a non-synchronized request queued behind a synchronized one waits for the next batch.
             std::vector<std::shared_ptr<multiplayer_client_pending_request>> processingQueue;
-            bool applySynchronizedChanges = false;
-            bool doneProcessing = false;
-            do
+            std::vector<std::shared_ptr<multiplayer_client_pending_request>> synchronizedQueue;
             {
                 std::lock_guard<std::mutex> lock(m_clientRequestLock);
+                while (m_pendingRequestQueue.size() > 0)
                 {
                     auto pendingRequest = m_pendingRequestQueue.front();
-                    processingQueue.push_back(pendingRequest);
+                    bool isSynchronized = pendingRequest->request_type() == pending_request_type::synchronized_changes;
+                    if (!isSynchronized && synchronizedQueue.size() > 0)
+                    {
+                        break;
+                    }
+
                     m_pendingRequestQueue.pop();
 
-                    if (m_pendingRequestQueue.size() > 0)
+                    if (isSynchronized)
                     {
-                        if (pendingRequest->request_type() != m_pendingRequestQueue.front()->request_type())
-                        {
-                            doneProcessing = true;
-                        }
+                        synchronizedQueue.push_back(pendingRequest);
                     }
-
-                    if (!applySynchronizedChanges && pendingRequest->request_type() == pending_request_type::synchronized_changes)
+                    else
                     {
-                        applySynchronizedChanges = true;
+                        processingQueue.push_back(pendingRequest);
                     }
                 }
+            }
 
-            } while (!doneProcessing && m_pendingRequestQueue.size() > 0);
-
-            if (processingQueue.size() > 0)
+            if (processingQueue.size() > 0 || synchronizedQueue.size() > 0)
             {
                 add_to_processing_queue(processingQueue);
+                add_to_processing_queue(synchronizedQueue);
+
                 pplx::task<xbox_live_result<std::vector<multiplayer_event>>> asyncOp;
-                if (applySynchronizedChanges)
+                if (processingQueue.size() > 0)
                 {
-                    asyncOp = m_sessionWriter->commit_pending_synchronized_changes(processingQueue, multiplayer_session_type::game_session);
+                    asyncOp = m_sessionWriter->commit_pending_changes(processingQueue, multiplayer_session_type::game_session);
                 }
                 else
                 {
-                    asyncOp = m_sessionWriter->commit_pending_changes(processingQueue, multiplayer_session_type::game_session);
+                    asyncOp = pplx::task_from_result(xbox_live_result<std::vector<multiplayer_event>>());
                 }
 
+                if (synchronizedQueue.size() > 0)
+                {
+                    asyncOp = m_sessionWriter->commit_pending_synchronized_changes_after(asyncOp, synchronizedQueue, multiplayer_session_type::game_session);
+                }
+
+                processingQueue.insert(processingQueue.end(), synchronizedQueue.begin(), synchronizedQueue.end());
+
                 std::weak_ptr<multiplayer_game_client> thisWeakPtr = shared_from_this();
 
                 create_task(asyncOp)
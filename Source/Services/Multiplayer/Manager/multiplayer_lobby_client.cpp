@@ -19,7 +19,7 @@ const int MAX_CONNECTION_ATTEMPTS = 3;
 
 multiplayer_lobby_client::multiplayer_lobby_client() :
     m_pendingCommitInProgress(false),
-    m_updateNumber(0),
+    m_writeCoalescingWindow(0),
     m_joinability(joinability::none)
 {
     m_sessionWriter = std::make_shared<multiplayer_session_writer>();
@@ -32,7 +32,7 @@ multiplayer_lobby_client::multiplayer_lobby_client(
     m_lobbySessionTemplateName(std::move(lobbySessionTemplateName)),
     m_multiplayerLocalUserManager(localUserManager),
     m_pendingCommitInProgress(false),
-    m_updateNumber(0),
+    m_writeCoalescingWindow(0),
     m_joinability(joinability::none)
 {
     m_sessionWriter = std::make_shared<multiplayer_session_writer>(localUserManager);
@@ -57,35 +57,6 @@ multiplayer_lobby_client::initialize()
     });
 }
 
-void multiplayer_lobby_client::deep_copy_if_updated(
-    _In_ const multiplayer_lobby_client& other
-    )
-{
-    std::lock_guard<std::mutex> lock(other.m_clientRequestLock);
-
-    m_joinability = other.m_joinability;
-    if (other.m_sessionWriter->session() == nullptr)
-    {
-        m_sessionWriter->update_session(nullptr);
-        m_multiplayerLobby = nullptr;
-    }
-    else if (other.m_multiplayerLobby == nullptr)
-    {
-        m_multiplayerLobby = nullptr;
-    }
-    else if (m_sessionWriter->session() == nullptr ||
-            other.m_sessionWriter->session()->change_number() > m_sessionWriter->session()->change_number() ||
-            other.m_sessionWriter->session()->e_tag() > m_sessionWriter->session()->e_tag())
-    {
-        m_sessionWriter->update_session(other.m_sessionWriter->session()->_Create_deep_copy());
-        m_multiplayerLobby = other.m_multiplayerLobby->_Create_deep_copy();
-    }
-    else if (m_updateNumber != other.m_updateNumber)
-    {
-        m_multiplayerLobby = other.m_multiplayerLobby->_Create_deep_copy();
-    }
-}
-
 std::shared_ptr<multiplayer_game_client>
 multiplayer_lobby_client::game_client()
 {
@@ -121,7 +92,6 @@ multiplayer_lobby_client::update_lobby(
     _In_ std::shared_ptr<multiplayer_lobby_session> multiplayerLobby
     )
 {
-    ++m_updateNumber;
     m_multiplayerLobby = multiplayerLobby;
 }
 
@@ -311,6 +281,21 @@ multiplayer_lobby_client::get_processing_queue()
     return m_processingQueue;
 }
 
+void
+multiplayer_lobby_client::set_write_coalescing_window(
+    _In_ std::chrono::milliseconds window
+    )
+{
+    m_writeCoalescingWindow = window;
+}
+
+bool
+multiplayer_lobby_client::is_coalescing_window_elapsed()
+{
+    std::lock_guard<std::mutex> lock(m_clientRequestLock);
+    return m_pendingRequestQueue.size() > 0 && m_pendingRequestQueue.front()->is_coalescing_window_elapsed(m_writeCoalescingWindow);
+}
+
 xbox_live_result<void>
 multiplayer_lobby_client::add_local_user(
     _In_ xbox_live_user_t user,
@@ -503,33 +488,44 @@ multiplayer_lobby_client::do_work()
     bool expected = false;
     if (m_pendingCommitInProgress.compare_exchange_strong(expected, true))
     {
-        if (m_pendingRequestQueue.size() > 0)
+        if (is_coalescing_window_elapsed())
         {
+            // Queued requests are coalesced into one update followed by one synchronized write.  Requests are never
+            // reordered, so a non-synchronized request queued behind a synchronized one waits for the next batch.
             std::vector<std::shared_ptr<multiplayer_client_pending_request>> processingQueue;
+            std::vector<std::shared_ptr<multiplayer_client_pending_request>> synchronizedQueue;
             multiplayer_session_reference teamSessionRef;
-            bool applySynchronizedChanges = false;
             bool lobbyStateIsJoin = false;
             bool joinByHandleId = false;
-            bool doneProcessing = false;
-            do
             {
                 std::lock_guard<std::mutex> lock(m_clientRequestLock);
+                while (m_pendingRequestQueue.size() > 0)
                 {
                     auto pendingRequest = m_pendingRequestQueue.front();
-                    processingQueue.push_back(pendingRequest);
-                    m_pendingRequestQueue.pop();
+                    bool isSynchronized = pendingRequest->request_type() == pending_request_type::synchronized_changes;
+                    if (!isSynchronized && synchronizedQueue.size() > 0)
+                    {
+                        break;
+                    }
 
-                    if (m_pendingRequestQueue.size() > 0)
+                    // A join replaces the lobby that earlier requests were made against, so it starts a new batch.
+                    if (!lobbyStateIsJoin &&
+                        pendingRequest->local_user() != nullptr &&
+                        pendingRequest->lobby_state() == multiplayer_local_user_lobby_state::join &&
+                        processingQueue.size() > 0)
                     {
-                        if (pendingRequest->request_type() != m_pendingRequestQueue.front()->request_type())
-                        {
-                            doneProcessing = true;
-                        }
+                        break;
                     }
 
-                    if (!applySynchronizedChanges && pendingRequest->request_type() == pending_request_type::synchronized_changes)
+                    m_pendingRequestQueue.pop();
+
+                    if (isSynchronized)
                     {
-                        applySynchronizedChanges = true;
+                        synchronizedQueue.push_back(pendingRequest);
+                    }
+                    else
+                    {
+                        processingQueue.push_back(pendingRequest);
                     }
 
                     if (pendingRequest->local_user() != nullptr)
@@ -570,18 +566,15 @@ multiplayer_lobby_client::do_work()
                         pendingRequest->local_user()->set_write_changes_to_service(true);
                     }
                 }
+            }
 
-            } while (!doneProcessing && m_pendingRequestQueue.size() > 0);
-
-            if (processingQueue.size() > 0)
+            if (processingQueue.size() > 0 || synchronizedQueue.size() > 0)
             {
                 add_to_processing_queue(processingQueue);
+                add_to_processing_queue(synchronizedQueue);
+
                 pplx::task<xbox_live_result<std::vector<multiplayer_event>>> asyncOp;
-                if (applySynchronizedChanges)
-                {
-                    asyncOp = m_sessionWriter->commit_pending_synchronized_changes(processingQueue, multiplayer_session_type::lobby_session);
-                }
-                else
+                if (processingQueue.size() > 0)
                 {
                     std::vector<string_t> xuidsInOrder;
 
@@ -594,12 +587,26 @@ multiplayer_lobby_client::do_work()
                         // than the join fails for the whole list of users.
                         for (auto pendingRequest : processingQueue)
                         {
-                            xuidsInOrder.push_back(pendingRequest->local_user()->xbox_user_id());
+                            if (pendingRequest->local_user() != nullptr)
+                            {
+                                xuidsInOrder.push_back(pendingRequest->local_user()->xbox_user_id());
+                            }
                         }
                     }
 
                     asyncOp = commit_pending_lobby_changes(xuidsInOrder, joinByHandleId, teamSessionRef);
                 }
+                else
+                {
+                    asyncOp = pplx::task_from_result(xbox_live_result<std::vector<multiplayer_event>>());
+                }
+
+                if (synchronizedQueue.size() > 0)
+                {
+                    asyncOp = m_sessionWriter->commit_pending_synchronized_changes_after(asyncOp, synchronizedQueue, multiplayer_session_type::lobby_session);
+                }
+
+                processingQueue.insert(processingQueue.end(), synchronizedQueue.begin(), synchronizedQueue.end());
 
                 std::weak_ptr<multiplayer_lobby_client> thisWeakPtr = shared_from_this();
 
@@ -851,8 +858,8 @@ multiplayer_lobby_client::commit_lobby_changes_helper(
 
             bool isGameInProgress = game_session() != nullptr;
 
-            // Update any pending local user or lobby session properties.
-            auto processingQueue = get_processing_queue();
+            // Update any pending local user or lobby session properties.  Coalesced synchronized requests are written separately.
+            auto processingQueue = multiplayer_manager_utils::filter_pending_requests(get_processing_queue(), pending_request_type::non_synchronized_changes);
             for(auto& request : processingQueue)
             {
                 request->append_pending_changes(lobbySessionToCommit, localUser, isGameInProgress);
@@ -5,6 +5,7 @@
 #include "xsapi/multiplayer.h"
 #include "xsapi/multiplayer_manager.h"
 #include "multiplayer_manager_internal.h"
+#include "mem_pool.h"
 
 #if defined __cplusplus_winrt
 using namespace Platform;
@@ -67,6 +68,7 @@ multiplayer_manager::_Is_dirty()
 std::vector<multiplayer_event>
 multiplayer_manager::do_work()
 {
+    xbox::services::system::xsapi_memory_subsystem_scope memoryScope(xbox::services::system::xsapi_memory_subsystem::multiplayer, __FUNCTION__);
     std::lock_guard<std::mutex> guard(m_lock);
 
     if (m_multiplayerClientManager == nullptr)
@@ -98,12 +100,12 @@ multiplayer_manager::do_work()
         m_isDirty = true;
         eventQueue = m_multiplayerClientManager->do_work();
 
-        std::shared_ptr<multiplayer_client_pending_reader> clientRequest = m_multiplayerClientManager->last_pending_read();
-        if (clientRequest != nullptr)
+        auto snapshot = m_multiplayerClientManager->last_snapshot();
+        if (snapshot != nullptr)
         {
-            m_joinability = clientRequest->lobby_client()->joinability();
-            set_multiplayer_game_session(clientRequest->game_client()->game());
-            set_multiplayer_lobby_session(clientRequest->lobby_client()->lobby());
+            m_joinability = snapshot->lobbyJoinability;
+            set_multiplayer_game_session(snapshot->game);
+            set_multiplayer_lobby_session(snapshot->lobby);
         }
         else
         {
@@ -144,8 +146,8 @@ multiplayer_manager::set_multiplayer_game_session(
     }
     else
     {
+        // The client manager was set before the snapshot holding this session was published
         m_multiplayerGameSession = gameSession;
-        m_multiplayerGameSession->_Set_multiplayer_client_manager(m_multiplayerClientManager);
     }
 }
 
@@ -168,8 +170,8 @@ multiplayer_manager::set_multiplayer_lobby_session(
     }
     else
     {
+        // The client manager was set before the snapshot holding this session was published
         m_multiplayerLobbySession = multiplayerLobby;
-        m_multiplayerLobbySession->_Set_multiplayer_client_manager(m_multiplayerClientManager);
     }
 }
 
@@ -263,7 +265,19 @@ multiplayer_manager::find_match(
     )
 {
     RETURN_CPP_IF(m_multiplayerClientManager == nullptr, void, xbox_live_error_code::logic_error, "Call multiplayer_manager::initialize() first.");
-    RETURN_EXCEPTION_FREE_XBOX_LIVE_RESULT(m_multiplayerClientManager->find_match(hopperName, attributes, timeout), void);
+    RETURN_EXCEPTION_FREE_XBOX_LIVE_RESULT(m_multiplayerClientManager->find_match(std::vector<string_t>(1, hopperName), attributes, timeout), void);
+}
+
+xbox_live_result<void>
+multiplayer_manager::find_match(
+    _In_ const std::vector<string_t>& hopperNames,
+    _In_ const web::json::value& attributes,
+    _In_ const std::chrono::seconds& timeout
+    )
+{
+    RETURN_CPP_IF(m_multiplayerClientManager == nullptr, void, xbox_live_error_code::logic_error, "Call multiplayer_manager::initialize() first.");
+    RETURN_CPP_IF(hopperNames.empty(), void, xbox_live_error_code::invalid_argument, "At least one hopper is required.");
+    RETURN_EXCEPTION_FREE_XBOX_LIVE_RESULT(m_multiplayerClientManager->find_match(hopperNames, attributes, timeout), void);
 }
 
 void
@@ -308,6 +322,20 @@ multiplayer_manager::set_quality_of_service_measurements(
     }
 }
 
+void
+multiplayer_manager::set_automatic_qos_measurements(
+    _In_ bool enabled,
+    _In_ uint32_t probeCount,
+    _In_ std::chrono::milliseconds probeTimeout,
+    _In_ std::function<string_t(const string_t& address)> resolveEndpoint
+    )
+{
+    if (m_multiplayerClientManager != nullptr && m_multiplayerClientManager->match_client() != nullptr)
+    {
+        m_multiplayerClientManager->match_client()->set_automatic_qos_measurements(enabled, probeCount, probeTimeout, std::move(resolveEndpoint));
+    }
+}
+
 bool
 multiplayer_manager::auto_fill_members_during_matchmaking() const
 {
@@ -325,6 +353,17 @@ multiplayer_manager::set_auto_fill_members_during_matchmaking(
     }
 }
 
+void
+multiplayer_manager::set_write_coalescing_window(
+    _In_ std::chrono::milliseconds window
+    )
+{
+    if (m_multiplayerClientManager != nullptr)
+    {
+        m_multiplayerClientManager->set_write_coalescing_window(window);
+    }
+}
+
 xbox::services::multiplayer::manager::joinability
 multiplayer_manager::joinability() const
 {
@@ -70,6 +70,11 @@ public:
 
     uint32_t identifier() const;
 
+    /// <summary>
+    /// True once the request has been queued for at least window, so that later requests can be coalesced into the same write.
+    /// </summary>
+    bool is_coalescing_window_elapsed(_In_ std::chrono::milliseconds window) const;
+
     // Local user properties
     std::shared_ptr<multiplayer_local_user> local_user();
     void set_local_user(_In_ std::shared_ptr<multiplayer_local_user> user);
@@ -123,6 +128,7 @@ private:
     context_t m_context;
     pending_request_type m_requestType;
     uint32_t m_identifier;
+    std::chrono::steady_clock::time_point m_queuedTime;
 
     // Local user properties
     std::shared_ptr<multiplayer_local_user> m_localUser;
@@ -186,6 +192,16 @@ public:
         _In_ multiplayer_session_type sessionType
         );
 
+    /// <summary>
+    /// Commits the synchronized requests of a coalesced batch once precedingCommit has completed, so the
+    /// synchronized write is made against the session returned by that write.  Events from both writes are returned together.
+    /// </summary>
+    pplx::task<xbox_live_result<std::vector<multiplayer_event>>> commit_pending_synchronized_changes_after(
+        _In_ pplx::task<xbox_live_result<std::vector<multiplayer_event>>> precedingCommit,
+        _In_ std::vector<std::shared_ptr<multiplayer_client_pending_request>> synchronizedQueue,
+        _In_ multiplayer_session_type sessionType
+        );
+
     pplx::task<xbox_live_result<std::shared_ptr<xbox::services::multiplayer::multiplayer_session>>> write_session(
         _In_ std::shared_ptr<xbox::services::xbox_live_context_impl> xboxLiveContext,
         _In_ std::shared_ptr<xbox::services::multiplayer::multiplayer_session> session,
@@ -230,6 +246,15 @@ private:
         _In_ bool updateLatest
         );
 
+    /// <summary>
+    /// Reads the session for a shoulder tap.  Only one read is in flight at a time; taps it may not cover are
+    /// collapsed into a single follow-up read.  Must be called with m_synchronizeWriteWithTapLock held.
+    /// </summary>
+    void read_session_for_tap(
+        _In_ const xbox::services::multiplayer::multiplayer_session_reference& sessionReference,
+        _In_ uint64_t tapChangeNumber
+        );
+
      pplx::task<xbox_live_result<std::shared_ptr<xbox::services::multiplayer::multiplayer_session>>> get_current_session_helper(
         _In_ std::shared_ptr<xbox::services::xbox_live_context_impl> xboxLiveContext,
         _In_ const xbox::services::multiplayer::multiplayer_session_reference& sessionReference
@@ -248,6 +273,11 @@ private:
     uint64_t m_tapChangeNumber;
     bool m_isTapReceived;
     uint64_t m_numOfWritesInProgress;
+
+    // Shoulder tap reads
+    bool m_isTapReadInProgress;
+    uint64_t m_tapReadChangeNumber;
+    uint64_t m_pendingTapReadChangeNumber;
     std::shared_ptr<xbox::services::multiplayer::multiplayer_session> m_session;
     std::shared_ptr<multiplayer_local_user_manager> m_multiplayerLocalUserManager;
 };
@@ -263,8 +293,6 @@ public:
         _In_ std::shared_ptr<multiplayer_local_user_manager> localUserManager
         );
 
-    void deep_copy_if_updated(_In_ const multiplayer_game_client& other);
-
     void initialize();
 
     void set_game_session_template(_In_ const string_t& sessionTemplateName);
@@ -287,6 +315,8 @@ public:
     const std::vector<multiplayer_event>& multiplayer_event_queue();
     std::vector<std::shared_ptr<multiplayer_client_pending_request>> get_processing_queue();
 
+    void set_write_coalescing_window(_In_ std::chrono::milliseconds window);
+
     void update_game_session(_In_ const std::shared_ptr<xbox::services::multiplayer::multiplayer_session>& session);
 
     void update_objects(
@@ -344,6 +374,8 @@ private:
     std::shared_ptr<multiplayer_lobby_client> lobby_client();
     std::shared_ptr<xbox::services::multiplayer::multiplayer_session> lobby_session();
 
+    bool is_coalescing_window_elapsed();
+
     std::shared_ptr<multiplayer_game_session> convert_to_multiplayer_game(
         _In_ const std::shared_ptr<xbox::services::multiplayer::multiplayer_session>& sessionToConvert,
         _In_ const std::shared_ptr<xbox::services::multiplayer::multiplayer_session>& lobbySession
@@ -366,8 +398,8 @@ private:
 
     mutable std::mutex m_clientRequestLock;
     std::atomic<bool> m_pendingCommitInProgress;
+    std::chrono::milliseconds m_writeCoalescingWindow;
     string_t m_gameSessionTemplateName;
-    uint64_t m_updateNumber;
     std::shared_ptr<multiplayer_session_writer> m_sessionWriter;
     std::vector<multiplayer_event> m_multiplayerEventQueue;
     std::shared_ptr<multiplayer_game_session> m_multiplayerGame;
@@ -388,8 +420,6 @@ public:
         _In_ std::shared_ptr<multiplayer_local_user_manager> localUserManager
         );
 
-    void deep_copy_if_updated(_In_ const multiplayer_lobby_client& other);
-
     void initialize();
 
     const std::shared_ptr<multiplayer_session_writer>& session_writer() const;
@@ -460,6 +490,8 @@ public:
     const std::vector<multiplayer_event>& multiplayer_event_queue();
     std::vector<std::shared_ptr<multiplayer_client_pending_request>> get_processing_queue();
 
+    void set_write_coalescing_window(_In_ std::chrono::milliseconds window);
+
     void update_lobby_session(_In_ const std::shared_ptr<xbox::services::multiplayer::multiplayer_session>& updatedSession);
 
     void update_objects(
@@ -509,6 +541,7 @@ private:
         );
 
     bool is_pending_lobby_local_user_changes();
+    bool is_coalescing_window_elapsed();
 
     bool should_update_host_token(
         _In_ std::shared_ptr<xbox::services::multiplayer::manager::multiplayer_local_user> localUser,
@@ -562,8 +595,8 @@ private:
 
     string_t m_lobbySessionTemplateName;
     std::atomic<bool> m_pendingCommitInProgress;
+    std::chrono::milliseconds m_writeCoalescingWindow;
 
-    uint64_t m_updateNumber;
     xbox::services::multiplayer::manager::joinability m_joinability;
     mutable std::mutex m_clientRequestLock;
     std::queue<std::shared_ptr<multiplayer_client_pending_request>> m_pendingRequestQueue;
@@ -575,11 +608,24 @@ private:
     std::vector<std::shared_ptr<multiplayer_client_pending_request>> m_processingQueue;
 };
 
+/// <summary>
+/// The state the title saw at the end of a do_work.  Never modified once published, so it can be read
+/// without a lock and shares its objects with the pending reader instead of copying them: session writers
+/// replace their session rather than modifying it, and the clients build new lobby and game objects each frame.
+/// </summary>
+struct multiplayer_client_snapshot
+{
+    std::shared_ptr<xbox::services::multiplayer::multiplayer_session> lobbySession;
+    std::shared_ptr<xbox::services::multiplayer::multiplayer_session> gameSession;
+    std::shared_ptr<xbox::services::multiplayer::multiplayer_session> matchSession;
+    std::shared_ptr<multiplayer_lobby_session> lobby;
+    std::shared_ptr<multiplayer_game_session> game;
+    xbox::services::multiplayer::manager::joinability lobbyJoinability;
+};
+
 class multiplayer_client_pending_reader : public std::enable_shared_from_this<multiplayer_client_pending_reader>
 {
 public:
-    multiplayer_client_pending_reader();
-
     ~multiplayer_client_pending_reader();
 
     multiplayer_client_pending_reader(
@@ -587,8 +633,8 @@ public:
         _In_ std::shared_ptr<multiplayer_local_user_manager> localUserManager
         );
 
-    void deep_copy_if_updated(_In_ const multiplayer_client_pending_reader& other);
-    bool is_update_avaialable(_In_ const multiplayer_client_pending_reader& other);
+    std::shared_ptr<const multiplayer_client_snapshot> create_snapshot();
+    bool is_update_avaialable(_In_ const multiplayer_client_snapshot& lastSnapshot);
 
     void do_work();
     void process_match_events();
@@ -599,7 +645,8 @@ public:
 
     std::vector<multiplayer_event> multiplayer_event_queue() const;
 
-    void clear_multiplayer_event_queue();
+    // Removes and returns the events queued since the last call
+    std::vector<multiplayer_event> take_multiplayer_event_queue();
     void add_to_multiplayer_event_queue(_In_ multiplayer_event multiplayerEvent);
     void add_to_multiplayer_event_queue(_In_ std::vector<multiplayer_event> multiplayerEventQueue);
 
@@ -611,13 +658,15 @@ public:
     bool is_match(_In_ xbox::services::multiplayer::multiplayer_session_reference sessionRef);
 
     xbox_live_result<void> find_match(
-        _In_ const string_t& hopperName,
+        _In_ const std::vector<string_t>& hopperNames,
         _In_ const web::json::value& attributes,
         _In_ const std::chrono::seconds& timeout
         );
 
     void set_auto_fill_members_during_matchmaking(_In_ bool autoFillMembers);
 
+    void set_write_coalescing_window(_In_ std::chrono::milliseconds window);
+
     xbox_live_result<void> set_joinability(
         _In_ xbox::services::multiplayer::manager::joinability value,
         _In_opt_ context_t context
@@ -819,7 +868,9 @@ public:
 
     std::shared_ptr<multiplayer_lobby_client> lobby_client() const;
     std::shared_ptr<multiplayer_client_pending_reader> latest_pending_read() const;
-    std::shared_ptr<multiplayer_client_pending_reader> last_pending_read() const;
+
+    // What the last do_work published; null before initialize() and after shutdown()
+    std::shared_ptr<const multiplayer_client_snapshot> last_snapshot() const;
 
     xbox_live_result<void> join_lobby_by_handle(
         _In_ const string_t& handleId,
@@ -896,13 +947,15 @@ public:
     std::shared_ptr<multiplayer_match_client> match_client();
 
     xbox_live_result<void> find_match(
-        _In_ const string_t& hopperName,
+        _In_ const std::vector<string_t>& hopperNames,
         _In_ const web::json::value& attributes,
         _In_ const std::chrono::seconds& timeout
         );
 
     void set_auto_fill_members_during_matchmaking(_In_ bool autoFillMembers);
 
+    void set_write_coalescing_window(_In_ std::chrono::milliseconds window);
+
     void on_session_changed(
         _In_ const xbox::services::multiplayer::multiplayer_session_change_event_args& args
     );
@@ -943,35 +996,41 @@ private:
         );
 
     void process_events(
+        _In_ const std::shared_ptr<multiplayer_client_pending_reader>& latestPendingRead,
         _In_ std::shared_ptr<xbox::services::multiplayer::multiplayer_session> currentSession,
         _In_ std::shared_ptr<xbox::services::multiplayer::multiplayer_session> oldSession,
         _In_ multiplayer_session_type sessionType
         );
 
     void handle_member_list_changed(
+        _In_ const std::shared_ptr<multiplayer_client_pending_reader>& latestPendingRead,
         _In_ std::shared_ptr<xbox::services::multiplayer::multiplayer_session> currentSession,
         _In_ std::shared_ptr<xbox::services::multiplayer::multiplayer_session> oldSession,
         _In_ multiplayer_session_type sessionType
         );
 
     void handle_member_properties_changed(
+        _In_ const std::shared_ptr<multiplayer_client_pending_reader>& latestPendingRead,
         _In_ std::shared_ptr<xbox::services::multiplayer::multiplayer_session> currentSession,
         _In_ std::shared_ptr<xbox::services::multiplayer::multiplayer_session> oldSession,
         _In_ multiplayer_session_type sessionType
         );
 
     void handle_session_properties_changed(
+        _In_ const std::shared_ptr<multiplayer_client_pending_reader>& latestPendingRead,
         _In_ std::shared_ptr<xbox::services::multiplayer::multiplayer_session> currentSession,
         _In_ std::shared_ptr<xbox::services::multiplayer::multiplayer_session> oldSession,
         _In_ multiplayer_session_type sessionType
         );
 
     void handle_host_changed(
+        _In_ const std::shared_ptr<multiplayer_client_pending_reader>& latestPendingRead,
         _In_ std::shared_ptr<xbox::services::multiplayer::multiplayer_session> currentSession,
         _In_ multiplayer_session_type sessionType
         );
 
     void handle_tournament_properties_changed(
+        _In_ const std::shared_ptr<multiplayer_client_pending_reader>& latestPendingRead,
         _In_ std::shared_ptr<multiplayer_session> currentSession,
         _In_ std::shared_ptr<multiplayer_session> oldSession,
         _In_ multiplayer_session_type sessionType
@@ -1011,6 +1070,7 @@ private:
     std::atomic<bool> m_subscriptionsLostFired;
 
     bool m_autoFillMembers;
+    std::chrono::milliseconds m_writeCoalescingWindow;
     string_t m_lobbySessionTemplateName;
     function_context m_sessionChangedContext;
     function_context m_subscriptionLostContext;
@@ -1021,8 +1081,76 @@ private:
     xbox::services::multiplayer::multiplayer_service m_clientManagerMultiplayerService;
     std::shared_ptr<xbox_live_context_impl> m_primaryXboxLiveContext;
     std::shared_ptr<multiplayer_local_user_manager> m_multiplayerLocalUserManager;
-    std::shared_ptr<multiplayer_client_pending_reader> m_lastPendingRead;
     std::shared_ptr<multiplayer_client_pending_reader> m_latestPendingRead;
+
+    // Only accessed through std::atomic_load and std::atomic_store
+    std::shared_ptr<const multiplayer_client_snapshot> m_lastSnapshot;
+};
+
+struct multiplayer_qos_probe_result
+{
+    uint32_t probesReceived;
+    std::chrono::milliseconds latency;
+};
+
+/// <summary>
+/// Measures round trip latency to UDP endpoints given as "host:port".  Each round sends one probe to every
+/// endpoint at once, so a measurement takes about probeCount rounds plus the timeout however many endpoints
+/// there are.  A probe is a c_probeSize byte datagram that the endpoint must echo back unchanged.
+/// </summary>
+class multiplayer_qos_prober
+{
+public:
+    static const uint32_t c_probeSize = 16;
+
+    multiplayer_qos_prober(
+        _In_ uint32_t probeCount,
+        _In_ std::chrono::milliseconds probeTimeout
+        );
+
+    /// <summary>
+    /// Blocks until every probe has been answered or has timed out.  Returns one result per endpoint, in order.
+    /// The latency is the median round trip of the answered probes; endpoints that answered none, or could not
+    /// be resolved, have probesReceived of zero.
+    /// </summary>
+    std::vector<multiplayer_qos_probe_result> measure(
+        _In_ const std::vector<string_t>& endpoints
+        ) const;
+
+private:
+    uint32_t m_probeCount;
+    std::chrono::milliseconds m_probeTimeout;
+};
+
+/// <summary>
+/// Echoes qos probes back to their sender from a background thread, so that peers can measure this device.
+/// </summary>
+class multiplayer_qos_responder
+{
+public:
+    multiplayer_qos_responder();
+    ~multiplayer_qos_responder();
+
+    /// <summary>
+    /// Binds to host and port and starts answering probes.  A port of zero picks a free one; see port().
+    /// </summary>
+    std::error_code start(
+        _In_ const string_t& host,
+        _In_ uint16_t port
+        );
+
+    uint16_t port() const;
+
+    void stop();
+
+private:
+    multiplayer_qos_responder(const multiplayer_qos_responder&);
+    multiplayer_qos_responder& operator=(const multiplayer_qos_responder&);
+
+    std::thread m_thread;
+    std::atomic<bool> m_stopping;
+    uintptr_t m_socket;
+    uint16_t m_port;
 };
 
 class multiplayer_match_client : public std::enable_shared_from_this<multiplayer_match_client>
@@ -1034,7 +1162,6 @@ public:
 
     std::vector<multiplayer_event> do_work();
     const std::vector<multiplayer_event>& multiplayer_event_queue();
-    void deep_copy_if_updated(_In_ const multiplayer_match_client& other);
 
     xbox::services::multiplayer::manager::match_status match_status() const;
     void set_match_status(_In_ xbox::services::multiplayer::manager::match_status status);
@@ -1054,6 +1181,19 @@ public:
         _In_ bool preserveSession
         );
 
+    /// <summary>
+    /// Searches the hoppers one at a time, fastest first by their current statistics.  Each hopper's ticket
+    /// times out after a few times its estimated wait, or an even share of the time left if it has no estimate,
+    /// and the search falls back to the next one until a match is found or timeout runs out.
+    /// </summary>
+    xbox_live_result<void> find_match(
+        _In_ const std::vector<string_t>& hopperNames,
+        _In_ const web::json::value& attributes,
+        _In_ const std::chrono::seconds& timeout,
+        _In_ std::shared_ptr<xbox::services::multiplayer::multiplayer_session> session,
+        _In_ bool preserveSession
+        );
+
     void cancel_match();
 
     void update_session(_In_ std::shared_ptr<xbox::services::multiplayer::multiplayer_session> currentSession);
@@ -1075,6 +1215,13 @@ public:
         _In_ std::shared_ptr<std::vector<xbox::services::multiplayer::multiplayer_quality_of_service_measurements>> measurements
         );
 
+    void set_automatic_qos_measurements(
+        _In_ bool enabled,
+        _In_ uint32_t probeCount,
+        _In_ std::chrono::milliseconds probeTimeout,
+        _In_ std::function<string_t(const string_t&)> resolveEndpoint
+        );
+
     void resubmit_matchmaking(
         _In_ std::shared_ptr<xbox::services::multiplayer::multiplayer_session> session
         );
@@ -1096,6 +1243,25 @@ private:
 
     void handle_qos_measurements();
 
+    void submit_match_ticket(
+        _In_ const string_t& hopperName,
+        _In_ std::chrono::seconds ticketTimeout
+        );
+
+    bool submit_next_hopper();
+    bool has_pending_hoppers();
+
+    void measure_and_upload_qos(
+        _In_ std::vector<string_t> deviceTokens,
+        _In_ std::vector<string_t> serverLocations,
+        _In_ std::vector<string_t> endpoints
+        );
+
+    void upload_qos_measurements(
+        _In_ std::shared_ptr<std::vector<xbox::services::multiplayer::multiplayer_quality_of_service_measurements>> measurements,
+        _In_ web::json::value serverMeasurementsJson
+        );
+
     void handle_match_found(
         _In_ std::shared_ptr<xbox::services::multiplayer::multiplayer_session> currentSession
         );
@@ -1119,9 +1285,17 @@ private:
     xbox::services::multiplayer::multiplayer_session_reference m_matchTicketSessionRef;
     std::shared_ptr<xbox::services::multiplayer::multiplayer_session> m_matchSession;
     std::shared_ptr<multiplayer_local_user_manager> m_multiplayerLocalUserManager;
+    std::vector<std::pair<string_t, std::chrono::seconds>> m_pendingHoppers;
+    utility::datetime m_matchDeadline;
+    bool m_automaticQos;
+    uint32_t m_qosProbeCount;
+    std::chrono::milliseconds m_qosProbeTimeout;
+    std::function<string_t(const string_t&)> m_qosResolveEndpoint;
 
     pplx::task<void> m_getSessionTask;
     pplx::task<xbox_live_result<std::shared_ptr<xbox::services::multiplayer::multiplayer_session>>> m_joinTargetSessionTask;
+
+    static const std::chrono::seconds c_minimumHopperTimeout;
 };
 
 class multiplayer_manager_utils
@@ -1218,6 +1392,11 @@ public:
         );
 
     static string_t convert_joinability_to_string(_In_ xbox::services::multiplayer::manager::joinability value);
+
+    static std::vector<std::shared_ptr<multiplayer_client_pending_request>> filter_pending_requests(
+        _In_ const std::vector<std::shared_ptr<multiplayer_client_pending_request>>& requests,
+        _In_ pending_request_type requestType
+        );
 };
 
 }}}}
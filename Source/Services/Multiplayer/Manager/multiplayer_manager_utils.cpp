@@ -48,15 +48,7 @@ multiplayer_manager_utils::is_player_in_session(
         return false;
     }
 
-    for (const auto& member : session->members())
-    {
-        if (utils::str_icmp(xboxUserId, member->xbox_user_id()) == 0)
-        {
-            return true;
-        }
-    }
-
-    return false;
+    return session->_Member_by_xbox_user_id(xboxUserId) != nullptr;
 }
 
 std::shared_ptr<multiplayer_session_member>
@@ -72,15 +64,7 @@ std::shared_ptr<multiplayer_session_member>
         return nullptr;
     }
 
-    for (const auto& member : session->members())
-    {
-        if (utils::str_icmp(xboxUserId, member->xbox_user_id()) == 0)
-        {
-            return member;
-        }
-    }
-
-    return nullptr;
+    return session->_Member_by_xbox_user_id(xboxUserId);
 }
 
 std::shared_ptr<multiplayer_session_member>
@@ -160,16 +144,9 @@ multiplayer_manager_utils::is_local(
 {
     if(xboxUserId.empty()) return false;
 
-    for(const auto& xboxLiveContext : xboxLiveContextMap)
-    {
-        const auto& localUser =  xboxLiveContext.second;
-        if (localUser != nullptr && utils::str_icmp(xboxUserId, localUser->xbox_user_id()) == 0)
-        {
-            return true;
-        }
-    }
-
-    return false;
+    // The map is keyed by xbox user id
+    auto iter = xboxLiveContextMap.find(xboxUserId);
+    return iter != xboxLiveContextMap.end() && iter->second != nullptr;
 }
 
 std::shared_ptr<multiplayer_member>
@@ -313,5 +290,23 @@ multiplayer_manager_utils::convert_joinability_to_string(
     }
 }
 
+std::vector<std::shared_ptr<multiplayer_client_pending_request>>
+multiplayer_manager_utils::filter_pending_requests(
+    _In_ const std::vector<std::shared_ptr<multiplayer_client_pending_request>>& requests,
+    _In_ pending_request_type requestType
+    )
+{
+    std::vector<std::shared_ptr<multiplayer_client_pending_request>> filteredRequests;
+    for (const auto& request : requests)
+    {
+        if (request->request_type() == requestType)
+        {
+            filteredRequests.push_back(request);
+        }
+    }
+
+    return filteredRequests;
+}
+
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_MULTIPLAYER_MANAGER_CPP_END
\ No newline at end of file
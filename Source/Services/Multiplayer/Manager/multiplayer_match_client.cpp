@@ -20,33 +20,22 @@ using namespace Windows::Xbox::Networking;
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_MULTIPLAYER_MANAGER_CPP_BEGIN
 
+const std::chrono::seconds multiplayer_match_client::c_minimumHopperTimeout(10);
+
 multiplayer_match_client::multiplayer_match_client(
     _In_ std::shared_ptr<multiplayer_local_user_manager> localUserManager
     ) :
     m_multiplayerLocalUserManager(localUserManager),
     m_matchStatus(match_status::none),
     m_disableNextTimer(false),
-    m_preservingMatchmakingSession(false)
+    m_preservingMatchmakingSession(false),
+    m_automaticQos(false),
+    m_qosProbeCount(0),
+    m_qosProbeTimeout(0)
 {
     m_getSessionTask = pplx::create_task([]{});
 }
 
-void
-multiplayer_match_client::deep_copy_if_updated(
-    _In_ const multiplayer_match_client& other
-    )
-{
-    std::lock_guard<std::mutex> lock(m_lock.get());
-    if (other.m_matchSession == nullptr)
-    {
-        m_matchSession = nullptr;
-    }
-    else if (m_matchSession == nullptr || other.m_matchSession->change_number() > m_matchSession->change_number())
-    {
-        m_matchSession = other.m_matchSession->_Create_deep_copy();
-    }
-}
-
 const std::vector<multiplayer_event>&
 multiplayer_match_client::multiplayer_event_queue()
 {
@@ -161,8 +150,9 @@ multiplayer_match_client::check_next_timer()
 void
 multiplayer_match_client::handle_qos_measurements()
 {
+    auto matchSession = session();
     std::map<string_t, string_t> addressDeviceTokenMap;
-    for (const auto& member : session()->members())
+    for (const auto& member : matchSession->members())
     {
         if (!member->is_current_user())
         {
@@ -175,7 +165,55 @@ multiplayer_match_client::handle_qos_measurements()
         }
     }
 
-    if (addressDeviceTokenMap.size() > 0)
+    bool automaticQos;
+    std::function<string_t(const string_t&)> resolveEndpoint;
+    {
+        std::lock_guard<std::mutex> lock(m_lock.get());
+        automaticQos = m_automaticQos;
+        resolveEndpoint = m_qosResolveEndpoint;
+    }
+
+    if (automaticQos)
+    {
+        // Members first, then measurement servers, each probed at the endpoint its address resolves to
+        std::vector<string_t> deviceTokens;
+        std::vector<string_t> serverLocations;
+        std::vector<string_t> endpoints;
+        for (const auto& address : addressDeviceTokenMap)
+        {
+            string_t endpoint = resolveEndpoint != nullptr ? resolveEndpoint(address.first) : address.first;
+            if (!endpoint.empty())
+            {
+                deviceTokens.push_back(address.second);
+                endpoints.push_back(std::move(endpoint));
+            }
+        }
+
+        const auto& serverAddressesJson = matchSession->session_constants()->measurement_server_addresses_json();
+        if (serverAddressesJson.is_object())
+        {
+            for (const auto& server : serverAddressesJson.as_object())
+            {
+                string_t addressBase64 = utils::extract_json_string(server.second, _T("secureDeviceAddress"));
+                std::vector<unsigned char> addressBytes(utility::conversions::from_base64(addressBase64));
+                string_t address(addressBytes.begin(), addressBytes.end());
+                string_t endpoint = resolveEndpoint != nullptr ? resolveEndpoint(address) : address;
+                if (!endpoint.empty())
+                {
+                    serverLocations.push_back(server.first);
+                    endpoints.push_back(std::move(endpoint));
+                }
+            }
+        }
+
+        if (!endpoints.empty())
+        {
+            m_matchStatus = match_status::measuring;
+            measure_and_upload_qos(std::move(deviceTokens), std::move(serverLocations), std::move(endpoints));
+            return;
+        }
+    }
+    else if (addressDeviceTokenMap.size() > 0)
     {
         m_matchStatus = match_status::measuring;
 
@@ -190,13 +228,57 @@ multiplayer_match_client::handle_qos_measurements()
 
         std::lock_guard<std::mutex> lock(m_multiplayerEventQueueLock);
         m_multiplayerEventQueue.push_back(multiplayerEvent);
+        return;
     }
-    else
+
+    // If clients fail to join, the stage advances to "measuring".
+    // Wait until memberInitialization either succeeds or fails.
+    check_next_timer();
+}
+
+void
+multiplayer_match_client::measure_and_upload_qos(
+    _In_ std::vector<string_t> deviceTokens,
+    _In_ std::vector<string_t> serverLocations,
+    _In_ std::vector<string_t> endpoints
+    )
+{
+    std::unique_lock<std::mutex> lock(m_lock.get());
+    multiplayer_qos_prober prober(m_qosProbeCount, m_qosProbeTimeout);
+    lock.unlock();
+
+    std::weak_ptr<multiplayer_match_client> thisWeakPtr = shared_from_this();
+    pplx::create_task([prober, endpoints]()
     {
-        // If clients fail to join, the stage advances to "measuring".
-        // Wait until memberInitialization either succeeds or fails.
-        check_next_timer();
-    }
+        return prober.measure(endpoints);
+    })
+    .then([thisWeakPtr, deviceTokens, serverLocations](std::vector<multiplayer_qos_probe_result> results)
+    {
+        std::shared_ptr<multiplayer_match_client> pThis(thisWeakPtr.lock());
+        if (pThis == nullptr) return;
+
+        // Unreachable endpoints are left out, which the service treats as a failed measurement
+        auto measurements = std::make_shared<std::vector<multiplayer_quality_of_service_measurements>>();
+        for (size_t i = 0; i < deviceTokens.size(); ++i)
+        {
+            if (results[i].probesReceived > 0)
+            {
+                measurements->push_back(multiplayer_quality_of_service_measurements(deviceTokens[i], results[i].latency, 0, 0, _T("{}")));
+            }
+        }
+
+        web::json::value serverMeasurementsJson;
+        for (size_t i = 0; i < serverLocations.size(); ++i)
+        {
+            const auto& result = results[deviceTokens.size() + i];
+            if (result.probesReceived > 0)
+            {
+                serverMeasurementsJson[serverLocations[i]][_T("latency")] = result.latency.count();
+            }
+        }
+
+        pThis->upload_qos_measurements(measurements->empty() ? nullptr : measurements, serverMeasurementsJson);
+    });
 }
 
 void
@@ -253,18 +335,35 @@ multiplayer_match_client::handle_match_status_changed(
                 int64_t delta = m_nextTimerToFetchSession.to_interval() - utility::datetime::utc_now().to_interval();
                 if ( delta < 0)
                 {
-                    // Delete the match ticket and let the title know that it failed.
+                    // Delete the match ticket and try the next hopper, or let the title know that it failed.
                     if (!m_hopperName.empty() && !m_matchTicketResponse.match_ticket_id().empty())
                     {
                         // Only the host has the ticketId info. Since we aren't the host who started the match, we cannot cancel it either.
                         std::shared_ptr<xbox_live_context_impl> primaryContext = m_multiplayerLocalUserManager->get_primary_context();
                         if (primaryContext == nullptr) return;
 
-                        primaryContext->matchmaking_service().delete_match_ticket(
+                        auto deleteTask = primaryContext->matchmaking_service().delete_match_ticket(
                             xbox::services::xbox_live_app_config::get_app_config_singleton()->scid(),
                             m_hopperName,
                             m_matchTicketResponse.match_ticket_id()
                         );
+
+                        if (has_pending_hoppers())
+                        {
+                            // The session can only hold one ticket, so wait for the delete before submitting the next
+                            m_matchStatus = match_status::submitting_match_ticket;
+                            std::weak_ptr<multiplayer_match_client> thisWeakPtr = shared_from_this();
+                            deleteTask.then([thisWeakPtr](xbox_live_result<void>)
+                            {
+                                std::shared_ptr<multiplayer_match_client> pThis(thisWeakPtr.lock());
+                                if (pThis != nullptr && !pThis->submit_next_hopper())
+                                {
+                                    pThis->m_matchStatus = match_status::failed;
+                                    pThis->handle_find_match_completed(xbox_live_error_code::generic_error, "Matchmaking request failed.");
+                                }
+                            });
+                            return;
+                        }
                     }
 
                     m_matchStatus = match_status::failed;
@@ -275,6 +374,17 @@ multiplayer_match_client::handle_match_status_changed(
         }
         case matchmaking_status::expired:
         {
+            if (m_matchStatus == match_status::submitting_match_ticket)
+            {
+                // The ticket being submitted can't have expired yet; this is the previous hopper's ticket
+                break;
+            }
+
+            if (m_matchStatus == match_status::searching && submit_next_hopper())
+            {
+                break;
+            }
+
             m_matchStatus = match_status::expired;
             handle_find_match_completed(xbox_live_error_code::generic_error, "Matchmaking request expired.");
             break;
@@ -287,6 +397,10 @@ multiplayer_match_client::handle_match_status_changed(
         }
         case matchmaking_status::found:
         {
+            {
+                std::lock_guard<std::mutex> lock(m_lock.get());
+                m_pendingHoppers.clear();
+            }
             handle_match_found(matchSession);
             break;
         }
@@ -368,6 +482,20 @@ multiplayer_match_client::find_match(
     _In_ bool preserveSession
     )
 {
+    return find_match(std::vector<string_t>(1, hopperName), attributes, timeout, session, preserveSession);
+}
+
+xbox_live_result<void>
+multiplayer_match_client::find_match(
+    _In_ const std::vector<string_t>& hopperNames,
+    _In_ const web::json::value& attributes,
+    _In_ const std::chrono::seconds& timeout,
+    _In_ std::shared_ptr<multiplayer_session> session,
+    _In_ bool preserveSession
+    )
+{
+    RETURN_CPP_IF(hopperNames.empty(), void, xbox_live_error_code::invalid_argument, "At least one hopper is required.");
+
     std::shared_ptr<xbox_live_context_impl> primaryContext = m_multiplayerLocalUserManager->get_primary_context();
     if( primaryContext == nullptr || session == nullptr)
     {
@@ -389,22 +517,111 @@ multiplayer_match_client::find_match(
         update_session(nullptr);
     }
 
-    m_hopperName = hopperName;
+    m_hopperName = hopperNames.front();
     m_attributes = attributes;
     m_timeout = timeout;
     m_preservingMatchmakingSession = preserveSession;
     m_matchTicketSessionRef = session->session_reference();
+    {
+        std::lock_guard<std::mutex> lock(m_lock.get());
+        m_pendingHoppers.clear();
+        m_matchDeadline = utility::datetime::utc_now() + utility::datetime::from_seconds(static_cast<int32_t>(timeout.count()));
+    }
+
+    if (hopperNames.size() == 1)
+    {
+        submit_match_ticket(hopperNames.front(), timeout);
+        return xbox_live_result<void>();
+    }
+
+    // Rank the hoppers by how long they currently take to match, querying them all at once
+    std::vector<pplx::task<xbox_live_result<hopper_statistics_response>>> statisticsTasks;
+    for (const auto& hopperName : hopperNames)
+    {
+        statisticsTasks.push_back(primaryContext->matchmaking_service().get_hopper_statistics(
+            session->session_reference().service_configuration_id(),
+            hopperName
+            ));
+    }
+
+    std::weak_ptr<multiplayer_match_client> thisWeakPtr = shared_from_this();
+    pplx::when_all(statisticsTasks.begin(), statisticsTasks.end())
+    .then([thisWeakPtr, hopperNames](pplx::task<std::vector<xbox_live_result<hopper_statistics_response>>> t)
+    {
+        std::shared_ptr<multiplayer_match_client> pThis(thisWeakPtr.lock());
+        if (pThis == nullptr || pThis->m_matchStatus != match_status::submitting_match_ticket) return;
+
+        std::vector<std::pair<string_t, std::chrono::seconds>> rankedHoppers;
+        try
+        {
+            auto statistics = t.get();
+            for (size_t i = 0; i < hopperNames.size(); ++i)
+            {
+                // Hoppers that are empty or failed to report have no estimate
+                const auto& result = statistics[i];
+                bool hasEstimate = !result.err() && result.payload().players_waiting_to_match() > 0;
+                rankedHoppers.push_back(std::make_pair(hopperNames[i], hasEstimate ? result.payload().estimated_wait_time() : std::chrono::seconds::zero()));
+            }
+        }
+        catch (...)
+        {
+            rankedHoppers.clear();
+            for (const auto& hopperName : hopperNames)
+            {
+                rankedHoppers.push_back(std::make_pair(hopperName, std::chrono::seconds::zero()));
+            }
+        }
+
+        std::stable_sort(rankedHoppers.begin(), rankedHoppers.end(), [](const std::pair<string_t, std::chrono::seconds>& left, const std::pair<string_t, std::chrono::seconds>& right)
+        {
+            if (left.second == std::chrono::seconds::zero() || right.second == std::chrono::seconds::zero())
+            {
+                return right.second == std::chrono::seconds::zero() && left.second != std::chrono::seconds::zero();
+            }
+            return left.second < right.second;
+        });
+
+        {
+            std::lock_guard<std::mutex> lock(pThis->m_lock.get());
+            pThis->m_pendingHoppers = std::move(rankedHoppers);
+        }
+
+        if (!pThis->submit_next_hopper())
+        {
+            pThis->m_matchStatus = match_status::failed;
+            pThis->handle_find_match_completed(xbox_live_error_code::generic_error, "Matchmaking request failed.");
+        }
+    });
+
+    return xbox_live_result<void>();
+}
+
+void
+multiplayer_match_client::submit_match_ticket(
+    _In_ const string_t& hopperName,
+    _In_ std::chrono::seconds ticketTimeout
+    )
+{
+    std::shared_ptr<xbox_live_context_impl> primaryContext = m_multiplayerLocalUserManager->get_primary_context();
+    if (primaryContext == nullptr)
+    {
+        m_matchStatus = match_status::failed;
+        handle_find_match_completed(xbox_live_error_code::logic_error, "No local user added. Call add_local_user() first.");
+        return;
+    }
+
+    m_hopperName = hopperName;
 
     std::weak_ptr<multiplayer_match_client> thisWeakPtr = shared_from_this();
     primaryContext->matchmaking_service().create_match_ticket(
-        session->session_reference(),
-        session->session_reference().service_configuration_id(),
+        m_matchTicketSessionRef,
+        m_matchTicketSessionRef.service_configuration_id(),
         hopperName,
-        timeout,
-        preserveSession ? preserve_session_mode::always : preserve_session_mode::never,
-        attributes
+        ticketTimeout,
+        m_preservingMatchmakingSession ? preserve_session_mode::always : preserve_session_mode::never,
+        m_attributes
         )
-    .then([thisWeakPtr, timeout](xbox_live_result<create_match_ticket_response> result)
+    .then([thisWeakPtr, ticketTimeout](xbox_live_result<create_match_ticket_response> result)
     {
         std::shared_ptr<multiplayer_match_client> pThis(thisWeakPtr.lock());
         if (pThis != nullptr)
@@ -414,18 +631,59 @@ multiplayer_match_client::find_match(
                 pThis->m_matchTicketResponse = result.payload();
                 pThis->m_matchStatus = match_status::searching;
                 pThis->m_nextTimerToFetchSession = utility::datetime::utc_now() 
-                    + utility::datetime::from_seconds(static_cast<int32_t>(timeout.count()))
+                    + utility::datetime::from_seconds(static_cast<int32_t>(ticketTimeout.count()))
                     + utility::datetime::from_seconds(5);   // some extra delay to be safe
             }
-            else
+            else if (!pThis->submit_next_hopper())
             {
                 pThis->m_matchStatus = match_status::failed;
                 pThis->handle_find_match_completed(result.err(), result.err_message());
             }
         }
     });
+}
 
-    return xbox_live_result<void>();
+bool
+multiplayer_match_client::submit_next_hopper()
+{
+    string_t hopperName;
+    std::chrono::seconds ticketTimeout;
+    {
+        std::lock_guard<std::mutex> lock(m_lock.get());
+        auto remaining = std::chrono::seconds((m_matchDeadline.to_interval() - utility::datetime::utc_now().to_interval()) / utility::datetime::from_seconds(1));
+        if (m_pendingHoppers.empty() || remaining <= std::chrono::seconds::zero())
+        {
+            m_pendingHoppers.clear();
+            return false;
+        }
+
+        hopperName = m_pendingHoppers.front().first;
+        std::chrono::seconds estimatedWaitTime = m_pendingHoppers.front().second;
+        m_pendingHoppers.erase(m_pendingHoppers.begin());
+
+        // A hopper gets a few times its estimated wait before falling back, or an even share of the time left
+        // when it has no estimate; the last one gets whatever is left
+        ticketTimeout = remaining;
+        if (!m_pendingHoppers.empty())
+        {
+            std::chrono::seconds budget = estimatedWaitTime != std::chrono::seconds::zero() ?
+                estimatedWaitTime * 2 :
+                remaining / static_cast<std::chrono::seconds::rep>(m_pendingHoppers.size() + 1);
+            ticketTimeout = std::min<std::chrono::seconds>(remaining, std::max<std::chrono::seconds>(budget, c_minimumHopperTimeout));
+        }
+    }
+
+    LOGS_DEBUG << "Submitting match ticket to hopper " << hopperName << " for " << ticketTimeout.count() << " seconds";
+    m_matchStatus = match_status::submitting_match_ticket;
+    submit_match_ticket(hopperName, ticketTimeout);
+    return true;
+}
+
+bool
+multiplayer_match_client::has_pending_hoppers()
+{
+    std::lock_guard<std::mutex> lock(m_lock.get());
+    return !m_pendingHoppers.empty();
 }
 
 void
@@ -443,6 +701,11 @@ multiplayer_match_client::cancel_match()
         return;
     }
 
+    {
+        std::lock_guard<std::mutex> lock(m_lock.get());
+        m_pendingHoppers.clear();
+    }
+
     if (m_hopperName.empty() || m_matchTicketResponse.match_ticket_id().empty())
     {
         // Since we aren't the host who started the match, we cannot cancel it either.
@@ -650,6 +913,30 @@ void
 multiplayer_match_client::set_quality_of_service_measurements(
     _In_ std::shared_ptr<std::vector<multiplayer_quality_of_service_measurements>> measurements
     )
+{
+    upload_qos_measurements(measurements, web::json::value::null());
+}
+
+void
+multiplayer_match_client::set_automatic_qos_measurements(
+    _In_ bool enabled,
+    _In_ uint32_t probeCount,
+    _In_ std::chrono::milliseconds probeTimeout,
+    _In_ std::function<string_t(const string_t&)> resolveEndpoint
+    )
+{
+    std::lock_guard<std::mutex> lock(m_lock.get());
+    m_automaticQos = enabled;
+    m_qosProbeCount = probeCount;
+    m_qosProbeTimeout = probeTimeout;
+    m_qosResolveEndpoint = std::move(resolveEndpoint);
+}
+
+void
+multiplayer_match_client::upload_qos_measurements(
+    _In_ std::shared_ptr<std::vector<multiplayer_quality_of_service_measurements>> measurements,
+    _In_ web::json::value serverMeasurementsJson
+    )
 {
     std::shared_ptr<xbox_live_context_impl> primaryContext = m_multiplayerLocalUserManager->get_primary_context();
     auto matchSession = session();
@@ -657,7 +944,7 @@ multiplayer_match_client::set_quality_of_service_measurements(
 
     auto matchSessionRef = matchSession->session_reference();
     std::weak_ptr<multiplayer_match_client> thisWeakPtr = shared_from_this();
-    auto task = pplx::create_task([thisWeakPtr, matchSessionRef, measurements]()
+    auto task = pplx::create_task([thisWeakPtr, matchSessionRef, measurements, serverMeasurementsJson]()
     {
         std::shared_ptr<multiplayer_match_client> pThis(thisWeakPtr.lock());
         if (pThis == nullptr) return;
@@ -673,7 +960,14 @@ multiplayer_match_client::set_quality_of_service_measurements(
             {
                 auto matchSession = std::make_shared<multiplayer_session>(localUser->xbox_user_id(), matchSessionRef);
                 matchSession->join();
-                matchSession->set_current_user_quality_of_service_measurements(measurements);
+                if (measurements != nullptr)
+                {
+                    matchSession->set_current_user_quality_of_service_measurements(measurements);
+                }
+                if (!serverMeasurementsJson.is_null())
+                {
+                    matchSession->set_current_user_quality_of_service_measurements_json(serverMeasurementsJson);
+                }
                 matchSessionResult = localUser->context()->multiplayer_service().write_session(matchSession, multiplayer_session_write_mode::update_existing).get();
                 if (matchSessionResult.err())
                 {
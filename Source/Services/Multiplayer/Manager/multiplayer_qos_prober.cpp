@@ -0,0 +1,449 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "pch.h"
+#include "multiplayer_manager_internal.h"
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <netdb.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_MULTIPLAYER_MANAGER_CPP_BEGIN
+
+namespace
+{
+#ifdef _WIN32
+typedef SOCKET qos_socket;
+const qos_socket c_invalidSocket = INVALID_SOCKET;
+
+void close_socket(_In_ qos_socket socket) { closesocket(socket); }
+
+bool set_non_blocking(_In_ qos_socket socket)
+{
+    u_long nonBlocking = 1;
+    return ioctlsocket(socket, FIONBIO, &nonBlocking) == 0;
+}
+
+// Keeps Winsock initialized while sockets are in use
+class socket_library_scope
+{
+public:
+    socket_library_scope()
+    {
+        WSADATA data;
+        m_initialized = WSAStartup(MAKEWORD(2, 2), &data) == 0;
+    }
+
+    ~socket_library_scope()
+    {
+        if (m_initialized)
+        {
+            WSACleanup();
+        }
+    }
+
+private:
+    bool m_initialized;
+};
+#else
+typedef int qos_socket;
+const qos_socket c_invalidSocket = -1;
+
+void close_socket(_In_ qos_socket socket) { close(socket); }
+
+bool set_non_blocking(_In_ qos_socket socket)
+{
+    int flags = fcntl(socket, F_GETFL, 0);
+    return flags != -1 && fcntl(socket, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+class socket_library_scope
+{
+};
+#endif
+
+const uint32_t c_probeMagic = 0x584f5153;  // "XQOS"
+const std::chrono::milliseconds c_probeInterval(20);
+
+struct probe_header
+{
+    uint32_t magic;
+    uint32_t nonce;
+    uint32_t endpointIndex;
+    uint32_t probeIndex;
+};
+static_assert(sizeof(probe_header) == multiplayer_qos_prober::c_probeSize, "probe_header must match the probe size");
+
+// Splits "host:port" or "[ipv6]:port" and resolves it to a datagram address
+bool resolve_endpoint(
+    _In_ const string_t& endpoint,
+    _In_ bool passive,
+    _Out_ sockaddr_storage& address,
+    _Out_ socklen_t& addressLength
+    )
+{
+    std::string endpointUtf8 = utility::conversions::to_utf8string(endpoint);
+    size_t separator = endpointUtf8.rfind(':');
+    if (separator == std::string::npos || separator + 1 == endpointUtf8.size())
+    {
+        return false;
+    }
+
+    std::string host = endpointUtf8.substr(0, separator);
+    std::string port = endpointUtf8.substr(separator + 1);
+    if (host.size() >= 2 && host.front() == '[' && host.back() == ']')
+    {
+        host = host.substr(1, host.size() - 2);
+    }
+
+    addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_DGRAM;
+    hints.ai_protocol = IPPROTO_UDP;
+    hints.ai_flags = passive ? AI_PASSIVE : 0;
+
+    addrinfo* results = nullptr;
+    if (getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(), &hints, &results) != 0 || results == nullptr)
+    {
+        return false;
+    }
+
+    memcpy(&address, results->ai_addr, results->ai_addrlen);
+    addressLength = static_cast<socklen_t>(results->ai_addrlen);
+    freeaddrinfo(results);
+    return true;
+}
+
+qos_socket open_socket(_In_ int family)
+{
+    qos_socket socket = ::socket(family, SOCK_DGRAM, IPPROTO_UDP);
+    if (socket != c_invalidSocket && !set_non_blocking(socket))
+    {
+        close_socket(socket);
+        socket = c_invalidSocket;
+    }
+    return socket;
+}
+
+bool is_same_address(
+    _In_ const sockaddr_storage& left,
+    _In_ socklen_t leftLength,
+    _In_ const sockaddr_storage& right,
+    _In_ socklen_t rightLength
+    )
+{
+    return leftLength == rightLength && memcmp(&left, &right, leftLength) == 0;
+}
+
+// Waits up to timeout for either socket to become readable
+bool wait_for_readable(
+    _In_ const qos_socket (&sockets)[2],
+    _In_ std::chrono::milliseconds timeout
+    )
+{
+    fd_set readSet;
+    FD_ZERO(&readSet);
+    qos_socket highest = 0;
+    for (qos_socket socket : sockets)
+    {
+        if (socket != c_invalidSocket)
+        {
+            FD_SET(socket, &readSet);
+            highest = std::max<qos_socket>(highest, socket);
+        }
+    }
+
+    timeval waitTime;
+    waitTime.tv_sec = static_cast<long>(timeout.count() / 1000);
+    waitTime.tv_usec = static_cast<long>((timeout.count() % 1000) * 1000);
+    return select(static_cast<int>(highest + 1), &readSet, nullptr, nullptr, &waitTime) > 0;
+}
+
+uint32_t next_nonce()
+{
+    static std::atomic<uint32_t> s_nonce(static_cast<uint32_t>(std::chrono::steady_clock::now().time_since_epoch().count()));
+    return ++s_nonce;
+}
+}
+
+multiplayer_qos_prober::multiplayer_qos_prober(
+    _In_ uint32_t probeCount,
+    _In_ std::chrono::milliseconds probeTimeout
+    ) :
+    m_probeCount(std::max<uint32_t>(probeCount, 1)),
+    m_probeTimeout(probeTimeout)
+{
+}
+
+std::vector<multiplayer_qos_probe_result>
+multiplayer_qos_prober::measure(
+    _In_ const std::vector<string_t>& endpoints
+    ) const
+{
+    typedef std::chrono::steady_clock clock;
+
+    multiplayer_qos_probe_result unreachable = { 0, std::chrono::milliseconds::zero() };
+    std::vector<multiplayer_qos_probe_result> results(endpoints.size(), unreachable);
+
+    socket_library_scope socketLibrary;
+    qos_socket sockets[2] = { c_invalidSocket, c_invalidSocket };  // IPv4 and IPv6
+
+    struct endpoint_state
+    {
+        bool resolved;
+        sockaddr_storage address;
+        socklen_t addressLength;
+        qos_socket socket;
+        std::vector<clock::time_point> sentTimes;
+        std::vector<std::chrono::milliseconds> roundTrips;
+    };
+
+    std::vector<endpoint_state> states(endpoints.size());
+    for (size_t i = 0; i < endpoints.size(); ++i)
+    {
+        auto& state = states[i];
+        state.resolved = resolve_endpoint(endpoints[i], false, state.address, state.addressLength);
+        if (!state.resolved)
+        {
+            LOGS_DEBUG << "Unable to resolve qos endpoint " << endpoints[i];
+            continue;
+        }
+
+        qos_socket& socket = state.address.ss_family == AF_INET6 ? sockets[1] : sockets[0];
+        if (socket == c_invalidSocket)
+        {
+            socket = open_socket(state.address.ss_family);
+        }
+        state.resolved = socket != c_invalidSocket;
+        state.socket = socket;
+        state.sentTimes.resize(m_probeCount);
+    }
+
+    uint32_t nonce = next_nonce();
+    auto receive_replies = [&]()
+    {
+        for (qos_socket socket : sockets)
+        {
+            if (socket == c_invalidSocket)
+            {
+                continue;
+            }
+
+            while (true)
+            {
+                probe_header reply;
+                sockaddr_storage from;
+                socklen_t fromLength = sizeof(from);
+                int received = static_cast<int>(recvfrom(socket, reinterpret_cast<char*>(&reply), sizeof(reply), 0, reinterpret_cast<sockaddr*>(&from), &fromLength));
+                if (received < 0)
+                {
+                    // Would block, or an ICMP error left by an unreachable endpoint
+                    break;
+                }
+
+                auto now = clock::now();
+                uint32_t endpointIndex = ntohl(reply.endpointIndex);
+                uint32_t probeIndex = ntohl(reply.probeIndex);
+                if (received != sizeof(reply) ||
+                    ntohl(reply.magic) != c_probeMagic ||
+                    ntohl(reply.nonce) != nonce ||
+                    endpointIndex >= states.size() ||
+                    probeIndex >= m_probeCount)
+                {
+                    continue;
+                }
+
+                auto& state = states[endpointIndex];
+                auto& sentTime = state.sentTimes[probeIndex];
+                if (!state.resolved || sentTime == clock::time_point() ||
+                    !is_same_address(state.address, state.addressLength, from, fromLength))
+                {
+                    continue;
+                }
+
+                auto roundTrip = std::chrono::duration_cast<std::chrono::milliseconds>(now - sentTime);
+                if (roundTrip <= m_probeTimeout)
+                {
+                    state.roundTrips.push_back(roundTrip);
+                }
+                sentTime = clock::time_point();  // Ignore duplicates
+            }
+        }
+    };
+
+    auto all_answered = [&]()
+    {
+        for (const auto& state : states)
+        {
+            if (state.resolved && state.roundTrips.size() < m_probeCount)
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    clock::time_point lastSend = clock::now();
+    for (uint32_t probeIndex = 0; probeIndex < m_probeCount; ++probeIndex)
+    {
+        for (size_t i = 0; i < states.size(); ++i)
+        {
+            auto& state = states[i];
+            if (!state.resolved)
+            {
+                continue;
+            }
+
+            probe_header probe = { htonl(c_probeMagic), htonl(nonce), htonl(static_cast<uint32_t>(i)), htonl(probeIndex) };
+            state.sentTimes[probeIndex] = clock::now();
+            sendto(state.socket, reinterpret_cast<const char*>(&probe), sizeof(probe), 0, reinterpret_cast<const sockaddr*>(&state.address), state.addressLength);
+        }
+        lastSend = clock::now();
+
+        auto roundEnd = lastSend + c_probeInterval;
+        for (auto now = clock::now(); now < roundEnd; now = clock::now())
+        {
+            if (wait_for_readable(sockets, std::chrono::duration_cast<std::chrono::milliseconds>(roundEnd - now)))
+            {
+                receive_replies();
+            }
+        }
+    }
+
+    auto deadline = lastSend + m_probeTimeout;
+    for (auto now = clock::now(); now < deadline && !all_answered(); now = clock::now())
+    {
+        if (wait_for_readable(sockets, std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now)))
+        {
+            receive_replies();
+        }
+    }
+
+    for (qos_socket socket : sockets)
+    {
+        if (socket != c_invalidSocket)
+        {
+            close_socket(socket);
+        }
+    }
+
+    for (size_t i = 0; i < states.size(); ++i)
+    {
+        auto& roundTrips = states[i].roundTrips;
+        if (!roundTrips.empty())
+        {
+            std::sort(roundTrips.begin(), roundTrips.end());
+            results[i].probesReceived = static_cast<uint32_t>(roundTrips.size());
+            results[i].latency = roundTrips[roundTrips.size() / 2];
+        }
+    }
+
+    return results;
+}
+
+multiplayer_qos_responder::multiplayer_qos_responder() :
+    m_stopping(false),
+    m_socket(static_cast<uintptr_t>(c_invalidSocket)),
+    m_port(0)
+{
+}
+
+multiplayer_qos_responder::~multiplayer_qos_responder()
+{
+    stop();
+}
+
+std::error_code
+multiplayer_qos_responder::start(
+    _In_ const string_t& host,
+    _In_ uint16_t port
+    )
+{
+    if (m_thread.joinable())
+    {
+        return xbox_live_error_code::logic_error;
+    }
+
+    sockaddr_storage address;
+    socklen_t addressLength;
+    if (!resolve_endpoint(host + _T(":") + utils::uint32_to_string_t(port), true, address, addressLength))
+    {
+        return xbox_live_error_code::invalid_argument;
+    }
+
+    auto libraryScope = std::make_shared<socket_library_scope>();
+    qos_socket socket = open_socket(address.ss_family);
+    if (socket == c_invalidSocket)
+    {
+        return xbox_live_error_code::runtime_error;
+    }
+
+    sockaddr_storage boundAddress;
+    socklen_t boundLength = sizeof(boundAddress);
+    if (bind(socket, reinterpret_cast<const sockaddr*>(&address), addressLength) != 0 ||
+        getsockname(socket, reinterpret_cast<sockaddr*>(&boundAddress), &boundLength) != 0)
+    {
+        close_socket(socket);
+        return xbox_live_error_code::runtime_error;
+    }
+
+    m_port = ntohs(boundAddress.ss_family == AF_INET6 ?
+        reinterpret_cast<const sockaddr_in6*>(&boundAddress)->sin6_port :
+        reinterpret_cast<const sockaddr_in*>(&boundAddress)->sin_port);
+    m_socket = static_cast<uintptr_t>(socket);
+    m_stopping = false;
+
+    m_thread = std::thread([this, socket, libraryScope]()
+    {
+        const qos_socket sockets[2] = { socket, c_invalidSocket };
+        while (!m_stopping)
+        {
+            if (!wait_for_readable(sockets, std::chrono::milliseconds(50)))
+            {
+                continue;
+            }
+
+            probe_header probe;
+            sockaddr_storage from;
+            socklen_t fromLength = sizeof(from);
+            int received = static_cast<int>(recvfrom(socket, reinterpret_cast<char*>(&probe), sizeof(probe), 0, reinterpret_cast<sockaddr*>(&from), &fromLength));
+            if (received == sizeof(probe) && ntohl(probe.magic) == c_probeMagic)
+            {
+                sendto(socket, reinterpret_cast<const char*>(&probe), sizeof(probe), 0, reinterpret_cast<const sockaddr*>(&from), fromLength);
+            }
+        }
+    });
+
+    return xbox_live_error_code::no_error;
+}
+
+uint16_t
+multiplayer_qos_responder::port() const
+{
+    return m_port;
+}
+
+void
+multiplayer_qos_responder::stop()
+{
+    if (!m_thread.joinable())
+    {
+        return;
+    }
+
+    m_stopping = true;
+    m_thread.join();
+    close_socket(static_cast<qos_socket>(m_socket));
+    m_socket = static_cast<uintptr_t>(c_invalidSocket);
+}
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_MULTIPLAYER_MANAGER_CPP_END
@@ -26,7 +26,10 @@ multiplayer_session_writer::multiplayer_session_writer() :
     m_tapChangeNumber(0),
     m_sessionUpdateEventHandlerCounter(0),
     m_handleResyncEventCounter(0),
-    m_isTaskInProgress(false)
+    m_isTaskInProgress(false),
+    m_isTapReadInProgress(false),
+    m_tapReadChangeNumber(0),
+    m_pendingTapReadChangeNumber(0)
 {
 }
 
@@ -39,7 +42,10 @@ multiplayer_session_writer::multiplayer_session_writer(
     m_tapChangeNumber(0),
     m_sessionUpdateEventHandlerCounter(0),
     m_handleResyncEventCounter(0),
-    m_isTaskInProgress(false)
+    m_isTaskInProgress(false),
+    m_isTapReadInProgress(false),
+    m_tapReadChangeNumber(0),
+    m_pendingTapReadChangeNumber(0)
 {
 }
 
@@ -50,6 +56,7 @@ multiplayer_session_writer::destroy()
     m_isTapReceived = false;
     m_numOfWritesInProgress = 0;
     m_tapChangeNumber = 0;
+    m_pendingTapReadChangeNumber = 0;
 }
 
 std::shared_ptr<xbox_live_context_impl>
@@ -228,6 +235,49 @@ multiplayer_session_writer::commit_pending_synchronized_changes(
     return utils::create_exception_free_task<std::vector<multiplayer_event>>(task);
 }
 
+pplx::task<xbox_live_result<std::vector<multiplayer_event>>>
+multiplayer_session_writer::commit_pending_synchronized_changes_after(
+    _In_ pplx::task<xbox_live_result<std::vector<multiplayer_event>>> precedingCommit,
+    _In_ std::vector<std::shared_ptr<multiplayer_client_pending_request>> synchronizedQueue,
+    _In_ multiplayer_session_type sessionType
+    )
+{
+    std::weak_ptr<multiplayer_session_writer> thisWeakPtr = shared_from_this();
+    auto task = precedingCommit
+    .then([thisWeakPtr, synchronizedQueue, sessionType](xbox_live_result<std::vector<multiplayer_event>> precedingResult)
+    {
+        std::shared_ptr<multiplayer_session_writer> pThis(thisWeakPtr.lock());
+        if (pThis == nullptr)
+        {
+            return pplx::task_from_result(xbox_live_result<std::vector<multiplayer_event>>(
+                precedingResult.payload(),
+                xbox_live_error_code::generic_error,
+                "multiplayer_session_writer class was destroyed."
+                ));
+        }
+
+        // Issued only after the preceding write so it carries the latest ETag rather than racing it into a 412.
+        // Chained rather than waited on, so no thread pool thread blocks on the second write.
+        return pThis->commit_pending_synchronized_changes(synchronizedQueue, sessionType)
+        .then([precedingResult](xbox_live_result<std::vector<multiplayer_event>> synchronizedResult)
+        {
+            auto eventQueue = precedingResult.payload();
+            for (const auto& ev : synchronizedResult.payload())
+            {
+                eventQueue.push_back(ev);
+            }
+
+            if (precedingResult.err())
+            {
+                return xbox_live_result<std::vector<multiplayer_event>>(eventQueue, precedingResult.err(), precedingResult.err_message());
+            }
+            return xbox_live_result<std::vector<multiplayer_event>>(eventQueue, synchronizedResult.err(), synchronizedResult.err_message());
+        });
+    });
+
+    return utils::create_exception_free_task<std::vector<multiplayer_event>>(task);
+}
+
 pplx::task<xbox_live_result<std::vector<multiplayer_event>>>
 multiplayer_session_writer::commit_pending_changes(
     _In_ std::vector<std::shared_ptr<multiplayer_client_pending_request>> processingQueue,
@@ -241,6 +291,9 @@ multiplayer_session_writer::commit_pending_changes(
         return pplx::task_from_result(xbox_live_result<std::vector<multiplayer_event>>(eventQueue, xbox_live_error_code::generic_error, "Session no longer exists."));
     }
 
+    // Synchronized requests coalesced into the same batch are written by commit_pending_synchronized_changes_after.
+    processingQueue = multiplayer_manager_utils::filter_pending_requests(processingQueue, pending_request_type::non_synchronized_changes);
+
     std::shared_ptr<multiplayer_session> sessionToCommit = m_session->_Create_deep_copy();
 
     // Update any pending local user or lobby session properties.
@@ -365,11 +418,70 @@ multiplayer_session_writer::on_session_changed(
         auto latestSession = session();
         if(latestSession != nullptr && argsChangeNumber > latestSession->change_number())
         {
-            get_current_session_helper(m_multiplayerLocalUserManager->get_primary_context(), latestSession->session_reference());
+            if (!m_isTapReadInProgress)
+            {
+                read_session_for_tap(latestSession->session_reference(), argsChangeNumber);
+            }
+            else if (argsChangeNumber > m_tapReadChangeNumber)
+            {
+                // The in-flight read may have been answered before this change was made.
+                m_pendingTapReadChangeNumber = std::max<uint64_t>(m_pendingTapReadChangeNumber, argsChangeNumber);
+            }
         }
     }
 }
 
+void
+multiplayer_session_writer::read_session_for_tap(
+    _In_ const multiplayer_session_reference& sessionReference,
+    _In_ uint64_t tapChangeNumber
+    )
+{
+    m_isTapReadInProgress = true;
+    m_tapReadChangeNumber = tapChangeNumber;
+    m_pendingTapReadChangeNumber = 0;
+
+    auto task = get_current_session_helper(m_multiplayerLocalUserManager->get_primary_context(), sessionReference);
+
+    std::weak_ptr<multiplayer_session_writer> thisWeakPtr = shared_from_this();
+    utils::create_exception_free_task<std::shared_ptr<multiplayer_session>>(task)
+    .then([thisWeakPtr](xbox_live_result<std::shared_ptr<multiplayer_session>> sessionResult)
+    {
+        UNREFERENCED_PARAMETER(sessionResult);
+        std::shared_ptr<multiplayer_session_writer> pThis(thisWeakPtr.lock());
+        if (pThis == nullptr)
+        {
+            return;
+        }
+
+        std::lock_guard<std::mutex> guard(pThis->m_synchronizeWriteWithTapLock);
+        pThis->m_isTapReadInProgress = false;
+
+        uint64_t pendingChangeNumber = pThis->m_pendingTapReadChangeNumber;
+        pThis->m_pendingTapReadChangeNumber = 0;
+
+        auto latestSession = pThis->session();
+        if (pendingChangeNumber == 0 || latestSession == nullptr || latestSession->change_number() >= pendingChangeNumber)
+        {
+            return;
+        }
+
+        if (pThis->is_write_in_progress())
+        {
+            // The write picks up the latest session when it completes.
+            if (pendingChangeNumber > pThis->tap_change_number())
+            {
+                pThis->set_tap_received(true);
+                pThis->set_tap_change_number(pendingChangeNumber);
+            }
+        }
+        else
+        {
+            pThis->read_session_for_tap(latestSession->session_reference(), pendingChangeNumber);
+        }
+    });
+}
+
 pplx::task<xbox_live_result<std::shared_ptr<multiplayer_session>>>
 multiplayer_session_writer::get_current_session_helper(
     _In_ std::shared_ptr<xbox::services::xbox_live_context_impl> xboxLiveContext,
@@ -8,9 +8,11 @@
 NAMESPACE_MICROSOFT_XBOX_SERVICES_MULTIPLAYER_MANAGER_CPP_BEGIN
 
 session_property_changed_event_args::session_property_changed_event_args(
-    _In_ web::json::value jsonProperties
+    _In_ web::json::value jsonProperties,
+    _In_ std::vector<string_t> changedProperties
     ):
-    m_properties(std::move(jsonProperties))
+    m_properties(std::move(jsonProperties)),
+    m_changedProperties(std::move(changedProperties))
 {
 }
 
@@ -20,4 +22,10 @@ session_property_changed_event_args::properties()
     return m_properties;
 }
 
+const std::vector<string_t>&
+session_property_changed_event_args::changed_properties() const
+{
+    return m_changedProperties;
+}
+
 NAMESPACE_MICROSOFT_XBOX_SERVICES_MULTIPLAYER_MANAGER_CPP_END
\ No newline at end of file
@@ -28,11 +28,7 @@ MultiplayerSession::MultiplayerSession(
 
     m_sessionReference = ref new MultiplayerSessionReference(m_cppObj->session_reference());
     m_sessionProperties = ref new MultiplayerSessionProperties(m_cppObj->session_properties());
-    m_sessionRoleTypes = ref new MultiplayerSessionRoleTypes(m_cppObj->session_role_types());
     m_sessionConstants = ref new MultiplayerSessionConstants(m_cppObj->session_constants());
-    m_matchmakingServer = ref new MultiplayerSessionMatchmakingServer(m_cppObj->matchmaking_server());
-    m_tournamentsServer = ref new MultiplayerSessionTournamentsServer(m_cppObj->tournaments_server());
-    m_arbitrationServer = ref new MultiplayerSessionArbitrationServer(m_cppObj->arbitration_server());
 }
 
 MultiplayerSession::MultiplayerSession(
@@ -180,18 +176,30 @@ MultiplayerSession::Members::get()
 MultiplayerSessionMatchmakingServer^
 MultiplayerSession::MatchmakingServer::get()
 {
+    if (m_matchmakingServer == nullptr)
+    {
+        m_matchmakingServer = ref new MultiplayerSessionMatchmakingServer(m_cppObj->matchmaking_server());
+    }
     return m_matchmakingServer;
 }
 
 MultiplayerSessionTournamentsServer^
 MultiplayerSession::TournamentsServer::get()
 {
+    if (m_tournamentsServer == nullptr)
+    {
+        m_tournamentsServer = ref new MultiplayerSessionTournamentsServer(m_cppObj->tournaments_server());
+    }
     return m_tournamentsServer;
 }
 
 MultiplayerSessionArbitrationServer^
 MultiplayerSession::ArbitrationServer::get()
 {
+    if (m_arbitrationServer == nullptr)
+    {
+        m_arbitrationServer = ref new MultiplayerSessionArbitrationServer(m_cppObj->arbitration_server());
+    }
     return m_arbitrationServer;
 }
 
@@ -0,0 +1,63 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "pch.h"
+#include "utils.h"
+#include "xsapi/multiplayer.h"
+#include "multiplayer_internal.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_MULTIPLAYER_CPP_BEGIN
+
+multiplayer_activity_details_result::multiplayer_activity_details_result()
+{
+}
+
+multiplayer_activity_details_result::multiplayer_activity_details_result(
+    _In_ std::vector<multiplayer_activity_details> items,
+    _In_ std::shared_ptr<multiplayer_query_pager<multiplayer_activity_details>> nextPage
+    ) :
+    m_items(std::move(items)),
+    m_nextPage(std::move(nextPage))
+{
+}
+
+const std::vector<multiplayer_activity_details>&
+multiplayer_activity_details_result::items() const
+{
+    return m_items;
+}
+
+bool
+multiplayer_activity_details_result::has_next() const
+{
+    return m_nextPage != nullptr;
+}
+
+pplx::task<xbox_live_result<multiplayer_activity_details_result>>
+multiplayer_activity_details_result::get_next()
+{
+    if (m_nextPage == nullptr)
+    {
+        xbox_live_result<multiplayer_activity_details_result> results(xbox_live_error_code::out_of_range, "multiplayer_activity_details_result doesn't have next page");
+        return pplx::task_from_result<xbox_live_result<multiplayer_activity_details_result>>(results);
+    }
+
+    auto task = m_nextPage->page()
+    .then([](xbox_live_result<multiplayer_query_pager<multiplayer_activity_details>::page_contents> result)
+    {
+        if (result.err())
+        {
+            return xbox_live_result<multiplayer_activity_details_result>(result.err(), result.err_message());
+        }
+
+        return xbox_live_result<multiplayer_activity_details_result>(
+            multiplayer_activity_details_result(std::move(result.payload().first), std::move(result.payload().second))
+            );
+    });
+
+    return utils::create_exception_free_task<multiplayer_activity_details_result>(
+        task
+        );
+}
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_MULTIPLAYER_CPP_END
@@ -4,6 +4,7 @@
 #pragma once
 #include "system_internal.h"
 #include "xsapi/multiplayer.h"
+#include "json_writer.h"
 namespace xbox { namespace services { namespace tournaments {
     class tournament_team_result;
 }}}
@@ -118,6 +119,17 @@ private:
     string_t m_socialGroup;
 };
 
+/// <summary>
+/// Serialized JSON for part of a member request and the value it was built from.  Empty until the request
+/// is serialized; the setter for the value clears it when given a different value.
+/// </summary>
+template<typename T>
+struct multiplayer_member_request_fragment
+{
+    T source;
+    xsapi_internal_string json;
+};
+
 class multiplayer_session_member_request
 {
 public:
@@ -203,9 +215,20 @@ public:
     void set_result(_In_ const string_t& team, _In_ const xbox::services::tournaments::tournament_team_result& result);
     void set_results(_In_ const std::unordered_map<string_t, xbox::services::tournaments::tournament_team_result>& results);
 
-    web::json::value serialize();
+    /// <summary>
+    /// False when serialize() would write an empty object, in which case the member is left out of the session write.
+    /// </summary>
+    bool has_content() const;
+    void serialize(_Inout_ json_writer& writer) const;
+
+    /// <summary>
+    /// Takes the roles, secure device address and subscription fragments of an earlier request for the same
+    /// member.  They are kept as long as the setters are given the values they were built from.
+    /// </summary>
+    void copy_fragments_from(_In_ const multiplayer_session_member_request& other);
 private:
     static std::vector<string_t> get_vector_view_for_change_types(_In_ multiplayer_session_change_types changeTypes);
+    bool has_system_properties() const;
 
     bool m_writeRequest;
     bool m_writeConstants;
@@ -234,6 +257,12 @@ private:
     string_t m_subscriptionId;
     string_t m_rtaConnectionId;
     std::unordered_map<string_t, xbox::services::tournaments::tournament_team_result> m_results;
+
+    // Built by serialize(); constants can't change once the request exists, so that one needs no source
+    mutable xsapi_internal_string m_customConstantsFragment;
+    mutable multiplayer_member_request_fragment<std::unordered_map<string_t, string_t>> m_rolesFragment;
+    mutable multiplayer_member_request_fragment<string_t> m_secureDeviceAddressFragment;
+    mutable multiplayer_member_request_fragment<std::pair<multiplayer_session_change_types, string_t>> m_subscriptionFragment;
 };
 
 /// <summary>
@@ -346,12 +375,13 @@ public:
 
     void set_mutable_role_settings(_In_ const std::unordered_map<string_t, multiplayer_role_type>& roleTypes);
 
-    web::json::value create_properties_json();
-    web::json::value create_matchmaking_json();
-    web::json::value create_role_types_json();
-    web::json::value serialize();
+    void serialize(_Inout_ json_writer& writer);
 
 private:
+    bool has_system_properties() const;
+    void write_properties(_Inout_ json_writer& writer);
+    void write_matchmaking(_Inout_ json_writer& writer);
+    void write_role_types(_Inout_ json_writer& writer);
     void deep_copy_from(
         _In_ const multiplayer_session_request& other
         );
@@ -391,6 +421,35 @@ private:
     bool m_allocateCloudCompute;
 };
 
+/// <summary>
+/// Parts of a session document that most readers never look at.  Each keeps its JSON and is decoded on first access.
+/// Decoded values do not change afterwards, so deep copies of a session share one instance.
+/// </summary>
+class multiplayer_session_lazy_fields
+{
+public:
+    multiplayer_session_lazy_fields();
+
+    multiplayer_session_lazy_fields(
+        _In_ web::json::value roleTypesJson,
+        _In_ web::json::value matchmakingServerJson,
+        _In_ web::json::value arbitrationServerJson
+        );
+
+    std::shared_ptr<multiplayer_session_role_types> role_types();
+    const multiplayer_session_matchmaking_server& matchmaking_server();
+    const multiplayer_session_arbitration_server& arbitration_server();
+
+private:
+    xbox::services::system::xbox_live_mutex m_lock;
+    web::json::value m_roleTypesJson;
+    web::json::value m_matchmakingServerJson;
+    web::json::value m_arbitrationServerJson;
+    std::shared_ptr<multiplayer_session_role_types> m_roleTypes;
+    std::shared_ptr<multiplayer_session_matchmaking_server> m_matchmakingServer;
+    std::shared_ptr<multiplayer_session_arbitration_server> m_arbitrationServer;
+};
+
 class multiplayer_invite
 {
 public:
@@ -440,6 +499,155 @@ private:
     uint32_t m_version;
 };
 
+/// <summary>
+/// One page of a multiplayer query whose xbox user id list is split across several requests.
+/// The request is sent the first time the page is asked for.  When it is handed to the caller the
+/// following page is requested, so it downloads while the caller processes this one; nothing further
+/// is sent until that page is asked for in turn.  Paging stops once maxItems results have been
+/// returned, or never if maxItems is 0.
+/// </summary>
+template<typename T>
+class multiplayer_query_pager
+{
+public:
+    typedef std::function<pplx::task<xbox_live_result<std::vector<T>>>(const std::vector<string_t>& xboxUserIds)> page_request;
+    typedef std::pair<std::vector<T>, std::shared_ptr<multiplayer_query_pager<T>>> page_contents;
+
+    multiplayer_query_pager(
+        _In_ page_request request,
+        _In_ std::shared_ptr<const std::vector<std::vector<string_t>>> pages,
+        _In_ size_t pageIndex,
+        _In_ uint32_t maxItems,
+        _In_ uint32_t itemsReturned
+        ) :
+        m_request(std::move(request)),
+        m_pages(std::move(pages)),
+        m_pageIndex(pageIndex),
+        m_maxItems(maxItems),
+        m_itemsReturned(itemsReturned),
+        m_started(false)
+    {
+    }
+
+    pplx::task<xbox_live_result<page_contents>> page()
+    {
+        return start()
+        .then([](xbox_live_result<page_contents> result)
+        {
+            if (!result.err() && result.payload().second != nullptr)
+            {
+                result.payload().second->start();
+            }
+            return result;
+        });
+    }
+
+private:
+    const pplx::task<xbox_live_result<page_contents>>& start()
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        if (m_started)
+        {
+            return m_page;
+        }
+        m_started = true;
+
+        auto request = m_request;
+        auto pages = m_pages;
+        size_t pageIndex = m_pageIndex;
+        uint32_t maxItems = m_maxItems;
+        uint32_t itemsReturned = m_itemsReturned;
+        m_page = request((*pages)[pageIndex])
+        .then([request, pages, pageIndex, maxItems, itemsReturned](xbox_live_result<std::vector<T>> result)
+        {
+            if (result.err())
+            {
+                return xbox_live_result<page_contents>(result.err(), result.err_message());
+            }
+
+            std::vector<T> items = std::move(result.payload());
+            if (maxItems != 0 && itemsReturned + items.size() > maxItems)
+            {
+                items.erase(items.begin() + (maxItems - itemsReturned), items.end());
+            }
+
+            uint32_t totalItems = itemsReturned + static_cast<uint32_t>(items.size());
+            std::shared_ptr<multiplayer_query_pager<T>> nextPage;
+            if (pageIndex + 1 < pages->size() && (maxItems == 0 || totalItems < maxItems))
+            {
+                nextPage = std::make_shared<multiplayer_query_pager<T>>(request, pages, pageIndex + 1, maxItems, totalItems);
+            }
+
+            return xbox_live_result<page_contents>(page_contents(std::move(items), nextPage));
+        });
+        return m_page;
+    }
+
+    page_request m_request;
+    std::shared_ptr<const std::vector<std::vector<string_t>>> m_pages;
+    size_t m_pageIndex;
+    uint32_t m_maxItems;
+    uint32_t m_itemsReturned;
+    std::mutex m_lock;
+    bool m_started;
+    pplx::task<xbox_live_result<page_contents>> m_page;
+};
+
+/// <summary>
+/// The last copy of each session read or written through a multiplayer_service, so that later reads
+/// can be made conditional on its ETag.  Cached sessions are never handed out directly; callers get a deep copy.
+/// Entries are dropped when RTA reports a newer change number, and the least recently used entry is evicted when full.
+/// </summary>
+class multiplayer_session_cache
+{
+public:
+    multiplayer_session_cache();
+
+    /// <summary>
+    /// Returns the cached session for the reference, or nullptr.  The returned session must not be modified.
+    /// </summary>
+    std::shared_ptr<multiplayer_session> session(_In_ const multiplayer_session_reference& sessionReference);
+
+    /// <summary>
+    /// Returns the cached session the handle was last resolved to, or nullptr.  The returned session must not be modified.
+    /// </summary>
+    std::shared_ptr<multiplayer_session> session_by_handle(_In_ const string_t& handleId);
+
+    /// <summary>
+    /// Caches a copy of the session under its own session reference, optionally recording the handle it was read through.
+    /// </summary>
+    void update(
+        _In_ const std::shared_ptr<multiplayer_session>& session,
+        _In_ const string_t& handleId = string_t()
+        );
+
+    /// <summary>
+    /// Drops the cached session if it is older than changeNumber.
+    /// </summary>
+    void invalidate(
+        _In_ const multiplayer_session_reference& sessionReference,
+        _In_ uint64_t changeNumber
+        );
+
+    void remove(_In_ const multiplayer_session_reference& sessionReference);
+
+    static const size_t c_maxCachedSessions;
+
+private:
+    struct cache_entry
+    {
+        std::shared_ptr<multiplayer_session> session;
+        uint64_t lastUsed;
+    };
+
+    static string_t cache_key(_In_ const multiplayer_session_reference& sessionReference);
+
+    std::unordered_map<string_t, cache_entry> m_sessions;
+    std::unordered_map<string_t, string_t> m_handles;
+    uint64_t m_useCounter;
+    xbox::services::system::xbox_live_mutex m_lock;
+};
+
 class multiplayer_service_impl : public std::enable_shared_from_this<multiplayer_service_impl>
 {
 public:
@@ -465,6 +673,8 @@ public:
     function_context add_multiplayer_subscription_lost_handler(_In_ std::function<void()> handler);
 
     void remove_multiplayer_subscription_lost_handler(_In_ function_context context);
+
+    multiplayer_session_cache& session_cache();
     
     ~multiplayer_service_impl();
 
@@ -481,6 +691,7 @@ private:
     xbox::services::system::xbox_live_mutex m_subscriptionEnabledLock;
     xbox::services::system::xbox_live_mutex m_subscriptionLock;
     function_context m_multiplayerJoinabilityChangeCounter;
+    multiplayer_session_cache m_sessionCache;
 };
 
 }}}
\ No newline at end of file
@@ -19,6 +19,41 @@ const uint32_t c_multiplayerHandleVersionValue = 1;
 const string_t c_getActivitiesSubpath = _T("/handles/query?include=relatedInfo,customProperties");
 const string_t c_getSearchHandlesSubpath = _T("/handles/query?include=relatedInfo,roleInfo,customProperties");
 const string_t c_multiplayerServiceContractHeaderValue = _T("107");
+const uint32_t c_defaultXboxUserIdsPerPage = 100;
+
+// The cached session is shared, so each read that was answered with a 304 gets its own copy
+static xbox_live_result<std::shared_ptr<multiplayer_session>>
+copy_not_modified_session(
+    _In_ const std::shared_ptr<multiplayer_session>& cachedSession,
+    _In_ const std::shared_ptr<http_call_response>& response
+    )
+{
+    auto session = cachedSession->_Create_deep_copy();
+    session->_Set_date_of_session(response->response_date());
+    return xbox_live_result<std::shared_ptr<multiplayer_session>>(session);
+}
+
+static std::shared_ptr<const std::vector<std::vector<string_t>>>
+split_xbox_user_ids_into_pages(
+    _In_ const std::vector<string_t>& xboxUserIds,
+    _In_ uint32_t xboxUserIdsPerPage
+    )
+{
+    size_t pageSize = xboxUserIdsPerPage == 0 ? c_defaultXboxUserIdsPerPage : xboxUserIdsPerPage;
+    auto pages = std::make_shared<std::vector<std::vector<string_t>>>();
+    for (size_t i = 0; i < xboxUserIds.size(); i += pageSize)
+    {
+        auto pageEnd = xboxUserIds.begin() + std::min<size_t>(i + pageSize, xboxUserIds.size());
+        pages->push_back(std::vector<string_t>(xboxUserIds.begin() + i, pageEnd));
+    }
+
+    if (pages->empty())
+    {
+        // Queries that do not filter on a list of users are a single page
+        pages->push_back(std::vector<string_t>());
+    }
+    return pages;
+}
 
 multiplayer_service::multiplayer_service()
 {
@@ -84,13 +119,15 @@ multiplayer_service::write_session_using_subpath(
 {
     RETURN_TASK_CPP_INVALIDARGUMENT_IF_STRING_EMPTY(subpathAndQuery, std::shared_ptr<multiplayer_session>, "Subpath and query was empty");
 
-    std::shared_ptr<http_call> httpCall = xbox_system_factory::get_factory()->create_http_call(
+    // Created through the internal overload so the UTF-8 body from json_writer is passed through without conversion
+    std::shared_ptr<http_call_internal> internalHttpCall = xbox_system_factory::get_factory()->create_http_call(
         m_xboxLiveContextSettings,
-        _T("PUT"),
-        utils::create_xboxlive_endpoint(_T("sessiondirectory"), m_appConfig),
+        "PUT",
+        utils::internal_string_from_string_t(utils::create_xboxlive_endpoint(_T("sessiondirectory"), m_appConfig)),
         subpathAndQuery,
         xbox_live_api::write_session_using_subpath
         );
+    std::shared_ptr<http_call> httpCall = internalHttpCall;
 
     httpCall->set_retry_allowed(false);
     httpCall->set_xbox_contract_version_header_value(c_multiplayerServiceContractHeaderValue);
@@ -130,40 +167,48 @@ multiplayer_service::write_session_using_subpath(
         }
     }
 
-    task<xbox_live_result<string_t>> subscriptionTask;
+    auto serializeSession = [session]()
+    {
+        json_writer writer;
+        session->_Session_request()->serialize(writer);
+        return writer.output();
+    };
+
+    task<xbox_live_result<xsapi_internal_string>> subscriptionTask;
     bool subscriptionsEnabled = m_multiplayerServiceImpl->subscriptions_enabled();
     if (subscriptionsEnabled && session->current_user() != nullptr && session->current_user()->_Member_request() != nullptr)
     {
         subscriptionTask = m_multiplayerServiceImpl->ensure_multiplayer_subscription()
-        .then([httpCall, session](xbox_live_result<string_t> connectionId)
+        .then([session, serializeSession](xbox_live_result<string_t> connectionId)
         {
             if (connectionId.err())
             {
-                return xbox_live_result<string_t>(connectionId.err(), connectionId.err_message());
+                return xbox_live_result<xsapi_internal_string>(connectionId.err(), connectionId.err_message());
             }
             session->current_user()->_Set_rta_connection_id(connectionId.payload());
-            return xbox_live_result<string_t>(session->_Session_request()->serialize().serialize(), connectionId.err(), connectionId.err_message());
+            return xbox_live_result<xsapi_internal_string>(serializeSession(), connectionId.err(), connectionId.err_message());
         });
     }
     else
     {
-        subscriptionTask = task_from_result(xbox_live_result<string_t>(session->_Session_request()->serialize().serialize()));
+        subscriptionTask = task_from_result(xbox_live_result<xsapi_internal_string>(serializeSession()));
     }
 
     auto userContext = m_userContext;
+    auto serviceImpl = m_multiplayerServiceImpl;
     multiplayer_session_reference sessionReference = session->session_reference();
-    auto task = subscriptionTask.then([httpCall, userContext](xbox_live_result<string_t> body)
+    auto task = subscriptionTask.then([httpCall, internalHttpCall, userContext](xbox_live_result<xsapi_internal_string> body)
     {
         if (body.err())
         {
             return task_from_result(xbox_live_result<std::shared_ptr<http_call_response>>(body.err(), body.err_message()));
         }
 
-        httpCall->set_request_body(body.payload());
+        internalHttpCall->set_request_body(body.payload());
         auto httpResponse = httpCall->get_response_with_auth(userContext);
         return task_from_result(xbox_live_result<std::shared_ptr<http_call_response>>(httpResponse.get()));
     }) 
-    .then([sessionReference, httpCall, userContext](xbox_live_result<std::shared_ptr<http_call_response>> responseResult)
+    .then([sessionReference, httpCall, userContext, serviceImpl](xbox_live_result<std::shared_ptr<http_call_response>> responseResult)
     {
         auto& response = responseResult.payload();
         if (responseResult.err())
@@ -190,6 +235,10 @@ multiplayer_service::write_session_using_subpath(
 
         if (status == 204)
         {
+            if (!sessionReference.is_null())
+            {
+                serviceImpl->session_cache().remove(sessionReference);
+            }
             return xbox_live_result<std::shared_ptr<multiplayer_session>>(nullptr);
         }
 
@@ -240,6 +289,11 @@ multiplayer_service::write_session_using_subpath(
                 utils::string_t_from_internal_string(userContext->xbox_user_id())
                 );
 
+            if (!multiplayerSession.err())
+            {
+                serviceImpl->session_cache().update(newSession);
+            }
+
             newSession->_Set_write_session_status(
                 response->http_status()
                 );
@@ -278,13 +332,26 @@ multiplayer_service::get_current_session(
 
     httpCall->set_xbox_contract_version_header_value(c_multiplayerServiceContractHeaderValue);
 
+    auto serviceImpl = m_multiplayerServiceImpl;
+    auto cachedSession = serviceImpl->session_cache().session(sessionReference);
+    if (cachedSession != nullptr)
+    {
+        httpCall->set_custom_header(_T("If-None-Match"), cachedSession->e_tag());
+    }
+
     auto userContextShared = m_userContext;
 
     auto task = httpCall->get_response_with_auth(m_userContext)
-    .then([sessionReference, userContextShared](std::shared_ptr<http_call_response> response)
+    .then([sessionReference, userContextShared, serviceImpl, cachedSession](std::shared_ptr<http_call_response> response)
     {
+        if (response->http_status() == 304 && cachedSession != nullptr)
+        {
+            return copy_not_modified_session(cachedSession, response);
+        }
+
         if (response->http_status() == 204)
         {
+            serviceImpl->session_cache().remove(sessionReference);
             return xbox_live_result<std::shared_ptr<multiplayer_session>>(xbox_live_error_code::http_status_204_resource_data_not_found, "Content not found on get_current_session");
         }
 
@@ -310,6 +377,11 @@ multiplayer_service::get_current_session(
             utils::string_t_from_internal_string(userContextShared->xbox_user_id())
             );
 
+        if (!multiplayerSessionSharedResult.err())
+        {
+            serviceImpl->session_cache().update(multiplayerSessionSharedResult.payload());
+        }
+
         return multiplayerSessionSharedResult;
     });
 
@@ -337,11 +409,24 @@ multiplayer_service::get_current_session_by_handle(
         );
 
     httpCall->set_xbox_contract_version_header_value(c_multiplayerServiceContractHeaderValue);
+
+    auto serviceImpl = m_multiplayerServiceImpl;
+    auto cachedSession = serviceImpl->session_cache().session_by_handle(handleId);
+    if (cachedSession != nullptr)
+    {
+        httpCall->set_custom_header(_T("If-None-Match"), cachedSession->e_tag());
+    }
+
     auto userContextShared = m_userContext;
 
     auto task = httpCall->get_response_with_auth(m_userContext)
-    .then([userContextShared](std::shared_ptr<http_call_response> response)
+    .then([userContextShared, serviceImpl, cachedSession, handleId](std::shared_ptr<http_call_response> response)
     {
+        if (response->http_status() == 304 && cachedSession != nullptr)
+        {
+            return copy_not_modified_session(cachedSession, response);
+        }
+
         if (response->http_status() == 204)
         {
             return xbox_live_result<std::shared_ptr<multiplayer_session>>(xbox_live_error_code::http_status_204_resource_data_not_found, "Content not found on get_current_session");
@@ -378,6 +463,11 @@ multiplayer_service::get_current_session_by_handle(
             utils::string_t_from_internal_string(userContextShared->xbox_user_id())
             );
 
+        if (!multiplayerSessionShared.err())
+        {
+            serviceImpl->session_cache().update(multiplayerSessionShared.payload(), handleId);
+        }
+
         return multiplayerSessionShared;
     });
 
@@ -474,6 +564,35 @@ multiplayer_service::get_sessions(
         );
 }
 
+task<xbox_live_result<multiplayer_session_states_result>>
+multiplayer_service::get_sessions_by_page(
+    _In_ multiplayer_get_sessions_request getSessionsRequest,
+    _In_ uint32_t xboxUserIdsPerPage
+    )
+{
+    auto pages = split_xbox_user_ids_into_pages(getSessionsRequest.xbox_user_ids_filter(), xboxUserIdsPerPage);
+
+    multiplayer_service service(*this);
+    auto pageRequest = [service, getSessionsRequest](const std::vector<string_t>& xboxUserIds) mutable
+    {
+        if (!xboxUserIds.empty())
+        {
+            getSessionsRequest.set_xbox_user_ids_filter(xboxUserIds);
+        }
+        return service.get_sessions(getSessionsRequest);
+    };
+
+    // max_items is sent with every page as well, so no page is longer than the cap
+    auto firstPage = std::make_shared<multiplayer_query_pager<multiplayer_session_states>>(
+        pageRequest,
+        pages,
+        0,
+        getSessionsRequest.max_items(),
+        0
+        );
+    return multiplayer_session_states_result(std::vector<multiplayer_session_states>(), firstPage).get_next();
+}
+
 task<xbox_live_result<void>>
 multiplayer_service::set_activity(
     _In_ multiplayer_session_reference sessionReference
@@ -879,6 +998,33 @@ multiplayer_service::get_activities_for_users(
         );
 }
 
+pplx::task<xbox_live_result<multiplayer_activity_details_result>>
+multiplayer_service::get_activities_for_users_by_page(
+    _In_ const string_t& serviceConfigurationId,
+    _In_ const std::vector<string_t>& xboxUserIds,
+    _In_ uint32_t xboxUserIdsPerPage,
+    _In_ uint32_t maxItems
+    )
+{
+    RETURN_TASK_CPP_INVALIDARGUMENT_IF_STRING_EMPTY(serviceConfigurationId, multiplayer_activity_details_result, "serviceConfigurationId is empty");
+    RETURN_TASK_CPP_INVALIDARGUMENT_IF(xboxUserIds.empty(), multiplayer_activity_details_result, "xboxUserIds are empty");
+
+    multiplayer_service service(*this);
+    auto pageRequest = [service, serviceConfigurationId](const std::vector<string_t>& pageXboxUserIds) mutable
+    {
+        return service.get_activities_for_users(serviceConfigurationId, pageXboxUserIds);
+    };
+
+    auto firstPage = std::make_shared<multiplayer_query_pager<multiplayer_activity_details>>(
+        pageRequest,
+        split_xbox_user_ids_into_pages(xboxUserIds, xboxUserIdsPerPage),
+        0,
+        maxItems,
+        0
+        );
+    return multiplayer_activity_details_result(std::vector<multiplayer_activity_details>(), firstPage).get_next();
+}
+
 pplx::task<xbox_live_result<std::vector<multiplayer_search_handle_details>>>
 multiplayer_service::get_search_handles(
     _In_ const string_t& serviceConfigurationId,
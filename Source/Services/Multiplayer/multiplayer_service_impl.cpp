@@ -83,6 +83,9 @@ multiplayer_service_impl::multiplayer_session_changed(
     _In_ const multiplayer_session_change_event_args& eventArgs
     )
 {
+    // The next read of this session has to download it in full
+    m_sessionCache.invalidate(eventArgs.session_reference(), eventArgs.change_number());
+
     std::unordered_map<uint32_t, std::function<void(const multiplayer_session_change_event_args&)>> sessionChangeCopy;
     {
         std::lock_guard<std::mutex> lock(m_subscriptionLock.get());
@@ -166,6 +169,12 @@ multiplayer_service_impl::enable_multiplayer_subscriptions()
     return xbox_live_error_code::no_error;
 }
 
+multiplayer_session_cache&
+multiplayer_service_impl::session_cache()
+{
+    return m_sessionCache;
+}
+
 bool
 multiplayer_service_impl::subscriptions_enabled()
 {
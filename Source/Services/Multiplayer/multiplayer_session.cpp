@@ -18,14 +18,13 @@ multiplayer_session::multiplayer_session() :
     m_newSession(false),
     m_initializationStage(multiplayer_initialization_stage::unknown),
     m_initializationEpisode(0),
-    m_hasMatchmakingServer(false),
     m_changeNumber(0)
 {
     m_servers = web::json::value::object();
     m_sessionConstants = std::make_shared<multiplayer_session_constants>();
     m_sessionRequest = std::make_shared<multiplayer_session_request>();
     m_multiplayerSessionProperties = std::make_shared<multiplayer_session_properties>();
-    m_sessionRoleTypes = std::make_shared<multiplayer_session_role_types>();
+    m_lazyFields = std::make_shared<multiplayer_session_lazy_fields>();
 }
 
 
@@ -38,7 +37,6 @@ multiplayer_session::multiplayer_session(
     m_newSession(true),
     m_initializationStage(multiplayer_initialization_stage::unknown),
     m_initializationEpisode(0),
-    m_hasMatchmakingServer(false),
     m_changeNumber(0)
 {
     XSAPI_ASSERT(!m_xboxUserId.empty());
@@ -56,7 +54,6 @@ multiplayer_session::multiplayer_session(
     m_joiningSession(false),
     m_initializationStage(multiplayer_initialization_stage::unknown),
     m_initializationEpisode(0),
-    m_hasMatchmakingServer(false),
     m_changeNumber(0)
 {
     XSAPI_ASSERT(!m_xboxUserId.empty());
@@ -78,7 +75,6 @@ multiplayer_session::multiplayer_session(
     m_joiningSession(false),
     m_initializationStage(multiplayer_initialization_stage::unknown),
     m_initializationEpisode(0),
-    m_hasMatchmakingServer(false),
     m_changeNumber(0)
 {
     XSAPI_ASSERT(!m_xboxUserId.empty());
@@ -105,7 +101,6 @@ multiplayer_session::multiplayer_session(
     m_joiningSession(false),
     m_initializationStage(multiplayer_initialization_stage::unknown),
     m_initializationEpisode(0),
-    m_hasMatchmakingServer(false),
     m_changeNumber(0)
 {
     XSAPI_ASSERT(!m_xboxUserId.empty());
@@ -149,7 +144,7 @@ void multiplayer_session::deep_copy_from(
     m_sessionReference = other.m_sessionReference;
     m_sessionConstants = other.m_sessionConstants;
     m_arbitrationStatus = other.m_arbitrationStatus;
-    m_sessionRoleTypes = other.m_sessionRoleTypes;
+    m_lazyFields = other.m_lazyFields;
     m_servers = other.m_servers;
     m_membersAccepted = other.m_membersAccepted;
     m_correlationId = other.m_correlationId;
@@ -159,8 +154,6 @@ void multiplayer_session::deep_copy_from(
     m_newSession = other.m_newSession;
     m_startTime = other.m_startTime;
     m_dateOfSession = other.m_dateOfSession;
-    m_matchmakingServer = other.m_matchmakingServer;
-    m_hasMatchmakingServer = other.m_hasMatchmakingServer;
     m_sessionSubscriptionGuid = other.m_sessionSubscriptionGuid;
     m_branch = other.m_branch;
     m_changeNumber = other.m_changeNumber;
@@ -171,7 +164,6 @@ void multiplayer_session::deep_copy_from(
     m_initializationEpisode = other.m_initializationEpisode;
     m_hostCandidate = other.m_hostCandidate;
     m_tournamentsServer = other.m_tournamentsServer;
-    m_arbitrationServer = other.m_arbitrationServer;
 
     m_memberCurrentUser = other.m_memberCurrentUser == nullptr ? nullptr : other.m_memberCurrentUser->_Create_deep_copy();
     m_sessionRequest = other.m_sessionRequest == nullptr ? nullptr : other.m_sessionRequest->create_deep_copy();
@@ -199,6 +191,13 @@ void multiplayer_session::deep_copy_from(
                     false
                     );
 
+                // Writes usually set the same roles, address and subscription again, so keep what they serialized to
+                auto previousMemberRequest = member->_Member_request();
+                if (previousMemberRequest != nullptr)
+                {
+                    memberRequest->copy_fragments_from(*previousMemberRequest);
+                }
+
                 memberCopy->_Set_member_request(memberRequest);
                 memberCopy->_Set_is_current_user(true);
                 memberCopy->_Set_current_user_status(member->status());
@@ -207,11 +206,13 @@ void multiplayer_session::deep_copy_from(
         }
         m_members.push_back(memberCopy);
     }
+    m_memberSlotByXboxUserId = other.m_memberSlotByXboxUserId;
+    m_memberSlotByMemberId = other.m_memberSlotByMemberId;
 
     m_multiplayerSessionProperties->_Deep_copy(*(other.m_multiplayerSessionProperties));
     m_multiplayerSessionProperties->_Initialize(
         m_sessionRequest,
-        m_members
+        [this](uint32_t memberId) { return _Member_by_member_id(memberId); }
         );
 }
 
@@ -223,12 +224,12 @@ void multiplayer_session::_Initialize(
     m_servers = web::json::value::object();
     m_sessionConstants = std::make_shared<multiplayer_session_constants>();
     m_multiplayerSessionProperties = std::make_shared<multiplayer_session_properties>();
-    m_sessionRoleTypes = std::make_shared<multiplayer_session_role_types>();
+    m_lazyFields = std::make_shared<multiplayer_session_lazy_fields>();
     m_sessionRequest = std::make_shared<multiplayer_session_request>(m_sessionConstants);
 
     m_multiplayerSessionProperties->_Initialize(
         m_sessionRequest,
-        m_members
+        [this](uint32_t memberId) { return _Member_by_member_id(memberId); }
         );
 
     ensure_session_subscription_id_initialized();
@@ -378,7 +379,7 @@ multiplayer_session::session_properties() const
 std::shared_ptr<multiplayer_session_role_types>
 multiplayer_session::session_role_types() const
 {
-    return m_sessionRoleTypes;
+    return m_lazyFields->role_types();
 }
 
 const std::vector<std::shared_ptr<multiplayer_session_member>>&
@@ -387,10 +388,54 @@ multiplayer_session::members() const
     return m_members;
 }
 
+std::shared_ptr<multiplayer_session_member>
+multiplayer_session::_Member_by_xbox_user_id(
+    _In_ const string_t& xboxUserId
+    ) const
+{
+    auto iter = m_memberSlotByXboxUserId.find(xboxUserId);
+    return iter == m_memberSlotByXboxUserId.end() ? nullptr : m_members[iter->second];
+}
+
+std::shared_ptr<multiplayer_session_member>
+multiplayer_session::_Member_by_member_id(
+    _In_ uint32_t memberId
+    ) const
+{
+    auto iter = m_memberSlotByMemberId.find(memberId);
+    return iter == m_memberSlotByMemberId.end() ? nullptr : m_members[iter->second];
+}
+
+void
+multiplayer_session::index_members()
+{
+    m_memberSlotByXboxUserId.clear();
+    m_memberSlotByMemberId.clear();
+    for (uint32_t slot = 0; slot < m_members.size(); ++slot)
+    {
+        index_member(slot, true);
+    }
+}
+
+void
+multiplayer_session::index_member(
+    _In_ uint32_t slot,
+    _In_ bool indexMemberId
+    )
+{
+    // The first member with a given key keeps the slot.  Members added locally have no service assigned id until they are written.
+    const auto& member = m_members[slot];
+    m_memberSlotByXboxUserId.emplace(member->xbox_user_id(), slot);
+    if (indexMemberId)
+    {
+        m_memberSlotByMemberId.emplace(member->member_id(), slot);
+    }
+}
+
 const multiplayer_session_matchmaking_server& 
 multiplayer_session::matchmaking_server() const
 {
-    return m_matchmakingServer;
+    return m_lazyFields->matchmaking_server();
 }
 
 const multiplayer_session_tournaments_server& 
@@ -402,7 +447,7 @@ multiplayer_session::tournaments_server() const
 const multiplayer_session_arbitration_server& 
 multiplayer_session::arbitration_server() const
 {
-    return m_arbitrationServer;
+    return m_lazyFields->arbitration_server();
 }
 
 uint32_t
@@ -464,6 +509,14 @@ multiplayer_session::_Set_write_session_status(
     m_writeSessionStatus = convert_http_status_to_write_session_status(httpStatusCode);
 }
 
+void
+multiplayer_session::_Set_date_of_session(
+    _In_ const string_t& responseDate
+    )
+{
+    m_dateOfSession = utility::datetime::from_string(responseDate, utility::datetime::date_format::RFC_1123);
+}
+
 std::error_code
 multiplayer_session::add_member_reservation(
     _In_ const string_t& xboxUserId,
@@ -846,6 +899,7 @@ multiplayer_session::leave()
         if (member->is_current_user())
         {
             m_members.erase((m_members.begin() + i));
+            index_members();
             break;
         }
     }
@@ -1093,6 +1147,7 @@ multiplayer_session::add_member_reservation_helper(
     member->_Set_member_request(memberRequest);
     member->_Set_session_request(m_sessionRequest);
     m_members.push_back(member);
+    index_member(static_cast<uint32_t>(m_members.size() - 1), false);
 
     return xbox_live_error_code::no_error;
 }
@@ -1143,6 +1198,7 @@ multiplayer_session::join_helper(
     member->_Set_member_request(memberRequest);
     member->_Set_session_request(m_sessionRequest);
     m_members.push_back(member);
+    index_member(static_cast<uint32_t>(m_members.size() - 1), false);
     m_memberCurrentUser = member;
 
     return xbox_live_result<std::shared_ptr<multiplayer_session_member>>(member);
@@ -1394,14 +1450,13 @@ multiplayer_session::_Deserialize_members_list(
 }
 
 std::error_code 
-multiplayer_session::_Populate_members_with_members_list(
-    _In_ std::vector<std::shared_ptr<multiplayer_session_member>> members
-    )
+multiplayer_session::_Populate_members_with_members_list()
 {
     std::error_code errc;
-    for (auto& member : members)
+    auto memberById = [this](uint32_t memberId) { return _Member_by_member_id(memberId); };
+    for (auto& member : m_members)
     {
-        errc = member->set_members_list(members);
+        errc = member->_Resolve_members_in_group(memberById);
     }
     return errc;
 }
@@ -1454,30 +1509,20 @@ multiplayer_session::compare_multiplayer_sessions(
     for (uint32_t i = 0; i < currentSession->members().size(); i++)
     {
         std::shared_ptr<multiplayer_session_member> currentSessionMember = currentSession->members()[i];
-        bool isMemberFound = false;
-        for (uint32_t j = 0; j < oldSession->members().size(); j++)
+        std::shared_ptr<multiplayer_session_member> olderSessionMember = oldSession->_Member_by_xbox_user_id(currentSessionMember->xbox_user_id());
+        if (olderSessionMember != nullptr)
         {
-            std::shared_ptr<multiplayer_session_member> olderSessionMember = oldSession->members()[j];
-
-            if (utils::str_icmp(currentSessionMember->xbox_user_id(),
-                olderSessionMember->xbox_user_id()) == 0)
+            if (currentSessionMember->status() != olderSessionMember->status())
             {
-                isMemberFound = true;
-
-                if (currentSessionMember->status() != olderSessionMember->status())
-                {
-                    memberStatusChanged = true;
-                }
+                memberStatusChanged = true;
+            }
 
-                if (utils::str_icmp(currentSessionMember->member_custom_properties_json().serialize(),
-                    olderSessionMember->member_custom_properties_json().serialize()) != 0)
-                {
-                    memberCustomPropertyChanged = true;
-                }
+            if (currentSessionMember->_Custom_properties_hash() != olderSessionMember->_Custom_properties_hash())
+            {
+                memberCustomPropertyChanged = true;
             }
         }
-
-        if (!isMemberFound)
+        else
         {
             hasMemberChanged = true;
         }
@@ -1514,7 +1559,7 @@ multiplayer_session::compare_multiplayer_sessions(
         currentType |= multiplayer_session_change_types::session_joinability_change;
     }
 
-    if (utils::str_icmp(currentSession->session_properties()->session_custom_properties_json().serialize(), oldSession->session_properties()->session_custom_properties_json().serialize()) != 0)
+    if (currentSession->session_properties()->_Custom_properties_hash() != oldSession->session_properties()->_Custom_properties_hash())
     {
         currentType |= multiplayer_session_change_types::custom_property_change;
     }
@@ -1604,7 +1649,8 @@ multiplayer_session::_Deserialize(
         }
     }
 
-    _Populate_members_with_members_list(returnResult.m_members);
+    returnResult.index_members();
+    returnResult._Populate_members_with_members_list();
 
     auto multiplayerSessionProperties = multiplayer_session_properties::_Deserialize(
         utils::extract_json_field(
@@ -1623,44 +1669,19 @@ multiplayer_session::_Deserialize(
 
     returnResult.m_multiplayerSessionProperties->_Initialize(
         returnResult.m_sessionRequest,
-        returnResult.m_members
+        [&returnResult](uint32_t memberId) { return returnResult._Member_by_member_id(memberId); }
         );
     returnResult.m_membersAccepted = utils::extract_json_int(memberInfoJson, _T("accepted"));
 
-    auto sessionRoleTypes = multiplayer_session_role_types::_Deserialize(
-        utils::extract_json_field(json, _T("roleTypes"), false)
-        );
-
-    if (sessionRoleTypes.err())
-    {
-        errc = sessionRoleTypes.err();
-    }
-    returnResult.m_sessionRoleTypes = std::make_shared<multiplayer_session_role_types>(sessionRoleTypes.payload());
-
+    // Role types and the matchmaking and arbitration servers are decoded on first access
     auto serversJson = utils::extract_json_field(json, _T("servers"), errc, false);
     auto serversMatchmakingJson = utils::extract_json_field(serversJson, _T("matchmaking"), errc, false);
     auto serversMatchmakingPropertiesJson = utils::extract_json_field(serversMatchmakingJson, _T("properties"), errc, false);
-
-    if (!serversMatchmakingJson.is_null())
-    {
-        returnResult.m_matchmakingServer =
-            multiplayer_session_matchmaking_server::_Deserialize(
-                utils::extract_json_field(serversMatchmakingPropertiesJson, _T("system"), errc, false)
-                ).payload();
-
-        returnResult.m_hasMatchmakingServer = true;
-    }
-
-    auto serversArbitrationJson = utils::extract_json_field(serversJson, _T("arbitration"), errc, false);
-    if (!serversArbitrationJson.is_null())
-    {
-        auto arbitrationServerResult = multiplayer_session_arbitration_server::_Deserialize(serversArbitrationJson);
-        if (arbitrationServerResult.err())
-        {
-            errc = arbitrationServerResult.err();
-        }
-        returnResult.m_arbitrationServer = arbitrationServerResult.payload();
-    }
+    returnResult.m_lazyFields = std::make_shared<multiplayer_session_lazy_fields>(
+        utils::extract_json_field(json, _T("roleTypes"), false),
+        utils::extract_json_field(serversMatchmakingPropertiesJson, _T("system"), errc, false),
+        utils::extract_json_field(serversJson, _T("arbitration"), errc, false)
+        );
 
     auto serversTournamentJson = utils::extract_json_field(serversJson, _T("tournaments"), errc, false);
     if (!serversTournamentJson.is_null())
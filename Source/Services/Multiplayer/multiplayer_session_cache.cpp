@@ -0,0 +1,144 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "pch.h"
+#include "xsapi/multiplayer.h"
+#include "multiplayer_internal.h"
+#include <locale>
+
+using namespace xbox::services::multiplayer;
+
+const size_t multiplayer_session_cache::c_maxCachedSessions = 32;
+
+multiplayer_session_cache::multiplayer_session_cache() :
+    m_useCounter(0)
+{
+}
+
+std::shared_ptr<multiplayer_session>
+multiplayer_session_cache::session(
+    _In_ const multiplayer_session_reference& sessionReference
+    )
+{
+    std::lock_guard<std::mutex> lock(m_lock.get());
+    auto iter = m_sessions.find(cache_key(sessionReference));
+    if (iter == m_sessions.end())
+    {
+        return nullptr;
+    }
+
+    iter->second.lastUsed = ++m_useCounter;
+    return iter->second.session;
+}
+
+std::shared_ptr<multiplayer_session>
+multiplayer_session_cache::session_by_handle(
+    _In_ const string_t& handleId
+    )
+{
+    std::lock_guard<std::mutex> lock(m_lock.get());
+    auto handleIter = m_handles.find(handleId);
+    if (handleIter == m_handles.end())
+    {
+        return nullptr;
+    }
+
+    auto iter = m_sessions.find(handleIter->second);
+    if (iter == m_sessions.end())
+    {
+        m_handles.erase(handleIter);
+        return nullptr;
+    }
+
+    iter->second.lastUsed = ++m_useCounter;
+    return iter->second.session;
+}
+
+void
+multiplayer_session_cache::update(
+    _In_ const std::shared_ptr<multiplayer_session>& session,
+    _In_ const string_t& handleId
+    )
+{
+    if (session == nullptr || session->session_reference().is_null() || session->e_tag().empty())
+    {
+        return;
+    }
+
+    // Copied outside the lock, so callers are free to modify their own session afterwards
+    auto sessionCopy = session->_Create_deep_copy();
+    string_t key = cache_key(sessionCopy->session_reference());
+
+    std::lock_guard<std::mutex> lock(m_lock.get());
+    auto iter = m_sessions.find(key);
+    if (iter != m_sessions.end() && iter->second.session->change_number() > sessionCopy->change_number())
+    {
+        // A slower request finished after a newer copy was cached
+        sessionCopy = iter->second.session;
+    }
+    else if (iter == m_sessions.end() && m_sessions.size() >= c_maxCachedSessions)
+    {
+        auto oldest = m_sessions.begin();
+        for (auto entry = m_sessions.begin(); entry != m_sessions.end(); ++entry)
+        {
+            if (entry->second.lastUsed < oldest->second.lastUsed)
+            {
+                oldest = entry;
+            }
+        }
+        m_sessions.erase(oldest);
+
+        // Handles to sessions that are no longer cached are cleaned up as they are looked up,
+        // but the map itself is not allowed to grow without bound
+        if (m_handles.size() >= c_maxCachedSessions * 2)
+        {
+            m_handles.clear();
+        }
+    }
+
+    cache_entry& entry = m_sessions[key];
+    entry.session = sessionCopy;
+    entry.lastUsed = ++m_useCounter;
+
+    if (!handleId.empty())
+    {
+        m_handles[handleId] = key;
+    }
+}
+
+void
+multiplayer_session_cache::invalidate(
+    _In_ const multiplayer_session_reference& sessionReference,
+    _In_ uint64_t changeNumber
+    )
+{
+    std::lock_guard<std::mutex> lock(m_lock.get());
+    auto iter = m_sessions.find(cache_key(sessionReference));
+    if (iter != m_sessions.end() && iter->second.session->change_number() < changeNumber)
+    {
+        m_sessions.erase(iter);
+    }
+}
+
+void
+multiplayer_session_cache::remove(
+    _In_ const multiplayer_session_reference& sessionReference
+    )
+{
+    std::lock_guard<std::mutex> lock(m_lock.get());
+    m_sessions.erase(cache_key(sessionReference));
+}
+
+string_t
+multiplayer_session_cache::cache_key(
+    _In_ const multiplayer_session_reference& sessionReference
+    )
+{
+    // Session directory names are case insensitive, and RTA may not use the casing the title did
+    string_t key = sessionReference.to_uri_path();
+    for (auto& c : key)
+    {
+        c = std::tolower(c, std::locale::classic());
+    }
+    return key;
+}
@@ -0,0 +1,68 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "pch.h"
+#include "utils.h"
+#include "xsapi/multiplayer.h"
+#include "multiplayer_internal.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_MULTIPLAYER_CPP_BEGIN
+
+multiplayer_session_lazy_fields::multiplayer_session_lazy_fields()
+{
+}
+
+multiplayer_session_lazy_fields::multiplayer_session_lazy_fields(
+    _In_ web::json::value roleTypesJson,
+    _In_ web::json::value matchmakingServerJson,
+    _In_ web::json::value arbitrationServerJson
+    ) :
+    m_roleTypesJson(std::move(roleTypesJson)),
+    m_matchmakingServerJson(std::move(matchmakingServerJson)),
+    m_arbitrationServerJson(std::move(arbitrationServerJson))
+{
+}
+
+std::shared_ptr<multiplayer_session_role_types>
+multiplayer_session_lazy_fields::role_types()
+{
+    std::lock_guard<std::mutex> lock(m_lock.get());
+    if (m_roleTypes == nullptr)
+    {
+        auto result = multiplayer_session_role_types::_Deserialize(m_roleTypesJson);
+        LOG_ERROR_IF(result.err(), "Failed to deserialize session roleTypes");
+        m_roleTypes = std::make_shared<multiplayer_session_role_types>(result.payload());
+        m_roleTypesJson = web::json::value();
+    }
+    return m_roleTypes;
+}
+
+const multiplayer_session_matchmaking_server&
+multiplayer_session_lazy_fields::matchmaking_server()
+{
+    std::lock_guard<std::mutex> lock(m_lock.get());
+    if (m_matchmakingServer == nullptr)
+    {
+        auto result = multiplayer_session_matchmaking_server::_Deserialize(m_matchmakingServerJson);
+        LOG_ERROR_IF(result.err(), "Failed to deserialize session matchmaking server");
+        m_matchmakingServer = std::make_shared<multiplayer_session_matchmaking_server>(result.payload());
+        m_matchmakingServerJson = web::json::value();
+    }
+    return *m_matchmakingServer;
+}
+
+const multiplayer_session_arbitration_server&
+multiplayer_session_lazy_fields::arbitration_server()
+{
+    std::lock_guard<std::mutex> lock(m_lock.get());
+    if (m_arbitrationServer == nullptr)
+    {
+        auto result = multiplayer_session_arbitration_server::_Deserialize(m_arbitrationServerJson);
+        LOG_ERROR_IF(result.err(), "Failed to deserialize session arbitration server");
+        m_arbitrationServer = std::make_shared<multiplayer_session_arbitration_server>(result.payload());
+        m_arbitrationServerJson = web::json::value();
+    }
+    return *m_arbitrationServer;
+}
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_MULTIPLAYER_CPP_END
@@ -25,6 +25,7 @@ void multiplayer_session_member::deep_copy_from(
     m_memberId = other.m_memberId;
     m_customConstantsJson = other.m_customConstantsJson;
     m_customPropertiesJson = other.m_customPropertiesJson;
+    m_customPropertiesHash = other.m_customPropertiesHash;
     m_gamertag = other.m_gamertag;
     m_xboxUserId = other.m_xboxUserId;
     m_isCurrentUser = other.m_isCurrentUser;
@@ -77,6 +78,7 @@ multiplayer_session_member::multiplayer_session_member() :
     m_matchmakingResultServerMeasurementsJson = web::json::value::object();
     m_customConstantsJson = web::json::value::object();
     m_customPropertiesJson = web::json::value::object();
+    m_customPropertiesHash = utils::json_hash(m_customPropertiesJson);
     m_memberMeasurements = std::make_shared<std::vector<multiplayer_quality_of_service_measurements>>();
 }
 
@@ -105,6 +107,7 @@ multiplayer_session_member::multiplayer_session_member(
     m_matchmakingResultServerMeasurementsJson = web::json::value::object();
     m_customConstantsJson = web::json::value::object();
     m_customPropertiesJson = web::json::value::object();
+    m_customPropertiesHash = utils::json_hash(m_customPropertiesJson);
     m_memberMeasurements = std::make_shared<std::vector<multiplayer_quality_of_service_measurements>>();
 }
 
@@ -192,6 +195,14 @@ multiplayer_session_member::member_custom_properties_json() const
     return m_customPropertiesJson;
 }
 
+uint64_t
+multiplayer_session_member::_Custom_properties_hash() const
+{
+    std::lock_guard<std::mutex> lock(get_xsapi_singleton()->m_mpsdMemberLock);
+
+    return m_customPropertiesHash;
+}
+
 const string_t&
 multiplayer_session_member::gamertag() const
 {
@@ -277,20 +288,35 @@ multiplayer_session_member::set_members_list(
     _In_ std::vector<std::shared_ptr<multiplayer_session_member>> members
     )
 {
-    std::vector<std::shared_ptr<multiplayer_session_member>> membersInGroup;
-    for (const uint32_t memberIndex : m_membersInGroupIndices)
+    return _Resolve_members_in_group([&members](uint32_t memberId) -> std::shared_ptr<multiplayer_session_member>
     {
         for (const auto& member : members)
         {
-            if (member->member_id() == memberIndex)
+            if (member->member_id() == memberId)
             {
-                membersInGroup.push_back(member);
-                break;
+                return member;
             }
         }
+        return std::shared_ptr<multiplayer_session_member>();
+    });
+}
+
+std::error_code
+multiplayer_session_member::_Resolve_members_in_group(
+    _In_ const std::function<std::shared_ptr<multiplayer_session_member>(uint32_t)>& memberById
+    )
+{
+    std::vector<std::shared_ptr<multiplayer_session_member>> membersInGroup;
+    for (const uint32_t memberIndex : m_membersInGroupIndices)
+    {
+        auto member = memberById(memberIndex);
+        if (member != nullptr)
+        {
+            membersInGroup.push_back(std::move(member));
+        }
     }
 
-    m_membersInGroup = membersInGroup;
+    m_membersInGroup = std::move(membersInGroup);
 
     return convert_measure_json_to_vector();
 }
@@ -708,6 +734,7 @@ multiplayer_session_member::_Deserialize(
     returnResult.m_xboxUserId = utils::extract_json_string(constantsSystemJson, _T("xuid"), errc);
     returnResult.m_initialize = utils::extract_json_bool(constantsSystemJson, _T("initialize"), errc);
     returnResult.m_customPropertiesJson = utils::extract_json_field(propertiesJson, _T("custom"), errc, false);
+    returnResult.m_customPropertiesHash = utils::json_hash(returnResult.m_customPropertiesJson);
     returnResult.m_customConstantsJson = utils::extract_json_field(constantsJson, _T("custom"), errc, false);
     returnResult.m_teamId = utils::extract_json_string(constantsSystemJson, _T("team"), errc);
     returnResult.m_arbitrationStatus = multiplayer_service::_Convert_string_to_arbitration_status(utils::extract_json_string(json, _T("arbitrationStatus"), errc));
@@ -11,6 +11,39 @@ using namespace xbox::services::tournaments;
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_MULTIPLAYER_CPP_BEGIN
 
+namespace
+{
+template<typename T, typename WriteFn>
+void write_fragment(
+    _Inout_ multiplayer_member_request_fragment<T>& fragment,
+    _In_ const T& source,
+    _In_ const WriteFn& writeValue,
+    _Inout_ json_writer& writer
+    )
+{
+    if (fragment.json.empty())
+    {
+        json_writer fragmentWriter;
+        writeValue(fragmentWriter);
+        fragment.source = source;
+        fragment.json = fragmentWriter.output();
+    }
+    writer.raw_value(fragment.json);
+}
+
+template<typename T>
+void invalidate_fragment_if_changed(
+    _Inout_ multiplayer_member_request_fragment<T>& fragment,
+    _In_ const T& value
+    )
+{
+    if (!fragment.json.empty() && !(fragment.source == value))
+    {
+        fragment.json.clear();
+    }
+}
+}
+
 multiplayer_session_member_request::multiplayer_session_member_request():
     m_writeRequest(false),
     m_writeConstants(false),
@@ -153,6 +186,7 @@ multiplayer_session_member_request::set_secure_device_address_base64(
     _In_ string_t deviceAddress
     )
 {
+    invalidate_fragment_if_changed(m_secureDeviceAddressFragment, deviceAddress);
     m_serviceDeviceAddressBase64 = std::move(deviceAddress);
 }
 
@@ -175,6 +209,7 @@ multiplayer_session_member_request::set_role_info(
     _In_ const std::unordered_map<string_t, string_t>& roles
     )
 {
+    invalidate_fragment_if_changed(m_rolesFragment, roles);
     m_roles = roles;
 }
 
@@ -327,6 +362,11 @@ multiplayer_session_member_request::set_subscribed_change_types(
     _In_ multiplayer_session_change_types changeTypes
     )
 {
+    // The id is set separately, so only the half of the source this setter owns is compared
+    if (changeTypes != m_subscriptionFragment.source.first)
+    {
+        m_subscriptionFragment.json.clear();
+    }
     m_changeTypes = changeTypes;
 }
 
@@ -341,6 +381,10 @@ multiplayer_session_member_request::set_subscription_id(
     _In_ string_t subscriptionId
     )
 {
+    if (subscriptionId != m_subscriptionFragment.source.second)
+    {
+        m_subscriptionFragment.json.clear();
+    }
     m_subscriptionId = std::move(subscriptionId);
 }
 
@@ -434,137 +478,226 @@ multiplayer_session_member_request::get_vector_view_for_change_types(
     return resultVector;
 }
 
-web::json::value
-multiplayer_session_member_request::serialize()
+bool
+multiplayer_session_member_request::has_system_properties() const
+{
+    return m_writeIsActive ||
+        m_writeSubscribedChangeType ||
+        !m_results.empty() ||
+        m_writeSecureDeviceAddressBase64 ||
+        m_writeMembersInGroup ||
+        !m_groups.empty() ||
+        !m_encounters.empty() ||
+        m_writeMemberMeasurementsJson ||
+        m_writeMemberServerMeasurementsJson;
+}
+
+bool
+multiplayer_session_member_request::has_content() const
 {
-    web::json::value serializedObject;
+    return m_writeRequest ||
+        m_writeConstants ||
+        !m_roles.empty() ||
+        has_system_properties() ||
+        !m_customProperties.is_null();
+}
+
+void
+multiplayer_session_member_request::serialize(
+    _Inout_ json_writer& writer
+    ) const
+{
+    writer.begin_object();
     if (m_writeRequest || m_writeConstants)
     {
-        web::json::value systemConstantsJson;
-        systemConstantsJson[_T("xuid")] = web::json::value::string(m_xboxUserId);
-
+        writer.key("constants");
+        writer.begin_object();
+        writer.key("system");
+        writer.begin_object();
+        writer.member("xuid", m_xboxUserId);
         if (m_addInitializePropertyToRequest)
         {
-            systemConstantsJson[_T("initialize")] = web::json::value(m_initializeRequested);
+            writer.member("initialize", m_initializeRequested);
         }
+        writer.end_object();
 
-        web::json::value constantsJson;
-        constantsJson[_T("system")] = systemConstantsJson;
         if (m_writeConstants && !m_customConstants.is_null())
         {
-            constantsJson[_T("custom")] = m_customConstants;
+            writer.key("custom");
+            if (m_customConstantsFragment.empty())
+            {
+                m_customConstantsFragment = utils::json_serialize_utf8(m_customConstants);
+            }
+            writer.raw_value(m_customConstantsFragment);
         }
-        serializedObject[_T("constants")] = std::move(constantsJson);
+        writer.end_object();
     }
 
-    web::json::value propertiesJson;
-    web::json::value systemPropertiesJson;
-
-    if (m_writeIsActive)
+    if (m_roles.size() > 0)
     {
-        systemPropertiesJson[_T("active")] = web::json::value(m_isActive);
-        if (!m_isActive)
-        {
-            systemPropertiesJson[_T("ready")] = web::json::value(m_isActive);
-        }
-        else
+        writer.key("roles");
+        write_fragment(m_rolesFragment, m_roles, [this](json_writer& fragmentWriter)
         {
-            if (!m_rtaConnectionId.empty())
+            fragmentWriter.begin_object();
+            for (const auto& role : m_roles)
             {
-                systemPropertiesJson[_T("connection")] = web::json::value::string(m_rtaConnectionId);
+                fragmentWriter.key(role.first);
+                fragmentWriter.value(role.second);
             }
-        }
+            fragmentWriter.end_object();
+        }, writer);
     }
 
-    if (m_roles.size() > 0)
+    bool writeSystemProperties = has_system_properties();
+    if (writeSystemProperties || !m_customProperties.is_null())
     {
-        web::json::value rolesJson;
-        for (const auto& role : m_roles)
-        {
-            rolesJson[role.first] = web::json::value::string(role.second);
-        }
-        serializedObject[_T("roles")] = rolesJson;
+        writer.key("properties");
+        writer.begin_object();
     }
 
-    if (m_writeSubscribedChangeType)
+    if (writeSystemProperties)
     {
-        web::json::value subscriptionJson = web::json::value::null();
+        writer.key("system");
+        writer.begin_object();
 
-        if (m_changeTypes != multiplayer_session_change_types::none)
+        if (m_writeIsActive)
         {
-            subscriptionJson[_T("id")] = web::json::value::string(m_subscriptionId);
-            subscriptionJson[_T("changeTypes")] = utils::serialize_vector<string_t>(
-                utils::json_string_serializer, 
-                get_vector_view_for_change_types(m_changeTypes)
-                );
+            writer.member("active", m_isActive);
+            if (!m_isActive)
+            {
+                writer.member("ready", m_isActive);
+            }
+            else if (!m_rtaConnectionId.empty())
+            {
+                writer.member("connection", m_rtaConnectionId);
+            }
         }
 
-        systemPropertiesJson[_T("subscription")] = subscriptionJson;
-    }
+        if (m_writeSubscribedChangeType)
+        {
+            writer.key("subscription");
+            if (m_changeTypes != multiplayer_session_change_types::none)
+            {
+                write_fragment(m_subscriptionFragment, std::make_pair(m_changeTypes, m_subscriptionId), [this](json_writer& fragmentWriter)
+                {
+                    fragmentWriter.begin_object();
+                    fragmentWriter.member("id", m_subscriptionId);
+                    fragmentWriter.key("changeTypes");
+                    fragmentWriter.begin_array();
+                    for (const auto& changeType : get_vector_view_for_change_types(m_changeTypes))
+                    {
+                        fragmentWriter.value(changeType);
+                    }
+                    fragmentWriter.end_array();
+                    fragmentWriter.end_object();
+                }, writer);
+            }
+            else
+            {
+                writer.null_value();
+            }
+        }
 
-    if (m_results.size() > 0)
-    {
-        web::json::value arbitrationResultsJson;
-        for (const auto& result : m_results)
+        if (m_results.size() > 0)
         {
-            web::json::value teamResultJson;
-            teamResultJson[_T("outcome")] = web::json::value::string(multiplayer_service::_Convert_game_result_state_to_string(result.second.state()));
-            if (result.second.state() == tournament_game_result_state::rank)
+            writer.key("arbitration");
+            writer.begin_object();
+            writer.key("results");
+            writer.begin_object();
+            for (const auto& result : m_results)
             {
-                teamResultJson[_T("ranking")] = web::json::value::number(result.second.ranking());
+                writer.key(result.first);
+                writer.begin_object();
+                writer.member("outcome", multiplayer_service::_Convert_game_result_state_to_string(result.second.state()));
+                if (result.second.state() == tournament_game_result_state::rank)
+                {
+                    writer.member("ranking", result.second.ranking());
+                }
+                writer.end_object();
             }
-            arbitrationResultsJson[result.first] = teamResultJson;
+            writer.end_object();
+            writer.end_object();
         }
-        systemPropertiesJson[_T("arbitration")][_T("results")] = arbitrationResultsJson;
-    }
 
-    if (m_writeSecureDeviceAddressBase64)
-    {
-        systemPropertiesJson[_T("secureDeviceAddress")] = web::json::value::string(m_serviceDeviceAddressBase64);
-    }
+        if (m_writeSecureDeviceAddressBase64)
+        {
+            writer.key("secureDeviceAddress");
+            write_fragment(m_secureDeviceAddressFragment, m_serviceDeviceAddressBase64, [this](json_writer& fragmentWriter)
+            {
+                fragmentWriter.value(m_serviceDeviceAddressBase64);
+            }, writer);
+        }
 
-    if (m_writeMembersInGroup)
-    {
-        systemPropertiesJson[_T("initializationGroup")] = utils::serialize_vector<uint32_t>(utils::json_int_serializer, m_membersInGroup);
-    }
+        if (m_writeMembersInGroup)
+        {
+            writer.key("initializationGroup");
+            writer.begin_array();
+            for (uint32_t memberIndex : m_membersInGroup)
+            {
+                writer.value(memberIndex);
+            }
+            writer.end_array();
+        }
 
-    if (!m_groups.empty())
-    {
-        systemPropertiesJson[_T("groups")] = utils::serialize_vector<string_t>(utils::json_string_serializer, m_groups);
-    }
+        if (!m_groups.empty())
+        {
+            writer.key("groups");
+            writer.begin_array();
+            for (const auto& group : m_groups)
+            {
+                writer.value(group);
+            }
+            writer.end_array();
+        }
 
-    if (!m_encounters.empty())
-    {
-        systemPropertiesJson[_T("encounters")] = utils::serialize_vector<string_t>(utils::json_string_serializer, m_encounters);
-    }
+        if (!m_encounters.empty())
+        {
+            writer.key("encounters");
+            writer.begin_array();
+            for (const auto& encounter : m_encounters)
+            {
+                writer.value(encounter);
+            }
+            writer.end_array();
+        }
 
-    if (m_writeMemberMeasurementsJson)
-    {
-        systemPropertiesJson[_T("measurements")] = m_memberMeasurementsJson;
-    }
+        if (m_writeMemberMeasurementsJson)
+        {
+            writer.key("measurements");
+            writer.json_value(m_memberMeasurementsJson);
+        }
 
-    if (m_writeMemberServerMeasurementsJson)
-    {
-        systemPropertiesJson[_T("serverMeasurements")] = m_memberServerMeasurementsJson;
-    }
+        if (m_writeMemberServerMeasurementsJson)
+        {
+            writer.key("serverMeasurements");
+            writer.json_value(m_memberServerMeasurementsJson);
+        }
 
-    if (!systemPropertiesJson.is_null())
-    {
-        propertiesJson[_T("system")] = std::move(systemPropertiesJson);
+        writer.end_object();
     }
 
     if (!m_customProperties.is_null())
     {
-        propertiesJson[_T("custom")] = m_customProperties;
+        writer.key("custom");
+        writer.json_value(m_customProperties);
     }
 
-    if (!propertiesJson.is_null())
+    if (writeSystemProperties || !m_customProperties.is_null())
     {
-        serializedObject[_T("properties")] = std::move(propertiesJson);
+        writer.end_object();
     }
 
-    return serializedObject;
+    writer.end_object();
 }
 
+void
+multiplayer_session_member_request::copy_fragments_from(
+    _In_ const multiplayer_session_member_request& other
+    )
+{
+    m_rolesFragment = other.m_rolesFragment;
+    m_secureDeviceAddressFragment = other.m_secureDeviceAddressFragment;
+    m_subscriptionFragment = other.m_subscriptionFragment;
+}
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_MULTIPLAYER_CPP_END
\ No newline at end of file
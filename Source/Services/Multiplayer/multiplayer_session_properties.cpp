@@ -16,6 +16,7 @@ multiplayer_session_properties::multiplayer_session_properties() :
 {
     m_matchmakingTargetSessionConstants = web::json::value::object();
     m_customPropertiesJson = web::json::value::object();
+    m_customPropertiesHash = utils::json_hash(m_customPropertiesJson);
     m_sessionRequest = std::make_shared<multiplayer_session_request>();
 }
 
@@ -24,6 +25,7 @@ multiplayer_session_properties& multiplayer_session_properties::_Deep_copy(
     )
 {
     m_customPropertiesJson = other.m_customPropertiesJson;
+    m_customPropertiesHash = other.m_customPropertiesHash;
     m_keywords = other.m_keywords;
     m_sessionOwnerIndices = other.m_sessionOwnerIndices;
     m_turnCollection = other.m_turnCollection;
@@ -128,6 +130,13 @@ multiplayer_session_properties::session_custom_properties_json() const
     return m_customPropertiesJson;
 }
 
+uint64_t
+multiplayer_session_properties::_Custom_properties_hash() const
+{
+    std::lock_guard<std::mutex> lock(get_xsapi_singleton()->m_mpsdPropertyLock);
+    return m_customPropertiesHash;
+}
+
 const string_t& 
 multiplayer_session_properties::matchmaking_server_connection_string() const
 {
@@ -178,26 +187,20 @@ multiplayer_session_properties::allocate_cloud_compute() const
 void 
 multiplayer_session_properties::_Initialize(
     _In_ std::shared_ptr<multiplayer_session_request> sessionRequest,
-    _In_ std::vector<std::shared_ptr<multiplayer_session_member>> members
+    _In_ const std::function<std::shared_ptr<multiplayer_session_member>(uint32_t)>& memberById
     )
 {
     m_sessionRequest = std::move(sessionRequest);
     std::vector<std::shared_ptr<multiplayer_session_member>> turnCollection;
-    if (!m_turnIndexList.empty() && !members.empty())
+    for (uint32_t memberIndex : m_turnIndexList)
     {
-        for (uint32_t memberIndex : m_turnIndexList)
+        auto member = memberById(memberIndex);
+        if (member != nullptr)
         {
-            for (const auto& member : members)
-            {
-                if (member->member_id() == memberIndex)
-                {
-                    turnCollection.push_back(member);
-                    break;
-                }
-            }
+            turnCollection.push_back(std::move(member));
         }
     }
-    m_turnCollection = turnCollection;
+    m_turnCollection = std::move(turnCollection);
 }
 
 std::error_code
@@ -324,6 +327,7 @@ multiplayer_session_properties::_Deserialize(
 
     returnResult.m_matchmakingTargetSessionConstants = utils::extract_json_field(systemMatchmakingJson, _T("targetSessionConstants"), errc, false);
     returnResult.m_customPropertiesJson = utils::extract_json_field(json, _T("custom"), errc, false);
+    returnResult.m_customPropertiesHash = utils::json_hash(returnResult.m_customPropertiesJson);
     
     returnResult.m_host = utils::extract_json_string(systemJson, _T("host"), errc);
     returnResult.m_serverConnectionString = utils::extract_json_string(systemMatchmakingJson, _T("serverConnectionString"), errc);
@@ -562,199 +562,265 @@ multiplayer_session_request::set_mutable_role_settings(
     m_roleTypes = std::move(roleTypes);
 }
 
-web::json::value
-multiplayer_session_request::create_properties_json()
+bool
+multiplayer_session_request::has_system_properties() const
+{
+    return !m_sessionPropertiesKeywords.empty() ||
+        !m_sessionPropertiesTurns.empty() ||
+        m_joinRestriction != multiplayer_session_restriction::unknown ||
+        m_readRestriction != multiplayer_session_restriction::unknown ||
+        m_writeClosed ||
+        m_writeLocked ||
+        m_writeAllocateCloudCompute ||
+        m_writeMatchmakingClientResult ||
+        m_writeMatchmakingSessionConstants ||
+        m_writeMatchmakingServerConnectionPath ||
+        m_writeMatchmakingResubmit ||
+        m_writeInitializationStatus ||
+        m_writeHostDeviceToken ||
+        m_writeServerConnectionStringCandidates;
+}
+
+void
+multiplayer_session_request::write_properties(
+    _Inout_ json_writer& writer
+    )
 {
-    web::json::value jsonProperties;
-    web::json::value jsonPropertiesSystem;
-    if (!m_sessionPropertiesKeywords.empty())
+    writer.begin_object();
+    if (has_system_properties())
     {
-        jsonPropertiesSystem[_T("keywords")] = utils::serialize_vector<string_t>(utils::json_string_serializer, m_sessionPropertiesKeywords);
-    }
-    
-    if (!m_sessionPropertiesTurns.empty())
-    {
-        jsonPropertiesSystem[_T("turn")] = utils::serialize_vector<uint32_t>(utils::json_int_serializer, m_sessionPropertiesTurns);
-    }
+        writer.key("system");
+        writer.begin_object();
 
-    if (m_joinRestriction != multiplayer_session_restriction::unknown)
-    {
-        auto joinRestrictionToString = multiplayer_session_states::_Convert_multiplayer_session_restriction_to_string(m_joinRestriction);
-        jsonPropertiesSystem[_T("joinRestriction")] = web::json::value::string(
-            joinRestrictionToString.payload()
-            );
-    }
+        if (!m_sessionPropertiesKeywords.empty())
+        {
+            writer.key("keywords");
+            writer.begin_array();
+            for (const auto& keyword : m_sessionPropertiesKeywords)
+            {
+                writer.value(keyword);
+            }
+            writer.end_array();
+        }
 
-    if (m_readRestriction != multiplayer_session_restriction::unknown)
-    {
-        auto readRestrictionToString = multiplayer_session_states::_Convert_multiplayer_session_restriction_to_string(m_readRestriction);
-        jsonPropertiesSystem[_T("readRestriction")] = web::json::value::string(
-            readRestrictionToString.payload()
-            );
-    }
+        if (!m_sessionPropertiesTurns.empty())
+        {
+            writer.key("turn");
+            writer.begin_array();
+            for (uint32_t turn : m_sessionPropertiesTurns)
+            {
+                writer.value(turn);
+            }
+            writer.end_array();
+        }
 
-    if (m_writeClosed)
-    {
-        jsonPropertiesSystem[_T("closed")] = web::json::value(m_closed);
-    }
+        if (m_joinRestriction != multiplayer_session_restriction::unknown)
+        {
+            writer.member("joinRestriction", multiplayer_session_states::_Convert_multiplayer_session_restriction_to_string(m_joinRestriction).payload());
+        }
 
-    if (m_writeLocked)
-    {
-        jsonPropertiesSystem[_T("locked")] = web::json::value(m_locked);
-    }
+        if (m_readRestriction != multiplayer_session_restriction::unknown)
+        {
+            writer.member("readRestriction", multiplayer_session_states::_Convert_multiplayer_session_restriction_to_string(m_readRestriction).payload());
+        }
 
-    if (m_writeAllocateCloudCompute)
-    {
-        jsonPropertiesSystem[_T("allocateCloudCompute")] = web::json::value(m_allocateCloudCompute);
-    }
+        if (m_writeClosed)
+        {
+            writer.member("closed", m_closed);
+        }
 
-    if (m_writeMatchmakingClientResult || m_writeMatchmakingSessionConstants || m_writeMatchmakingServerConnectionPath)
-    {
-        jsonPropertiesSystem[_T("matchmaking")] = create_matchmaking_json();
-    }
+        if (m_writeLocked)
+        {
+            writer.member("locked", m_locked);
+        }
 
-    if (m_writeMatchmakingResubmit)
-    {
-        jsonPropertiesSystem[_T("matchmakingResubmit")] = web::json::value(m_matchmakingMatchResubmit);
-    }
+        if (m_writeAllocateCloudCompute)
+        {
+            writer.member("allocateCloudCompute", m_allocateCloudCompute);
+        }
 
-    if (m_writeInitializationStatus)
-    {
-        jsonPropertiesSystem[_T("initializationSucceeded")] = web::json::value(m_initializationSucceeded);
-    }
+        if (m_writeMatchmakingClientResult || m_writeMatchmakingSessionConstants || m_writeMatchmakingServerConnectionPath)
+        {
+            writer.key("matchmaking");
+            write_matchmaking(writer);
+        }
 
-    if (m_writeHostDeviceToken)
-    {
-        jsonPropertiesSystem[_T("host")] = web::json::value(m_hostDeviceToken);
-    }
+        if (m_writeMatchmakingResubmit)
+        {
+            writer.member("matchmakingResubmit", m_matchmakingMatchResubmit);
+        }
 
-    if (m_writeServerConnectionStringCandidates)
-    {
-        jsonPropertiesSystem[_T("serverConnectionStringCandidates")] = utils::serialize_vector<string_t>(
-            utils::json_string_serializer, 
-            m_serverConnectionStringCandidates
-            );
-    }
+        if (m_writeInitializationStatus)
+        {
+            writer.member("initializationSucceeded", m_initializationSucceeded);
+        }
 
-    if (!jsonPropertiesSystem.is_null())
-    {
-        jsonProperties[_T("system")] = jsonPropertiesSystem;
+        if (m_writeHostDeviceToken)
+        {
+            writer.member("host", m_hostDeviceToken);
+        }
+
+        if (m_writeServerConnectionStringCandidates)
+        {
+            writer.key("serverConnectionStringCandidates");
+            writer.begin_array();
+            for (const auto& candidate : m_serverConnectionStringCandidates)
+            {
+                writer.value(candidate);
+            }
+            writer.end_array();
+        }
+
+        writer.end_object();
     }
 
     if (!m_sessionPropertiesCustomProperties.is_null())
     {
-        jsonProperties[_T("custom")] = m_sessionPropertiesCustomProperties;
+        writer.key("custom");
+        writer.json_value(m_sessionPropertiesCustomProperties);
     }
-
-    return jsonProperties;
+    writer.end_object();
 }
 
-web::json::value 
-multiplayer_session_request::create_matchmaking_json()
+void
+multiplayer_session_request::write_matchmaking(
+    _Inout_ json_writer& writer
+    )
 {
-    web::json::value jsonMatchmaking;
+    // The service expects an explicit null when there is nothing to send
+    if (m_sessionPropertiesTargetSessionsConstants.is_null() && !m_writeMatchmakingServerConnectionPath)
+    {
+        writer.null_value();
+        return;
+    }
 
+    writer.begin_object();
     if (!m_sessionPropertiesTargetSessionsConstants.is_null())
     {
-        jsonMatchmaking[_T("targetSessionConstants")] = m_sessionPropertiesTargetSessionsConstants;
+        writer.key("targetSessionConstants");
+        writer.json_value(m_sessionPropertiesTargetSessionsConstants);
     }
 
     if (m_writeMatchmakingServerConnectionPath)
     {
-        jsonMatchmaking[_T("serverConnectionString")] = web::json::value::string(m_matchmakingServerConnectionPath);
+        writer.member("serverConnectionString", m_matchmakingServerConnectionPath);
     }
-
-    return jsonMatchmaking;
+    writer.end_object();
 }
 
-web::json::value
-multiplayer_session_request::create_role_types_json()
+void
+multiplayer_session_request::write_role_types(
+    _Inout_ json_writer& writer
+    )
 {
-    web::json::value serializedObject;
-    if (m_roleTypes.size() > 0)
+    writer.begin_object();
+    for (const auto& roleType : m_roleTypes)
     {
-        web::json::value roleTypeJson;
-        for (const auto& roleType : m_roleTypes)
+        writer.key(roleType.first);
+        writer.begin_object();
+        writer.key("roles");
+        const auto& roles = roleType.second.roles();
+        if (roles.empty())
+        {
+            writer.null_value();
+        }
+        else
         {
-            web::json::value rolesJson;
-            auto roles = roleType.second.roles();
+            writer.begin_object();
             for (const auto& role : roles)
             {
-                web::json::value roleJson;
-                auto roleInfo = role.second;
+                const auto& roleInfo = role.second;
+                writer.key(role.first);
+                if (roleInfo.max_members_count() == 0 && roleInfo.target_count() == 0)
+                {
+                    writer.null_value();
+                    continue;
+                }
+
+                writer.begin_object();
                 if (roleInfo.max_members_count() > 0)
                 {
-                    roleJson[_T("max")] = roleInfo.max_members_count();
+                    writer.member("max", roleInfo.max_members_count());
                 }
                 if (roleInfo.target_count() > 0)
                 {
-                    roleJson[_T("target")] = roleInfo.target_count();
+                    writer.member("target", roleInfo.target_count());
                 }
-                rolesJson[role.first] = roleJson;
+                writer.end_object();
             }
-            roleTypeJson[_T("roles")] = rolesJson;
-            serializedObject[roleType.first] = roleTypeJson;
+            writer.end_object();
         }
+        writer.end_object();
     }
-    return serializedObject;
+    writer.end_object();
 }
 
-web::json::value 
-multiplayer_session_request::serialize()
+void
+multiplayer_session_request::serialize(
+    _Inout_ json_writer& writer
+    )
 {
-    web::json::value serializedObject = web::json::value::object();
-    std::lock_guard<std::mutex> lock(m_lock.get()); 
+    std::lock_guard<std::mutex> lock(m_lock.get());
+    writer.begin_object();
 
     if (m_sessionConstants != nullptr)
     {
-        web::json::value sessionConstantsJson = m_sessionConstants->_Serialize(); 
+        web::json::value sessionConstantsJson = m_sessionConstants->_Serialize();
         if (!sessionConstantsJson.is_null())
         {
-            serializedObject[_T("constants")] = sessionConstantsJson;
+            writer.key("constants");
+            writer.json_value(sessionConstantsJson);
         }
     }
 
-    web::json::value roleTypesJson = create_role_types_json();
-    if (!roleTypesJson.is_null())
+    if (!m_roleTypes.empty())
+    {
+        writer.key("roleTypes");
+        write_role_types(writer);
+    }
+
+    if (has_system_properties() || !m_sessionPropertiesCustomProperties.is_null())
     {
-        serializedObject[_T("roleTypes")] = std::move(roleTypesJson);
+        writer.key("properties");
+        write_properties(writer);
     }
 
-    web::json::value jsonProperties = create_properties_json();
-    if (!jsonProperties.is_null())
+    bool writeMembers = m_bLeaveSession;
+    for (const auto& member : m_members)
     {
-        serializedObject[_T("properties")] = jsonProperties;
+        writeMembers = writeMembers || member->has_content();
     }
 
-    if (!m_members.empty() || m_bLeaveSession)
+    if (writeMembers)
     {
-        web::json::value memberListJson;
+        writer.key("members");
+        writer.begin_object();
         for (const auto& member : m_members)
         {
-            web::json::value memberJson = member->serialize();
-            if (!memberJson.is_null())
+            // "me" : null below replaces any pending write for the local member
+            if (!member->has_content() || (m_bLeaveSession && member->member_id() == _T("me")))
             {
-                memberListJson[member->member_id()] = memberJson;
+                continue;
             }
+            writer.key(member->member_id());
+            member->serialize(writer);
         }
 
         if (m_bLeaveSession)
         {
             // Write "me" : null to leave session.
-            memberListJson[_T("me")] = web::json::value();
-        }
-
-        if (!memberListJson.is_null())
-        {
-            serializedObject[_T("members")] = memberListJson;
+            writer.key("me");
+            writer.null_value();
         }
+        writer.end_object();
     }
 
     if (!m_servers.is_null())
     {
-        serializedObject[_T("servers")] = m_servers;
+        writer.key("servers");
+        writer.json_value(m_servers);
     }
 
-    return serializedObject;
+    writer.end_object();
 }
 NAMESPACE_MICROSOFT_XBOX_SERVICES_MULTIPLAYER_CPP_END
\ No newline at end of file
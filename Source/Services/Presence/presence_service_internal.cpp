@@ -73,10 +73,12 @@ presence_service_internal::set_presence(
         m_userContext->xbox_user_id()
         );
 
+    // The endpoint doesn't change for a context, so later heartbeats reuse the one their template was built for
+    auto requestTemplate = m_userContext->request_template(xbox_live_api::set_presence_helper);
     std::shared_ptr<http_call_internal> httpCall = xbox_system_factory::get_factory()->create_http_call(
         m_xboxLiveContextSettings,
         "POST",
-        utils::create_xboxlive_endpoint("userpresence", m_appConfig),
+        requestTemplate != nullptr ? requestTemplate->server_name() : utils::create_xboxlive_endpoint("userpresence", m_appConfig),
         utils::string_t_from_internal_string(pathAndQuery),
         xbox_live_api::set_presence_helper
         );
@@ -86,7 +88,7 @@ presence_service_internal::set_presence(
         std::move(presenceData)
         );
 
-    httpCall->set_request_body(utils::internal_string_from_string_t(request.serialize().serialize()));
+    httpCall->set_request_body(utils::json_serialize_utf8(request.serialize()));
     httpCall->set_xbox_contract_version_header_value(_T("3"));
 
     return httpCall->get_response_with_auth(
@@ -377,7 +379,7 @@ presence_service_internal::get_presence_for_multiple_users(
         false
         );
 
-    httpCall->set_request_body(utils::internal_string_from_string_t(request.serialize().serialize()));
+    httpCall->set_request_body(utils::json_serialize_utf8(request.serialize()));
     httpCall->set_xbox_contract_version_header_value(_T("3"));
 
     auto task = httpCall->get_response_with_auth(
@@ -439,7 +441,7 @@ presence_service_internal::get_presence_for_multiple_users(
         broadcastingOnly
         );
 
-    httpCall->set_request_body(utils::internal_string_from_string_t(request.serialize().serialize()));
+    httpCall->set_request_body(utils::json_serialize_utf8(request.serialize()));
     httpCall->set_xbox_contract_version_header_value(_T("3"));
 
     auto task = httpCall->get_response_with_auth(
@@ -551,7 +553,7 @@ presence_service_internal::get_presence_for_social_group(
         broadcastingOnly
         );
 
-    httpCall->set_request_body(utils::internal_string_from_string_t(request.serialize().serialize()));
+    httpCall->set_request_body(utils::json_serialize_utf8(request.serialize()));
     httpCall->set_xbox_contract_version_header_value(_T("3"));
 
     auto task = httpCall->get_response_with_auth(
@@ -11,6 +11,8 @@
 #include "web_socket_client.h"
 #include "utils.h"
 #include "xbox_live_app_config_internal.h"
+#include "json_writer.h"
+#include "mem_pool.h"
 using namespace pplx;
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_RTA_CPP_BEGIN
@@ -146,6 +148,18 @@ real_time_activity_service::activate()
             }
         });
 
+        // Binary frames carry the same UTF-8 JSON messages as text frames
+        m_webSocketConnection->set_binary_received_handler([thisWeakPtr](xsapi_internal_vector<uint8_t> payload)
+        {
+            std::shared_ptr<real_time_activity_service> pThis(thisWeakPtr.lock());
+            if (pThis != nullptr)
+            {
+                pThis->on_socket_message_received(xsapi_internal_string(payload.begin(), payload.end()));
+            }
+        });
+
+        // Change events are mostly repeated JSON keys and compress well, so offer permessage-deflate whenever the transport can inflate it
+        m_webSocketConnection->request_compression();
         m_webSocketConnection->ensure_connected();
     }
 }
@@ -467,7 +481,15 @@ real_time_activity_service::on_socket_message_received(
     _In_ const xsapi_internal_string& message
     )
 {
-    auto msgJson = web::json::value::parse(utils::string_t_from_internal_string(message));
+    system::xsapi_memory_subsystem_scope memoryScope(system::xsapi_memory_subsystem::rta, __FUNCTION__);
+    std::error_code errc;
+    auto msgJson = utils::json_parse_utf8(message, errc);
+    if (errc)
+    {
+        LOGS_ERROR << "Malformed RTA message: " << message;
+        return;
+    }
+
     real_time_activity_message_type messageType = static_cast<real_time_activity_message_type>(msgJson[0].as_integer());
 
     switch (messageType)
@@ -628,6 +650,7 @@ real_time_activity_service::_Add_subscription(
 void
 real_time_activity_service::submit_subscriptions()
 {
+    json_writer request;
     while (m_webSocketConnection != nullptr && !m_pendingSubmission.empty())
     {
         auto subscription = m_pendingSubmission.back();
@@ -635,12 +658,14 @@ real_time_activity_service::submit_subscriptions()
         int sequenceNumber = utils::interlocked_increment(m_sequenceNumber);
         m_pendingResponseSubscriptions[sequenceNumber] = subscription;
 
-        web::json::value request;
-        request[0] = static_cast<uint32_t>(real_time_activity_message_type::subscribe);
-        request[1] = sequenceNumber;
-        request[2] = web::json::value(subscription->resource_uri());
+        request.reset();
+        request.begin_array();
+        request.value(static_cast<uint32_t>(real_time_activity_message_type::subscribe));
+        request.value(sequenceNumber);
+        request.value(subscription->resource_uri());
+        request.end_array();
 
-        m_webSocketConnection->send(utils::internal_string_from_string_t(request.serialize()));
+        m_webSocketConnection->send(request.output());
     }
 }
 
@@ -672,12 +697,14 @@ real_time_activity_service::_Remove_subscription(
             subscriptionIter->_Set_state(real_time_activity_subscription_state::pending_unsubscribe);
             m_pendingUnsubscriptions[sequenceNumber] = subscriptionIter;
 
-            web::json::value request;
-            request[0] = static_cast<uint32_t>(real_time_activity_message_type::unsubscribe);
-            request[1] = sequenceNumber;
-            request[2] = subscriptionId;
+            json_writer request;
+            request.begin_array();
+            request.value(static_cast<uint32_t>(real_time_activity_message_type::unsubscribe));
+            request.value(sequenceNumber);
+            request.value(subscriptionId);
+            request.end_array();
 
-            m_webSocketConnection->send(utils::internal_string_from_string_t(request.serialize()));
+            m_webSocketConnection->send(request.output());
         }
     }
     else if(subscription->state() == real_time_activity_subscription_state::pending_subscribe)
@@ -95,38 +95,28 @@ void peoplehub_service::get_social_graph(
         }
 
         postJSON[_T("xuids")] = xuidJSON;
-        httpCall->set_request_body(utils::internal_string_from_string_t(postJSON.serialize()));
+        httpCall->set_request_body(utils::json_serialize_utf8(postJSON));
     }
 
     auto task = httpCall->get_response_with_auth(m_userContext,
-        http_call_response_body_type::json_body,
+        http_call_response_body_type::string_body,
         false,
         queue,
         [callback](std::shared_ptr<http_call_response_internal> response)
     {
+        // Social graphs are the largest documents we receive, so they are read straight from the body without a DOM
         std::error_code errc = xbox_live_error_code::no_error;
-        web::json::value peopleArray = utils::extract_json_field(
-            response->response_body_json(),
-            "people",
-            errc,
-            false
-            );
-
-        if (errc)
+        xsapi_internal_vector<xbox_social_user> socialUserVec;
+        if (!response->err_code())
         {
-            callback(xbox_live_result<xsapi_internal_vector<xbox_social_user>>(
-                response->err_code(),
-                response->err_message().data()
-                ));
-            return;
+            json_reader reader(response->response_body_string());
+            if (!xbox_social_user_reader::read_people(reader, socialUserVec))
+            {
+                LOGS_DEBUG << "Malformed peoplehub response at offset " << reader.position();
+                errc = xbox_live_error_code::json_error;
+            }
         }
 
-        xsapi_internal_vector<xbox_social_user> socialUserVec = utils::extract_json_vector_internal<xbox_social_user>(
-            xbox_social_user::_Deserialize,
-            peopleArray,
-            errc,
-            false
-            );
         auto it = response->response_headers().find("x-xbl-servicedefault");
         if (it != response->response_headers().end())
         {
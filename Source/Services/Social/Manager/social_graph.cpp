@@ -263,7 +263,7 @@ social_graph::schedule_event_work()
 {
     std::weak_ptr<social_graph> thisWeak = shared_from_this();
 
-    AsyncBlock* async = new (xsapi_memory::mem_alloc(sizeof(AsyncBlock))) AsyncBlock{};
+    AsyncBlock* async = utils::allocate_async_block();
     async->context = utils::store_weak_ptr(thisWeak);
     async->queue = m_backgroundAsyncQueue;
     async->callback = [](AsyncBlock* async)
@@ -273,7 +273,7 @@ social_graph::schedule_event_work()
         {
             pThis->schedule_event_work();
         }
-        xsapi_memory::mem_free(async);
+        utils::free_async_block(async);
     };
 
     BeginAsync(async, utils::store_weak_ptr(thisWeak), nullptr, __FUNCTION__,
@@ -996,11 +996,11 @@ social_graph::setup_device_and_presence_subscriptions(
     _In_ const xsapi_internal_vector<uint64_t>& users
 )
 {
-    AsyncBlock* async = new (xsapi_memory::mem_alloc(sizeof(AsyncBlock))) AsyncBlock{};
+    AsyncBlock* async = utils::allocate_async_block();
     async->queue = m_backgroundAsyncQueue;
     async->callback = [](AsyncBlock* asyncBlock)
     {
-        xsapi_memory::mem_free(asyncBlock);
+        utils::free_async_block(asyncBlock);
     };
 
     auto context = utils::store_shared_ptr(xsapi_allocate_shared<social_graph_context>(users, shared_from_this()));
@@ -1027,11 +1027,11 @@ social_graph::unsubscribe_users(
     _In_ const xsapi_internal_vector<uint64_t>& users
     )
 {
-    AsyncBlock* async = new (xsapi_memory::mem_alloc(sizeof(AsyncBlock))) AsyncBlock{};
+    AsyncBlock* async = utils::allocate_async_block();
     async->queue = m_backgroundAsyncQueue;
     async->callback = [](AsyncBlock* asyncBlock)
     {
-        xsapi_memory::mem_free(asyncBlock);
+        utils::free_async_block(asyncBlock);
     };
 
     auto context = utils::store_shared_ptr(xsapi_allocate_shared<social_graph_context>(users, shared_from_this()));
@@ -1363,7 +1363,7 @@ void social_graph::schedule_social_graph_refresh()
 #if UWP_API || TV_API || UNIT_TEST_SERVICES
     std::weak_ptr<social_graph> thisWeakPtr = shared_from_this();
 
-    AsyncBlock* async = new (xsapi_memory::mem_alloc(sizeof(AsyncBlock))) AsyncBlock{};
+    AsyncBlock* async = utils::allocate_async_block();
     async->queue = m_backgroundAsyncQueue;
     async->context = utils::store_weak_ptr(thisWeakPtr);
     async->callback = [](AsyncBlock* async) 
@@ -1373,7 +1373,7 @@ void social_graph::schedule_social_graph_refresh()
         {
             pThis->schedule_social_graph_refresh();
         }
-        xsapi_memory::mem_free(async);
+        utils::free_async_block(async);
     };
     BeginAsync(async, utils::store_weak_ptr(thisWeakPtr), nullptr, __FUNCTION__,
         [](AsyncOp op, const AsyncProviderData* data)
@@ -1668,7 +1668,7 @@ social_graph::schedule_presence_refresh()
 #if UWP_API || TV_API || UNIT_TEST_SERVICES
     std::weak_ptr<social_graph> thisWeakPtr = shared_from_this();
 
-    AsyncBlock* async = new (xsapi_memory::mem_alloc(sizeof(AsyncBlock))) AsyncBlock{};
+    AsyncBlock* async = utils::allocate_async_block();
     async->queue = m_backgroundAsyncQueue;
     async->context = utils::store_weak_ptr(thisWeakPtr);
     async->callback = [](AsyncBlock* async)
@@ -1678,7 +1678,7 @@ social_graph::schedule_presence_refresh()
         {
             pThis->schedule_presence_refresh();
         }
-        xsapi_memory::mem_free(async);
+        utils::free_async_block(async);
     };
     BeginAsync(async, utils::store_weak_ptr(thisWeakPtr), nullptr, __FUNCTION__,
         [](AsyncOp op, const AsyncProviderData* data)
@@ -3,6 +3,7 @@
 
 #include "pch.h"
 #include "social_manager_internal.h"
+#include "mem_pool.h"
 #if UNIT_TEST_SERVICES
 #include "MockSocialManager.h"
 #endif
@@ -399,6 +400,7 @@ social_manager_internal::remove_local_user(
 xsapi_internal_vector<std::shared_ptr<social_event_internal>>
 social_manager_internal::do_work()
 {
+    xsapi_memory_subsystem_scope memoryScope(xsapi_memory_subsystem::social, __FUNCTION__);
     std::lock_guard<std::recursive_mutex> lock(m_socialMangerLock);
     std::lock_guard<std::recursive_mutex> eventLock(m_socialManagerEventLock);
     xsapi_internal_vector<std::shared_ptr<social_event_internal>> socialEvents(m_eventQueue);
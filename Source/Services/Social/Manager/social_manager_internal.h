@@ -16,6 +16,7 @@
 #include "perf_tester.h"
 #include "call_buffer_timer.h"
 #include "presence_internal.h"
+#include "json_deserializer.h"
 
 typedef unsigned char byte;
 
@@ -344,6 +345,28 @@ private:
     xbox::services::system::xbox_live_mutex m_eventGraphMutex;
 };
 
+/// <summary>
+/// Streams peoplehub documents straight into xbox_social_user objects without building a web::json::value.
+/// Each type's members are dispatched through a json_field table declared next to its reader.
+/// </summary>
+class xbox_social_user_reader
+{
+public:
+    /// <summary>
+    /// Reads the "people" array of a peoplehub response, skipping every other member of the document.
+    /// </summary>
+    static bool read_people(
+        _Inout_ xbox::services::json_reader& reader,
+        _Inout_ xsapi_internal_vector<xbox_social_user>& people
+        );
+
+    static bool read_user(_Inout_ xbox::services::json_reader& reader, _Inout_ xbox_social_user& user);
+    static bool read_preferred_color(_Inout_ xbox::services::json_reader& reader, _Inout_ preferred_color& color);
+    static bool read_title_history(_Inout_ xbox::services::json_reader& reader, _Inout_ title_history& titleHistory);
+    static bool read_presence_details(_Inout_ xbox::services::json_reader& reader, _Inout_ social_manager_presence_record& presenceRecord);
+    static bool read_presence_title_record(_Inout_ xbox::services::json_reader& reader, _Inout_ social_manager_presence_title_record& titleRecord);
+};
+
 class peoplehub_service
 {
 public:
@@ -562,11 +585,11 @@ protected:
         context->result = result;
         context->callback = callback;
 
-        AsyncBlock* async = new (xbox::services::system::xsapi_memory::mem_alloc(sizeof(AsyncBlock))) AsyncBlock{};
+        AsyncBlock* async = utils::allocate_async_block();
         async->queue = m_backgroundAsyncQueue;
         async->callback = [](AsyncBlock* asyncBlock)
         {
-            xsapi_memory::mem_free(asyncBlock);
+            utils::free_async_block(asyncBlock);
         };
 
         BeginAsync(async, utils::store_shared_ptr(context), nullptr, __FUNCTION__,
@@ -0,0 +1,206 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "pch.h"
+#include "xsapi/social_manager.h"
+#include "social_manager_internal.h"
+
+using namespace xbox::services;
+using namespace xbox::services::presence;
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_SOCIAL_MANAGER_CPP_BEGIN
+
+bool
+xbox_social_user_reader::read_people(
+    _Inout_ json_reader& reader,
+    _Inout_ xsapi_internal_vector<xbox_social_user>& people
+    )
+{
+    if (reader.next() != json_token::begin_object)
+    {
+        return false;
+    }
+
+    while (reader.next() == json_token::key)
+    {
+        if (!reader.string_equals("people"))
+        {
+            if (!reader.skip_value())
+            {
+                return false;
+            }
+            continue;
+        }
+
+        reader.next();
+        bool succeeded = json_read_array(reader, [&people](json_reader& elementReader)
+        {
+            people.push_back(xbox_social_user());
+            return read_user(elementReader, people.back());
+        });
+        if (!succeeded)
+        {
+            return false;
+        }
+    }
+
+    return reader.token() == json_token::end_object;
+}
+
+bool
+xbox_social_user_reader::read_user(
+    _Inout_ json_reader& reader,
+    _Inout_ xbox_social_user& user
+    )
+{
+    static const json_field<xbox_social_user> s_fields[] =
+    {
+        { "xuid", [](json_reader& r, xbox_social_user& u)
+        {
+            u.m_xboxUserIdAsInt = r.token() == json_token::string ? strtoull(r.string_value().c_str(), nullptr, 10) : 0;
+            return json_read_value(r, u.m_xboxUserId);
+        } },
+        { "isFavorite", [](json_reader& r, xbox_social_user& u) { return json_read_value(r, u.m_isFavorite); } },
+        { "isFollowedByCaller", [](json_reader& r, xbox_social_user& u) { return json_read_value(r, u.m_isFollowedByCaller); } },
+        { "isFollowingCaller", [](json_reader& r, xbox_social_user& u) { return json_read_value(r, u.m_isFollowingCaller); } },
+        { "displayName", [](json_reader& r, xbox_social_user& u) { return json_read_value(r, u.m_displayName); } },
+        { "realName", [](json_reader& r, xbox_social_user& u) { return json_read_value(r, u.m_realName); } },
+        { "displayPicRaw", [](json_reader& r, xbox_social_user& u) { return json_read_value(r, u.m_displayPicUrlRaw); } },
+        { "useAvatar", [](json_reader& r, xbox_social_user& u) { return json_read_value(r, u.m_useAvatar); } },
+        { "gamertag", [](json_reader& r, xbox_social_user& u) { return json_read_value(r, u.m_gamertag); } },
+        { "gamerScore", [](json_reader& r, xbox_social_user& u) { return json_read_value(r, u.m_gamerscore); } },
+        { "presenceState", [](json_reader& r, xbox_social_user& u)
+        {
+            if (r.token() == json_token::string)
+            {
+                u.m_presenceRecord.m_userState = presence_record_internal::convert_string_to_user_presence_state(r.string_value());
+            }
+            return r.skip_value();
+        } },
+        { "presenceDetails", [](json_reader& r, xbox_social_user& u) { return read_presence_details(r, u.m_presenceRecord); } },
+        { "preferredColor", [](json_reader& r, xbox_social_user& u) { return read_preferred_color(r, u.m_preferredColor); } },
+        { "titleHistory", [](json_reader& r, xbox_social_user& u) { return read_title_history(r, u.m_titleHistory); } },
+    };
+
+    // Matches the DOM path, which converts an absent presenceState
+    user.m_presenceRecord.m_userState = presence_record_internal::convert_string_to_user_presence_state(xsapi_internal_string());
+
+    if (!json_read_object(reader, user, s_fields))
+    {
+        return false;
+    }
+
+    for (const auto& titleRecord : user.m_presenceRecord.m_presenceVec)
+    {
+        if (!titleRecord._Is_null() && titleRecord.is_title_active())
+        {
+            user.m_presenceRecord.m_userState = user_presence_state::online;
+        }
+    }
+    user.m_presenceRecord._Set_xbox_user_id(user.m_xboxUserIdAsInt);
+    return true;
+}
+
+bool
+xbox_social_user_reader::read_preferred_color(
+    _Inout_ json_reader& reader,
+    _Inout_ preferred_color& color
+    )
+{
+    static const json_field<preferred_color> s_fields[] =
+    {
+        { "primaryColor", [](json_reader& r, preferred_color& c) { return json_read_value(r, c.m_primaryColor); } },
+        { "secondaryColor", [](json_reader& r, preferred_color& c) { return json_read_value(r, c.m_secondaryColor); } },
+        { "tertiaryColor", [](json_reader& r, preferred_color& c) { return json_read_value(r, c.m_tertiaryColor); } },
+    };
+
+    return json_read_object(reader, color, s_fields);
+}
+
+bool
+xbox_social_user_reader::read_title_history(
+    _Inout_ json_reader& reader,
+    _Inout_ title_history& titleHistory
+    )
+{
+    static const json_field<title_history> s_fields[] =
+    {
+        { "LastTimePlayed", [](json_reader& r, title_history& t)
+        {
+            if (r.token() == json_token::string)
+            {
+                t.m_lastTimeUserPlayed = utility::datetime::from_string(
+                    utils::string_t_from_internal_string(r.string_value()),
+                    utility::datetime::date_format::ISO_8601
+                    );
+                t.m_userHasPlayed = t.m_lastTimeUserPlayed.to_interval() != 0;
+            }
+            return r.skip_value();
+        } },
+        { "TitleId", [](json_reader& r, title_history& t) { return json_read_value(r, t.m_titleId); } },
+    };
+
+    return json_read_object(reader, titleHistory, s_fields);
+}
+
+bool
+xbox_social_user_reader::read_presence_details(
+    _Inout_ json_reader& reader,
+    _Inout_ social_manager_presence_record& presenceRecord
+    )
+{
+    uint32_t index = 0;
+    return json_read_array(reader, [&presenceRecord, &index](json_reader& elementReader)
+    {
+        // Records past NUM_PRESENCE_RECORDS are dropped, as in the DOM path
+        if (index >= NUM_PRESENCE_RECORDS)
+        {
+            return elementReader.skip_value();
+        }
+        return read_presence_title_record(elementReader, presenceRecord.m_presenceVec[index++]);
+    });
+}
+
+bool
+xbox_social_user_reader::read_presence_title_record(
+    _Inout_ json_reader& reader,
+    _Inout_ social_manager_presence_title_record& titleRecord
+    )
+{
+    static const json_field<social_manager_presence_title_record> s_fields[] =
+    {
+        { "Device", [](json_reader& r, social_manager_presence_title_record& t)
+        {
+            if (r.token() == json_token::string)
+            {
+                t.m_deviceType = presence_device_record_internal::convert_string_to_presence_device_type(r.string_value());
+            }
+            return r.skip_value();
+        } },
+        { "PresenceText", [](json_reader& r, social_manager_presence_title_record& t) { return json_read_value(r, t.m_presenceText); } },
+        { "State", [](json_reader& r, social_manager_presence_title_record& t)
+        {
+            t.m_isTitleActive = r.token() == json_token::string && utils::str_icmp(r.string_value(), "active") == 0;
+            return r.skip_value();
+        } },
+        { "TitleId", [](json_reader& r, social_manager_presence_title_record& t)
+        {
+            if (r.token() == json_token::string)
+            {
+                t.m_titleId = static_cast<uint32_t>(strtoul(r.string_value().c_str(), nullptr, 10));
+            }
+            return r.skip_value();
+        } },
+    };
+
+    if (reader.token() == json_token::null)
+    {
+        return true;
+    }
+
+    titleRecord.m_deviceType = presence_device_record_internal::convert_string_to_presence_device_type(xsapi_internal_string());
+    titleRecord.m_isNull = false;
+    return json_read_object(reader, titleRecord, s_fields);
+}
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_SOCIAL_MANAGER_CPP_END
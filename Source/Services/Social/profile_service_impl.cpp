@@ -86,7 +86,7 @@ _XSAPIIMP xbox_live_result<void> profile_service_impl::get_user_profiles(
     request[_T("userIds")] = utils::serialize_vector<xsapi_internal_string>(utils::json_internal_string_serializer, xboxUserIds);
     request[_T("settings")] = SETTINGS_SERIALIZED;
 
-    httpCall->set_request_body(utils::internal_string_from_string_t(request.serialize()));
+    httpCall->set_request_body(utils::json_serialize_utf8(request));
 
     httpCall->get_response_with_auth(
         m_userContext,
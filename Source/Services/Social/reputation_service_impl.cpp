@@ -57,7 +57,7 @@ xbox_live_result<void> reputation_service_impl::submit_reputation_feedback(
         );
 
     web::json::value request = reputationFeedbackRequest.serialize_feedback_request();
-    httpCall->set_request_body(utils::internal_string_from_string_t(request.serialize()));
+    httpCall->set_request_body(utils::json_serialize_utf8(request));
 
     httpCall->get_response_with_auth(
         m_userContext, 
@@ -104,7 +104,7 @@ xbox_live_result<void> reputation_service_impl::submit_batch_reputation_feedback
     std::error_code err;
     web::json::value request = reputation_feedback_request::serialize_batch_feedback_request(feedbackItems, err);
     RETURN_CPP_INVALIDARGUMENT_IF(err, void, "Invalid reputation_feedback_item");
-    httpCall->set_request_body(utils::internal_string_from_string_t(request.serialize()));
+    httpCall->set_request_body(utils::json_serialize_utf8(request));
 
     httpCall->get_response_with_auth(
         m_userContext, 
@@ -11,6 +11,7 @@
 #include <iostream>
 #include "xsapi/mem.h"
 #include "call_buffer_timer.h"
+#include "json_writer.h"
 
 namespace xbox { namespace services { namespace stats { namespace manager { 
 
@@ -83,7 +84,7 @@ public:
 
     void set_revision_from_clock();
 
-    web::json::value serialize();
+    void serialize(_Inout_ json_writer& writer) const;
     
     bool is_dirty() const;
 
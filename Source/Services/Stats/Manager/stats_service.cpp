@@ -38,15 +38,21 @@ simplified_stats_service::update_stats_value_document(
         false
         );
 
-    std::shared_ptr<http_call> httpCall = xbox::services::system::xbox_system_factory::get_factory()->create_http_call(
+    // The endpoint doesn't change for a context, so later uploads reuse the one their template was built for
+    auto requestTemplate = m_userContext->request_template(xbox_live_api::update_stats_value_document);
+    std::shared_ptr<http_call_internal> internalHttpCall = xbox::services::system::xbox_system_factory::get_factory()->create_http_call(
         m_xboxLiveContextSettings,
-        _T("POST"),
-        utils::create_xboxlive_endpoint(_T("statswrite"), m_appConfig),
+        "POST",
+        requestTemplate != nullptr ? requestTemplate->server_name() : utils::internal_string_from_string_t(utils::create_xboxlive_endpoint(_T("statswrite"), m_appConfig)),
         pathAndQuery,
         xbox_live_api::update_stats_value_document
         );
 
-    httpCall->set_request_body(statsDocToPost.serialize());
+    json_writer writer;
+    statsDocToPost.serialize(writer);
+    internalHttpCall->set_request_body(writer.output());
+
+    std::shared_ptr<http_call> httpCall = internalHttpCall;
 
     auto task = httpCall->get_response_with_auth(m_userContext, http_call_response_body_type::json_body)
     .then([](std::shared_ptr<http_call_response> response)
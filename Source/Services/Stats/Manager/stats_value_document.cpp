@@ -192,28 +192,43 @@ stats_value_document::merge_stat_value_documents(
     m_state = svd_state::loaded;
 }
 
-web::json::value
-stats_value_document::serialize()
+void
+stats_value_document::serialize(
+    _Inout_ json_writer& writer
+    ) const
 {
-    web::json::value requestJSON;
-    requestJSON[_T("$schema")] = web::json::value::string(_T("http://stats.xboxlive.com/2017-1/schema#"));
-    requestJSON[_T("revision")] = web::json::value::number(m_revision);
-    requestJSON[_T("previousRevision")] = web::json::value::number(m_previousRevision);
+    writer.begin_object();
+    writer.member("$schema", "http://stats.xboxlive.com/2017-1/schema#");
+    writer.member("revision", m_revision);
+    writer.member("previousRevision", m_previousRevision);
 #if TV_API
-    requestJSON[_T("timestamp")] = web::json::value(utils::datetime_to_string(utility::datetime::utc_now()));
+    writer.member("timestamp", utils::datetime_to_string(utility::datetime::utc_now()));
 #else
-    requestJSON[_T("timestamp")] = web::json::value(utility::datetime::utc_now().to_string(utility::datetime::ISO_8601));
+    writer.member("timestamp", utility::datetime::utc_now().to_string(utility::datetime::ISO_8601));
 #endif
-    auto& statsField = requestJSON[_T("stats")];
 
-    auto& titleField = statsField[_T("title")];
-    titleField = web::json::value::object();
-    for (auto& stat : m_statisticDocument)
+    writer.key("stats");
+    writer.begin_object();
+    writer.key("title");
+    writer.begin_object();
+    for (const auto& stat : m_statisticDocument)
     {
-        titleField[stat.first.c_str()] = stat.second.serialize();
+        writer.key(stat.first);
+        writer.begin_object();
+        if (stat.second.data_type() == stat_data_type::number)
+        {
+            writer.member("value", stat.second.as_number());
+        }
+        else if (stat.second.data_type() == stat_data_type::string)
+        {
+            writer.member("value", stat.second.as_string());
+        }
+        writer.end_object();
     }
+    writer.end_object();
+    writer.end_object();
 
-    return requestJSON;
+    writer.end_object();
 }
 
 xbox_live_result<stats_value_document>
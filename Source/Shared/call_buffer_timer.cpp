@@ -113,7 +113,7 @@ call_buffer_timer::fire_helper(
         m_previousTime = std::chrono::high_resolution_clock::now();
 
         auto contextSharedPtr = xsapi_allocate_shared<fire_context>(shared_from_this(), usersAddedStruct, m_usersToCall);
-        AsyncBlock* async = new (xsapi_memory::mem_alloc(sizeof(AsyncBlock))) AsyncBlock{};
+        AsyncBlock* async = utils::allocate_async_block();
         async->queue = m_queue;
         async->context = utils::store_shared_ptr(contextSharedPtr);
         async->callback = [](AsyncBlock* async)
@@ -131,7 +131,7 @@ call_buffer_timer::fire_helper(
                     pThis->fire_helper();
                 }
             }
-            xsapi_memory::mem_free(async);
+            utils::free_async_block(async);
         };
 
         BeginAsync(async, async->context, nullptr, __FUNCTION__,
@@ -0,0 +1,263 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "pch.h"
+#include "http_call_dispatcher.h"
+#include "utils.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
+
+http_call_priority default_http_call_priority(_In_ xbox_live_api xboxLiveApi)
+{
+    switch (xboxLiveApi)
+    {
+    // Multiplayer, matchmaking and game server calls that a player is waiting on in game
+    case xbox_live_api::allocate_cluster:
+    case xbox_live_api::allocate_cluster_inline:
+    case xbox_live_api::allocate_session_host:
+    case xbox_live_api::clear_activity:
+    case xbox_live_api::clear_search_handle:
+    case xbox_live_api::create_match_ticket:
+    case xbox_live_api::delete_match_ticket:
+    case xbox_live_api::get_current_session:
+    case xbox_live_api::get_current_session_by_handle:
+    case xbox_live_api::get_game_server_metadata:
+    case xbox_live_api::get_hopper_statistics:
+    case xbox_live_api::get_match_ticket_details:
+    case xbox_live_api::get_quality_of_service_servers:
+    case xbox_live_api::get_session_host_allocation_status:
+    case xbox_live_api::get_ticket_status:
+    case xbox_live_api::send_invites:
+    case xbox_live_api::set_activity:
+    case xbox_live_api::set_search_handle:
+    case xbox_live_api::set_transfer_handle:
+    case xbox_live_api::write_session_using_subpath:
+        return http_call_priority::gameplay_critical;
+
+    // Periodic flushes and bulk refreshes nobody is blocked on
+    case xbox_live_api::download_blob:
+    case xbox_live_api::get_activities_for_social_group:
+    case xbox_live_api::get_presence_for_social_group:
+    case xbox_live_api::get_quota:
+    case xbox_live_api::get_quota_for_session_storage:
+    case xbox_live_api::get_social_graph:
+    case xbox_live_api::get_social_relationships:
+    case xbox_live_api::get_user_profiles_for_social_group:
+    case xbox_live_api::set_presence_helper:
+    case xbox_live_api::submit_batch_reputation_feedback:
+    case xbox_live_api::submit_reputation_feedback:
+    case xbox_live_api::subscribe_to_notifications:
+    case xbox_live_api::update_achievement:
+    case xbox_live_api::update_stats_value_document:
+    case xbox_live_api::upload_blob:
+        return http_call_priority::background;
+
+    default:
+        return http_call_priority::interactive;
+    }
+}
+
+const char* http_call_priority_to_string(_In_ http_call_priority priority)
+{
+    switch (priority)
+    {
+    case http_call_priority::gameplay_critical: return "gameplay_critical";
+    case http_call_priority::interactive: return "interactive";
+    case http_call_priority::background: return "background";
+    default: return "unknown";
+    }
+}
+
+http_call_dispatcher::http_call_dispatcher(
+    _In_ http_call_perform_function performFunction,
+    _In_ http_call_failed_function failedFunction
+    ) :
+    m_performFunction(performFunction != nullptr ? performFunction : HCHttpCallPerformAsync),
+    m_failedFunction(failedFunction)
+{
+    m_limits[static_cast<uint32_t>(http_call_priority::gameplay_critical)] = DEFAULT_GAMEPLAY_CRITICAL_CONCURRENCY_LIMIT;
+    m_limits[static_cast<uint32_t>(http_call_priority::interactive)] = DEFAULT_INTERACTIVE_CONCURRENCY_LIMIT;
+    m_limits[static_cast<uint32_t>(http_call_priority::background)] = DEFAULT_BACKGROUND_CONCURRENCY_LIMIT;
+
+    for (uint32_t i = 0; i < HTTP_CALL_PRIORITY_COUNT; ++i)
+    {
+        m_inFlight[i] = 0;
+    }
+}
+
+http_call_dispatcher::~http_call_dispatcher()
+{
+    // Queued calls were never sent, but their owners are still waiting on a completion
+    for (uint32_t i = 0; i < HTTP_CALL_PRIORITY_COUNT; ++i)
+    {
+        while (!m_pending[i].empty())
+        {
+            pending_call call = m_pending[i].front();
+            m_pending[i].pop();
+            if (m_failedFunction != nullptr)
+            {
+                m_failedFunction(call.asyncBlock, E_ABORT);
+            }
+        }
+    }
+}
+
+std::shared_ptr<http_call_dispatcher> http_call_dispatcher::get_singleton_instance()
+{
+    auto xsapiSingleton = get_xsapi_singleton();
+    std::lock_guard<std::mutex> guard(xsapiSingleton->m_singletonLock);
+    if (xsapiSingleton->m_httpCallDispatcherSingleton == nullptr)
+    {
+        xsapiSingleton->m_httpCallDispatcherSingleton = xsapi_allocate_shared<http_call_dispatcher>(
+            HCHttpCallPerformAsync,
+            http_call_impl::on_perform_failed
+            );
+    }
+    return xsapiSingleton->m_httpCallDispatcherSingleton;
+}
+
+void http_call_dispatcher::set_concurrency_limit(
+    _In_ http_call_priority priority,
+    _In_ uint32_t limit
+    )
+{
+    uint32_t index = static_cast<uint32_t>(priority);
+    xsapi_internal_vector<pending_call> ready;
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_limits[index] = limit;
+
+        // Raising the limit may free slots for calls that are already waiting
+        while (!m_pending[index].empty() && has_free_slot(index))
+        {
+            ready.push_back(m_pending[index].front());
+            m_pending[index].pop();
+            ++m_inFlight[index];
+            m_inFlightCalls[ready.back().asyncBlock] = index;
+        }
+    }
+    start(index, ready);
+}
+
+uint32_t http_call_dispatcher::concurrency_limit(_In_ http_call_priority priority) const
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_limits[static_cast<uint32_t>(priority)];
+}
+
+bool http_call_dispatcher::perform(
+    _In_ http_call_priority priority,
+    _Inout_ AsyncBlock* asyncBlock,
+    _In_ hc_call_handle_t callHandle
+    )
+{
+    uint32_t index = static_cast<uint32_t>(priority);
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        if (!has_free_slot(index))
+        {
+            m_pending[index].push(pending_call{ asyncBlock, callHandle });
+            return false;
+        }
+        ++m_inFlight[index];
+        m_inFlightCalls[asyncBlock] = index;
+    }
+
+    return start(index, pending_call{ asyncBlock, callHandle });
+}
+
+void http_call_dispatcher::on_complete(_In_ AsyncBlock* asyncBlock)
+{
+    uint32_t index = 0;
+    xsapi_internal_vector<pending_call> ready;
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        auto iter = m_inFlightCalls.find(asyncBlock);
+        if (iter == m_inFlightCalls.end())
+        {
+            return;
+        }
+        index = iter->second;
+        m_inFlightCalls.erase(iter);
+        release(index, ready);
+    }
+    start(index, ready);
+}
+
+uint32_t http_call_dispatcher::in_flight_count(_In_ http_call_priority priority) const
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_inFlight[static_cast<uint32_t>(priority)];
+}
+
+size_t http_call_dispatcher::queued_count(_In_ http_call_priority priority) const
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_pending[static_cast<uint32_t>(priority)].size();
+}
+
+bool http_call_dispatcher::has_free_slot(_In_ uint32_t index) const
+{
+    return m_limits[index] == 0 || m_inFlight[index] < m_limits[index];
+}
+
+void http_call_dispatcher::release(
+    _In_ uint32_t index,
+    _Inout_ xsapi_internal_vector<pending_call>& ready
+    )
+{
+    if (m_inFlight[index] > 0)
+    {
+        --m_inFlight[index];
+    }
+
+    if (!m_pending[index].empty() && has_free_slot(index))
+    {
+        ready.push_back(m_pending[index].front());
+        m_pending[index].pop();
+        ++m_inFlight[index];
+        m_inFlightCalls[ready.back().asyncBlock] = index;
+    }
+}
+
+bool http_call_dispatcher::start(
+    _In_ uint32_t index,
+    _In_ const pending_call& call
+    )
+{
+    // Perform outside the lock in case libHttpClient completes the call inline
+    HRESULT hr = m_performFunction(call.asyncBlock, call.callHandle);
+    if (SUCCEEDED(hr))
+    {
+        return true;
+    }
+
+    LOGS_ERROR << "Failed to start " << http_call_priority_to_string(static_cast<http_call_priority>(index)) << " HTTP call: " << hr;
+    xsapi_internal_vector<pending_call> ready;
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_inFlightCalls.erase(call.asyncBlock);
+        release(index, ready);
+    }
+
+    if (m_failedFunction != nullptr)
+    {
+        m_failedFunction(call.asyncBlock, hr);
+    }
+    start(index, ready);
+    return false;
+}
+
+void http_call_dispatcher::start(
+    _In_ uint32_t index,
+    _In_ const xsapi_internal_vector<pending_call>& calls
+    )
+{
+    for (const auto& call : calls)
+    {
+        LOGS_DEBUG << "Dispatching queued " << http_call_priority_to_string(static_cast<http_call_priority>(index)) << " HTTP call";
+        start(index, call);
+    }
+}
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
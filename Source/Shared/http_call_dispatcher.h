@@ -0,0 +1,93 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#pragma once
+#include "http_call_impl.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
+
+const uint32_t HTTP_CALL_PRIORITY_COUNT = static_cast<uint32_t>(http_call_priority::background) + 1;
+const uint32_t DEFAULT_GAMEPLAY_CRITICAL_CONCURRENCY_LIMIT = 0; // unlimited
+const uint32_t DEFAULT_INTERACTIVE_CONCURRENCY_LIMIT = 8;
+const uint32_t DEFAULT_BACKGROUND_CONCURRENCY_LIMIT = 2;
+
+/// <summary>
+/// Returns the priority class a call to an xbox_live_api is dispatched with unless the caller overrides it.
+/// </summary>
+http_call_priority default_http_call_priority(_In_ xbox_live_api xboxLiveApi);
+
+const char* http_call_priority_to_string(_In_ http_call_priority priority);
+
+typedef HRESULT (*http_call_perform_function)(_Inout_ AsyncBlock* asyncBlock, _In_ hc_call_handle_t callHandle);
+typedef void (*http_call_failed_function)(_Inout_ AsyncBlock* asyncBlock, _In_ HRESULT hr);
+
+/// <summary>
+/// Sits in front of HCHttpCallPerformAsync and limits how many calls of each priority class are in flight.
+/// Each class has its own limit and its own FIFO, so gameplay critical calls never queue behind
+/// interactive or background traffic.  Every call that was started must be matched by one on_complete.
+/// A call that could not be started, or was still queued when the dispatcher is destroyed, is handed to
+/// the failed function with the error instead.
+/// </summary>
+class http_call_dispatcher
+{
+public:
+    http_call_dispatcher(
+        _In_ http_call_perform_function performFunction = nullptr,
+        _In_ http_call_failed_function failedFunction = nullptr
+        );
+
+    ~http_call_dispatcher();
+
+    static std::shared_ptr<http_call_dispatcher> get_singleton_instance();
+
+    /// <summary>
+    /// Sets the maximum number of calls of a class in flight at once.  0 means unlimited.
+    /// </summary>
+    void set_concurrency_limit(
+        _In_ http_call_priority priority,
+        _In_ uint32_t limit
+        );
+
+    uint32_t concurrency_limit(_In_ http_call_priority priority) const;
+
+    /// <summary>
+    /// Starts the call now if its class has a free slot, otherwise queues it.  Returns true if the call was started.
+    /// Returns false if it was queued or failed to start.
+    /// </summary>
+    bool perform(
+        _In_ http_call_priority priority,
+        _Inout_ AsyncBlock* asyncBlock,
+        _In_ hc_call_handle_t callHandle
+        );
+
+    /// <summary>
+    /// Frees the slot held by a call and starts the next queued call of the class it was dispatched with.
+    /// Does nothing for a call the dispatcher did not start.
+    /// </summary>
+    void on_complete(_In_ AsyncBlock* asyncBlock);
+
+    uint32_t in_flight_count(_In_ http_call_priority priority) const;
+    size_t queued_count(_In_ http_call_priority priority) const;
+
+private:
+    struct pending_call
+    {
+        AsyncBlock* asyncBlock;
+        hc_call_handle_t callHandle;
+    };
+
+    bool has_free_slot(_In_ uint32_t index) const;
+    bool start(_In_ uint32_t index, _In_ const pending_call& call);
+    void start(_In_ uint32_t index, _In_ const xsapi_internal_vector<pending_call>& calls);
+    void release(_In_ uint32_t index, _Inout_ xsapi_internal_vector<pending_call>& ready);
+
+    http_call_perform_function m_performFunction;
+    http_call_failed_function m_failedFunction;
+    mutable std::mutex m_lock;
+    uint32_t m_limits[HTTP_CALL_PRIORITY_COUNT];
+    uint32_t m_inFlight[HTTP_CALL_PRIORITY_COUNT];
+    xsapi_internal_unordered_map<AsyncBlock*, uint32_t> m_inFlightCalls; // the class each started call holds a slot in
+    xsapi_internal_queue<pending_call> m_pending[HTTP_CALL_PRIORITY_COUNT];
+};
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
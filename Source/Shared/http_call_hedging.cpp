@@ -0,0 +1,252 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "pch.h"
+#include "http_call_hedging.h"
+#include "http_call_metrics.h"
+#include "utils.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
+
+http_call_hedging_policy::http_call_hedging_policy() :
+    m_latencyPercentile(DEFAULT_HEDGE_LATENCY_PERCENTILE),
+    m_minSampleCount(DEFAULT_HEDGE_MIN_SAMPLE_COUNT),
+    m_minDelay(DEFAULT_HEDGE_MIN_DELAY),
+    m_maxDelay(DEFAULT_HEDGE_MAX_DELAY),
+    m_budgetRatio(DEFAULT_HEDGE_BUDGET_RATIO),
+    m_budgetBurst(DEFAULT_HEDGE_BUDGET_BURST),
+    m_budgetTokens(DEFAULT_HEDGE_BUDGET_BURST),
+    m_hedgesSent(0),
+    m_hedgesWon(0)
+{
+    // Reads whose tail latency gates matchmaking and session joins
+    m_hedgedApis[static_cast<uint32_t>(xbox_live_api::get_current_session)] = true;
+    m_hedgedApis[static_cast<uint32_t>(xbox_live_api::get_match_ticket_details)] = true;
+    m_hedgedApis[static_cast<uint32_t>(xbox_live_api::get_hopper_statistics)] = true;
+}
+
+std::shared_ptr<http_call_hedging_policy> http_call_hedging_policy::get_singleton_instance()
+{
+    auto xsapiSingleton = get_xsapi_singleton();
+    std::lock_guard<std::mutex> guard(xsapiSingleton->m_singletonLock);
+    if (xsapiSingleton->m_httpCallHedgingPolicySingleton == nullptr)
+    {
+        xsapiSingleton->m_httpCallHedgingPolicySingleton = xsapi_allocate_shared<http_call_hedging_policy>();
+    }
+    return xsapiSingleton->m_httpCallHedgingPolicySingleton;
+}
+
+void http_call_hedging_policy::add_api(_In_ xbox_live_api xboxLiveApi)
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_hedgedApis[static_cast<uint32_t>(xboxLiveApi)] = true;
+}
+
+void http_call_hedging_policy::remove_api(_In_ xbox_live_api xboxLiveApi)
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_hedgedApis.erase(static_cast<uint32_t>(xboxLiveApi));
+}
+
+bool http_call_hedging_policy::is_api_hedged(_In_ xbox_live_api xboxLiveApi) const
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_hedgedApis.find(static_cast<uint32_t>(xboxLiveApi)) != m_hedgedApis.end();
+}
+
+void http_call_hedging_policy::set_latency_percentile(_In_ double percentile)
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_latencyPercentile = percentile;
+}
+
+void http_call_hedging_policy::set_min_sample_count(_In_ uint64_t sampleCount)
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_minSampleCount = sampleCount;
+}
+
+void http_call_hedging_policy::set_delay_bounds(
+    _In_ std::chrono::milliseconds minDelay,
+    _In_ std::chrono::milliseconds maxDelay
+    )
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_minDelay = minDelay;
+    m_maxDelay = maxDelay;
+}
+
+void http_call_hedging_policy::set_budget(
+    _In_ double budgetRatio,
+    _In_ uint32_t burst
+    )
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_budgetRatio = budgetRatio;
+    m_budgetBurst = burst;
+    m_budgetTokens = std::min(m_budgetTokens, m_budgetBurst);
+}
+
+std::chrono::milliseconds http_call_hedging_policy::hedge_delay(
+    _In_ const std::shared_ptr<http_call_data>& httpCallData
+    )
+{
+    if (httpCallData->xboxLiveContextSettings == nullptr ||
+        !httpCallData->xboxLiveContextSettings->use_http_request_hedging() ||
+        httpCallData->longHttpCall ||
+        utils::str_icmp(httpCallData->httpMethod, "GET") != 0)
+    {
+        return std::chrono::milliseconds::zero();
+    }
+
+    std::lock_guard<std::mutex> lock(m_lock);
+    if (m_hedgedApis.find(static_cast<uint32_t>(httpCallData->xboxLiveApi)) == m_hedgedApis.end())
+    {
+        return std::chrono::milliseconds::zero();
+    }
+
+    // Every eligible request earns a fraction of a hedge, which is what bounds the extra traffic
+    m_budgetTokens = std::min(m_budgetTokens + m_budgetRatio, m_budgetBurst);
+
+    auto metrics = http_call_metrics_internal::get_singleton_instance();
+    if (metrics->sample_count(httpCallData->xboxLiveApi) < m_minSampleCount)
+    {
+        return std::chrono::milliseconds::zero();
+    }
+
+    auto delay = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::microseconds(metrics->latency_at_percentile(httpCallData->xboxLiveApi, m_latencyPercentile))
+        );
+    return std::max(m_minDelay, std::min(delay, m_maxDelay));
+}
+
+bool http_call_hedging_policy::try_acquire_budget()
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    if (m_budgetTokens < 1.0)
+    {
+        return false;
+    }
+
+    m_budgetTokens -= 1.0;
+    ++m_hedgesSent;
+    return true;
+}
+
+void http_call_hedging_policy::record_hedge_won()
+{
+    ++m_hedgesWon;
+}
+
+void http_call_hedging_policy::reset()
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_budgetTokens = m_budgetBurst;
+    m_hedgesSent = 0;
+    m_hedgesWon = 0;
+}
+
+http_call_hedge_state::http_call_hedge_state() :
+    completed(false),
+    primaryAsyncBlock(nullptr),
+    hedgeAsyncBlock(nullptr)
+{
+}
+
+bool http_call_hedge_state::attach(
+    _In_ AsyncBlock* asyncBlock,
+    _In_ bool isHedge
+    )
+{
+    std::lock_guard<std::recursive_mutex> guard(lock);
+    if (completed)
+    {
+        return false;
+    }
+
+    (isHedge ? hedgeAsyncBlock : primaryAsyncBlock) = asyncBlock;
+    return true;
+}
+
+bool http_call_hedge_state::try_complete(_In_ AsyncBlock* asyncBlock)
+{
+    std::lock_guard<std::recursive_mutex> guard(lock);
+    if (completed)
+    {
+        return false;
+    }
+    completed = true;
+
+    AsyncBlock* other = asyncBlock == primaryAsyncBlock ? hedgeAsyncBlock : primaryAsyncBlock;
+    if (other != nullptr)
+    {
+        // The other block stays valid until its owner calls release, which needs this lock
+        CancelAsync(other);
+    }
+    return true;
+}
+
+void http_call_hedge_state::release(_In_ AsyncBlock* asyncBlock)
+{
+    std::lock_guard<std::recursive_mutex> guard(lock);
+    if (asyncBlock == primaryAsyncBlock)
+    {
+        primaryAsyncBlock = nullptr;
+    }
+    else if (asyncBlock == hedgeAsyncBlock)
+    {
+        hedgeAsyncBlock = nullptr;
+    }
+}
+
+std::shared_ptr<http_call_data> create_hedge_http_call_data(
+    _In_ const std::shared_ptr<http_call_data>& primary
+    )
+{
+    auto hedge = xsapi_allocate_shared<http_call_data>(
+        primary->xboxLiveContextSettings,
+        primary->httpMethod,
+        primary->serverName,
+        primary->pathQueryFragment,
+        primary->xboxLiveApi
+        );
+
+    hedge->firstCallStartTime = primary->firstCallStartTime;
+    hedge->hasPerformedRetryOn401 = primary->hasPerformedRetryOn401;
+    hedge->retryAllowed = primary->retryAllowed;
+    // The hedge is a second copy of the same attempt, not a retry
+    hedge->iterationNumber = primary->iterationNumber - 1;
+    hedge->longHttpCall = primary->longHttpCall;
+    hedge->httpTimeout = primary->httpTimeout;
+    hedge->userContext = primary->userContext;
+    hedge->xboxContractVersionHeaderValue = primary->xboxContractVersionHeaderValue;
+    hedge->contentTypeHeaderValue = primary->contentTypeHeaderValue;
+    hedge->httpCallResponseBodyType = primary->httpCallResponseBodyType;
+    hedge->requestBody = primary->requestBody;
+    hedge->requestHeaders = primary->requestHeaders;
+    hedge->addDefaultHeaders = primary->addDefaultHeaders;
+    hedge->requestTemplate = primary->requestTemplate;
+    hedge->queue = primary->queue;
+    hedge->callback = primary->callback;
+    hedge->isHedge = true;
+
+    for (const auto& header : hedge->requestHeaders)
+    {
+        bool allowTracing = header.first != AUTH_HEADER && header.first != SIG_HEADER;
+        HCHttpCallRequestSetHeader(hedge->callHandle, header.first.data(), header.second.data(), allowTracing);
+    }
+
+    if (hedge->requestBody.get_http_request_message_type() == http_request_message_type::vector_message)
+    {
+        const auto& body = hedge->requestBody.request_message_vector();
+        HCHttpCallRequestSetRequestBodyBytes(hedge->callHandle, body.data(), static_cast<uint32_t>(body.size()));
+    }
+    else if (!hedge->requestBody.request_message_string().empty())
+    {
+        HCHttpCallRequestSetRequestBodyString(hedge->callHandle, hedge->requestBody.request_message_string().data());
+    }
+
+    return hedge;
+}
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
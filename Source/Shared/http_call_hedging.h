@@ -0,0 +1,117 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#pragma once
+#include "http_call_impl.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
+
+const double DEFAULT_HEDGE_LATENCY_PERCENTILE = 95.0;
+const uint64_t DEFAULT_HEDGE_MIN_SAMPLE_COUNT = 20;
+const std::chrono::milliseconds DEFAULT_HEDGE_MIN_DELAY = std::chrono::milliseconds(10);
+const std::chrono::milliseconds DEFAULT_HEDGE_MAX_DELAY = std::chrono::milliseconds(2000);
+const double DEFAULT_HEDGE_BUDGET_RATIO = 0.05;
+const uint32_t DEFAULT_HEDGE_BUDGET_BURST = 10;
+
+/// <summary>
+/// Decides which calls get a hedged (duplicate) request and when.  The hedge delay for an API is derived
+/// from the latency percentile recorded by http_call_metrics_internal, and extra traffic is capped by a
+/// token bucket: every eligible request earns budget_ratio of a hedge, and each hedge spends a whole one.
+/// </summary>
+class http_call_hedging_policy
+{
+public:
+    http_call_hedging_policy();
+
+    static std::shared_ptr<http_call_hedging_policy> get_singleton_instance();
+
+    void add_api(_In_ xbox_live_api xboxLiveApi);
+    void remove_api(_In_ xbox_live_api xboxLiveApi);
+    bool is_api_hedged(_In_ xbox_live_api xboxLiveApi) const;
+
+    void set_latency_percentile(_In_ double percentile);
+    void set_min_sample_count(_In_ uint64_t sampleCount);
+    void set_delay_bounds(_In_ std::chrono::milliseconds minDelay, _In_ std::chrono::milliseconds maxDelay);
+    void set_budget(_In_ double budgetRatio, _In_ uint32_t burst);
+
+    /// <summary>
+    /// Returns the delay after which a hedge should be sent for this call, or zero if the call must not be hedged.
+    /// Only idempotent GETs on configured APIs are hedged, and only once enough latency samples exist.
+    /// </summary>
+    std::chrono::milliseconds hedge_delay(_In_ const std::shared_ptr<http_call_data>& httpCallData);
+
+    /// <summary>
+    /// Spends one hedge from the budget.  Returns false if the budget is exhausted.
+    /// </summary>
+    bool try_acquire_budget();
+
+    void record_hedge_won();
+
+    uint64_t hedges_sent() const { return m_hedgesSent; }
+    uint64_t hedges_won() const { return m_hedgesWon; }
+
+    void reset();
+
+private:
+    mutable std::mutex m_lock;
+    xsapi_internal_unordered_map<uint32_t, bool> m_hedgedApis;
+    double m_latencyPercentile;
+    uint64_t m_minSampleCount;
+    std::chrono::milliseconds m_minDelay;
+    std::chrono::milliseconds m_maxDelay;
+    double m_budgetRatio;
+    double m_budgetBurst;
+    double m_budgetTokens;
+    std::atomic<uint64_t> m_hedgesSent;
+    std::atomic<uint64_t> m_hedgesWon;
+};
+
+/// <summary>
+/// Shared between the primary request and its hedge.  Whichever completes first claims the race and
+/// cancels the other; the loser's completion is swallowed.
+/// </summary>
+struct http_call_hedge_state
+{
+    http_call_hedge_state();
+
+    /// <summary>
+    /// Registers the AsyncBlock of the primary request or of the hedge.  Returns false if the race has
+    /// already been decided, in which case the request must not be sent.
+    /// </summary>
+    bool attach(_In_ AsyncBlock* asyncBlock, _In_ bool isHedge);
+
+    /// <summary>
+    /// Returns true if the caller won.  The other request is cancelled if it is still in flight.
+    /// </summary>
+    bool try_complete(_In_ AsyncBlock* asyncBlock);
+
+    /// <summary>
+    /// Must be called by each request before its AsyncBlock is freed.
+    /// </summary>
+    void release(_In_ AsyncBlock* asyncBlock);
+
+    /// <summary>
+    /// Latency is recorded from when the primary went out, whichever request delivers the response.
+    /// </summary>
+    chrono_clock_t::time_point primaryStartTime;
+    std::recursive_mutex lock; // CancelAsync may complete the loser inline
+    bool completed;
+    AsyncBlock* primaryAsyncBlock;
+    AsyncBlock* hedgeAsyncBlock;
+};
+
+struct http_call_hedge_timer_context
+{
+    std::shared_ptr<http_call_data> primary;
+    std::shared_ptr<http_call_hedge_state> hedgeState;
+};
+
+/// <summary>
+/// Creates a copy of a prepared call on a new libHttpClient handle, with the same URL, headers and body.
+/// The caller attaches the hedge state.
+/// </summary>
+std::shared_ptr<http_call_data> create_hedge_http_call_data(
+    _In_ const std::shared_ptr<http_call_data>& primary
+    );
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
@@ -9,6 +9,11 @@
 #include "build_version.h"
 #include "xsapi/system.h"
 #include "xbox_live_app_config_internal.h"
+#include "http_call_metrics.h"
+#include "http_call_hedging.h"
+#include "http_call_dispatcher.h"
+#include "http_compression.h"
+#include "mem_pool.h"
 #if TV_API
 #include "System/ppltasks_extra.h"
 #elif XSAPI_U
@@ -69,6 +74,9 @@ http_call_data::http_call_data(
     contentTypeHeaderValue("application/json; charset=utf-8"),
     xboxContractVersionHeaderValue("1"),
     addDefaultHeaders(true),
+    isHedge(false),
+    priority(default_http_call_priority(_xboxLiveApi)),
+    performResult(S_OK),
     queue(nullptr),
     callback(nullptr)
 {
@@ -137,6 +145,7 @@ http_call_impl::get_response(
     m_httpCallData->callback = std::move(callback);
 
     add_default_headers_if_needed(m_httpCallData);
+    apply_content_encoding_if_needed(m_httpCallData);
 
     internal_get_response(m_httpCallData);
     return xbox_live_result<void>();
@@ -245,6 +254,8 @@ xbox_live_result<void> http_call_impl::get_response_with_auth(
     m_httpCallData->callback = callback;
 
     add_default_headers_if_needed(m_httpCallData);
+    // Must happen before the request is signed since the signature covers the encoded body
+    apply_content_encoding_if_needed(m_httpCallData);
 
 #if !TV_API 
 #if XSAPI_CPP
@@ -367,12 +378,14 @@ xbox_live_result<void> http_call_impl::internal_get_response_with_auth(
         internal_get_response(httpCallData);
     };
 
+    xsapi_internal_string headersBuffer;
+    const xsapi_internal_string& headers = headers_to_sign(m_httpCallData, headersBuffer);
     if (m_httpCallData->requestBody.get_http_request_message_type() == http_request_message_type::vector_message)
     {
         m_httpCallData->userContext->get_auth_result(
             m_httpCallData->httpMethod,
             m_httpCallData->fullUrl,
-            utils::headers_to_string(m_httpCallData->requestHeaders),
+            headers,
             m_httpCallData->requestBody.request_message_vector(),
             allUsersAuthRequired,
             m_httpCallData->queue,
@@ -384,7 +397,7 @@ xbox_live_result<void> http_call_impl::internal_get_response_with_auth(
         m_httpCallData->userContext->get_auth_result(
             m_httpCallData->httpMethod,
             m_httpCallData->fullUrl,
-            utils::headers_to_string(m_httpCallData->requestHeaders),
+            headers,
             m_httpCallData->requestBody.request_message_string(),
             allUsersAuthRequired,
             m_httpCallData->queue,
@@ -427,6 +440,8 @@ void http_call_impl::handle_unauthorized_error(
     _In_ const std::shared_ptr<http_call_data>& httpCallData
     )
 {
+    http_call_metrics_internal::get_singleton_instance()->record_token_refresh(httpCallData->xboxLiveApi);
+
     httpCallData->userContext->refresh_token(
         httpCallData->queue, 
         [context, httpCallResponse, httpCallData](xbox_live_result<std::shared_ptr<token_and_signature_result_internal>> result)
@@ -448,26 +463,138 @@ void http_call_impl::handle_unauthorized_error(
         });
 }
 
+void http_call_impl::on_perform_failed(
+    _Inout_ AsyncBlock* asyncBlock,
+    _In_ HRESULT hr
+    )
+{
+    // The call never reached libHttpClient, so its completion is run here with the error as the result
+    auto httpCallData = utils::get_shared_ptr<http_call_data>(asyncBlock->context, false);
+    httpCallData->performResult = hr;
+    asyncBlock->callback(asyncBlock);
+}
+
+void http_call_impl::record_response_metrics(
+    _In_ const std::shared_ptr<http_call_data>& httpCallData,
+    _In_ const chrono_clock_t::time_point& startTime,
+    _In_ const chrono_clock_t::time_point& responseTime,
+    _In_ uint32_t httpStatus,
+    _In_ bool failed
+    )
+{
+    size_t bytesReceived = 0;
+    HCHttpCallResponseGetResponseBodyBytesSize(httpCallData->callHandle, &bytesReceived);
+    http_call_metrics_internal::get_singleton_instance()->record_response(
+        httpCallData->xboxLiveApi,
+        std::chrono::duration_cast<std::chrono::microseconds>(responseTime - startTime),
+        httpStatus,
+        failed,
+        bytesReceived
+        );
+}
+
 void http_call_impl::internal_get_response(
     _In_ const std::shared_ptr<http_call_data>& httpCallData
     )
 {
+    xsapi_memory_subsystem_scope memoryScope(xsapi_memory_subsystem::http, __FUNCTION__);
+    httpCallData->requestStartTime = chrono_clock_t::now();
+    httpCallData->performResult = S_OK;
+    if (httpCallData->iterationNumber == 0 && !httpCallData->isHedge)
+    {
+        httpCallData->firstCallStartTime = httpCallData->requestStartTime;
+    }
+
     set_http_timeout(httpCallData);
     set_user_agent(httpCallData);
 
+    const auto& requestBody = httpCallData->requestBody;
+    uint64_t bytesSent = requestBody.get_http_request_message_type() == http_request_message_type::vector_message ?
+        requestBody.request_message_vector().size() :
+        requestBody.request_message_string().size();
+    http_call_metrics_internal::get_singleton_instance()->record_request(
+        httpCallData->xboxLiveApi,
+        bytesSent,
+        httpCallData->iterationNumber > 0
+        );
+    ++httpCallData->iterationNumber;
+
     HCHttpCallRequestSetRetryAllowed(httpCallData->callHandle, httpCallData->retryAllowed);
     HCHttpCallRequestSetTimeout(httpCallData->callHandle, static_cast<uint32_t>(httpCallData->httpTimeout.count()));
 
-    AsyncBlock *asyncBlock = new (xsapi_memory::mem_alloc(sizeof(AsyncBlock))) AsyncBlock{};
+    // A hedge shares the race state of its primary; a primary starts a new race on every attempt
+    std::chrono::milliseconds hedgeDelay = std::chrono::milliseconds::zero();
+    if (!httpCallData->isHedge)
+    {
+        hedgeDelay = http_call_hedging_policy::get_singleton_instance()->hedge_delay(httpCallData);
+        httpCallData->hedgeState = hedgeDelay.count() > 0 ? xsapi_allocate_shared<http_call_hedge_state>() : nullptr;
+        if (httpCallData->hedgeState != nullptr)
+        {
+            httpCallData->hedgeState->primaryStartTime = httpCallData->requestStartTime;
+        }
+    }
+
+    AsyncBlock *asyncBlock = utils::allocate_async_block();
     asyncBlock->queue = httpCallData->queue;
     asyncBlock->context = utils::store_shared_ptr(httpCallData);
     asyncBlock->callback = [](_Inout_ AsyncBlock* asyncBlock)
     {
         auto httpCallData = utils::get_shared_ptr<http_call_data>(asyncBlock->context, false);
-        auto httpCallResponse = xsapi_allocate_shared<http_call_response_internal>(httpCallData);
+        if (SUCCEEDED(httpCallData->performResult))
+        {
+            // A call that failed to start no longer holds a dispatcher slot
+            http_call_dispatcher::get_singleton_instance()->on_complete(asyncBlock);
+        }
+
+        auto hedgeState = httpCallData->hedgeState;
+        auto latencyStartTime = hedgeState != nullptr ? hedgeState->primaryStartTime : httpCallData->requestStartTime;
+        if (hedgeState != nullptr)
+        {
+            bool won = hedgeState->try_complete(asyncBlock);
+            hedgeState->release(asyncBlock);
+            if (!won)
+            {
+                // The other request already delivered its response.  A primary that finished on its own
+                // rather than being cancelled still has a true latency worth keeping.
+                if (!httpCallData->isHedge && GetAsyncStatus(asyncBlock, false) != E_ABORT)
+                {
+                    uint32_t httpStatus = 0;
+                    HRESULT networkError = S_OK;
+                    uint32_t platformErrorCode = 0;
+                    HCHttpCallResponseGetStatusCode(httpCallData->callHandle, &httpStatus);
+                    HCHttpCallResponseGetNetworkErrorCode(httpCallData->callHandle, &networkError, &platformErrorCode);
+                    record_response_metrics(httpCallData, latencyStartTime, chrono_clock_t::now(), httpStatus, FAILED(networkError));
+                }
+
+                utils::get_shared_ptr<http_call_data>(asyncBlock->context, true);
+                utils::free_async_block(asyncBlock);
+                return;
+            }
+
+            if (httpCallData->isHedge)
+            {
+                http_call_hedging_policy::get_singleton_instance()->record_hedge_won();
+                httpCallData->isHedge = false;
+            }
+        }
+
+        std::shared_ptr<http_call_response_internal> httpCallResponse;
+        {
+            // Only the response itself is attributed to HTTP, not what the caller's handler allocates
+            xsapi_memory_subsystem_scope memoryScope(xsapi_memory_subsystem::http, "http_call_response_internal");
+            httpCallResponse = xsapi_allocate_shared<http_call_response_internal>(httpCallData);
+        }
+
+        record_response_metrics(
+            httpCallData,
+            latencyStartTime,
+            httpCallResponse->local_response_time(),
+            httpCallResponse->http_status(),
+            !!httpCallResponse->err_code()
+            );
 
         void* context = asyncBlock->context;
-        xsapi_memory::mem_free(asyncBlock);
+        utils::free_async_block(asyncBlock);
 
         if (httpCallData->retryAllowed && 
             httpCallResponse->http_status() == web::http::status_codes::Unauthorized &&
@@ -489,7 +616,82 @@ void http_call_impl::internal_get_response(
         }
     };
 
-    HCHttpCallPerformAsync(asyncBlock, httpCallData->callHandle);
+    if (httpCallData->hedgeState != nullptr && !httpCallData->hedgeState->attach(asyncBlock, httpCallData->isHedge))
+    {
+        // The primary completed before the hedge went out
+        utils::get_shared_ptr<http_call_data>(asyncBlock->context, true);
+        utils::free_async_block(asyncBlock);
+        return;
+    }
+
+    bool started = true;
+    if (httpCallData->isHedge)
+    {
+        // Hedges are already budgeted and exist to beat a slow primary, so they skip the dispatch queue
+        HRESULT hr = HCHttpCallPerformAsync(asyncBlock, httpCallData->callHandle);
+        if (FAILED(hr))
+        {
+            // The primary is still in flight, so a hedge that could not be sent just drops out of the race
+            LOGS_DEBUG << "Failed to send HTTP hedge: " << hr;
+            httpCallData->hedgeState->release(asyncBlock);
+            utils::get_shared_ptr<http_call_data>(asyncBlock->context, true);
+            utils::free_async_block(asyncBlock);
+        }
+    }
+    else
+    {
+        started = http_call_dispatcher::get_singleton_instance()->perform(httpCallData->priority, asyncBlock, httpCallData->callHandle);
+    }
+
+    // A queued primary has not been sent yet, so there is nothing to race and nothing that could be cancelled
+    if (hedgeDelay.count() > 0 && started)
+    {
+        schedule_hedge(httpCallData, hedgeDelay);
+    }
+}
+
+void http_call_impl::schedule_hedge(
+    _In_ const std::shared_ptr<http_call_data>& httpCallData,
+    _In_ std::chrono::milliseconds delay
+    )
+{
+    auto timerContext = xsapi_allocate_shared<http_call_hedge_timer_context>();
+    timerContext->primary = httpCallData;
+    timerContext->hedgeState = httpCallData->hedgeState;
+
+    AsyncBlock* async = utils::allocate_async_block();
+    async->queue = httpCallData->queue;
+    async->context = utils::store_shared_ptr(timerContext);
+    async->callback = [](AsyncBlock* async)
+    {
+        utils::get_shared_ptr<http_call_hedge_timer_context>(async->context, true);
+        utils::free_async_block(async);
+    };
+
+    BeginAsync(async, async->context, nullptr, __FUNCTION__,
+        [](AsyncOp op, const AsyncProviderData* data)
+    {
+        if (op == AsyncOp_DoWork)
+        {
+            auto timerContext = utils::get_shared_ptr<http_call_hedge_timer_context>(data->context, false);
+
+            // Holding the race lock keeps the primary from completing, and retrying, while it is copied
+            std::lock_guard<std::recursive_mutex> guard(timerContext->hedgeState->lock);
+            if (!timerContext->hedgeState->completed &&
+                http_call_hedging_policy::get_singleton_instance()->try_acquire_budget())
+            {
+                auto hedge = create_hedge_http_call_data(timerContext->primary);
+                hedge->hedgeState = timerContext->hedgeState;
+                internal_get_response(hedge);
+            }
+            CompleteAsync(data->async, S_OK, 0);
+
+            // Have to return E_PENDING from AsyncOp_DoWork
+            return E_PENDING;
+        }
+        return S_OK;
+    });
+    ScheduleAsync(async, static_cast<uint32_t>(delay.count()));
 }
 
 string_t http_call_impl::server_name() const
@@ -529,6 +731,16 @@ bool http_call_impl::long_http_call() const
     return m_httpCallData->longHttpCall;
 }
 
+void http_call_impl::set_priority(_In_ http_call_priority value)
+{
+    m_httpCallData->priority = value;
+}
+
+http_call_priority http_call_impl::priority() const
+{
+    return m_httpCallData->priority;
+}
+
 void http_call_impl::set_retry_allowed(
     _In_ bool value
     )
@@ -567,7 +779,7 @@ void http_call_impl::set_request_body(
     _In_ const web::json::value& value
     )
 {
-    xsapi_internal_string stringValue = utils::internal_string_from_string_t(value.serialize());
+    xsapi_internal_string stringValue = utils::json_serialize_utf8(value);
     m_httpCallData->requestBody = http_call_request_message_internal(stringValue);
     HCHttpCallRequestSetRequestBodyString(m_httpCallData->callHandle, stringValue.data());
 }
@@ -633,32 +845,19 @@ void http_call_impl::set_user_agent(
     _In_ const std::shared_ptr<http_call_data>& httpCallData
     )
 {
-    if (httpCallData->userContext != nullptr)
+    if (httpCallData->requestTemplate != nullptr)
     {
-        xsapi_internal_string userAgent = DEFAULT_USER_AGENT;
-        if (!httpCallData->userContext->caller_context().empty())
-        {
-            userAgent += " " + httpCallData->userContext->caller_context();
-        }
-
-        if (httpCallData->userContext->api_type() != xbox::services::caller_api_type::api_unknown)
-        {
-            switch (httpCallData->userContext->api_type())
-            {
-                case xbox::services::caller_api_type::api_c: userAgent += " c"; break;
-                case xbox::services::caller_api_type::api_cpp: userAgent += " cpp"; break;
-                case xbox::services::caller_api_type::api_winrt: userAgent += " winrt"; break;
-            }
-        }
-
-        add_header(httpCallData, "User-Agent", userAgent, true);
+        add_header(httpCallData, "User-Agent", httpCallData->requestTemplate->user_agent(), true);
+    }
+    else if (httpCallData->userContext != nullptr)
+    {
+        add_header(httpCallData, "User-Agent", httpCallData->userContext->user_agent(), true);
     }
     else
     {
         xsapi_internal_string userAgent = DEFAULT_USER_AGENT;
         add_header(httpCallData, "User-Agent", userAgent, true);
     }
-
 }
 
 void http_call_impl::set_http_timeout(
@@ -686,7 +885,28 @@ void http_call_impl::add_default_headers_if_needed(
     _In_ const std::shared_ptr<http_call_data>& httpCallData
     )
 {
-    if (httpCallData->addDefaultHeaders)
+    if (!httpCallData->addDefaultHeaders)
+    {
+        return;
+    }
+
+    if (httpCallData->userContext != nullptr && httpCallData->xboxLiveApi != xbox_live_api::unspecified)
+    {
+        // Reuse the header block built for this endpoint by an earlier call with the same context
+        httpCallData->requestTemplate = httpCallData->userContext->request_template(
+            httpCallData->xboxLiveApi,
+            httpCallData->httpMethod,
+            httpCallData->serverName,
+            httpCallData->xboxContractVersionHeaderValue,
+            httpCallData->contentTypeHeaderValue
+            );
+
+        for (const auto& header : httpCallData->requestTemplate->default_headers())
+        {
+            add_header(httpCallData, header.first, header.second, true);
+        }
+    }
+    else
     {
         add_header(httpCallData, "x-xbl-contract-version", httpCallData->xboxContractVersionHeaderValue, true);
         add_header(httpCallData, "Content-Type", httpCallData->contentTypeHeaderValue, true);
@@ -694,6 +914,77 @@ void http_call_impl::add_default_headers_if_needed(
     }
 }
 
+const xsapi_internal_string& http_call_impl::headers_to_sign(
+    _In_ const std::shared_ptr<http_call_data>& httpCallData,
+    _Inout_ xsapi_internal_string& headersBuffer
+    )
+{
+    // A request carrying only its template's headers is signed over the string built with the template
+    const auto& requestTemplate = httpCallData->requestTemplate;
+    if (requestTemplate != nullptr && httpCallData->requestHeaders.size() == requestTemplate->default_headers().size())
+    {
+        return requestTemplate->default_headers_string();
+    }
+
+    headersBuffer = utils::headers_to_string(httpCallData->requestHeaders);
+    return headersBuffer;
+}
+
+void http_call_impl::apply_content_encoding_if_needed(
+    _In_ const std::shared_ptr<http_call_data>& httpCallData
+    )
+{
+    if (httpCallData->xboxLiveContextSettings == nullptr ||
+        !httpCallData->xboxLiveContextSettings->use_http_compression())
+    {
+        return;
+    }
+
+    auto policy = http_compression_policy::get_singleton_instance();
+    if (policy->accept_compressed_response(httpCallData->xboxLiveApi))
+    {
+        add_header(httpCallData, ACCEPT_ENCODING_HEADER, "gzip, deflate", true);
+    }
+
+    auto encoding = policy->request_encoding();
+    if (encoding == http_content_encoding::identity ||
+        !policy->compress_request(httpCallData->xboxLiveApi) ||
+        httpCallData->requestHeaders.find(CONTENT_ENCODING_HEADER) != httpCallData->requestHeaders.end())
+    {
+        return;
+    }
+
+    const auto& requestBody = httpCallData->requestBody;
+    const uint8_t* body;
+    size_t bodySize;
+    if (requestBody.get_http_request_message_type() == http_request_message_type::vector_message)
+    {
+        body = requestBody.request_message_vector().data();
+        bodySize = requestBody.request_message_vector().size();
+    }
+    else
+    {
+        body = reinterpret_cast<const uint8_t*>(requestBody.request_message_string().data());
+        bodySize = requestBody.request_message_string().size();
+    }
+
+    if (bodySize < policy->request_threshold())
+    {
+        return;
+    }
+
+    auto encodedBody = http_compression::compress(encoding, body, bodySize);
+    if (encodedBody.size() >= bodySize)
+    {
+        return;
+    }
+
+    LOGS_DEBUG << "Compressed " << xbox_live_api_to_string(httpCallData->xboxLiveApi) << " request body from " << bodySize << " to " << encodedBody.size() << " bytes";
+    add_header(httpCallData, CONTENT_ENCODING_HEADER, http_compression::content_encoding_to_string(encoding), true);
+    HCHttpCallRequestSetRequestBodyBytes(httpCallData->callHandle, encodedBody.data(), static_cast<uint32_t>(encodedBody.size()));
+    httpCallData->requestBody = http_call_request_message_internal(std::move(encodedBody));
+}
+
 void http_call_impl::add_header(
     _In_ const std::shared_ptr<http_call_data>& httpCallData,
     _In_ const xsapi_internal_string& headerName,
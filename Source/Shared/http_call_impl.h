@@ -6,6 +6,7 @@
 #include "httpClient/httpClient.h"
 #include "http_call_response_internal.h"
 #include "http_call_request_message_internal.h"
+#include "http_call_request_template.h"
 #include "system_internal.h"
 
 #if XSAPI_U
@@ -108,6 +109,18 @@ enum class xbox_live_api
     xbox_one_pins_remove_item
 };
 
+/// <summary>
+/// Dispatch class of a service call.  Each class has its own concurrency limit in http_call_dispatcher.
+/// </summary>
+enum class http_call_priority
+{
+    gameplay_critical,
+    interactive,
+    background
+};
+
+struct http_call_hedge_state;
+
 typedef xbox_live_callback<std::shared_ptr<http_call_response_internal>> http_call_callback;
 
 struct http_call_data
@@ -145,6 +158,11 @@ struct http_call_data
     http_call_request_message_internal requestBody;
     http_headers requestHeaders;
     bool addDefaultHeaders;
+    std::shared_ptr<const http_call_request_template> requestTemplate;
+    std::shared_ptr<http_call_hedge_state> hedgeState;
+    bool isHedge;
+    http_call_priority priority;
+    HRESULT performResult;
 
     chrono_clock_t::time_point requestStartTime;
     async_queue_handle_t queue;
@@ -209,6 +227,12 @@ public:
         _In_ bool allowTracing
         ) = 0;
 
+    /// <summary>
+    /// Overrides the dispatch class, which defaults from the xbox_live_api of the call.
+    /// </summary>
+    virtual void set_priority(_In_ http_call_priority value) = 0;
+    virtual http_call_priority priority() const = 0;
+
 #if XSAPI_U
     /// <summary>
     /// Sign the request and get the response. Used for auth services.
@@ -374,6 +398,17 @@ public:
         _In_ bool allowTracing
         ) override;
 
+    void set_priority(_In_ http_call_priority value) override;
+    http_call_priority priority() const override;
+
+    /// <summary>
+    /// Completes a call that http_call_dispatcher could not start, with the error as its result.
+    /// </summary>
+    static void on_perform_failed(
+        _Inout_ AsyncBlock* asyncBlock,
+        _In_ HRESULT hr
+        );
+
 private:
     NO_COPY_AND_ASSIGN(http_call_impl);
 
@@ -398,6 +433,19 @@ private:
         _In_ const std::shared_ptr<http_call_data>& httpCallData
         );
 
+    static void record_response_metrics(
+        _In_ const std::shared_ptr<http_call_data>& httpCallData,
+        _In_ const chrono_clock_t::time_point& startTime,
+        _In_ const chrono_clock_t::time_point& responseTime,
+        _In_ uint32_t httpStatus,
+        _In_ bool failed
+        );
+
+    static void schedule_hedge(
+        _In_ const std::shared_ptr<http_call_data>& httpCallData,
+        _In_ std::chrono::milliseconds delay
+        );
+
     static void set_user_agent(
         _In_ const std::shared_ptr<http_call_data>& httpCallData
         );
@@ -410,6 +458,15 @@ private:
         _In_ const std::shared_ptr<http_call_data>& httpCallData
         );
 
+    static const xsapi_internal_string& headers_to_sign(
+        _In_ const std::shared_ptr<http_call_data>& httpCallData,
+        _Inout_ xsapi_internal_string& headersBuffer
+        );
+
+    static void apply_content_encoding_if_needed(
+        _In_ const std::shared_ptr<http_call_data>& httpCallData
+        );
+
     static void add_header(
         _In_ const std::shared_ptr<http_call_data>& httpCallData,
         _In_ const xsapi_internal_string& headerName,
@@ -0,0 +1,522 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "pch.h"
+#include "http_call_metrics.h"
+#include "utils.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
+
+const char* xbox_live_api_to_string(_In_ xbox_live_api xboxLiveApi)
+{
+    switch (xboxLiveApi)
+    {
+    case xbox_live_api::unspecified: return "unspecified";
+    case xbox_live_api::add_user_to_club: return "add_user_to_club";
+    case xbox_live_api::add_club_role: return "add_club_role";
+    case xbox_live_api::allocate_cluster: return "allocate_cluster";
+    case xbox_live_api::allocate_cluster_inline: return "allocate_cluster_inline";
+    case xbox_live_api::allocate_session_host: return "allocate_session_host";
+    case xbox_live_api::browse_catalog_bundles_helper: return "browse_catalog_bundles_helper";
+    case xbox_live_api::browse_catalog_helper: return "browse_catalog_helper";
+    case xbox_live_api::check_multiple_permissions_with_multiple_target_users: return "check_multiple_permissions_with_multiple_target_users";
+    case xbox_live_api::check_permission_with_target_user: return "check_permission_with_target_user";
+    case xbox_live_api::clear_activity: return "clear_activity";
+    case xbox_live_api::clear_search_handle: return "clear_search_handle";
+    case xbox_live_api::consume_inventory_item: return "consume_inventory_item";
+    case xbox_live_api::create_club: return "create_club";
+    case xbox_live_api::create_match_ticket: return "create_match_ticket";
+    case xbox_live_api::delete_blob: return "delete_blob";
+    case xbox_live_api::delete_club: return "delete_club";
+    case xbox_live_api::delete_match_ticket: return "delete_match_ticket";
+    case xbox_live_api::download_blob: return "download_blob";
+    case xbox_live_api::get_achievement: return "get_achievement";
+    case xbox_live_api::get_achievements: return "get_achievements";
+    case xbox_live_api::get_activities_for_social_group: return "get_activities_for_social_group";
+    case xbox_live_api::get_activities_for_users: return "get_activities_for_users";
+    case xbox_live_api::get_avoid_or_mute_list: return "get_avoid_or_mute_list";
+    case xbox_live_api::get_blob_metadata: return "get_blob_metadata";
+    case xbox_live_api::get_broadcasts: return "get_broadcasts";
+    case xbox_live_api::get_catalog_item_details: return "get_catalog_item_details";
+    case xbox_live_api::get_club: return "get_club";
+    case xbox_live_api::get_club_batch: return "get_club_batch";
+    case xbox_live_api::get_clubs_owned: return "get_clubs_owned";
+    case xbox_live_api::get_configuration: return "get_configuration";
+    case xbox_live_api::get_current_session: return "get_current_session";
+    case xbox_live_api::get_current_session_by_handle: return "get_current_session_by_handle";
+    case xbox_live_api::get_game_clips: return "get_game_clips";
+    case xbox_live_api::get_game_server_metadata: return "get_game_server_metadata";
+    case xbox_live_api::get_hopper_statistics: return "get_hopper_statistics";
+    case xbox_live_api::get_inventory_item: return "get_inventory_item";
+    case xbox_live_api::get_inventory_items: return "get_inventory_items";
+    case xbox_live_api::get_leaderboard_for_social_group_internal: return "get_leaderboard_for_social_group_internal";
+    case xbox_live_api::get_leaderboard_internal: return "get_leaderboard_internal";
+    case xbox_live_api::get_match_ticket_details: return "get_match_ticket_details";
+    case xbox_live_api::get_multiple_user_statistics_for_multiple_service_configurations: return "get_multiple_user_statistics_for_multiple_service_configurations";
+    case xbox_live_api::get_presence: return "get_presence";
+    case xbox_live_api::get_presence_for_multiple_users: return "get_presence_for_multiple_users";
+    case xbox_live_api::get_presence_for_social_group: return "get_presence_for_social_group";
+    case xbox_live_api::get_quality_of_service_servers: return "get_quality_of_service_servers";
+    case xbox_live_api::get_quota: return "get_quota";
+    case xbox_live_api::get_quota_for_session_storage: return "get_quota_for_session_storage";
+    case xbox_live_api::get_search_handles: return "get_search_handles";
+    case xbox_live_api::get_session_host_allocation_status: return "get_session_host_allocation_status";
+    case xbox_live_api::get_sessions: return "get_sessions";
+    case xbox_live_api::get_single_user_statistics: return "get_single_user_statistics";
+    case xbox_live_api::get_social_graph: return "get_social_graph";
+    case xbox_live_api::get_social_relationships: return "get_social_relationships";
+    case xbox_live_api::get_stats_value_document: return "get_stats_value_document";
+    case xbox_live_api::get_ticket_status: return "get_ticket_status";
+    case xbox_live_api::get_tournaments: return "get_tournaments";
+    case xbox_live_api::get_tournament_details: return "get_tournament_details";
+    case xbox_live_api::get_teams: return "get_teams";
+    case xbox_live_api::get_team_details: return "get_team_details";
+    case xbox_live_api::get_user_profiles: return "get_user_profiles";
+    case xbox_live_api::get_user_profiles_for_social_group: return "get_user_profiles_for_social_group";
+    case xbox_live_api::get_users_club_associations: return "get_users_club_associations";
+    case xbox_live_api::recommend_clubs: return "recommend_clubs";
+    case xbox_live_api::register_team: return "register_team";
+    case xbox_live_api::remove_user_from_club: return "remove_user_from_club";
+    case xbox_live_api::remove_club_role: return "remove_club_role";
+    case xbox_live_api::rename_club: return "rename_club";
+    case xbox_live_api::search_clubs: return "search_clubs";
+    case xbox_live_api::send_invites: return "send_invites";
+    case xbox_live_api::set_activity: return "set_activity";
+    case xbox_live_api::set_presence_helper: return "set_presence_helper";
+    case xbox_live_api::set_search_handle: return "set_search_handle";
+    case xbox_live_api::set_transfer_handle: return "set_transfer_handle";
+    case xbox_live_api::set_user_presence_within_club: return "set_user_presence_within_club";
+    case xbox_live_api::submit_batch_reputation_feedback: return "submit_batch_reputation_feedback";
+    case xbox_live_api::submit_reputation_feedback: return "submit_reputation_feedback";
+    case xbox_live_api::subscribe_to_notifications: return "subscribe_to_notifications";
+    case xbox_live_api::suggest_clubs: return "suggest_clubs";
+    case xbox_live_api::update_achievement: return "update_achievement";
+    case xbox_live_api::update_stats_value_document: return "update_stats_value_document";
+    case xbox_live_api::upload_blob: return "upload_blob";
+    case xbox_live_api::verify_strings: return "verify_strings";
+    case xbox_live_api::write_session_using_subpath: return "write_session_using_subpath";
+    case xbox_live_api::xbox_one_pins_add_item: return "xbox_one_pins_add_item";
+    case xbox_live_api::xbox_one_pins_contains_item: return "xbox_one_pins_contains_item";
+    case xbox_live_api::xbox_one_pins_remove_item: return "xbox_one_pins_remove_item";
+    default: return "unknown";
+    }
+}
+
+latency_histogram::latency_histogram()
+{
+    reset();
+}
+
+uint32_t latency_histogram::bucket_index(_In_ uint64_t valueInMicroseconds)
+{
+    if (valueInMicroseconds < LATENCY_HISTOGRAM_SUB_BUCKET_COUNT)
+    {
+        return static_cast<uint32_t>(valueInMicroseconds);
+    }
+
+    uint32_t exponent = 0;
+    for (uint64_t v = valueInMicroseconds; v > 1; v >>= 1)
+    {
+        ++exponent;
+    }
+
+    // The last exponent with its own buckets is LATENCY_HISTOGRAM_MAX_EXPONENT - 1
+    if (exponent >= LATENCY_HISTOGRAM_MAX_EXPONENT)
+    {
+        return LATENCY_HISTOGRAM_BUCKET_COUNT - 1;
+    }
+
+    uint32_t subBucket = static_cast<uint32_t>(valueInMicroseconds >> (exponent - LATENCY_HISTOGRAM_SUB_BUCKET_BITS)) & (LATENCY_HISTOGRAM_SUB_BUCKET_COUNT - 1);
+    return (exponent - LATENCY_HISTOGRAM_SUB_BUCKET_BITS + 1) * LATENCY_HISTOGRAM_SUB_BUCKET_COUNT + subBucket;
+}
+
+uint64_t latency_histogram::bucket_lower_bound(_In_ uint32_t index)
+{
+    if (index < LATENCY_HISTOGRAM_SUB_BUCKET_COUNT)
+    {
+        return index;
+    }
+
+    uint32_t exponent = index / LATENCY_HISTOGRAM_SUB_BUCKET_COUNT + LATENCY_HISTOGRAM_SUB_BUCKET_BITS - 1;
+    uint64_t subBucket = index % LATENCY_HISTOGRAM_SUB_BUCKET_COUNT;
+    return (LATENCY_HISTOGRAM_SUB_BUCKET_COUNT + subBucket) << (exponent - LATENCY_HISTOGRAM_SUB_BUCKET_BITS);
+}
+
+uint64_t latency_histogram::bucket_upper_bound(_In_ uint32_t index)
+{
+    if (index < LATENCY_HISTOGRAM_SUB_BUCKET_COUNT)
+    {
+        return index;
+    }
+
+    uint32_t exponent = index / LATENCY_HISTOGRAM_SUB_BUCKET_COUNT + LATENCY_HISTOGRAM_SUB_BUCKET_BITS - 1;
+    return bucket_lower_bound(index) + (1ULL << (exponent - LATENCY_HISTOGRAM_SUB_BUCKET_BITS)) - 1;
+}
+
+void latency_histogram::record(_In_ uint64_t valueInMicroseconds)
+{
+    m_buckets[bucket_index(valueInMicroseconds)].fetch_add(1, std::memory_order_relaxed);
+    m_totalCount.fetch_add(1, std::memory_order_relaxed);
+    m_totalValue.fetch_add(valueInMicroseconds, std::memory_order_relaxed);
+
+    uint64_t currentMax = m_maxValue.load(std::memory_order_relaxed);
+    while (valueInMicroseconds > currentMax &&
+        !m_maxValue.compare_exchange_weak(currentMax, valueInMicroseconds, std::memory_order_relaxed))
+    {
+    }
+}
+
+uint64_t latency_histogram::total_count() const
+{
+    return m_totalCount.load(std::memory_order_relaxed);
+}
+
+uint64_t latency_histogram::max_value() const
+{
+    return m_maxValue.load(std::memory_order_relaxed);
+}
+
+uint64_t latency_histogram::value_at_percentile(_In_ double percentile) const
+{
+    // Sum the buckets rather than trusting m_totalCount so a concurrent record() can't push the target past the end
+    uint64_t buckets[LATENCY_HISTOGRAM_BUCKET_COUNT];
+    uint64_t totalCount = 0;
+    for (uint32_t i = 0; i < LATENCY_HISTOGRAM_BUCKET_COUNT; ++i)
+    {
+        buckets[i] = m_buckets[i].load(std::memory_order_relaxed);
+        totalCount += buckets[i];
+    }
+
+    if (totalCount == 0)
+    {
+        return 0;
+    }
+
+    percentile = __max(0.0, __min(100.0, percentile));
+    uint64_t target = static_cast<uint64_t>((percentile / 100.0) * totalCount + 0.5);
+    target = __max(1ULL, target);
+
+    uint64_t runningCount = 0;
+    for (uint32_t i = 0; i < LATENCY_HISTOGRAM_BUCKET_COUNT; ++i)
+    {
+        runningCount += buckets[i];
+        if (runningCount >= target)
+        {
+            return __min(bucket_upper_bound(i), max_value());
+        }
+    }
+
+    return max_value();
+}
+
+void latency_histogram::reset()
+{
+    for (auto& bucket : m_buckets)
+    {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    m_totalCount.store(0, std::memory_order_relaxed);
+    m_totalValue.store(0, std::memory_order_relaxed);
+    m_maxValue.store(0, std::memory_order_relaxed);
+}
+
+http_call_api_counters::http_call_api_counters()
+{
+    reset();
+}
+
+void http_call_api_counters::reset()
+{
+    requestCount.store(0, std::memory_order_relaxed);
+    failureCount.store(0, std::memory_order_relaxed);
+    retryCount.store(0, std::memory_order_relaxed);
+    tokenRefreshCount.store(0, std::memory_order_relaxed);
+    throttledCount.store(0, std::memory_order_relaxed);
+    bytesSent.store(0, std::memory_order_relaxed);
+    bytesReceived.store(0, std::memory_order_relaxed);
+    latency.reset();
+}
+
+http_call_metrics_internal::http_call_metrics_internal() :
+    m_isEnabled(true)
+{
+    for (auto& counters : m_counters)
+    {
+        counters.store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+http_call_metrics_internal::~http_call_metrics_internal()
+{
+    for (auto& counters : m_counters)
+    {
+        http_call_api_counters* apiCounters = counters.exchange(nullptr);
+        if (apiCounters != nullptr)
+        {
+            apiCounters->~http_call_api_counters();
+            xsapi_memory::mem_free(apiCounters);
+        }
+    }
+}
+
+std::shared_ptr<http_call_metrics_internal> http_call_metrics_internal::get_singleton_instance()
+{
+    auto xsapiSingleton = get_xsapi_singleton();
+    std::lock_guard<std::mutex> guard(xsapiSingleton->m_singletonLock);
+    if (xsapiSingleton->m_httpCallMetricsSingleton == nullptr)
+    {
+        xsapiSingleton->m_httpCallMetricsSingleton = xsapi_allocate_shared<http_call_metrics_internal>();
+    }
+    return xsapiSingleton->m_httpCallMetricsSingleton;
+}
+
+http_call_api_counters* http_call_metrics_internal::get_counters(_In_ xbox_live_api xboxLiveApi)
+{
+    uint32_t index = static_cast<uint32_t>(xboxLiveApi);
+    if (index >= XBOX_LIVE_API_COUNT)
+    {
+        return nullptr;
+    }
+
+    http_call_api_counters* counters = m_counters[index].load(std::memory_order_acquire);
+    if (counters == nullptr)
+    {
+        void* buffer = xsapi_memory::mem_alloc(sizeof(http_call_api_counters));
+        if (buffer == nullptr)
+        {
+            return nullptr;
+        }
+
+        http_call_api_counters* newCounters = new (buffer) http_call_api_counters();
+        if (m_counters[index].compare_exchange_strong(counters, newCounters, std::memory_order_acq_rel))
+        {
+            counters = newCounters;
+        }
+        else
+        {
+            // Another thread won the race, counters now holds its allocation
+            newCounters->~http_call_api_counters();
+            xsapi_memory::mem_free(newCounters);
+        }
+    }
+    return counters;
+}
+
+const http_call_api_counters* http_call_metrics_internal::peek_counters(_In_ xbox_live_api xboxLiveApi) const
+{
+    uint32_t index = static_cast<uint32_t>(xboxLiveApi);
+    if (index >= XBOX_LIVE_API_COUNT)
+    {
+        return nullptr;
+    }
+    return m_counters[index].load(std::memory_order_acquire);
+}
+
+void http_call_metrics_internal::record_request(
+    _In_ xbox_live_api xboxLiveApi,
+    _In_ uint64_t bytesSent,
+    _In_ bool isRetry
+    )
+{
+    if (!m_isEnabled) return;
+
+    auto counters = get_counters(xboxLiveApi);
+    if (counters == nullptr) return;
+
+    counters->requestCount.fetch_add(1, std::memory_order_relaxed);
+    counters->bytesSent.fetch_add(bytesSent, std::memory_order_relaxed);
+    if (isRetry)
+    {
+        counters->retryCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void http_call_metrics_internal::record_response(
+    _In_ xbox_live_api xboxLiveApi,
+    _In_ const std::chrono::microseconds& latency,
+    _In_ uint32_t httpStatus,
+    _In_ bool failed,
+    _In_ uint64_t bytesReceived
+    )
+{
+    if (!m_isEnabled) return;
+
+    auto counters = get_counters(xboxLiveApi);
+    if (counters == nullptr) return;
+
+    counters->latency.record(static_cast<uint64_t>(__max(0LL, static_cast<long long>(latency.count()))));
+    counters->bytesReceived.fetch_add(bytesReceived, std::memory_order_relaxed);
+    if (failed)
+    {
+        counters->failureCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (httpStatus == static_cast<uint32_t>(xbox_live_error_code::http_status_429_too_many_requests))
+    {
+        counters->throttledCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void http_call_metrics_internal::record_token_refresh(_In_ xbox_live_api xboxLiveApi)
+{
+    if (!m_isEnabled) return;
+
+    auto counters = get_counters(xboxLiveApi);
+    if (counters == nullptr) return;
+
+    counters->tokenRefreshCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t http_call_metrics_internal::latency_at_percentile(
+    _In_ xbox_live_api xboxLiveApi,
+    _In_ double percentile
+    ) const
+{
+    auto counters = peek_counters(xboxLiveApi);
+    return counters == nullptr ? 0 : counters->latency.value_at_percentile(percentile);
+}
+
+uint64_t http_call_metrics_internal::sample_count(_In_ xbox_live_api xboxLiveApi) const
+{
+    auto counters = peek_counters(xboxLiveApi);
+    return counters == nullptr ? 0 : counters->latency.total_count();
+}
+
+xsapi_internal_vector<http_call_api_metrics> http_call_metrics_internal::snapshot() const
+{
+    xsapi_internal_vector<http_call_api_metrics> result;
+    for (uint32_t i = 0; i < XBOX_LIVE_API_COUNT; ++i)
+    {
+        const http_call_api_counters* counters = m_counters[i].load(std::memory_order_acquire);
+        if (counters == nullptr || counters->requestCount.load(std::memory_order_relaxed) == 0)
+        {
+            continue;
+        }
+
+        http_call_api_metrics metrics;
+        metrics.m_apiName = utils::string_t_from_utf8(xbox_live_api_to_string(static_cast<xbox_live_api>(i)));
+        metrics.m_requestCount = counters->requestCount.load(std::memory_order_relaxed);
+        metrics.m_failureCount = counters->failureCount.load(std::memory_order_relaxed);
+        metrics.m_retryCount = counters->retryCount.load(std::memory_order_relaxed);
+        metrics.m_tokenRefreshCount = counters->tokenRefreshCount.load(std::memory_order_relaxed);
+        metrics.m_throttledCount = counters->throttledCount.load(std::memory_order_relaxed);
+        metrics.m_bytesSent = counters->bytesSent.load(std::memory_order_relaxed);
+        metrics.m_bytesReceived = counters->bytesReceived.load(std::memory_order_relaxed);
+        metrics.m_latencyP50 = std::chrono::microseconds(counters->latency.value_at_percentile(50.0));
+        metrics.m_latencyP90 = std::chrono::microseconds(counters->latency.value_at_percentile(90.0));
+        metrics.m_latencyP99 = std::chrono::microseconds(counters->latency.value_at_percentile(99.0));
+        metrics.m_latencyMax = std::chrono::microseconds(counters->latency.max_value());
+        result.push_back(std::move(metrics));
+    }
+    return result;
+}
+
+void http_call_metrics_internal::reset()
+{
+    for (auto& counters : m_counters)
+    {
+        http_call_api_counters* apiCounters = counters.load(std::memory_order_acquire);
+        if (apiCounters != nullptr)
+        {
+            apiCounters->reset();
+        }
+    }
+}
+
+http_call_api_metrics::http_call_api_metrics() :
+    m_requestCount(0),
+    m_failureCount(0),
+    m_retryCount(0),
+    m_tokenRefreshCount(0),
+    m_throttledCount(0),
+    m_bytesSent(0),
+    m_bytesReceived(0),
+    m_latencyP50(0),
+    m_latencyP90(0),
+    m_latencyP99(0),
+    m_latencyMax(0)
+{
+}
+
+const string_t& http_call_api_metrics::api_name() const { return m_apiName; }
+uint64_t http_call_api_metrics::request_count() const { return m_requestCount; }
+uint64_t http_call_api_metrics::failure_count() const { return m_failureCount; }
+uint64_t http_call_api_metrics::retry_count() const { return m_retryCount; }
+uint64_t http_call_api_metrics::token_refresh_count() const { return m_tokenRefreshCount; }
+uint64_t http_call_api_metrics::throttled_count() const { return m_throttledCount; }
+uint64_t http_call_api_metrics::bytes_sent() const { return m_bytesSent; }
+uint64_t http_call_api_metrics::bytes_received() const { return m_bytesReceived; }
+const std::chrono::microseconds& http_call_api_metrics::latency_p50() const { return m_latencyP50; }
+const std::chrono::microseconds& http_call_api_metrics::latency_p90() const { return m_latencyP90; }
+const std::chrono::microseconds& http_call_api_metrics::latency_p99() const { return m_latencyP99; }
+const std::chrono::microseconds& http_call_api_metrics::latency_max() const { return m_latencyMax; }
+
+web::json::value http_call_api_metrics::serialize() const
+{
+    web::json::value json;
+    json[_T("api")] = web::json::value::string(m_apiName);
+    json[_T("requestCount")] = utils::serialize_uint52_to_json(m_requestCount);
+    json[_T("failureCount")] = utils::serialize_uint52_to_json(m_failureCount);
+    json[_T("retryCount")] = utils::serialize_uint52_to_json(m_retryCount);
+    json[_T("tokenRefreshCount")] = utils::serialize_uint52_to_json(m_tokenRefreshCount);
+    json[_T("throttledCount")] = utils::serialize_uint52_to_json(m_throttledCount);
+    json[_T("bytesSent")] = utils::serialize_uint52_to_json(m_bytesSent);
+    json[_T("bytesReceived")] = utils::serialize_uint52_to_json(m_bytesReceived);
+    json[_T("latencyP50Us")] = utils::serialize_uint52_to_json(m_latencyP50.count());
+    json[_T("latencyP90Us")] = utils::serialize_uint52_to_json(m_latencyP90.count());
+    json[_T("latencyP99Us")] = utils::serialize_uint52_to_json(m_latencyP99.count());
+    json[_T("latencyMaxUs")] = utils::serialize_uint52_to_json(m_latencyMax.count());
+    return json;
+}
+
+std::shared_ptr<http_call_metrics> http_call_metrics::get_singleton_instance()
+{
+    auto xsapiSingleton = get_xsapi_singleton();
+    std::lock_guard<std::mutex> guard(xsapiSingleton->m_singletonLock);
+    if (xsapiSingleton->m_httpCallMetricsConfigSingleton == nullptr)
+    {
+        xsapiSingleton->m_httpCallMetricsConfigSingleton = std::shared_ptr<http_call_metrics>(new http_call_metrics());
+    }
+    return xsapiSingleton->m_httpCallMetricsConfigSingleton;
+}
+
+http_call_metrics::http_call_metrics()
+{
+}
+
+void http_call_metrics::enable()
+{
+    http_call_metrics_internal::get_singleton_instance()->set_enabled(true);
+}
+
+void http_call_metrics::disable()
+{
+    http_call_metrics_internal::get_singleton_instance()->set_enabled(false);
+}
+
+bool http_call_metrics::is_enabled() const
+{
+    return http_call_metrics_internal::get_singleton_instance()->is_enabled();
+}
+
+std::vector<http_call_api_metrics> http_call_metrics::snapshot() const
+{
+    return utils::std_vector_from_internal_vector(http_call_metrics_internal::get_singleton_instance()->snapshot());
+}
+
+web::json::value http_call_metrics::serialize_snapshot() const
+{
+    web::json::value json = web::json::value::array();
+    uint32_t i = 0;
+    for (const auto& metrics : http_call_metrics_internal::get_singleton_instance()->snapshot())
+    {
+        json[i++] = metrics.serialize();
+    }
+    return json;
+}
+
+void http_call_metrics::reset()
+{
+    http_call_metrics_internal::get_singleton_instance()->reset();
+}
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
@@ -0,0 +1,126 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#pragma once
+#include "xsapi/http_call_metrics.h"
+#include "http_call_impl.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
+
+const uint32_t XBOX_LIVE_API_COUNT = static_cast<uint32_t>(xbox_live_api::xbox_one_pins_remove_item) + 1;
+
+/// <summary>
+/// Returns a stable, null terminated name for an xbox_live_api value.
+/// </summary>
+const char* xbox_live_api_to_string(_In_ xbox_live_api xboxLiveApi);
+
+/// <summary>
+/// Lock free log-linear latency histogram (HDR style).  Values below 2^LATENCY_HISTOGRAM_SUB_BUCKET_BITS
+/// microseconds are counted exactly, larger values keep LATENCY_HISTOGRAM_SUB_BUCKET_BITS significant bits
+/// which bounds the relative error of any percentile to 1/LATENCY_HISTOGRAM_SUB_BUCKET_COUNT.
+/// </summary>
+const uint32_t LATENCY_HISTOGRAM_SUB_BUCKET_BITS = 3;
+const uint32_t LATENCY_HISTOGRAM_SUB_BUCKET_COUNT = 1 << LATENCY_HISTOGRAM_SUB_BUCKET_BITS;
+const uint32_t LATENCY_HISTOGRAM_MAX_EXPONENT = 27; // 2^27 us is a bit over 2 minutes
+const uint32_t LATENCY_HISTOGRAM_BUCKET_COUNT = (LATENCY_HISTOGRAM_MAX_EXPONENT - LATENCY_HISTOGRAM_SUB_BUCKET_BITS + 1) * LATENCY_HISTOGRAM_SUB_BUCKET_COUNT;
+
+class latency_histogram
+{
+public:
+    latency_histogram();
+
+    void record(_In_ uint64_t valueInMicroseconds);
+
+    uint64_t total_count() const;
+
+    uint64_t max_value() const;
+
+    uint64_t value_at_percentile(_In_ double percentile) const;
+
+    void reset();
+
+    static uint32_t bucket_index(_In_ uint64_t valueInMicroseconds);
+    static uint64_t bucket_lower_bound(_In_ uint32_t index);
+    static uint64_t bucket_upper_bound(_In_ uint32_t index);
+
+private:
+    std::atomic<uint64_t> m_buckets[LATENCY_HISTOGRAM_BUCKET_COUNT];
+    std::atomic<uint64_t> m_totalCount;
+    std::atomic<uint64_t> m_totalValue;
+    std::atomic<uint64_t> m_maxValue;
+};
+
+struct http_call_api_counters
+{
+    http_call_api_counters();
+
+    void reset();
+
+    std::atomic<uint64_t> requestCount;
+    std::atomic<uint64_t> failureCount;
+    std::atomic<uint64_t> retryCount;
+    std::atomic<uint64_t> tokenRefreshCount;
+    std::atomic<uint64_t> throttledCount;
+    std::atomic<uint64_t> bytesSent;
+    std::atomic<uint64_t> bytesReceived;
+    latency_histogram latency;
+};
+
+/// <summary>
+/// In-process registry of per xbox_live_api HTTP metrics.  Recording is lock free; counters for an API
+/// are allocated on first use and live until the xsapi singleton is torn down.
+/// </summary>
+class http_call_metrics_internal
+{
+public:
+    http_call_metrics_internal();
+    ~http_call_metrics_internal();
+
+    static std::shared_ptr<http_call_metrics_internal> get_singleton_instance();
+
+    bool is_enabled() const { return m_isEnabled; }
+    void set_enabled(_In_ bool value) { m_isEnabled = value; }
+
+    void record_request(
+        _In_ xbox_live_api xboxLiveApi,
+        _In_ uint64_t bytesSent,
+        _In_ bool isRetry
+        );
+
+    void record_response(
+        _In_ xbox_live_api xboxLiveApi,
+        _In_ const std::chrono::microseconds& latency,
+        _In_ uint32_t httpStatus,
+        _In_ bool failed,
+        _In_ uint64_t bytesReceived
+        );
+
+    void record_token_refresh(_In_ xbox_live_api xboxLiveApi);
+
+    /// <summary>
+    /// Returns the latency percentile for an API in microseconds, or 0 if there are no samples.
+    /// </summary>
+    uint64_t latency_at_percentile(
+        _In_ xbox_live_api xboxLiveApi,
+        _In_ double percentile
+        ) const;
+
+    uint64_t sample_count(_In_ xbox_live_api xboxLiveApi) const;
+
+    /// <summary>
+    /// Returns the counters for an API, or nullptr if the API has never been called.
+    /// </summary>
+    const http_call_api_counters* peek_counters(_In_ xbox_live_api xboxLiveApi) const;
+
+    xsapi_internal_vector<http_call_api_metrics> snapshot() const;
+
+    void reset();
+
+private:
+    http_call_api_counters* get_counters(_In_ xbox_live_api xboxLiveApi);
+
+    std::atomic<bool> m_isEnabled;
+    std::atomic<http_call_api_counters*> m_counters[XBOX_LIVE_API_COUNT];
+};
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
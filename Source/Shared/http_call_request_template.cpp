@@ -0,0 +1,46 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "pch.h"
+#include "http_call_request_template.h"
+#include "utils.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
+
+http_call_request_template::http_call_request_template(
+    _In_ const xsapi_internal_string& httpMethod,
+    _In_ const xsapi_internal_string& serverName,
+    _In_ const xsapi_internal_string& xboxContractVersion,
+    _In_ const xsapi_internal_string& contentType,
+    _In_ const xsapi_internal_string& locales,
+    _In_ const xsapi_internal_string& userAgent
+    ) :
+    m_httpMethod(httpMethod),
+    m_serverName(serverName),
+    m_xboxContractVersion(xboxContractVersion),
+    m_contentType(contentType),
+    m_locales(locales),
+    m_userAgent(userAgent)
+{
+    m_defaultHeaders["x-xbl-contract-version"] = m_xboxContractVersion;
+    m_defaultHeaders["Content-Type"] = m_contentType;
+    m_defaultHeaders["Accept-Language"] = m_locales;
+    m_defaultHeadersString = utils::headers_to_string(m_defaultHeaders);
+}
+
+bool http_call_request_template::matches(
+    _In_ const xsapi_internal_string& httpMethod,
+    _In_ const xsapi_internal_string& serverName,
+    _In_ const xsapi_internal_string& xboxContractVersion,
+    _In_ const xsapi_internal_string& contentType,
+    _In_ const xsapi_internal_string& locales
+    ) const
+{
+    return m_httpMethod == httpMethod &&
+        m_serverName == serverName &&
+        m_xboxContractVersion == xboxContractVersion &&
+        m_contentType == contentType &&
+        m_locales == locales;
+}
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
@@ -0,0 +1,62 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#pragma once
+#include "http_headers.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
+
+/// <summary>
+/// The invariant parts of calls to one Xbox Live endpoint made with one xbox_live_context: the server name,
+/// the default header block built from the contract version, content type and locale, the header string
+/// a request carrying only those headers is signed over, and the User-Agent.
+/// Templates are immutable once built so they can be shared between concurrent calls.
+/// </summary>
+class http_call_request_template
+{
+public:
+    http_call_request_template(
+        _In_ const xsapi_internal_string& httpMethod,
+        _In_ const xsapi_internal_string& serverName,
+        _In_ const xsapi_internal_string& xboxContractVersion,
+        _In_ const xsapi_internal_string& contentType,
+        _In_ const xsapi_internal_string& locales,
+        _In_ const xsapi_internal_string& userAgent
+        );
+
+    /// <summary>
+    /// Returns true if this template was built from the given inputs and can be reused for a call.
+    /// </summary>
+    bool matches(
+        _In_ const xsapi_internal_string& httpMethod,
+        _In_ const xsapi_internal_string& serverName,
+        _In_ const xsapi_internal_string& xboxContractVersion,
+        _In_ const xsapi_internal_string& contentType,
+        _In_ const xsapi_internal_string& locales
+        ) const;
+
+    const xsapi_internal_string& server_name() const { return m_serverName; }
+    const xsapi_internal_string& user_agent() const { return m_userAgent; }
+
+    /// <summary>
+    /// The x-xbl-contract-version, Content-Type and Accept-Language headers.
+    /// </summary>
+    const http_headers& default_headers() const { return m_defaultHeaders; }
+
+    /// <summary>
+    /// default_headers() formatted as utils::headers_to_string would.
+    /// </summary>
+    const xsapi_internal_string& default_headers_string() const { return m_defaultHeadersString; }
+
+private:
+    xsapi_internal_string m_httpMethod;
+    xsapi_internal_string m_serverName;
+    xsapi_internal_string m_xboxContractVersion;
+    xsapi_internal_string m_contentType;
+    xsapi_internal_string m_locales;
+    xsapi_internal_string m_userAgent;
+    http_headers m_defaultHeaders;
+    xsapi_internal_string m_defaultHeadersString;
+};
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
@@ -13,6 +13,7 @@
 #include "service_call_logger.h"
 #endif
 #include "http_call_impl.h"
+#include "http_compression.h"
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
 
@@ -32,18 +33,15 @@ std::shared_ptr<http_call_response_internal> http_call_response::_Internal_respo
 
 web::http::http_headers http_call_response::response_headers() const
 {
-    auto headers = web::http::http_headers();
+    return *m_internalObj->public_response_headers();
+}
 
-    auto& internalHeaders = m_internalObj->response_headers();
-    for (auto& kvp : internalHeaders)
-    {
-        headers.add(utils::string_t_from_internal_string(kvp.first), utils::string_t_from_internal_string(kvp.second));
-    }
-    return headers;
+string_t http_call_response::response_body_string() const
+{
+    return *m_internalObj->public_response_body_string();
 }
 
 DEFINE_GET_ENUM_TYPE(http_call_response, http_call_response_body_type, body_type);
-DEFINE_GET_STRING(http_call_response, response_body_string);
 DEFINE_GET_OBJECT_REF(http_call_response, web::json::value, response_body_json);
 DEFINE_GET_VECTOR(http_call_response, unsigned char, response_body_vector);
 DEFINE_GET_UINT32(http_call_response, http_status);
@@ -81,6 +79,10 @@ http_call_response_internal::http_call_response_internal(
     uint32_t platformErrorCode = 0;
     HCHttpCallResponseGetNetworkErrorCode(httpCallData->callHandle, &hr, &platformErrorCode);
     HCHttpCallResponseGetStatusCode(httpCallData->callHandle, &m_httpStatus);
+    if (SUCCEEDED(hr))
+    {
+        hr = httpCallData->performResult;
+    }
 
     if (httpCallData->userContext != nullptr)
     {
@@ -88,12 +90,13 @@ http_call_response_internal::http_call_response_internal(
     }
     m_xboxLiveContextSettings = httpCallData->xboxLiveContextSettings;
     m_httpMethod = httpCallData->httpMethod;
-    m_fullUrl = httpCallData->serverName + utils::internal_string_from_string_t(httpCallData->pathQueryFragment.to_string());
+    m_fullUrl = httpCallData->fullUrl;
     m_requestBody = httpCallData->requestBody;
     m_xboxLiveApi = httpCallData->xboxLiveApi;
     m_requestTime = httpCallData->requestStartTime;
     m_responseTime = chrono_clock_t::now();
 
+    http_content_encoding contentEncoding = http_content_encoding::identity;
     uint32_t numHeaders;
     HCHttpCallResponseGetNumHeaders(httpCallData->callHandle, &numHeaders);
     for (uint32_t i = 0; i < numHeaders; ++i)
@@ -102,6 +105,11 @@ http_call_response_internal::http_call_response_internal(
         const char* headerValue;
         HCHttpCallResponseGetHeaderAtIndex(httpCallData->callHandle, i, &headerName, &headerValue);
         add_response_header(headerName, headerValue);
+
+        if (utils::str_icmp(headerName, CONTENT_ENCODING_HEADER) == 0)
+        {
+            contentEncoding = http_compression::content_encoding_from_string(headerValue);
+        }
     }
 
     PCSTR responseBody = nullptr;
@@ -119,7 +127,26 @@ http_call_response_internal::http_call_response_internal(
 #pragma warning(suppress: 4244)
         m_errorCode = get_xbox_live_error_code_from_http_status(m_httpStatus);
 
-        if (httpCallData->httpCallResponseBodyType == http_call_response_body_type::vector_body)
+        // Some platform stacks decode the body themselves but keep the header, so undecodable bodies are used as is
+        xsapi_internal_vector<uint8_t> decodedBody;
+        bool isDecoded = false;
+        if (contentEncoding != http_content_encoding::identity)
+        {
+            size_t encodedSize = 0;
+            HCHttpCallResponseGetResponseBodyBytesSize(httpCallData->callHandle, &encodedSize);
+            xsapi_internal_vector<uint8_t> encodedBody(encodedSize);
+            if (encodedSize > 0)
+            {
+                HCHttpCallResponseGetResponseBodyBytes(httpCallData->callHandle, encodedSize, &encodedBody[0], nullptr);
+            }
+            isDecoded = http_compression::decompress(contentEncoding, encodedBody.data(), encodedBody.size(), decodedBody);
+        }
+
+        if (isDecoded && httpCallData->httpCallResponseBodyType == http_call_response_body_type::vector_body)
+        {
+            set_response_body(decodedBody);
+        }
+        else if (httpCallData->httpCallResponseBodyType == http_call_response_body_type::vector_body)
         {
             size_t responseSize;
             HCHttpCallResponseGetResponseBodyBytesSize(httpCallData->callHandle, &responseSize);
@@ -131,12 +158,23 @@ http_call_response_internal::http_call_response_internal(
         }
         else
         {
-            HCHttpCallResponseGetResponseString(httpCallData->callHandle, &responseBody);
+            xsapi_internal_string decodedString;
+            if (isDecoded)
+            {
+                decodedString.assign(decodedBody.begin(), decodedBody.end());
+                responseBody = decodedString.data();
+            }
+            else
+            {
+                HCHttpCallResponseGetResponseString(httpCallData->callHandle, &responseBody);
+            }
+
             if (httpCallData->httpCallResponseBodyType == http_call_response_body_type::json_body)
             {
-                web::json::value responseBodyJson;
                 std::error_code errCode;
-                responseBodyJson = web::json::value::parse(utils::string_t_from_internal_string(responseBody), errCode);
+                web::json::value responseBodyJson = responseBody != nullptr ?
+                    utils::json_parse_utf8(responseBody, strlen(responseBody), errCode) :
+                    web::json::value();
                 if (!errCode)
                 {
                     set_response_body(responseBodyJson);
@@ -189,7 +227,7 @@ xsapi_internal_string http_call_response_internal::response_body_to_string() con
 {
     switch (m_httpCallResponseBodyType)
     {
-        case http_call_response_body_type::json_body: return utils::internal_string_from_string_t(m_responseBodyJson.serialize());
+        case http_call_response_body_type::json_body: return utils::json_serialize_utf8(m_responseBodyJson);
         case http_call_response_body_type::string_body: return m_responseBodyString;
         case http_call_response_body_type::vector_body: return "Binary data response";
         default: return "Unknown response";
@@ -202,6 +240,7 @@ void http_call_response_internal::add_response_header(
     )
 {
     m_responseHeaders[headerName] = headerValue;
+    std::atomic_store(&m_publicResponseHeaders, std::shared_ptr<const web::http::http_headers>());
 
     // special handling for certain headers
     if (headerName == ETAG_HEADER)
@@ -235,6 +274,35 @@ void http_call_response_internal::set_response_body(_In_ const xsapi_internal_st
 {
     m_responseBodyString = responseBodyString;
     m_httpCallResponseBodyType = http_call_response_body_type::string_body;
+    std::atomic_store(&m_publicResponseBodyString, std::shared_ptr<const string_t>());
+}
+
+std::shared_ptr<const string_t> http_call_response_internal::public_response_body_string() const
+{
+    auto bodyString = std::atomic_load(&m_publicResponseBodyString);
+    if (bodyString == nullptr)
+    {
+        // Racing callers may both convert; either result is identical
+        bodyString = xsapi_allocate_shared<string_t>(utils::string_t_from_internal_string(m_responseBodyString));
+        std::atomic_store(&m_publicResponseBodyString, bodyString);
+    }
+    return bodyString;
+}
+
+std::shared_ptr<const web::http::http_headers> http_call_response_internal::public_response_headers() const
+{
+    auto headers = std::atomic_load(&m_publicResponseHeaders);
+    if (headers == nullptr)
+    {
+        auto converted = xsapi_allocate_shared<web::http::http_headers>();
+        for (const auto& kvp : m_responseHeaders)
+        {
+            converted->add(utils::string_t_from_internal_string(kvp.first), utils::string_t_from_internal_string(kvp.second));
+        }
+        headers = converted;
+        std::atomic_store(&m_publicResponseHeaders, headers);
+    }
+    return headers;
 }
 
 void http_call_response_internal::set_response_body(_In_ const xsapi_internal_vector<unsigned char>& responseBodyVector)
@@ -64,8 +64,16 @@ public:
     void remove_response_header(_In_ const xsapi_internal_string& headerName)
     {
         m_responseHeaders.erase(headerName);
+        std::atomic_store(&m_publicResponseHeaders, std::shared_ptr<const web::http::http_headers>());
     }
 
+    /// <summary>
+    /// The string body and headers as the public http_call_response exposes them.  Everything internal stays
+    /// UTF-8; these are converted to string_t the first time a caller asks and then reused.
+    /// </summary>
+    std::shared_ptr<const string_t> public_response_body_string() const;
+    std::shared_ptr<const web::http::http_headers> public_response_headers() const;
+
     void set_response_body(_In_ const xsapi_internal_string& responseBodyString);
 
     void set_response_body(_In_ const xsapi_internal_vector<unsigned char>& responseBodyVector);
@@ -119,6 +127,9 @@ private:
     http_call_request_message_internal m_requestBody;
     xbox_live_api m_xboxLiveApi;
 
+    mutable std::shared_ptr<const string_t> m_publicResponseBodyString;
+    mutable std::shared_ptr<const web::http::http_headers> m_publicResponseHeaders;
+
     xsapi_internal_string response_body_to_string() const;
 };
 
@@ -0,0 +1,910 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "pch.h"
+#include "http_compression.h"
+#include "utils.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
+
+namespace
+{
+const uint32_t DEFLATE_WINDOW_SIZE = 32768;
+const uint32_t DEFLATE_MIN_MATCH = 3;
+const uint32_t DEFLATE_MAX_MATCH = 258;
+const uint32_t DEFLATE_MAX_CHAIN = 32;
+const uint32_t DEFLATE_HASH_BITS = 15;
+const uint32_t DEFLATE_HASH_SIZE = 1 << DEFLATE_HASH_BITS;
+const uint32_t DEFLATE_MAX_BITS = 15;
+const uint32_t DEFLATE_MAX_LITLEN_CODES = 288;
+const uint32_t DEFLATE_MAX_DIST_CODES = 30;
+
+const uint16_t LENGTH_BASE[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+const uint8_t LENGTH_EXTRA[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+const uint16_t DIST_BASE[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+const uint8_t DIST_EXTRA[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+const uint8_t CODE_LENGTH_ORDER[19] = {
+    16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+class bit_writer
+{
+public:
+    bit_writer(_Inout_ xsapi_internal_vector<uint8_t>& output) :
+        m_output(output), m_bitBuffer(0), m_bitCount(0)
+    {
+    }
+
+    void write_bits(_In_ uint32_t value, _In_ uint32_t count)
+    {
+        m_bitBuffer |= static_cast<uint64_t>(value) << m_bitCount;
+        m_bitCount += count;
+        while (m_bitCount >= 8)
+        {
+            m_output.push_back(static_cast<uint8_t>(m_bitBuffer));
+            m_bitBuffer >>= 8;
+            m_bitCount -= 8;
+        }
+    }
+
+    // Huffman codes are packed starting from their most significant bit
+    void write_code(_In_ uint32_t code, _In_ uint32_t length)
+    {
+        uint32_t reversed = 0;
+        for (uint32_t i = 0; i < length; ++i)
+        {
+            reversed = (reversed << 1) | ((code >> i) & 1);
+        }
+        write_bits(reversed, length);
+    }
+
+    void flush()
+    {
+        if (m_bitCount > 0)
+        {
+            m_output.push_back(static_cast<uint8_t>(m_bitBuffer));
+            m_bitBuffer = 0;
+            m_bitCount = 0;
+        }
+    }
+
+private:
+    xsapi_internal_vector<uint8_t>& m_output;
+    uint64_t m_bitBuffer;
+    uint32_t m_bitCount;
+};
+
+void write_fixed_literal(_Inout_ bit_writer& writer, _In_ uint32_t symbol)
+{
+    if (symbol < 144)
+    {
+        writer.write_code(0x30 + symbol, 8);
+    }
+    else if (symbol < 256)
+    {
+        writer.write_code(0x190 + symbol - 144, 9);
+    }
+    else if (symbol < 280)
+    {
+        writer.write_code(symbol - 256, 7);
+    }
+    else
+    {
+        writer.write_code(0xC0 + symbol - 280, 8);
+    }
+}
+
+void write_fixed_match(_Inout_ bit_writer& writer, _In_ uint32_t length, _In_ uint32_t distance)
+{
+    uint32_t lengthCode = 28;
+    while (LENGTH_BASE[lengthCode] > length)
+    {
+        --lengthCode;
+    }
+    write_fixed_literal(writer, 257 + lengthCode);
+    writer.write_bits(length - LENGTH_BASE[lengthCode], LENGTH_EXTRA[lengthCode]);
+
+    uint32_t distCode = 29;
+    while (DIST_BASE[distCode] > distance)
+    {
+        --distCode;
+    }
+    writer.write_code(distCode, 5);
+    writer.write_bits(distance - DIST_BASE[distCode], DIST_EXTRA[distCode]);
+}
+
+uint32_t hash3(_In_reads_bytes_(3) const uint8_t* p)
+{
+    uint32_t value = (static_cast<uint32_t>(p[0]) << 16) | (static_cast<uint32_t>(p[1]) << 8) | p[2];
+    return (value * 2654435761u) >> (32 - DEFLATE_HASH_BITS);
+}
+
+class bit_reader
+{
+public:
+    bit_reader(_In_reads_bytes_(size) const uint8_t* data, _In_ size_t size) :
+        m_data(data), m_size(size), m_position(0), m_bitBuffer(0), m_bitCount(0), m_overrun(false)
+    {
+    }
+
+    uint32_t read_bits(_In_ uint32_t count)
+    {
+        while (m_bitCount < count)
+        {
+            if (m_position >= m_size)
+            {
+                m_overrun = true;
+                return 0;
+            }
+            m_bitBuffer |= static_cast<uint32_t>(m_data[m_position++]) << m_bitCount;
+            m_bitCount += 8;
+        }
+
+        uint32_t value = m_bitBuffer & ((1u << count) - 1);
+        m_bitBuffer >>= count;
+        m_bitCount -= count;
+        return value;
+    }
+
+    void align_to_byte()
+    {
+        m_bitBuffer = 0;
+        m_bitCount = 0;
+    }
+
+    bool read_bytes(_In_ size_t count, _Inout_ xsapi_internal_vector<uint8_t>& output)
+    {
+        if (m_size - m_position < count)
+        {
+            m_overrun = true;
+            return false;
+        }
+        output.insert(output.end(), m_data + m_position, m_data + m_position + count);
+        m_position += count;
+        return true;
+    }
+
+    // Only padding bits of the last byte are left
+    bool at_end() const { return m_position >= m_size && m_bitCount < 8; }
+
+    // Whole bytes already pulled into the bit buffer are returned to the stream
+    size_t bytes_consumed() const { return m_position - m_bitCount / 8; }
+    bool overrun() const { return m_overrun; }
+
+private:
+    const uint8_t* m_data;
+    size_t m_size;
+    size_t m_position;
+    uint32_t m_bitBuffer;
+    uint32_t m_bitCount;
+    bool m_overrun;
+};
+
+struct huffman_table
+{
+    uint16_t count[DEFLATE_MAX_BITS + 1];
+    uint16_t symbol[DEFLATE_MAX_LITLEN_CODES];
+};
+
+// Returns false for over-subscribed code lengths; incomplete codes are allowed as in zlib
+bool build_huffman_table(
+    _Out_ huffman_table& table,
+    _In_reads_(count) const uint8_t* lengths,
+    _In_ uint32_t count
+    )
+{
+    memset(&table, 0, sizeof(table));
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        ++table.count[lengths[i]];
+    }
+    if (table.count[0] == count)
+    {
+        return true;
+    }
+
+    int32_t left = 1;
+    for (uint32_t len = 1; len <= DEFLATE_MAX_BITS; ++len)
+    {
+        left <<= 1;
+        left -= table.count[len];
+        if (left < 0)
+        {
+            return false;
+        }
+    }
+
+    uint16_t offsets[DEFLATE_MAX_BITS + 1];
+    offsets[1] = 0;
+    for (uint32_t len = 1; len < DEFLATE_MAX_BITS; ++len)
+    {
+        offsets[len + 1] = offsets[len] + table.count[len];
+    }
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        if (lengths[i] != 0)
+        {
+            table.symbol[offsets[lengths[i]]++] = static_cast<uint16_t>(i);
+        }
+    }
+    return true;
+}
+
+int32_t decode_symbol(_Inout_ bit_reader& reader, _In_ const huffman_table& table)
+{
+    int32_t code = 0;
+    int32_t first = 0;
+    int32_t index = 0;
+    for (uint32_t len = 1; len <= DEFLATE_MAX_BITS; ++len)
+    {
+        code |= static_cast<int32_t>(reader.read_bits(1));
+        if (reader.overrun())
+        {
+            return -1;
+        }
+        int32_t count = table.count[len];
+        if (code - count < first)
+        {
+            return table.symbol[index + (code - first)];
+        }
+        index += count;
+        first += count;
+        first <<= 1;
+        code <<= 1;
+    }
+    return -1;
+}
+
+bool inflate_block(
+    _Inout_ bit_reader& reader,
+    _In_ const huffman_table& litLenTable,
+    _In_ const huffman_table& distTable,
+    _Inout_ xsapi_internal_vector<uint8_t>& output
+    )
+{
+    for (;;)
+    {
+        int32_t symbol = decode_symbol(reader, litLenTable);
+        if (symbol < 0)
+        {
+            return false;
+        }
+        if (symbol < 256)
+        {
+            output.push_back(static_cast<uint8_t>(symbol));
+        }
+        else if (symbol == 256)
+        {
+            return true;
+        }
+        else
+        {
+            symbol -= 257;
+            if (symbol >= 29)
+            {
+                return false;
+            }
+            uint32_t length = LENGTH_BASE[symbol] + reader.read_bits(LENGTH_EXTRA[symbol]);
+
+            int32_t distSymbol = decode_symbol(reader, distTable);
+            if (distSymbol < 0 || distSymbol >= static_cast<int32_t>(DEFLATE_MAX_DIST_CODES))
+            {
+                return false;
+            }
+            uint32_t distance = DIST_BASE[distSymbol] + reader.read_bits(DIST_EXTRA[distSymbol]);
+            if (reader.overrun() || distance > output.size())
+            {
+                return false;
+            }
+
+            size_t from = output.size() - distance;
+            for (uint32_t i = 0; i < length; ++i)
+            {
+                output.push_back(output[from + i]);
+            }
+        }
+
+        if (output.size() > MAX_DECOMPRESSED_BODY_SIZE)
+        {
+            return false;
+        }
+    }
+}
+
+bool read_dynamic_tables(
+    _Inout_ bit_reader& reader,
+    _Out_ huffman_table& litLenTable,
+    _Out_ huffman_table& distTable
+    )
+{
+    uint32_t litLenCount = reader.read_bits(5) + 257;
+    uint32_t distCount = reader.read_bits(5) + 1;
+    uint32_t codeLengthCount = reader.read_bits(4) + 4;
+    if (reader.overrun() || litLenCount > 286 || distCount > DEFLATE_MAX_DIST_CODES)
+    {
+        return false;
+    }
+
+    uint8_t lengths[DEFLATE_MAX_LITLEN_CODES + DEFLATE_MAX_DIST_CODES] = {};
+    for (uint32_t i = 0; i < codeLengthCount; ++i)
+    {
+        lengths[CODE_LENGTH_ORDER[i]] = static_cast<uint8_t>(reader.read_bits(3));
+    }
+
+    huffman_table codeLengthTable;
+    if (reader.overrun() || !build_huffman_table(codeLengthTable, lengths, 19))
+    {
+        return false;
+    }
+
+    memset(lengths, 0, sizeof(lengths));
+    uint32_t index = 0;
+    while (index < litLenCount + distCount)
+    {
+        int32_t symbol = decode_symbol(reader, codeLengthTable);
+        if (symbol < 0)
+        {
+            return false;
+        }
+
+        if (symbol < 16)
+        {
+            lengths[index++] = static_cast<uint8_t>(symbol);
+            continue;
+        }
+
+        uint8_t value = 0;
+        uint32_t repeat;
+        if (symbol == 16)
+        {
+            if (index == 0)
+            {
+                return false;
+            }
+            value = lengths[index - 1];
+            repeat = 3 + reader.read_bits(2);
+        }
+        else if (symbol == 17)
+        {
+            repeat = 3 + reader.read_bits(3);
+        }
+        else
+        {
+            repeat = 11 + reader.read_bits(7);
+        }
+
+        if (reader.overrun() || index + repeat > litLenCount + distCount)
+        {
+            return false;
+        }
+        while (repeat-- > 0)
+        {
+            lengths[index++] = value;
+        }
+    }
+
+    // A block without an end-of-block code can never terminate
+    if (lengths[256] == 0)
+    {
+        return false;
+    }
+
+    return build_huffman_table(litLenTable, lengths, litLenCount) &&
+        build_huffman_table(distTable, lengths + litLenCount, distCount);
+}
+
+uint32_t read_uint32_le(_In_reads_bytes_(4) const uint8_t* p)
+{
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+        (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+void append_uint32_le(_Inout_ xsapi_internal_vector<uint8_t>& output, _In_ uint32_t value)
+{
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        output.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+void append_uint32_be(_Inout_ xsapi_internal_vector<uint8_t>& output, _In_ uint32_t value)
+{
+    for (int32_t i = 3; i >= 0; --i)
+    {
+        output.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+}
+
+xsapi_internal_vector<uint8_t> http_compression::compress(
+    _In_ http_content_encoding encoding,
+    _In_reads_bytes_(size) const uint8_t* data,
+    _In_ size_t size
+    )
+{
+    xsapi_internal_vector<uint8_t> output;
+    output.reserve(size / 2 + 64);
+
+    switch (encoding)
+    {
+    case http_content_encoding::gzip:
+    {
+        const uint8_t header[10] = { 0x1f, 0x8b, 8, 0, 0, 0, 0, 0, 0, 0xff };
+        output.insert(output.end(), header, header + sizeof(header));
+        deflate(data, size, output);
+        append_uint32_le(output, crc32(data, size));
+        append_uint32_le(output, static_cast<uint32_t>(size));
+        break;
+    }
+    case http_content_encoding::deflate:
+        // The "deflate" content coding is the zlib format
+        output.push_back(0x78);
+        output.push_back(0x9c);
+        deflate(data, size, output);
+        append_uint32_be(output, adler32(data, size));
+        break;
+
+    default:
+        output.assign(data, data + size);
+        break;
+    }
+
+    return output;
+}
+
+bool http_compression::decompress(
+    _In_ http_content_encoding encoding,
+    _In_reads_bytes_(size) const uint8_t* data,
+    _In_ size_t size,
+    _Out_ xsapi_internal_vector<uint8_t>& output
+    )
+{
+    output.clear();
+    size_t consumed = 0;
+
+    switch (encoding)
+    {
+    case http_content_encoding::gzip:
+    {
+        if (size < 18 || data[0] != 0x1f || data[1] != 0x8b || data[2] != 8)
+        {
+            return false;
+        }
+
+        uint8_t flags = data[3];
+        size_t position = 10;
+        if (flags & 0x04) // FEXTRA
+        {
+            if (position + 2 > size)
+            {
+                return false;
+            }
+            position += 2 + (data[position] | (data[position + 1] << 8));
+        }
+        for (uint8_t flag : { static_cast<uint8_t>(0x08), static_cast<uint8_t>(0x10) }) // FNAME, FCOMMENT
+        {
+            if (flags & flag)
+            {
+                while (position < size && data[position] != 0)
+                {
+                    ++position;
+                }
+                ++position;
+            }
+        }
+        if (flags & 0x02) // FHCRC
+        {
+            position += 2;
+        }
+
+        if (position + 8 > size ||
+            !inflate(data + position, size - position - 8, consumed, output))
+        {
+            return false;
+        }
+
+        const uint8_t* trailer = data + position + consumed;
+        if (trailer + 8 > data + size)
+        {
+            return false;
+        }
+        return read_uint32_le(trailer) == crc32(output.data(), output.size()) &&
+            read_uint32_le(trailer + 4) == static_cast<uint32_t>(output.size());
+    }
+
+    case http_content_encoding::deflate:
+    {
+        // Some servers send raw DEFLATE instead of zlib for this coding, so only strip a valid zlib header
+        bool hasZlibHeader = size >= 2 && (data[0] & 0x0f) == 8 && ((data[0] << 8) | data[1]) % 31 == 0;
+        if (!hasZlibHeader)
+        {
+            return inflate(data, size, consumed, output);
+        }
+        if ((data[1] & 0x20) != 0) // preset dictionaries are not used by HTTP
+        {
+            return false;
+        }
+        if (!inflate(data + 2, size - 2, consumed, output))
+        {
+            return false;
+        }
+
+        const uint8_t* trailer = data + 2 + consumed;
+        if (trailer + 4 > data + size)
+        {
+            return false;
+        }
+        uint32_t expected = (static_cast<uint32_t>(trailer[0]) << 24) | (static_cast<uint32_t>(trailer[1]) << 16) |
+            (static_cast<uint32_t>(trailer[2]) << 8) | trailer[3];
+        return expected == adler32(output.data(), output.size());
+    }
+
+    default:
+        output.assign(data, data + size);
+        return true;
+    }
+}
+
+void http_compression::deflate(
+    _In_reads_bytes_(size) const uint8_t* data,
+    _In_ size_t size,
+    _Inout_ xsapi_internal_vector<uint8_t>& output
+    )
+{
+    bit_writer writer(output);
+    writer.write_bits(1, 1); // BFINAL
+    writer.write_bits(1, 2); // BTYPE = fixed Huffman
+
+    xsapi_internal_vector<int32_t> head(DEFLATE_HASH_SIZE, -1);
+    xsapi_internal_vector<int32_t> prev(DEFLATE_WINDOW_SIZE, -1);
+
+    size_t position = 0;
+    while (position < size)
+    {
+        uint32_t bestLength = 0;
+        uint32_t bestDistance = 0;
+
+        if (position + DEFLATE_MIN_MATCH <= size)
+        {
+            uint32_t hash = hash3(data + position);
+            uint32_t maxLength = static_cast<uint32_t>(std::min<size_t>(DEFLATE_MAX_MATCH, size - position));
+
+            int32_t candidate = head[hash];
+            for (uint32_t chain = 0; candidate >= 0 && chain < DEFLATE_MAX_CHAIN; ++chain)
+            {
+                size_t distance = position - candidate;
+                if (distance > DEFLATE_WINDOW_SIZE)
+                {
+                    break;
+                }
+
+                uint32_t length = 0;
+                while (length < maxLength && data[candidate + length] == data[position + length])
+                {
+                    ++length;
+                }
+                if (length > bestLength)
+                {
+                    bestLength = length;
+                    bestDistance = static_cast<uint32_t>(distance);
+                    if (length == maxLength)
+                    {
+                        break;
+                    }
+                }
+
+                int32_t next = prev[candidate & (DEFLATE_WINDOW_SIZE - 1)];
+                if (next >= candidate)
+                {
+                    break;
+                }
+                candidate = next;
+            }
+        }
+
+        size_t advance = 1;
+        if (bestLength >= DEFLATE_MIN_MATCH)
+        {
+            write_fixed_match(writer, bestLength, bestDistance);
+            advance = bestLength;
+        }
+        else
+        {
+            write_fixed_literal(writer, data[position]);
+        }
+
+        // Index every position covered so later matches can reference inside this one
+        for (size_t i = 0; i < advance; ++i, ++position)
+        {
+            if (position + DEFLATE_MIN_MATCH <= size)
+            {
+                uint32_t hash = hash3(data + position);
+                prev[position & (DEFLATE_WINDOW_SIZE - 1)] = head[hash];
+                head[hash] = static_cast<int32_t>(position);
+            }
+        }
+    }
+
+    write_fixed_literal(writer, 256);
+    writer.flush();
+}
+
+bool http_compression::inflate(
+    _In_reads_bytes_(size) const uint8_t* data,
+    _In_ size_t size,
+    _Out_ size_t& bytesConsumed,
+    _Inout_ xsapi_internal_vector<uint8_t>& output,
+    _In_ bool stopAtEndOfInput
+    )
+{
+    bytesConsumed = 0;
+    bit_reader reader(data, size);
+
+    huffman_table fixedLitLen;
+    huffman_table fixedDist;
+    bool fixedBuilt = false;
+
+    uint32_t isFinal = 0;
+    do
+    {
+        isFinal = reader.read_bits(1);
+        uint32_t type = reader.read_bits(2);
+        if (reader.overrun())
+        {
+            return false;
+        }
+
+        if (type == 0)
+        {
+            reader.align_to_byte();
+            uint32_t length = reader.read_bits(16);
+            uint32_t lengthComplement = reader.read_bits(16);
+            if (reader.overrun() || (length ^ 0xffff) != lengthComplement || !reader.read_bytes(length, output))
+            {
+                return false;
+            }
+        }
+        else if (type == 1)
+        {
+            if (!fixedBuilt)
+            {
+                uint8_t lengths[DEFLATE_MAX_LITLEN_CODES];
+                memset(lengths, 8, 144);
+                memset(lengths + 144, 9, 112);
+                memset(lengths + 256, 7, 24);
+                memset(lengths + 280, 8, 8);
+                build_huffman_table(fixedLitLen, lengths, DEFLATE_MAX_LITLEN_CODES);
+                memset(lengths, 5, DEFLATE_MAX_DIST_CODES);
+                build_huffman_table(fixedDist, lengths, DEFLATE_MAX_DIST_CODES);
+                fixedBuilt = true;
+            }
+            if (!inflate_block(reader, fixedLitLen, fixedDist, output))
+            {
+                return false;
+            }
+        }
+        else if (type == 2)
+        {
+            huffman_table litLenTable;
+            huffman_table distTable;
+            if (!read_dynamic_tables(reader, litLenTable, distTable) ||
+                !inflate_block(reader, litLenTable, distTable, output))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            return false;
+        }
+
+        if (output.size() > MAX_DECOMPRESSED_BODY_SIZE)
+        {
+            return false;
+        }
+    } while (!isFinal && !(stopAtEndOfInput && reader.at_end()));
+
+    bytesConsumed = reader.bytes_consumed();
+    return true;
+}
+
+bool http_compression::inflate_message(
+    _In_reads_bytes_(size) const uint8_t* data,
+    _In_ size_t size,
+    _Inout_ xsapi_internal_vector<uint8_t>& history,
+    _Out_ xsapi_internal_vector<uint8_t>& output
+    )
+{
+    output.clear();
+
+    // Senders strip the empty stored block a sync flush ends each message with, so put it back
+    xsapi_internal_vector<uint8_t> input(data, data + size);
+    input.insert(input.end(), { 0x00, 0x00, 0xff, 0xff });
+
+    size_t historySize = history.size();
+    size_t consumed = 0;
+    if (!inflate(input.data(), input.size(), consumed, history, true))
+    {
+        history.resize(historySize);
+        return false;
+    }
+
+    output.assign(history.begin() + historySize, history.end());
+    if (history.size() > DEFLATE_WINDOW_SIZE)
+    {
+        history.erase(history.begin(), history.end() - DEFLATE_WINDOW_SIZE);
+    }
+    return true;
+}
+
+http_content_encoding http_compression::content_encoding_from_string(_In_ const xsapi_internal_string& value)
+{
+    if (utils::str_icmp(value, "gzip") == 0 || utils::str_icmp(value, "x-gzip") == 0)
+    {
+        return http_content_encoding::gzip;
+    }
+    if (utils::str_icmp(value, "deflate") == 0)
+    {
+        return http_content_encoding::deflate;
+    }
+    return http_content_encoding::identity;
+}
+
+const char* http_compression::content_encoding_to_string(_In_ http_content_encoding encoding)
+{
+    switch (encoding)
+    {
+    case http_content_encoding::gzip: return "gzip";
+    case http_content_encoding::deflate: return "deflate";
+    default: return "identity";
+    }
+}
+
+uint32_t http_compression::crc32(_In_reads_bytes_(size) const uint8_t* data, _In_ size_t size)
+{
+    static const struct crc_table
+    {
+        crc_table()
+        {
+            for (uint32_t n = 0; n < 256; ++n)
+            {
+                uint32_t c = n;
+                for (uint32_t k = 0; k < 8; ++k)
+                {
+                    c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+                }
+                entries[n] = c;
+            }
+        }
+        uint32_t entries[256];
+    } table;
+
+    uint32_t crc = 0xffffffffu;
+    for (size_t i = 0; i < size; ++i)
+    {
+        crc = table.entries[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+    }
+    return crc ^ 0xffffffffu;
+}
+
+uint32_t http_compression::adler32(_In_reads_bytes_(size) const uint8_t* data, _In_ size_t size)
+{
+    const uint32_t ADLER_MOD = 65521;
+    uint32_t a = 1;
+    uint32_t b = 0;
+    while (size > 0)
+    {
+        // 5552 is the most bytes that can be summed before b can overflow 32 bits
+        size_t chunk = std::min<size_t>(size, 5552);
+        size -= chunk;
+        while (chunk-- > 0)
+        {
+            a += *data++;
+            b += a;
+        }
+        a %= ADLER_MOD;
+        b %= ADLER_MOD;
+    }
+    return (b << 16) | a;
+}
+
+http_compression_policy::http_compression_policy() :
+    m_requestEncoding(http_content_encoding::gzip),
+    m_requestThreshold(DEFAULT_REQUEST_COMPRESSION_THRESHOLD_BYTES)
+{
+    // Uploads that routinely carry large JSON documents
+    m_requestApis.insert(static_cast<uint32_t>(xbox_live_api::update_stats_value_document));
+    m_requestApis.insert(static_cast<uint32_t>(xbox_live_api::write_session_using_subpath));
+    m_requestApis.insert(static_cast<uint32_t>(xbox_live_api::submit_batch_reputation_feedback));
+
+    // Reads that return large JSON documents
+    m_responseApis.insert(static_cast<uint32_t>(xbox_live_api::browse_catalog_bundles_helper));
+    m_responseApis.insert(static_cast<uint32_t>(xbox_live_api::browse_catalog_helper));
+    m_responseApis.insert(static_cast<uint32_t>(xbox_live_api::get_catalog_item_details));
+    m_responseApis.insert(static_cast<uint32_t>(xbox_live_api::get_leaderboard_internal));
+    m_responseApis.insert(static_cast<uint32_t>(xbox_live_api::get_leaderboard_for_social_group_internal));
+    m_responseApis.insert(static_cast<uint32_t>(xbox_live_api::get_social_graph));
+    m_responseApis.insert(static_cast<uint32_t>(xbox_live_api::get_social_relationships));
+}
+
+std::shared_ptr<http_compression_policy> http_compression_policy::get_singleton_instance()
+{
+    auto xsapiSingleton = get_xsapi_singleton();
+    std::lock_guard<std::mutex> guard(xsapiSingleton->m_singletonLock);
+    if (xsapiSingleton->m_httpCompressionPolicySingleton == nullptr)
+    {
+        xsapiSingleton->m_httpCompressionPolicySingleton = xsapi_allocate_shared<http_compression_policy>();
+    }
+    return xsapiSingleton->m_httpCompressionPolicySingleton;
+}
+
+void http_compression_policy::set_request_encoding(_In_ http_content_encoding encoding)
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_requestEncoding = encoding;
+}
+
+http_content_encoding http_compression_policy::request_encoding() const
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_requestEncoding;
+}
+
+void http_compression_policy::set_request_threshold(_In_ size_t thresholdBytes)
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_requestThreshold = thresholdBytes;
+}
+
+size_t http_compression_policy::request_threshold() const
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_requestThreshold;
+}
+
+void http_compression_policy::set_compress_request(_In_ xbox_live_api xboxLiveApi, _In_ bool value)
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    if (value)
+    {
+        m_requestApis.insert(static_cast<uint32_t>(xboxLiveApi));
+    }
+    else
+    {
+        m_requestApis.erase(static_cast<uint32_t>(xboxLiveApi));
+    }
+}
+
+bool http_compression_policy::compress_request(_In_ xbox_live_api xboxLiveApi) const
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_requestApis.find(static_cast<uint32_t>(xboxLiveApi)) != m_requestApis.end();
+}
+
+void http_compression_policy::set_accept_compressed_response(_In_ xbox_live_api xboxLiveApi, _In_ bool value)
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    if (value)
+    {
+        m_responseApis.insert(static_cast<uint32_t>(xboxLiveApi));
+    }
+    else
+    {
+        m_responseApis.erase(static_cast<uint32_t>(xboxLiveApi));
+    }
+}
+
+bool http_compression_policy::accept_compressed_response(_In_ xbox_live_api xboxLiveApi) const
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_responseApis.find(static_cast<uint32_t>(xboxLiveApi)) != m_responseApis.end();
+}
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
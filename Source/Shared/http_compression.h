@@ -0,0 +1,107 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#pragma once
+#include "http_call_impl.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
+
+const size_t DEFAULT_REQUEST_COMPRESSION_THRESHOLD_BYTES = 1024;
+const size_t MAX_DECOMPRESSED_BODY_SIZE = 64 * 1024 * 1024;
+
+enum class http_content_encoding
+{
+    identity,
+    gzip,
+    deflate
+};
+
+/// <summary>
+/// Self contained DEFLATE (RFC 1951) codec with gzip (RFC 1952) and zlib (RFC 1950) framing, used for
+/// the Content-Encoding of request and response bodies.  The encoder does LZ77 with hash chains and
+/// emits fixed Huffman blocks; the decoder handles stored, fixed and dynamic blocks.
+/// </summary>
+class http_compression
+{
+public:
+    static xsapi_internal_vector<uint8_t> compress(
+        _In_ http_content_encoding encoding,
+        _In_reads_bytes_(size) const uint8_t* data,
+        _In_ size_t size
+        );
+
+    /// <summary>
+    /// Returns false if the data is malformed, fails its checksum, or would expand past MAX_DECOMPRESSED_BODY_SIZE.
+    /// </summary>
+    static bool decompress(
+        _In_ http_content_encoding encoding,
+        _In_reads_bytes_(size) const uint8_t* data,
+        _In_ size_t size,
+        _Out_ xsapi_internal_vector<uint8_t>& output
+        );
+
+    /// <summary>
+    /// Inflates one permessage-deflate (RFC 7692) message.  history holds the output of earlier messages on the
+    /// same connection so back references into them resolve; it is trimmed to the 32KB window and left untouched on failure.
+    /// </summary>
+    static bool inflate_message(
+        _In_reads_bytes_(size) const uint8_t* data,
+        _In_ size_t size,
+        _Inout_ xsapi_internal_vector<uint8_t>& history,
+        _Out_ xsapi_internal_vector<uint8_t>& output
+        );
+
+    static http_content_encoding content_encoding_from_string(_In_ const xsapi_internal_string& value);
+    static const char* content_encoding_to_string(_In_ http_content_encoding encoding);
+
+    static uint32_t crc32(_In_reads_bytes_(size) const uint8_t* data, _In_ size_t size);
+    static uint32_t adler32(_In_reads_bytes_(size) const uint8_t* data, _In_ size_t size);
+
+private:
+    static void deflate(
+        _In_reads_bytes_(size) const uint8_t* data,
+        _In_ size_t size,
+        _Inout_ xsapi_internal_vector<uint8_t>& output
+        );
+
+    static bool inflate(
+        _In_reads_bytes_(size) const uint8_t* data,
+        _In_ size_t size,
+        _Out_ size_t& bytesConsumed,
+        _Inout_ xsapi_internal_vector<uint8_t>& output,
+        _In_ bool stopAtEndOfInput = false
+        );
+};
+
+/// <summary>
+/// Decides which request bodies are compressed and which responses are negotiated with Accept-Encoding.
+/// Only used for calls whose xbox_live_context_settings opt in with set_use_http_compression.
+/// </summary>
+class http_compression_policy
+{
+public:
+    http_compression_policy();
+
+    static std::shared_ptr<http_compression_policy> get_singleton_instance();
+
+    void set_request_encoding(_In_ http_content_encoding encoding);
+    http_content_encoding request_encoding() const;
+
+    void set_request_threshold(_In_ size_t thresholdBytes);
+    size_t request_threshold() const;
+
+    void set_compress_request(_In_ xbox_live_api xboxLiveApi, _In_ bool value);
+    bool compress_request(_In_ xbox_live_api xboxLiveApi) const;
+
+    void set_accept_compressed_response(_In_ xbox_live_api xboxLiveApi, _In_ bool value);
+    bool accept_compressed_response(_In_ xbox_live_api xboxLiveApi) const;
+
+private:
+    mutable std::mutex m_lock;
+    http_content_encoding m_requestEncoding;
+    size_t m_requestThreshold;
+    xsapi_internal_unordered_set<uint32_t> m_requestApis;
+    xsapi_internal_unordered_set<uint32_t> m_responseApis;
+};
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
@@ -0,0 +1,166 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#pragma once
+#include "json_reader.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
+
+/// <summary>
+/// One entry in a type's field table.  read is called with the reader on the first token of the
+/// member's value and must leave it on the last token of that value.
+/// </summary>
+template<typename T>
+struct json_field
+{
+    const char* name;
+    bool (*read)(_Inout_ json_reader& reader, _Inout_ T& target);
+};
+
+/// <summary>
+/// Reads the object at the current token into target, dispatching each member through the field table.
+/// Members not in the table are skipped.  A null value leaves target untouched.
+/// </summary>
+template<typename T, size_t N>
+bool json_read_object(
+    _Inout_ json_reader& reader,
+    _Inout_ T& target,
+    _In_ const json_field<T> (&fields)[N]
+    )
+{
+    if (reader.token() == json_token::null)
+    {
+        return true;
+    }
+    if (reader.token() != json_token::begin_object)
+    {
+        return false;
+    }
+
+    while (reader.next() == json_token::key)
+    {
+        const json_field<T>* field = nullptr;
+        for (size_t i = 0; i < N; ++i)
+        {
+            if (reader.string_equals(fields[i].name))
+            {
+                field = &fields[i];
+                break;
+            }
+        }
+
+        if (reader.next() == json_token::error)
+        {
+            return false;
+        }
+
+        bool succeeded = field != nullptr ? field->read(reader, target) : reader.skip_value();
+        if (!succeeded)
+        {
+            return false;
+        }
+    }
+
+    return reader.token() == json_token::end_object;
+}
+
+/// <summary>
+/// Reads the array at the current token, calling readElement with the reader on the first token of each element.
+/// A null value is treated as an empty array.
+/// </summary>
+template<typename Fn>
+bool json_read_array(
+    _Inout_ json_reader& reader,
+    _In_ Fn readElement
+    )
+{
+    if (reader.token() == json_token::null)
+    {
+        return true;
+    }
+    if (reader.token() != json_token::begin_array)
+    {
+        return false;
+    }
+
+    while (true)
+    {
+        json_token token = reader.next();
+        if (token == json_token::end_array)
+        {
+            return true;
+        }
+        if (token == json_token::error || !readElement(reader))
+        {
+            return false;
+        }
+    }
+}
+
+// Scalar readers mirror the utils::extract_json_* defaults: a value of the wrong type is skipped and leaves the target unchanged
+
+inline bool json_read_value(_Inout_ json_reader& reader, _Inout_ bool& value)
+{
+    if (reader.token() == json_token::boolean)
+    {
+        value = reader.bool_value();
+    }
+    return reader.skip_value();
+}
+
+inline bool json_read_value(_Inout_ json_reader& reader, _Inout_ int32_t& value)
+{
+    if (reader.token() == json_token::number)
+    {
+        value = static_cast<int32_t>(reader.int64_value());
+    }
+    return reader.skip_value();
+}
+
+inline bool json_read_value(_Inout_ json_reader& reader, _Inout_ uint32_t& value)
+{
+    if (reader.token() == json_token::number)
+    {
+        value = static_cast<uint32_t>(reader.uint64_value());
+    }
+    return reader.skip_value();
+}
+
+inline bool json_read_value(_Inout_ json_reader& reader, _Inout_ uint64_t& value)
+{
+    if (reader.token() == json_token::number)
+    {
+        value = reader.uint64_value();
+    }
+    return reader.skip_value();
+}
+
+inline bool json_read_value(_Inout_ json_reader& reader, _Inout_ double& value)
+{
+    if (reader.token() == json_token::number)
+    {
+        value = reader.double_value();
+    }
+    return reader.skip_value();
+}
+
+inline bool json_read_value(_Inout_ json_reader& reader, _Inout_ xsapi_internal_string& value)
+{
+    if (reader.token() == json_token::string)
+    {
+        value = reader.string_value();
+    }
+    return reader.skip_value();
+}
+
+template<size_t N>
+bool json_read_value(_Inout_ json_reader& reader, _Inout_ char_t (&value)[N])
+{
+    if (reader.token() == json_token::string)
+    {
+        reader.copy_string_value(value, N);
+    }
+    return reader.skip_value();
+}
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
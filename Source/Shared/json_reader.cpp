@@ -0,0 +1,525 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "pch.h"
+#include "json_reader.h"
+#include "utils.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
+
+namespace
+{
+void append_utf8(_Inout_ xsapi_internal_string& output, _In_ uint32_t codePoint)
+{
+    if (codePoint < 0x80)
+    {
+        output.push_back(static_cast<char>(codePoint));
+    }
+    else if (codePoint < 0x800)
+    {
+        output.push_back(static_cast<char>(0xc0 | (codePoint >> 6)));
+        output.push_back(static_cast<char>(0x80 | (codePoint & 0x3f)));
+    }
+    else if (codePoint < 0x10000)
+    {
+        output.push_back(static_cast<char>(0xe0 | (codePoint >> 12)));
+        output.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3f)));
+        output.push_back(static_cast<char>(0x80 | (codePoint & 0x3f)));
+    }
+    else
+    {
+        output.push_back(static_cast<char>(0xf0 | (codePoint >> 18)));
+        output.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3f)));
+        output.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3f)));
+        output.push_back(static_cast<char>(0x80 | (codePoint & 0x3f)));
+    }
+}
+
+bool is_digit(_In_ char c)
+{
+    return c >= '0' && c <= '9';
+}
+}
+
+json_reader::json_reader(
+    _In_reads_bytes_(size) const char* data,
+    _In_ size_t size
+    ) :
+    m_begin(data),
+    m_position(data),
+    m_end(data + size),
+    m_token(json_token::none),
+    m_state(reader_state::value),
+    m_boolValue(false)
+{
+}
+
+json_reader::json_reader(_In_ const xsapi_internal_string& document) :
+    json_reader(document.data(), document.size())
+{
+}
+
+json_token
+json_reader::next()
+{
+    if (m_token == json_token::error)
+    {
+        return m_token;
+    }
+
+    skip_whitespace();
+    if (m_state == reader_state::done)
+    {
+        return m_position == m_end ? set_token(json_token::end_of_input) : fail();
+    }
+    if (m_position == m_end)
+    {
+        return fail();
+    }
+
+    char c = *m_position;
+    switch (m_state)
+    {
+    case reader_state::comma_or_end:
+    {
+        char container = m_containers.back();
+        if (c == ',')
+        {
+            ++m_position;
+            m_state = container == '{' ? reader_state::key : reader_state::value;
+            return next();
+        }
+        if (c != (container == '{' ? '}' : ']'))
+        {
+            return fail();
+        }
+        ++m_position;
+        m_containers.pop_back();
+        after_value();
+        return set_token(container == '{' ? json_token::end_object : json_token::end_array);
+    }
+
+    case reader_state::key_or_end:
+        if (c == '}')
+        {
+            ++m_position;
+            m_containers.pop_back();
+            after_value();
+            return set_token(json_token::end_object);
+        }
+        // fall through
+
+    case reader_state::key:
+        if (c != '"' || !read_string())
+        {
+            return fail();
+        }
+        skip_whitespace();
+        if (m_position == m_end || *m_position != ':')
+        {
+            return fail();
+        }
+        ++m_position;
+        m_state = reader_state::value;
+        return set_token(json_token::key);
+
+    case reader_state::value_or_end:
+        if (c == ']')
+        {
+            ++m_position;
+            m_containers.pop_back();
+            after_value();
+            return set_token(json_token::end_array);
+        }
+        // fall through
+
+    default:
+        return read_value();
+    }
+}
+
+json_token
+json_reader::token() const
+{
+    return m_token;
+}
+
+bool
+json_reader::skip_value()
+{
+    if (m_token == json_token::key)
+    {
+        next();
+    }
+
+    if (m_token == json_token::begin_object || m_token == json_token::begin_array)
+    {
+        size_t targetDepth = m_containers.size() - 1;
+        while (m_containers.size() > targetDepth)
+        {
+            if (next() == json_token::error)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    return m_token != json_token::error && m_token != json_token::end_of_input && m_token != json_token::none;
+}
+
+bool
+json_reader::find_member(_In_z_ const char* key)
+{
+    if (m_token != json_token::begin_object)
+    {
+        return false;
+    }
+
+    while (next() == json_token::key)
+    {
+        if (string_equals(key))
+        {
+            next();
+            return !has_error();
+        }
+        if (!skip_value())
+        {
+            return false;
+        }
+    }
+    return false;
+}
+
+const xsapi_internal_string&
+json_reader::string_value() const
+{
+    return m_stringValue;
+}
+
+bool
+json_reader::string_equals(_In_z_ const char* value) const
+{
+    return strcmp(m_stringValue.c_str(), value) == 0;
+}
+
+bool
+json_reader::bool_value() const
+{
+    return m_boolValue;
+}
+
+int64_t
+json_reader::int64_value() const
+{
+    return m_token == json_token::number ? strtoll(m_stringValue.c_str(), nullptr, 10) : 0;
+}
+
+uint64_t
+json_reader::uint64_value() const
+{
+    if (m_token != json_token::number || m_stringValue[0] == '-')
+    {
+        return 0;
+    }
+    return strtoull(m_stringValue.c_str(), nullptr, 10);
+}
+
+double
+json_reader::double_value() const
+{
+    return m_token == json_token::number ? strtod(m_stringValue.c_str(), nullptr) : 0;
+}
+
+void
+json_reader::copy_string_value(
+    _Out_writes_(size) char_t* buffer,
+    _In_ size_t size
+    ) const
+{
+    if (size == 0)
+    {
+        return;
+    }
+
+#ifdef _WIN32
+    int required = MultiByteToWideChar(CP_UTF8, 0, m_stringValue.data(), static_cast<int>(m_stringValue.size()), nullptr, 0);
+    if (static_cast<size_t>(required) < size)
+    {
+        MultiByteToWideChar(CP_UTF8, 0, m_stringValue.data(), static_cast<int>(m_stringValue.size()), buffer, required);
+        buffer[required] = 0;
+    }
+    else
+    {
+        auto converted = utils::string_t_from_internal_string(m_stringValue);
+        wcsncpy_s(buffer, size, converted.c_str(), size - 1);
+    }
+#else
+    size_t length = __min(size - 1, m_stringValue.size());
+    memcpy(buffer, m_stringValue.data(), length);
+    buffer[length] = 0;
+#endif
+}
+
+bool
+json_reader::has_error() const
+{
+    return m_token == json_token::error;
+}
+
+size_t
+json_reader::depth() const
+{
+    return m_containers.size();
+}
+
+size_t
+json_reader::position() const
+{
+    return static_cast<size_t>(m_position - m_begin);
+}
+
+json_token
+json_reader::set_token(_In_ json_token token)
+{
+    m_token = token;
+    return token;
+}
+
+json_token
+json_reader::fail()
+{
+    m_state = reader_state::done;
+    return set_token(json_token::error);
+}
+
+void
+json_reader::after_value()
+{
+    m_state = m_containers.empty() ? reader_state::done : reader_state::comma_or_end;
+}
+
+void
+json_reader::skip_whitespace()
+{
+    while (m_position < m_end && (*m_position == ' ' || *m_position == '\t' || *m_position == '\n' || *m_position == '\r'))
+    {
+        ++m_position;
+    }
+}
+
+json_token
+json_reader::read_value()
+{
+    switch (*m_position)
+    {
+    case '{':
+    case '[':
+        if (m_containers.size() >= MAX_JSON_READER_DEPTH)
+        {
+            return fail();
+        }
+        m_containers.push_back(*m_position);
+        m_state = *m_position == '{' ? reader_state::key_or_end : reader_state::value_or_end;
+        ++m_position;
+        return set_token(m_containers.back() == '{' ? json_token::begin_object : json_token::begin_array);
+
+    case '"':
+        if (!read_string())
+        {
+            return fail();
+        }
+        after_value();
+        return set_token(json_token::string);
+
+    case 't':
+    case 'f':
+        m_boolValue = *m_position == 't';
+        if (!read_literal(m_boolValue ? "true" : "false"))
+        {
+            return fail();
+        }
+        after_value();
+        return set_token(json_token::boolean);
+
+    case 'n':
+        if (!read_literal("null"))
+        {
+            return fail();
+        }
+        after_value();
+        return set_token(json_token::null);
+
+    default:
+        if (!read_number())
+        {
+            return fail();
+        }
+        after_value();
+        return set_token(json_token::number);
+    }
+}
+
+bool
+json_reader::read_string()
+{
+    // m_position is on the opening quote
+    ++m_position;
+    m_stringValue.clear();
+
+    while (m_position < m_end)
+    {
+        // Copy runs of plain characters in one go
+        const char* runStart = m_position;
+        while (m_position < m_end && *m_position != '"' && *m_position != '\\' && static_cast<uint8_t>(*m_position) >= 0x20)
+        {
+            ++m_position;
+        }
+        m_stringValue.append(runStart, m_position);
+
+        if (m_position == m_end || static_cast<uint8_t>(*m_position) < 0x20)
+        {
+            return false;
+        }
+        if (*m_position == '"')
+        {
+            ++m_position;
+            return true;
+        }
+
+        // Escape sequence
+        if (++m_position == m_end)
+        {
+            return false;
+        }
+        char escaped = *m_position++;
+        switch (escaped)
+        {
+        case '"': m_stringValue.push_back('"'); break;
+        case '\\': m_stringValue.push_back('\\'); break;
+        case '/': m_stringValue.push_back('/'); break;
+        case 'b': m_stringValue.push_back('\b'); break;
+        case 'f': m_stringValue.push_back('\f'); break;
+        case 'n': m_stringValue.push_back('\n'); break;
+        case 'r': m_stringValue.push_back('\r'); break;
+        case 't': m_stringValue.push_back('\t'); break;
+        case 'u':
+        {
+            uint32_t codePoint;
+            if (!read_hex4(codePoint))
+            {
+                return false;
+            }
+            if (codePoint >= 0xd800 && codePoint <= 0xdbff)
+            {
+                uint32_t lowSurrogate;
+                if (m_end - m_position < 6 || m_position[0] != '\\' || m_position[1] != 'u')
+                {
+                    return false;
+                }
+                m_position += 2;
+                if (!read_hex4(lowSurrogate) || lowSurrogate < 0xdc00 || lowSurrogate > 0xdfff)
+                {
+                    return false;
+                }
+                codePoint = 0x10000 + ((codePoint - 0xd800) << 10) + (lowSurrogate - 0xdc00);
+            }
+            else if (codePoint >= 0xdc00 && codePoint <= 0xdfff)
+            {
+                return false;
+            }
+            append_utf8(m_stringValue, codePoint);
+            break;
+        }
+        default:
+            return false;
+        }
+    }
+
+    return false;
+}
+
+bool
+json_reader::read_literal(_In_z_ const char* literal)
+{
+    size_t length = strlen(literal);
+    if (static_cast<size_t>(m_end - m_position) < length || memcmp(m_position, literal, length) != 0)
+    {
+        return false;
+    }
+    m_position += length;
+    return true;
+}
+
+bool
+json_reader::read_number()
+{
+    const char* start = m_position;
+    if (m_position < m_end && *m_position == '-')
+    {
+        ++m_position;
+    }
+
+    if (m_position == m_end || !is_digit(*m_position))
+    {
+        return false;
+    }
+    if (*m_position == '0')
+    {
+        ++m_position;
+    }
+    else
+    {
+        while (m_position < m_end && is_digit(*m_position)) ++m_position;
+    }
+
+    if (m_position < m_end && *m_position == '.')
+    {
+        ++m_position;
+        if (m_position == m_end || !is_digit(*m_position))
+        {
+            return false;
+        }
+        while (m_position < m_end && is_digit(*m_position)) ++m_position;
+    }
+
+    if (m_position < m_end && (*m_position == 'e' || *m_position == 'E'))
+    {
+        ++m_position;
+        if (m_position < m_end && (*m_position == '+' || *m_position == '-'))
+        {
+            ++m_position;
+        }
+        if (m_position == m_end || !is_digit(*m_position))
+        {
+            return false;
+        }
+        while (m_position < m_end && is_digit(*m_position)) ++m_position;
+    }
+
+    m_stringValue.assign(start, m_position);
+    return true;
+}
+
+bool
+json_reader::read_hex4(_Out_ uint32_t& value)
+{
+    value = 0;
+    if (m_end - m_position < 4)
+    {
+        return false;
+    }
+
+    for (int i = 0; i < 4; ++i)
+    {
+        char c = *m_position++;
+        value <<= 4;
+        if (c >= '0' && c <= '9') value |= c - '0';
+        else if (c >= 'a' && c <= 'f') value |= c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') value |= c - 'A' + 10;
+        else return false;
+    }
+    return true;
+}
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
@@ -0,0 +1,122 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#pragma once
+#include "shared_macros.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
+
+const uint32_t MAX_JSON_READER_DEPTH = 128;
+
+enum class json_token
+{
+    none,
+    begin_object,
+    end_object,
+    begin_array,
+    end_array,
+    key,
+    string,
+    number,
+    boolean,
+    null,
+    end_of_input,
+    error
+};
+
+/// <summary>
+/// Forward only pull parser over a UTF-8 JSON document.  Each call to next() scans exactly one token,
+/// so callers deserialize straight into their own types without building a web::json::value.
+/// Key and string tokens are unescaped into a buffer that is reused for the whole document.
+/// The document must outlive the reader.
+/// </summary>
+class json_reader
+{
+public:
+    json_reader(
+        _In_reads_bytes_(size) const char* data,
+        _In_ size_t size
+        );
+
+    json_reader(_In_ const xsapi_internal_string& document);
+
+    /// <summary>
+    /// Scans the next token.  After a key token the next call returns the start of its value.
+    /// Once an error is hit every later call returns json_token::error.
+    /// </summary>
+    json_token next();
+
+    json_token token() const;
+
+    /// <summary>
+    /// Skips the value that starts at the current token, including any nested objects or arrays.
+    /// Leaves the reader on the last token of the value.
+    /// </summary>
+    bool skip_value();
+
+    /// <summary>
+    /// Moves to the value of the member named key in the object that starts at the current token,
+    /// skipping all members before it.  Returns false if the object has no such member.
+    /// </summary>
+    bool find_member(_In_z_ const char* key);
+
+    /// <summary>
+    /// The unescaped UTF-8 text of a key or string token, or the literal text of a number token.
+    /// </summary>
+    const xsapi_internal_string& string_value() const;
+
+    bool string_equals(_In_z_ const char* value) const;
+
+    bool bool_value() const;
+    int64_t int64_value() const;
+    uint64_t uint64_value() const;
+    double double_value() const;
+
+    /// <summary>
+    /// Copies the current string token into a fixed size char_t buffer, truncating it if needed.
+    /// </summary>
+    void copy_string_value(
+        _Out_writes_(size) char_t* buffer,
+        _In_ size_t size
+        ) const;
+
+    bool has_error() const;
+    size_t depth() const;
+
+    /// <summary>
+    /// Byte offset of the next unread character, useful when reporting malformed documents.
+    /// </summary>
+    size_t position() const;
+
+private:
+    enum class reader_state
+    {
+        value,
+        value_or_end,
+        key,
+        key_or_end,
+        comma_or_end,
+        done
+    };
+
+    json_token set_token(_In_ json_token token);
+    json_token fail();
+    void after_value();
+    void skip_whitespace();
+    json_token read_value();
+    bool read_string();
+    bool read_literal(_In_z_ const char* literal);
+    bool read_number();
+    bool read_hex4(_Out_ uint32_t& value);
+
+    const char* m_begin;
+    const char* m_position;
+    const char* m_end;
+    json_token m_token;
+    reader_state m_state;
+    bool m_boolValue;
+    xsapi_internal_string m_stringValue;
+    xsapi_internal_vector<char> m_containers;
+};
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
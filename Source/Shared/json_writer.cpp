@@ -0,0 +1,325 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "pch.h"
+#include "json_writer.h"
+#include "utils.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
+
+namespace
+{
+const char s_hexDigits[] = "0123456789abcdef";
+
+bool needs_escape(_In_ char c)
+{
+    return c == '"' || c == '\\' || static_cast<uint8_t>(c) < 0x20;
+}
+
+void append_escaped(_Inout_ xsapi_internal_string& output, _In_ char c)
+{
+    output.push_back('\\');
+    switch (c)
+    {
+    case '"': output.push_back('"'); break;
+    case '\\': output.push_back('\\'); break;
+    case '\b': output.push_back('b'); break;
+    case '\f': output.push_back('f'); break;
+    case '\n': output.push_back('n'); break;
+    case '\r': output.push_back('r'); break;
+    case '\t': output.push_back('t'); break;
+    default:
+        output.append("u00");
+        output.push_back(s_hexDigits[(c >> 4) & 0xf]);
+        output.push_back(s_hexDigits[c & 0xf]);
+        break;
+    }
+}
+}
+
+json_writer::json_writer() :
+    m_needsComma(false)
+{
+}
+
+void
+json_writer::reset()
+{
+    m_output.clear();
+    m_needsComma = false;
+}
+
+const xsapi_internal_string&
+json_writer::output() const
+{
+    return m_output;
+}
+
+void
+json_writer::begin_object()
+{
+    begin_value();
+    m_output.push_back('{');
+    m_needsComma = false;
+}
+
+void
+json_writer::end_object()
+{
+    m_output.push_back('}');
+    m_needsComma = true;
+}
+
+void
+json_writer::begin_array()
+{
+    begin_value();
+    m_output.push_back('[');
+    m_needsComma = false;
+}
+
+void
+json_writer::end_array()
+{
+    m_output.push_back(']');
+    m_needsComma = true;
+}
+
+void
+json_writer::key(_In_z_ const char* name)
+{
+    begin_value();
+    write_string(name, strlen(name));
+    m_output.push_back(':');
+    m_needsComma = false;
+}
+
+void
+json_writer::key(_In_ const xsapi_internal_string& name)
+{
+    begin_value();
+    write_string(name.data(), name.size());
+    m_output.push_back(':');
+    m_needsComma = false;
+}
+
+void
+json_writer::key(_In_ const string_t& name)
+{
+    begin_value();
+    write_string(name.data(), name.size());
+    m_output.push_back(':');
+    m_needsComma = false;
+}
+
+void
+json_writer::value(_In_ bool value)
+{
+    begin_value();
+    m_output.append(value ? "true" : "false");
+}
+
+void
+json_writer::value(_In_ int32_t value)
+{
+    this->value(static_cast<int64_t>(value));
+}
+
+void
+json_writer::value(_In_ uint32_t value)
+{
+    this->value(static_cast<uint64_t>(value));
+}
+
+void
+json_writer::value(_In_ int64_t value)
+{
+    begin_value();
+    char buffer[24];
+    int length = snprintf(buffer, sizeof(buffer), "%lld", static_cast<long long>(value));
+    m_output.append(buffer, length);
+}
+
+void
+json_writer::value(_In_ uint64_t value)
+{
+    begin_value();
+    char buffer[24];
+    int length = snprintf(buffer, sizeof(buffer), "%llu", static_cast<unsigned long long>(value));
+    m_output.append(buffer, length);
+}
+
+void
+json_writer::value(_In_ double value)
+{
+    // JSON has no representation for NaN or infinity
+    if (!std::isfinite(value))
+    {
+        null_value();
+        return;
+    }
+
+    begin_value();
+    char buffer[32];
+    int length = snprintf(buffer, sizeof(buffer), "%.17g", value);
+    m_output.append(buffer, length);
+}
+
+void
+json_writer::value(_In_z_ const char* value)
+{
+    begin_value();
+    write_string(value, strlen(value));
+}
+
+void
+json_writer::value(_In_ const xsapi_internal_string& value)
+{
+    begin_value();
+    write_string(value.data(), value.size());
+}
+
+void
+json_writer::value(_In_ const string_t& value)
+{
+    begin_value();
+    write_string(value.data(), value.size());
+}
+
+#ifdef _WIN32
+void
+json_writer::value(_In_z_ const char_t* value)
+{
+    begin_value();
+    write_string(value, wcslen(value));
+}
+#endif
+
+void
+json_writer::null_value()
+{
+    begin_value();
+    m_output.append("null");
+}
+
+void
+json_writer::json_value(_In_ const web::json::value& value)
+{
+    if (value.is_null())
+    {
+        null_value();
+        return;
+    }
+
+    begin_value();
+    m_output.append(utils::json_serialize_utf8(value));
+}
+
+void
+json_writer::raw_value(_In_ const xsapi_internal_string& json)
+{
+    begin_value();
+    m_output.append(json);
+}
+
+void
+json_writer::begin_value()
+{
+    if (m_needsComma)
+    {
+        m_output.push_back(',');
+    }
+    m_needsComma = true;
+}
+
+void
+json_writer::write_string(
+    _In_reads_(length) const char* text,
+    _In_ size_t length
+    )
+{
+    m_output.push_back('"');
+
+    const char* end = text + length;
+    while (text < end)
+    {
+        // Copy runs that need no escaping in one go
+        const char* runStart = text;
+        while (text < end && !needs_escape(*text))
+        {
+            ++text;
+        }
+        m_output.append(runStart, text);
+
+        if (text < end)
+        {
+            append_escaped(m_output, *text++);
+        }
+    }
+
+    m_output.push_back('"');
+}
+
+#ifdef _WIN32
+void
+json_writer::write_string(
+    _In_reads_(length) const wchar_t* text,
+    _In_ size_t length
+    )
+{
+    m_output.push_back('"');
+
+    const wchar_t* end = text + length;
+    while (text < end)
+    {
+        uint32_t codePoint = static_cast<uint16_t>(*text++);
+        if (codePoint < 0x80)
+        {
+            char c = static_cast<char>(codePoint);
+            if (needs_escape(c))
+            {
+                append_escaped(m_output, c);
+            }
+            else
+            {
+                m_output.push_back(c);
+            }
+            continue;
+        }
+
+        if (codePoint >= 0xd800 && codePoint <= 0xdbff && text < end &&
+            static_cast<uint16_t>(*text) >= 0xdc00 && static_cast<uint16_t>(*text) <= 0xdfff)
+        {
+            codePoint = 0x10000 + ((codePoint - 0xd800) << 10) + (static_cast<uint16_t>(*text++) - 0xdc00);
+        }
+        else if (codePoint >= 0xd800 && codePoint <= 0xdfff)
+        {
+            // Unpaired surrogates have no UTF-8 encoding
+            codePoint = 0xfffd;
+        }
+
+        if (codePoint < 0x800)
+        {
+            m_output.push_back(static_cast<char>(0xc0 | (codePoint >> 6)));
+            m_output.push_back(static_cast<char>(0x80 | (codePoint & 0x3f)));
+        }
+        else if (codePoint < 0x10000)
+        {
+            m_output.push_back(static_cast<char>(0xe0 | (codePoint >> 12)));
+            m_output.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3f)));
+            m_output.push_back(static_cast<char>(0x80 | (codePoint & 0x3f)));
+        }
+        else
+        {
+            m_output.push_back(static_cast<char>(0xf0 | (codePoint >> 18)));
+            m_output.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3f)));
+            m_output.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3f)));
+            m_output.push_back(static_cast<char>(0x80 | (codePoint & 0x3f)));
+        }
+    }
+
+    m_output.push_back('"');
+}
+#endif
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
@@ -0,0 +1,74 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#pragma once
+#include "shared_macros.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
+
+/// <summary>
+/// Forward only JSON writer that appends UTF-8 text straight into an output buffer, so request bodies
+/// are built without a tree of web::json::value nodes.  Commas are inserted automatically; callers
+/// are responsible for balancing begin/end calls and for writing a key before each value in an object.
+/// reset() keeps the buffer's capacity so one writer can be reused for many documents.
+/// </summary>
+class json_writer
+{
+public:
+    json_writer();
+
+    void reset();
+    const xsapi_internal_string& output() const;
+
+    void begin_object();
+    void end_object();
+    void begin_array();
+    void end_array();
+
+    void key(_In_z_ const char* name);
+    void key(_In_ const xsapi_internal_string& name);
+    void key(_In_ const string_t& name);
+
+    void value(_In_ bool value);
+    void value(_In_ int32_t value);
+    void value(_In_ uint32_t value);
+    void value(_In_ int64_t value);
+    void value(_In_ uint64_t value);
+    void value(_In_ double value);
+    void value(_In_z_ const char* value);
+    void value(_In_ const xsapi_internal_string& value);
+    void value(_In_ const string_t& value);
+#ifdef _WIN32
+    void value(_In_z_ const char_t* value);
+#endif
+    void null_value();
+
+    /// <summary>
+    /// Embeds an existing DOM value, e.g. title supplied custom properties.
+    /// </summary>
+    void json_value(_In_ const web::json::value& value);
+
+    /// <summary>
+    /// Embeds a value serialized earlier by another json_writer, e.g. a cached request fragment.
+    /// </summary>
+    void raw_value(_In_ const xsapi_internal_string& json);
+
+    template<typename T>
+    void member(_In_z_ const char* name, _In_ const T& memberValue)
+    {
+        key(name);
+        value(memberValue);
+    }
+
+private:
+    void begin_value();
+    void write_string(_In_reads_(length) const char* text, _In_ size_t length);
+#ifdef _WIN32
+    void write_string(_In_reads_(length) const wchar_t* text, _In_ size_t length);
+#endif
+
+    xsapi_internal_string m_output;
+    bool m_needsComma;
+};
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
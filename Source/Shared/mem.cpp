@@ -4,6 +4,7 @@
 #include "pch.h"
 #include "xsapi/mem.h"
 #include "xsapi/system.h"
+#include "mem_pool.h"
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_SYSTEM_CPP_BEGIN
 
@@ -14,8 +15,7 @@ void* xsapi_memory::mem_alloc(
 {
     try
     {
-        init_mem_hooks();
-        return g_pMemAllocHook(dwSize, 0);
+        return xsapi_memory_pool::alloc(dwSize);
     }
     catch (...)
     {
@@ -30,10 +30,9 @@ void xsapi_memory::mem_free(
 {
     try
     {
-        init_mem_hooks();
         if (pAddress)
         {
-            g_pMemFreeHook(pAddress, 0);
+            xsapi_memory_pool::free(pAddress);
         }
     }
     catch (...)
@@ -0,0 +1,610 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "pch.h"
+#include "mem_pool.h"
+#include "utils.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_SYSTEM_CPP_BEGIN
+
+namespace
+{
+// The header keeps the 16 byte alignment the hooks give us
+const size_t c_headerSize = 16;
+// Four classes per doubling above 128 bytes keeps rounding waste under 25%, on top of the header
+const size_t c_sizeClasses[] = { 16, 32, 48, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384, 448, 512, 640, 768, 896, 1024 };
+const uint8_t c_sizeClassCount = static_cast<uint8_t>(sizeof(c_sizeClasses) / sizeof(c_sizeClasses[0]));
+const uint8_t c_largeSizeClass = 0xff;
+const size_t c_subsystemCount = static_cast<size_t>(xsapi_memory_subsystem::count);
+
+// A thread keeps up to c_threadCacheLimit free blocks per list and moves c_transferBatch at a time to or from its arena
+const uint32_t c_threadCacheLimit = 32;
+const uint32_t c_transferBatch = 16;
+
+// An arena keeps at most this many bytes of free blocks per size class; the rest go back to the hooks
+const size_t c_arenaCacheBytes = 64 * 1024;
+
+// In sampled mode one allocation in c_sampleRate is counted, standing in for c_sampleRate allocations of its size
+const uint32_t c_sampleRate = 64;
+const uint8_t c_noCallSite = 0xff;
+const uint32_t c_maxCallSites = 64;
+
+enum block_tracking : uint8_t
+{
+    untracked,
+    tracked,
+    sampled
+};
+
+struct block_header
+{
+    size_t size;
+    uint8_t sizeClass;
+    uint8_t subsystem;
+    uint8_t tracking;
+    uint8_t callSite;
+};
+static_assert(sizeof(block_header) <= c_headerSize, "block_header must fit in c_headerSize");
+
+struct free_block
+{
+    free_block* next;
+};
+
+struct free_list
+{
+    free_block* head;
+    uint32_t count;
+};
+
+struct arena
+{
+    std::mutex lock;
+    free_list lists[c_sizeClassCount];
+};
+
+struct memory_counters
+{
+    std::atomic<int64_t> liveBytes;
+    std::atomic<int64_t> liveAllocations;
+    std::atomic<int64_t> totalAllocations;
+    std::atomic<int64_t> highWaterBytes;
+};
+
+struct pool_state
+{
+    arena arenas[c_subsystemCount];
+    std::atomic<uint32_t> generation;
+
+    std::atomic<uint32_t> trackingMode;
+    memory_counters counters[c_subsystemCount];
+
+    // Call sites are matched by pointer, so each scope must name its site with a string literal
+    std::atomic<const char*> callSites[c_maxCallSites];
+    memory_counters callSiteCounters[c_maxCallSites];
+};
+
+pool_state& get_pool_state()
+{
+    // Never destroyed, so blocks freed during static destruction still have somewhere to go
+    static std::aligned_storage<sizeof(pool_state), std::alignment_of<pool_state>::value>::type s_storage;
+    static pool_state* s_state = new (&s_storage) pool_state();
+    return *s_state;
+}
+
+block_header* header_from_pointer(_In_ void* pointer)
+{
+    return reinterpret_cast<block_header*>(static_cast<uint8_t*>(pointer) - c_headerSize);
+}
+
+uint8_t size_class_for(_In_ size_t size)
+{
+    for (uint8_t i = 0; i < c_sizeClassCount; ++i)
+    {
+        if (size <= c_sizeClasses[i])
+        {
+            return i;
+        }
+    }
+    return c_largeSizeClass;
+}
+
+void push(_Inout_ free_list& list, _In_ block_header* header)
+{
+    auto block = reinterpret_cast<free_block*>(reinterpret_cast<uint8_t*>(header) + c_headerSize);
+    block->next = list.head;
+    list.head = block;
+    ++list.count;
+}
+
+block_header* pop(_Inout_ free_list& list)
+{
+    if (list.head == nullptr)
+    {
+        return nullptr;
+    }
+
+    free_block* block = list.head;
+    list.head = block->next;
+    --list.count;
+    return header_from_pointer(block);
+}
+
+void record_alloc(
+    _Inout_ memory_counters& counters,
+    _In_ int64_t bytes,
+    _In_ int64_t count
+    )
+{
+    // Statistics only, so nothing is ordered against these counters
+    int64_t liveBytes = counters.liveBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    counters.liveAllocations.fetch_add(count, std::memory_order_relaxed);
+    counters.totalAllocations.fetch_add(count, std::memory_order_relaxed);
+
+    int64_t highWaterBytes = counters.highWaterBytes.load(std::memory_order_relaxed);
+    while (liveBytes > highWaterBytes &&
+        !counters.highWaterBytes.compare_exchange_weak(highWaterBytes, liveBytes, std::memory_order_relaxed))
+    {
+    }
+}
+
+void record_free(
+    _Inout_ memory_counters& counters,
+    _In_ int64_t bytes,
+    _In_ int64_t count
+    )
+{
+    counters.liveBytes.fetch_sub(bytes, std::memory_order_relaxed);
+    counters.liveAllocations.fetch_sub(count, std::memory_order_relaxed);
+}
+
+void track(
+    _In_ const block_header* header,
+    _In_ bool allocating
+    )
+{
+    auto& state = get_pool_state();
+    int64_t count = header->tracking == sampled ? c_sampleRate : 1;
+    int64_t bytes = static_cast<int64_t>(header->size) * count;
+
+    memory_counters* counters[] = {
+        &state.counters[header->subsystem],
+        header->callSite != c_noCallSite ? &state.callSiteCounters[header->callSite] : nullptr
+    };
+    for (memory_counters* counter : counters)
+    {
+        if (counter == nullptr)
+        {
+            continue;
+        }
+
+        if (allocating)
+        {
+            record_alloc(*counter, bytes, count);
+        }
+        else
+        {
+            record_free(*counter, bytes, count);
+        }
+    }
+}
+
+xsapi_memory_stats to_stats(_In_ const memory_counters& counters)
+{
+    return xsapi_memory_stats(
+        static_cast<uint64_t>(std::max<int64_t>(counters.liveBytes, 0)),
+        static_cast<uint64_t>(std::max<int64_t>(counters.liveAllocations, 0)),
+        static_cast<uint64_t>(std::max<int64_t>(counters.totalAllocations, 0)),
+        static_cast<uint64_t>(std::max<int64_t>(counters.highWaterBytes, 0))
+        );
+}
+
+#if _DEBUG
+uint8_t call_site_index(_In_opt_z_ const char* callSite)
+{
+    if (callSite == nullptr)
+    {
+        return c_noCallSite;
+    }
+
+    auto& state = get_pool_state();
+    for (uint8_t i = 0; i < c_maxCallSites; ++i)
+    {
+        const char* existing = state.callSites[i];
+        if (existing == nullptr && state.callSites[i].compare_exchange_strong(existing, callSite))
+        {
+            return i;
+        }
+        if (existing == callSite)
+        {
+            return i;
+        }
+    }
+
+    // Table is full; the allocation is still counted against its subsystem
+    return c_noCallSite;
+}
+#endif
+
+thread_local xsapi_memory_subsystem t_subsystem = xsapi_memory_subsystem::general;
+thread_local const char* t_callSite = nullptr;
+thread_local uint32_t t_sampleCounter = 0;
+
+// Attributes a block being handed out to the calling thread's scope and counts it if tracking is on
+void start_tracking(_Inout_ block_header* header)
+{
+    header->tracking = untracked;
+    header->callSite = c_noCallSite;
+
+    auto mode = static_cast<xsapi_memory_tracking_mode>(get_pool_state().trackingMode.load(std::memory_order_relaxed));
+    if (mode == xsapi_memory_tracking_mode::full)
+    {
+        header->tracking = tracked;
+#if _DEBUG
+        header->callSite = call_site_index(t_callSite);
+#endif
+    }
+    else if (mode == xsapi_memory_tracking_mode::sampled && ++t_sampleCounter % c_sampleRate == 0)
+    {
+        header->tracking = sampled;
+    }
+
+    if (header->tracking != untracked)
+    {
+        track(header, true);
+    }
+}
+
+void stop_tracking(_Inout_ block_header* header)
+{
+    if (header->tracking != untracked)
+    {
+        track(header, false);
+        header->tracking = untracked;
+    }
+}
+
+// Moves up to count blocks from one list to another
+void transfer(_Inout_ free_list& from, _Inout_ free_list& to, _In_ uint32_t count)
+{
+    for (uint32_t i = 0; i < count && from.head != nullptr; ++i)
+    {
+        push(to, pop(from));
+    }
+}
+
+void release(_Inout_ free_list& list)
+{
+    init_mem_hooks();
+    while (block_header* header = pop(list))
+    {
+        g_pMemFreeHook(header, 0);
+    }
+}
+
+// Frees blocks from an arena list until it is back under the arena cache limit for its size class
+void release_excess(_Inout_ free_list& list, _In_ uint8_t sizeClass)
+{
+    uint32_t limit = std::max<uint32_t>(
+        c_transferBatch,
+        static_cast<uint32_t>(c_arenaCacheBytes / (c_headerSize + c_sizeClasses[sizeClass]))
+        );
+    if (list.count <= limit)
+    {
+        return;
+    }
+
+    init_mem_hooks();
+    while (list.count > limit)
+    {
+        g_pMemFreeHook(pop(list), 0);
+    }
+}
+
+struct thread_cache
+{
+    thread_cache();
+    ~thread_cache();
+
+    free_list lists[c_subsystemCount][c_sizeClassCount];
+    uint32_t generation;
+};
+
+// Trivially destructible, so it stays readable after t_cache has been destroyed at thread exit
+thread_local bool t_cacheDestroyed = false;
+thread_local thread_cache t_cache;
+
+thread_cache::thread_cache() :
+    lists(),
+    generation(get_pool_state().generation)
+{
+}
+
+thread_cache::~thread_cache()
+{
+    // Hand cached blocks back to the arenas so other threads can reuse them
+    auto& state = get_pool_state();
+    bool stale = generation != state.generation;
+    for (size_t subsystem = 0; subsystem < c_subsystemCount; ++subsystem)
+    {
+        arena& subsystemArena = state.arenas[subsystem];
+        std::lock_guard<std::mutex> lock(subsystemArena.lock);
+        for (uint8_t sizeClass = 0; sizeClass < c_sizeClassCount; ++sizeClass)
+        {
+            free_list& list = lists[subsystem][sizeClass];
+            if (stale)
+            {
+                release(list);
+            }
+            else
+            {
+                transfer(list, subsystemArena.lists[sizeClass], list.count);
+                release_excess(subsystemArena.lists[sizeClass], sizeClass);
+            }
+        }
+    }
+    t_cacheDestroyed = true;
+}
+
+// Returns the calling thread's cache, or nullptr if the thread is exiting
+thread_cache* get_thread_cache()
+{
+    if (t_cacheDestroyed)
+    {
+        return nullptr;
+    }
+
+    thread_cache* cache = &t_cache;
+    uint32_t generation = get_pool_state().generation;
+    if (cache->generation != generation)
+    {
+        // The pool was trimmed from another thread.  Blocks that outlive a hook change are freed
+        // with the current hook, which is what happens to every other live allocation as well.
+        for (auto& subsystemLists : cache->lists)
+        {
+            for (auto& list : subsystemLists)
+            {
+                release(list);
+            }
+        }
+        cache->generation = generation;
+    }
+    return cache;
+}
+}
+
+_Ret_maybenull_ void*
+xsapi_memory_pool::alloc(
+    _In_ size_t size
+    )
+{
+    if (size > SIZE_MAX - c_headerSize)
+    {
+        return nullptr;
+    }
+
+    uint8_t sizeClass = size_class_for(size);
+    uint8_t subsystem = static_cast<uint8_t>(t_subsystem);
+    block_header* header = nullptr;
+
+    if (sizeClass != c_largeSizeClass)
+    {
+        thread_cache* cache = get_thread_cache();
+        arena& subsystemArena = get_pool_state().arenas[subsystem];
+        if (cache != nullptr)
+        {
+            free_list& list = cache->lists[subsystem][sizeClass];
+            if (list.head == nullptr)
+            {
+                std::lock_guard<std::mutex> lock(subsystemArena.lock);
+                transfer(subsystemArena.lists[sizeClass], list, c_transferBatch);
+            }
+            header = pop(list);
+        }
+        else
+        {
+            std::lock_guard<std::mutex> lock(subsystemArena.lock);
+            header = pop(subsystemArena.lists[sizeClass]);
+        }
+    }
+
+    if (header == nullptr)
+    {
+        size_t blockSize = sizeClass == c_largeSizeClass ? size : c_sizeClasses[sizeClass];
+        init_mem_hooks();
+        header = static_cast<block_header*>(g_pMemAllocHook(c_headerSize + blockSize, 0));
+        if (header == nullptr)
+        {
+            return nullptr;
+        }
+    }
+
+    header->size = size;
+    header->sizeClass = sizeClass;
+    header->subsystem = subsystem;
+    start_tracking(header);
+    return reinterpret_cast<uint8_t*>(header) + c_headerSize;
+}
+
+void
+xsapi_memory_pool::free(
+    _In_ void* pointer
+    )
+{
+    block_header* header = header_from_pointer(pointer);
+    stop_tracking(header);
+
+    if (header->sizeClass == c_largeSizeClass)
+    {
+        init_mem_hooks();
+        g_pMemFreeHook(header, 0);
+        return;
+    }
+
+    arena& subsystemArena = get_pool_state().arenas[header->subsystem];
+    thread_cache* cache = get_thread_cache();
+    if (cache != nullptr)
+    {
+        free_list& list = cache->lists[header->subsystem][header->sizeClass];
+        push(list, header);
+        if (list.count > c_threadCacheLimit)
+        {
+            std::lock_guard<std::mutex> lock(subsystemArena.lock);
+            transfer(list, subsystemArena.lists[header->sizeClass], c_transferBatch);
+            release_excess(subsystemArena.lists[header->sizeClass], header->sizeClass);
+        }
+    }
+    else
+    {
+        std::lock_guard<std::mutex> lock(subsystemArena.lock);
+        push(subsystemArena.lists[header->sizeClass], header);
+        release_excess(subsystemArena.lists[header->sizeClass], header->sizeClass);
+    }
+}
+
+void
+xsapi_memory_pool::on_block_cached(
+    _In_ void* pointer
+    )
+{
+    stop_tracking(header_from_pointer(pointer));
+}
+
+void
+xsapi_memory_pool::on_block_reused(
+    _In_ void* pointer
+    )
+{
+    block_header* header = header_from_pointer(pointer);
+    header->subsystem = static_cast<uint8_t>(t_subsystem);
+    start_tracking(header);
+}
+
+void
+xsapi_memory_pool::trim()
+{
+    auto& state = get_pool_state();
+    ++state.generation;
+
+    // Refreshing the generation releases the calling thread's cache
+    get_thread_cache();
+
+    for (auto& subsystemArena : state.arenas)
+    {
+        std::lock_guard<std::mutex> lock(subsystemArena.lock);
+        for (auto& list : subsystemArena.lists)
+        {
+            release(list);
+        }
+    }
+}
+
+xsapi_memory_subsystem
+xsapi_memory_pool::current_subsystem()
+{
+    return t_subsystem;
+}
+
+void
+xsapi_memory_pool::set_tracking_mode(
+    _In_ xsapi_memory_tracking_mode mode
+    )
+{
+    auto& state = get_pool_state();
+    auto previous = static_cast<xsapi_memory_tracking_mode>(state.trackingMode.exchange(static_cast<uint32_t>(mode)));
+    if (previous == xsapi_memory_tracking_mode::disabled && mode != xsapi_memory_tracking_mode::disabled)
+    {
+        for (auto& counters : state.counters)
+        {
+            counters.totalAllocations = counters.liveAllocations.load();
+            counters.highWaterBytes = counters.liveBytes.load();
+        }
+        for (auto& counters : state.callSiteCounters)
+        {
+            counters.totalAllocations = counters.liveAllocations.load();
+            counters.highWaterBytes = counters.liveBytes.load();
+        }
+    }
+}
+
+xsapi_memory_tracking_mode
+xsapi_memory_pool::tracking_mode()
+{
+    return static_cast<xsapi_memory_tracking_mode>(get_pool_state().trackingMode.load());
+}
+
+xsapi_memory_stats
+xsapi_memory_pool::stats(
+    _In_ xsapi_memory_subsystem subsystem
+    )
+{
+    if (subsystem >= xsapi_memory_subsystem::count)
+    {
+        return xsapi_memory_stats();
+    }
+    return to_stats(get_pool_state().counters[static_cast<size_t>(subsystem)]);
+}
+
+std::vector<std::pair<std::string, xsapi_memory_stats>>
+xsapi_memory_pool::call_site_stats()
+{
+    std::vector<std::pair<std::string, xsapi_memory_stats>> callSiteStats;
+    auto& state = get_pool_state();
+    for (uint32_t i = 0; i < c_maxCallSites; ++i)
+    {
+        const char* callSite = state.callSites[i];
+        if (callSite == nullptr)
+        {
+            break;
+        }
+        callSiteStats.push_back(std::make_pair(std::string(callSite), to_stats(state.callSiteCounters[i])));
+    }
+    return callSiteStats;
+}
+
+void
+xsapi_memory_pool::reset_high_water_marks()
+{
+    auto& state = get_pool_state();
+    for (auto& counters : state.counters)
+    {
+        counters.highWaterBytes = counters.liveBytes.load();
+    }
+    for (auto& counters : state.callSiteCounters)
+    {
+        counters.highWaterBytes = counters.liveBytes.load();
+    }
+}
+
+void
+xsapi_memory_pool::set_current_scope(
+    _In_ xsapi_memory_subsystem subsystem,
+    _In_opt_z_ const char* callSite
+    )
+{
+    t_subsystem = subsystem;
+    t_callSite = callSite;
+}
+
+const char*
+xsapi_memory_pool::current_call_site()
+{
+    return t_callSite;
+}
+
+xsapi_memory_subsystem_scope::xsapi_memory_subsystem_scope(
+    _In_ xsapi_memory_subsystem subsystem,
+    _In_opt_z_ const char* callSite
+    ) :
+    m_previousSubsystem(xsapi_memory_pool::current_subsystem()),
+    m_previousCallSite(xsapi_memory_pool::current_call_site())
+{
+    xsapi_memory_pool::set_current_scope(subsystem, callSite);
+}
+
+xsapi_memory_subsystem_scope::~xsapi_memory_subsystem_scope()
+{
+    xsapi_memory_pool::set_current_scope(m_previousSubsystem, m_previousCallSite);
+}
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_SYSTEM_CPP_END
@@ -0,0 +1,177 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#pragma once
+#include "xsapi/mem.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_SYSTEM_CPP_BEGIN
+
+/// <summary>
+/// Size class allocator that sits between xsapi_memory and the title's memory hooks.
+/// Small blocks are recycled through a per thread cache backed by one arena per subsystem,
+/// so steady state allocations rarely reach the hooks.  Both caches are bounded, and blocks freed
+/// beyond the bound go back to the hooks.  Blocks larger than the biggest size class
+/// go straight to the hooks.  Every block carries a header recording its size class and subsystem.
+/// </summary>
+class xsapi_memory_pool
+{
+public:
+    static _Ret_maybenull_ void* alloc(_In_ size_t size);
+
+    static void free(_In_ void* pointer);
+
+    /// <summary>
+    /// For blocks from alloc that a caller recycles itself instead of freeing.  A cached block is
+    /// not counted as live, and a reused block is attributed to the calling thread's subsystem.
+    /// </summary>
+    static void on_block_cached(_In_ void* pointer);
+    static void on_block_reused(_In_ void* pointer);
+
+    /// <summary>
+    /// Returns every cached block to the memory hooks.  Must be called before the hooks are replaced,
+    /// since cached blocks have to be released through the hook that allocated them.
+    /// Caches on other threads are released the next time those threads use the pool.
+    /// </summary>
+    static void trim();
+
+    /// <summary>
+    /// The subsystem that allocations on the calling thread are currently attributed to.
+    /// </summary>
+    static xsapi_memory_subsystem current_subsystem();
+
+    /// <summary>
+    /// Blocks allocated while tracking is on stay counted until they are freed, even if tracking is turned off.
+    /// Turning tracking on from disabled restarts the allocation totals and high water marks.
+    /// </summary>
+    static void set_tracking_mode(_In_ xsapi_memory_tracking_mode mode);
+
+    static xsapi_memory_tracking_mode tracking_mode();
+
+    static xsapi_memory_stats stats(_In_ xsapi_memory_subsystem subsystem);
+
+    /// <summary>
+    /// Statistics for each call site named by an xsapi_memory_subsystem_scope.  Only collected
+    /// in debug builds with full tracking; empty otherwise.
+    /// </summary>
+    static std::vector<std::pair<std::string, xsapi_memory_stats>> call_site_stats();
+
+    static void reset_high_water_marks();
+
+private:
+    friend class xsapi_memory_subsystem_scope;
+
+    static void set_current_scope(
+        _In_ xsapi_memory_subsystem subsystem,
+        _In_opt_z_ const char* callSite
+        );
+
+    static const char* current_call_site();
+};
+
+/// <summary>
+/// Attributes allocations made on the calling thread to a subsystem for the lifetime of the scope.
+/// Scopes nest, restoring the enclosing subsystem when they end.  callSite must be a string literal,
+/// typically __FUNCTION__; debug builds report statistics per call site.
+/// </summary>
+class xsapi_memory_subsystem_scope
+{
+public:
+    xsapi_memory_subsystem_scope(
+        _In_ xsapi_memory_subsystem subsystem,
+        _In_opt_z_ const char* callSite = nullptr
+        );
+    ~xsapi_memory_subsystem_scope();
+
+private:
+    xsapi_memory_subsystem_scope(const xsapi_memory_subsystem_scope&);
+    xsapi_memory_subsystem_scope& operator=(const xsapi_memory_subsystem_scope&);
+
+    xsapi_memory_subsystem m_previousSubsystem;
+    const char* m_previousCallSite;
+};
+
+/// <summary>
+/// Recycles blocks of a single size through a small per thread free list.  Used for objects that are
+/// created and destroyed on every async hop, such as AsyncBlocks and async contexts, so a steady state
+/// hop reuses a block without a size class lookup or touching the shared arenas.
+/// Blocks come from xsapi_memory and are returned to it when the list is full or the thread exits.
+/// </summary>
+template<size_t BlockSize>
+class xsapi_fixed_block_pool
+{
+public:
+    static _Ret_maybenull_ void* alloc()
+    {
+        free_list* list = local_list();
+        if (list != nullptr && list->head != nullptr)
+        {
+            free_block* block = list->head;
+            list->head = block->next;
+            --list->count;
+            xsapi_memory_pool::on_block_reused(block);
+            return block;
+        }
+        return xsapi_memory::mem_alloc(BlockSize);
+    }
+
+    static void free(_In_ void* pointer)
+    {
+        free_list* list = local_list();
+        if (list == nullptr || list->count >= c_maxCachedBlocks)
+        {
+            xsapi_memory::mem_free(pointer);
+            return;
+        }
+
+        xsapi_memory_pool::on_block_cached(pointer);
+        auto block = static_cast<free_block*>(pointer);
+        block->next = list->head;
+        list->head = block;
+        ++list->count;
+    }
+
+private:
+    static_assert(BlockSize >= sizeof(void*), "BlockSize must be able to hold a free list link");
+    static const uint32_t c_maxCachedBlocks = 16;
+
+    struct free_block
+    {
+        free_block* next;
+    };
+
+    struct free_list
+    {
+        free_block* head;
+        uint32_t count;
+
+        ~free_list()
+        {
+            while (head != nullptr)
+            {
+                free_block* block = head;
+                head = block->next;
+                xsapi_memory::mem_free(block);
+            }
+            destroyed() = true;
+        }
+    };
+
+    // Trivially destructible, so it stays readable after the list has been destroyed at thread exit
+    static bool& destroyed()
+    {
+        static thread_local bool t_destroyed = false;
+        return t_destroyed;
+    }
+
+    static free_list* local_list()
+    {
+        if (destroyed())
+        {
+            return nullptr;
+        }
+        static thread_local free_list t_list = { nullptr, 0 };
+        return &t_list;
+    }
+};
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_SYSTEM_CPP_END
@@ -66,6 +66,8 @@
 #define ETAG_HEADER ("ETag")
 #define DATE_HEADER ("Date")
 #define RETRY_AFTER_HEADER ("Retry-After")
+#define CONTENT_ENCODING_HEADER ("Content-Encoding")
+#define ACCEPT_ENCODING_HEADER ("Accept-Encoding")
 #define DEFAULT_USER_AGENT "XboxServicesAPI/" XBOX_SERVICES_API_VERSION_STRING
 
 #define RETURN_EXCEPTION_FREE_XBOX_LIVE_RESULT(func, type) \
@@ -46,12 +46,80 @@ user_context::set_caller_context_type(xbox::services::caller_context_type contex
     {
         m_callerContext = "StatManager";
     }
+    update_user_agent();
 }
 
 void
 user_context::set_caller_api_type(xbox::services::caller_api_type apiType)
 {
     m_apiType = apiType;
+    update_user_agent();
+}
+
+void
+user_context::update_user_agent()
+{
+    xsapi_internal_string userAgent = DEFAULT_USER_AGENT;
+    if (!m_callerContext.empty())
+    {
+        userAgent += " " + m_callerContext;
+    }
+
+    switch (m_apiType)
+    {
+        case xbox::services::caller_api_type::api_c: userAgent += " c"; break;
+        case xbox::services::caller_api_type::api_cpp: userAgent += " cpp"; break;
+        case xbox::services::caller_api_type::api_winrt: userAgent += " winrt"; break;
+        default: break;
+    }
+
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_userAgent = std::move(userAgent);
+    m_requestTemplates.clear();
+}
+
+xsapi_internal_string
+user_context::user_agent() const
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_userAgent;
+}
+
+std::shared_ptr<const http_call_request_template>
+user_context::request_template(
+    _In_ xbox_live_api xboxLiveApi
+    ) const
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    auto iter = m_requestTemplates.find(static_cast<uint32_t>(xboxLiveApi));
+    return iter == m_requestTemplates.end() ? nullptr : iter->second;
+}
+
+std::shared_ptr<const http_call_request_template>
+user_context::request_template(
+    _In_ xbox_live_api xboxLiveApi,
+    _In_ const xsapi_internal_string& httpMethod,
+    _In_ const xsapi_internal_string& serverName,
+    _In_ const xsapi_internal_string& xboxContractVersion,
+    _In_ const xsapi_internal_string& contentType
+    )
+{
+    const xsapi_internal_string& locales = utils::get_locales();
+
+    std::lock_guard<std::mutex> lock(m_lock);
+    auto& requestTemplate = m_requestTemplates[static_cast<uint32_t>(xboxLiveApi)];
+    if (requestTemplate == nullptr || !requestTemplate->matches(httpMethod, serverName, xboxContractVersion, contentType, locales))
+    {
+        requestTemplate = xsapi_allocate_shared<http_call_request_template>(
+            httpMethod,
+            serverName,
+            xboxContractVersion,
+            contentType,
+            locales,
+            m_userAgent
+            );
+    }
+    return requestTemplate;
 }
 
 const xsapi_internal_string& user_context::xbox_user_id() const
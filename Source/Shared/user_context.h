@@ -15,6 +15,7 @@
     #endif
 #endif
 #include "xsapi/types.h"
+#include "http_call_request_template.h"
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_SYSTEM_CPP_BEGIN
 class token_and_signature_result_internal;
@@ -22,6 +23,8 @@ NAMESPACE_MICROSOFT_XBOX_SERVICES_SYSTEM_CPP_END
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
 
+enum class xbox_live_api;
+
 enum class caller_context_type
 {
     title,
@@ -72,6 +75,29 @@ public:
     void set_caller_context_type(xbox::services::caller_context_type context);
     void set_caller_api_type(xbox::services::caller_api_type apiType);
 
+    /// <summary>
+    /// The User-Agent header value for calls made with this context.  Rebuilt when the caller context or api type changes.
+    /// Returned by value since the caller context can change while calls are made on other threads.
+    /// </summary>
+    xsapi_internal_string user_agent() const;
+
+    /// <summary>
+    /// The request template for calls to xboxLiveApi made with this context, or nullptr before the first one.
+    /// </summary>
+    std::shared_ptr<const http_call_request_template> request_template(_In_ xbox_live_api xboxLiveApi) const;
+
+    /// <summary>
+    /// Returns the request template for a call to xboxLiveApi, rebuilding it if it no longer matches the call.
+    /// Templates carry the User-Agent, so they are dropped when the caller context or api type changes.
+    /// </summary>
+    std::shared_ptr<const http_call_request_template> request_template(
+        _In_ xbox_live_api xboxLiveApi,
+        _In_ const xsapi_internal_string& httpMethod,
+        _In_ const xsapi_internal_string& serverName,
+        _In_ const xsapi_internal_string& xboxContractVersion,
+        _In_ const xsapi_internal_string& contentType
+        );
+
     bool is_signed_in() const;
 
     void get_auth_result(
@@ -159,10 +185,15 @@ private:
 
 
 private:
+    void update_user_agent();
+
     xsapi_internal_string m_xboxUserId;
     xsapi_internal_string m_callerContext;
     xbox::services::caller_api_type m_apiType;
     xbox::services::caller_context_type m_callerContextType;
+    xsapi_internal_string m_userAgent = DEFAULT_USER_AGENT;
+    xsapi_internal_unordered_map<uint32_t, std::shared_ptr<const http_call_request_template>> m_requestTemplates;
+    mutable std::mutex m_lock;
 };
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
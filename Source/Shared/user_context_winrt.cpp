@@ -63,14 +63,14 @@ void get_auth_result(
     async_queue_handle_t queue
     )
 {
-    AsyncBlock* async = new (xsapi_memory::mem_alloc(sizeof(AsyncBlock))) AsyncBlock{};
+    AsyncBlock* async = utils::allocate_async_block();
     async->queue = queue;
     async->context = utils::store_shared_ptr(context);
     async->callback = [](AsyncBlock* async)
     {
         auto context = utils::get_shared_ptr<auth_context>(async->context);
         context->callback(context->result);
-        xsapi_memory::mem_free(async);
+        utils::free_async_block(async);
     };
 
     auto hr = BeginAsync(async, async->context, nullptr, __FUNCTION__,
@@ -5,6 +5,7 @@
 #include "utils.h"
 #include "local_config.h"
 #include "xbox_live_app_config_internal.h"
+#include "mem_pool.h"
 #include <iomanip>
 #include <chrono>
 #include <time.h>
@@ -115,6 +116,7 @@ void xsapi_singleton::init()
 xsapi_singleton::~xsapi_singleton()
 {
     CloseAsyncQueue(m_asyncQueue);
+    xbox::services::system::xsapi_memory_pool::trim();
 }
 
 std::shared_ptr<xsapi_singleton>
@@ -1987,6 +1989,206 @@ xsapi_internal_vector<uint32_t> utils::uint32_array_to_internal_vector(
     return vector;
 }
 
+#ifdef _WIN32
+namespace
+{
+// Read-only view over a buffer the caller keeps alive, so the JSON parser can read it without a copy
+class utf8_buffer_streambuf : public std::streambuf
+{
+public:
+    utf8_buffer_streambuf(_In_reads_bytes_(size) const char* data, _In_ size_t size)
+    {
+        char* begin = const_cast<char*>(data);
+        setg(begin, begin, begin + size);
+    }
+};
+}
+#endif
+
+web::json::value utils::json_parse_utf8(
+    _In_reads_bytes_(size) const char* utf8,
+    _In_ size_t size,
+    _Out_ std::error_code& errc
+    )
+{
+    errc = std::error_code();
+#ifdef _WIN32
+    utf8_buffer_streambuf buffer(utf8, size);
+    std::istream stream(&buffer);
+    return web::json::value::parse(stream, errc);
+#else
+    return web::json::value::parse(string_t(utf8, size), errc);
+#endif
+}
+
+web::json::value utils::json_parse_utf8(
+    _In_ const xsapi_internal_string& utf8,
+    _Out_ std::error_code& errc
+    )
+{
+    return json_parse_utf8(utf8.data(), utf8.size(), errc);
+}
+
+xsapi_internal_string utils::json_serialize_utf8(_In_ const web::json::value& json)
+{
+#ifdef _WIN32
+    xsapi_internal_stringstream stream;
+    json.serialize(stream);
+    return stream.str();
+#else
+    auto serialized = json.serialize();
+    return xsapi_internal_string(serialized.begin(), serialized.end());
+#endif
+}
+
+namespace
+{
+const uint64_t c_fnvOffsetBasis = 14695981039346656037ULL;
+const uint64_t c_fnvPrime = 1099511628211ULL;
+
+uint64_t fnv1a(_In_ uint64_t hash, _In_reads_bytes_(size) const void* data, _In_ size_t size)
+{
+    auto bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash = (hash ^ bytes[i]) * c_fnvPrime;
+    }
+    return hash;
+}
+
+uint64_t fnv1a(_In_ uint64_t hash, _In_ uint64_t value)
+{
+    return fnv1a(hash, &value, sizeof(value));
+}
+
+uint64_t mix_hash(_In_ uint64_t hash)
+{
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+}
+
+uint64_t utils::json_hash(_In_ const web::json::value& json)
+{
+    uint64_t hash = fnv1a(c_fnvOffsetBasis, static_cast<uint64_t>(json.type()));
+    switch (json.type())
+    {
+    case web::json::value::Number:
+    {
+        const auto& number = json.as_number();
+        if (number.is_int64())
+        {
+            hash = fnv1a(hash, static_cast<uint64_t>(number.to_int64()));
+        }
+        else if (number.is_uint64())
+        {
+            hash = fnv1a(hash, number.to_uint64());
+        }
+        else
+        {
+            // +0.0 and -0.0 compare equal so they must hash equal
+            double value = number.to_double();
+            if (value == 0)
+            {
+                value = 0;
+            }
+            hash = fnv1a(hash, &value, sizeof(value));
+        }
+        break;
+    }
+
+    case web::json::value::Boolean:
+        hash = fnv1a(hash, json.as_bool() ? 1 : 0);
+        break;
+
+    case web::json::value::String:
+    {
+        const auto& value = json.as_string();
+        hash = fnv1a(hash, value.data(), value.size() * sizeof(char_t));
+        break;
+    }
+
+    case web::json::value::Array:
+        for (const auto& element : json.as_array())
+        {
+            hash = fnv1a(hash, json_hash(element));
+        }
+        break;
+
+    case web::json::value::Object:
+    {
+        // Summing the mixed member hashes makes the result independent of member order
+        uint64_t members = 0;
+        for (const auto& field : json.as_object())
+        {
+            uint64_t keyHash = fnv1a(c_fnvOffsetBasis, field.first.data(), field.first.size() * sizeof(char_t));
+            members += mix_hash(keyHash * c_fnvPrime + json_hash(field.second));
+        }
+        hash = fnv1a(hash, members);
+        break;
+    }
+
+    default:
+        break;
+    }
+    return hash;
+}
+
+std::vector<string_t> utils::json_changed_keys(
+    _In_ const web::json::value& current,
+    _In_ const web::json::value& previous
+    )
+{
+    std::vector<string_t> changedKeys;
+    if (current.is_object())
+    {
+        for (const auto& field : current.as_object())
+        {
+            if (!previous.is_object() || !previous.has_field(field.first) || previous.at(field.first) != field.second)
+            {
+                changedKeys.push_back(field.first);
+            }
+        }
+    }
+
+    if (previous.is_object())
+    {
+        for (const auto& field : previous.as_object())
+        {
+            if (!current.is_object() || !current.has_field(field.first))
+            {
+                changedKeys.push_back(field.first);
+            }
+        }
+    }
+    return changedKeys;
+}
+
+typedef xbox::services::system::xsapi_fixed_block_pool<sizeof(AsyncBlock)> async_block_pool;
+
+AsyncBlock* utils::allocate_async_block()
+{
+    void* buffer = async_block_pool::alloc();
+    if (buffer == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return new (buffer) AsyncBlock{};
+}
+
+void utils::free_async_block(_In_ AsyncBlock* asyncBlock)
+{
+    if (asyncBlock != nullptr)
+    {
+        asyncBlock->~AsyncBlock();
+        async_block_pool::free(asyncBlock);
+    }
+}
+
 #ifdef _WIN32
 time_t utils::time_t_from_datetime(const utility::datetime& datetime)
 {
@@ -12,6 +12,7 @@
 #include "xsapi/xbox_live_app_config.h"
 #include "http_call_response_internal.h"
 #include "xsapi/mem.h"
+#include "mem_pool.h"
 #include "xsapi/system.h"
 
 struct XblAppConfig;
@@ -52,6 +53,11 @@ NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
     class service_call_logger_protocol;
     class service_call_logger;
     class http_retry_after_manager;
+    class http_call_metrics;
+    class http_call_metrics_internal;
+    class http_call_hedging_policy;
+    class http_call_dispatcher;
+    class http_compression_policy;
     class logger;
     class perf_tester;
     class initiator;
@@ -103,210 +109,292 @@ NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
 #define __max(a,b)            (((a) < (b)) ? (b) : (a))
 #endif  
 
+#ifndef XSAPI_CALLBACK_INLINE_SIZE
+// Functors up to this many bytes are stored inside xbox_live_callback instead of being allocated.
+// The default fits the common completion captures: a shared_ptr to the owner plus a string and a reference,
+// or up to four shared_ptrs.  A callback is always larger than its own buffer, so a capture of another
+// xbox_live_callback is allocated; moving it afterwards only moves the pointer.
+#define XSAPI_CALLBACK_INLINE_SIZE (8 * sizeof(void*))
+#endif
+
+/// <summary>
+/// Type erased callback used on the internal async completion paths.  Functors that fit in
+/// XSAPI_CALLBACK_INLINE_SIZE bytes and can be moved without throwing are stored inline, so wrapping
+/// and moving them never allocates; larger ones are allocated through xsapi_memory.
+/// Functors must be copyable, since callbacks are copied into continuations and handler maps.
+/// A moved-from callback is null.
+/// </summary>
 template<typename... Args>
 class xbox_live_callback
 {
 public:
-    xbox_live_callback() : m_callable(nullptr) {}
-    xbox_live_callback(nullptr_t) : m_callable(nullptr) {}
+    xbox_live_callback() : m_operations(nullptr) {}
+    xbox_live_callback(nullptr_t) : m_operations(nullptr) {}
 
-    template <typename Functor>
-    xbox_live_callback(Functor functor)
+    template <typename Functor, typename = typename std::enable_if<!std::is_base_of<xbox_live_callback, typename std::decay<Functor>::type>::value>::type>
+    xbox_live_callback(Functor functor) : m_operations(nullptr)
     {
-        m_callable = xsapi_unique_ptr<ICallable>(xsapi_allocate_unique<callable<Functor>>(functor).release());
+        assign(std::move(functor));
     }
 
-    xbox_live_callback(const xbox_live_callback& rhs)
+    xbox_live_callback(const xbox_live_callback& rhs) : m_operations(nullptr)
     {
-        *this = rhs;
+        copy_from(rhs);
     }
 
-    xbox_live_callback(xbox_live_callback&& rhs)
+    xbox_live_callback(xbox_live_callback&& rhs) noexcept : m_operations(nullptr)
     {
-        *this = std::move(rhs);
+        move_from(rhs);
     }
 
-    template <typename Functor>
-    xbox_live_callback& operator=(Functor f)
+    ~xbox_live_callback()
     {
-        m_callable = xsapi_unique_ptr<ICallable>(xsapi_allocate_unique<callable<Functor>>(f).release());
+        reset();
+    }
+
+    template <typename Functor, typename = typename std::enable_if<!std::is_base_of<xbox_live_callback, typename std::decay<Functor>::type>::value>::type>
+    xbox_live_callback& operator=(Functor functor)
+    {
+        reset();
+        assign(std::move(functor));
         return *this;
     }
 
     xbox_live_callback& operator=(const xbox_live_callback& rhs)
     {
-        if (rhs.m_callable != nullptr)
-        {
-            m_callable = rhs.m_callable->copy();
-        }
-        else
+        if (this != &rhs)
         {
-            m_callable = nullptr;
+            xbox_live_callback copy(rhs);
+            reset();
+            move_from(copy);
         }
         return *this;
     }
 
-    xbox_live_callback& operator=(xbox_live_callback&& rhs)
+    xbox_live_callback& operator=(xbox_live_callback&& rhs) noexcept
     {
-        m_callable = std::move(rhs.m_callable);
+        if (this != &rhs)
+        {
+            reset();
+            move_from(rhs);
+        }
         return *this;
     }
 
     xbox_live_callback& operator=(nullptr_t)
     {
-        m_callable = nullptr;
+        reset();
         return *this;
     }
 
     void operator()(Args... args) const
     {
-        if (m_callable != nullptr)
+        if (m_operations != nullptr)
         {
-            (*m_callable)(args...);
+            m_operations->invoke(const_cast<storage&>(m_storage), args...);
         }
     }
 
-    bool operator==(std::nullptr_t) noexcept
+    bool operator==(std::nullptr_t) const noexcept
     {
-        return m_callable == nullptr;
+        return m_operations == nullptr;
     }
 
-    bool operator!=(std::nullptr_t) noexcept
+    bool operator!=(std::nullptr_t) const noexcept
     {
-        return m_callable != nullptr;
+        return m_operations != nullptr;
     }
 
 private:
-    struct ICallable
+    union storage
     {
-        virtual ~ICallable() = default;
-        virtual void operator()(Args...) = 0;
-        virtual xsapi_unique_ptr<ICallable> copy() = 0;
+        typename std::aligned_storage<XSAPI_CALLBACK_INLINE_SIZE>::type buffer;
+        void* heap;
     };
 
-    template <typename Functor>
-    struct callable : public ICallable
+    // Hand written vtable, so the functor can live in m_storage rather than behind an ICallable pointer
+    struct operations
     {
-        callable(const Functor& functor) : m_functor(functor) { }
-        ~callable() override = default;
+        void (*invoke)(storage& target, Args&... args);
+        void (*copy)(const storage& source, storage& destination);
+        void (*move)(storage& source, storage& destination);
+        void (*destroy)(storage& target);
+    };
 
-        void operator()(Args... args) override
+    template<typename Functor>
+    struct handler
+    {
+        typedef std::integral_constant<bool,
+            sizeof(Functor) <= sizeof(storage) &&
+            std::alignment_of<Functor>::value <= std::alignment_of<storage>::value &&
+            std::is_nothrow_move_constructible<Functor>::value> is_inline;
+
+        static const operations* table()
         {
-            m_functor(args...);
+            static const operations s_operations = { &invoke, &copy, &move, &destroy };
+            return &s_operations;
         }
 
-        xsapi_unique_ptr<ICallable> copy() override
+        template<typename Source>
+        static void create(storage& target, Source&& functor)
         {
-            return xsapi_unique_ptr<ICallable>(xsapi_allocate_unique<callable<Functor>>(m_functor).release());
+            create_impl(target, std::forward<Source>(functor), is_inline());
         }
 
-        Functor m_functor;
-    };
+        static Functor* get(storage& target)
+        {
+            return get_impl(target, is_inline());
+        }
 
-    xsapi_unique_ptr<ICallable> m_callable;
-};
+        static void invoke(storage& target, Args&... args)
+        {
+            (*get(target))(args...);
+        }
 
-template<>
-class xbox_live_callback<void>
-{
-public:
-    xbox_live_callback() : m_callable(nullptr) {}
-    xbox_live_callback(nullptr_t) : m_callable(nullptr) {}
+        static void copy(const storage& source, storage& destination)
+        {
+            create(destination, static_cast<const Functor&>(*get(const_cast<storage&>(source))));
+        }
 
-    template <typename Functor>
-    xbox_live_callback(Functor functor)
-    {
-        m_callable = xsapi_unique_ptr<ICallable>(xsapi_allocate_unique<callable<Functor>>(functor).release());
-    }
+        static void move(storage& source, storage& destination)
+        {
+            move_impl(source, destination, is_inline());
+        }
 
-    xbox_live_callback(const xbox_live_callback& rhs)
-    {
-        *this = rhs;
-    }
+        static void destroy(storage& target)
+        {
+            destroy_impl(target, is_inline());
+        }
 
-    xbox_live_callback(xbox_live_callback&& rhs)
-    {
-        *this = std::move(rhs);
-    }
+    private:
+        template<typename Source>
+        static void create_impl(storage& target, Source&& functor, std::true_type)
+        {
+            new (&target.buffer) Functor(std::forward<Source>(functor));
+        }
 
-    template <typename Functor>
-    xbox_live_callback& operator=(Functor f)
-    {
-        m_callable = xsapi_unique_ptr<ICallable>(xsapi_allocate_unique<callable<Functor>>(f).release());
-        return *this;
-    }
+        template<typename Source>
+        static void create_impl(storage& target, Source&& functor, std::false_type)
+        {
+            void* buffer = xbox::services::system::xsapi_memory::mem_alloc(sizeof(Functor));
+            if (buffer == nullptr)
+            {
+                throw std::bad_alloc();
+            }
 
-    xbox_live_callback& operator=(const xbox_live_callback& rhs)
-    {
-        if (rhs.m_callable != nullptr)
+            try
+            {
+                target.heap = new (buffer) Functor(std::forward<Source>(functor));
+            }
+            catch (...)
+            {
+                xbox::services::system::xsapi_memory::mem_free(buffer);
+                throw;
+            }
+        }
+
+        static Functor* get_impl(storage& target, std::true_type)
         {
-            m_callable = rhs.m_callable->copy();
+            return reinterpret_cast<Functor*>(&target.buffer);
         }
-        else
+
+        static Functor* get_impl(storage& target, std::false_type)
         {
-            m_callable = nullptr;
+            return static_cast<Functor*>(target.heap);
         }
-        return *this;
-    }
 
-    xbox_live_callback& operator=(xbox_live_callback&& rhs)
+        static void move_impl(storage& source, storage& destination, std::true_type)
+        {
+            Functor* functor = get(source);
+            new (&destination.buffer) Functor(std::move(*functor));
+            functor->~Functor();
+        }
+
+        static void move_impl(storage& source, storage& destination, std::false_type)
+        {
+            destination.heap = source.heap;
+            source.heap = nullptr;
+        }
+
+        static void destroy_impl(storage& target, std::true_type)
+        {
+            get(target)->~Functor();
+        }
+
+        static void destroy_impl(storage& target, std::false_type)
+        {
+            Functor* functor = get(target);
+            functor->~Functor();
+            xbox::services::system::xsapi_memory::mem_free(functor);
+        }
+    };
+
+    template<typename Functor>
+    void assign(Functor&& functor)
     {
-        m_callable = std::move(rhs.m_callable);
-        return *this;
+        typedef typename std::decay<Functor>::type functor_type;
+        static_assert(std::is_copy_constructible<functor_type>::value, "xbox_live_callback requires a copyable functor; hold move-only state through a shared_ptr");
+        handler<functor_type>::create(m_storage, std::forward<Functor>(functor));
+        m_operations = handler<functor_type>::table();
     }
 
-    xbox_live_callback& operator=(nullptr_t)
+    void copy_from(const xbox_live_callback& rhs)
     {
-        m_callable = nullptr;
-        return *this;
+        if (rhs.m_operations != nullptr)
+        {
+            rhs.m_operations->copy(rhs.m_storage, m_storage);
+            m_operations = rhs.m_operations;
+        }
     }
 
-    void operator()() const
+    void move_from(xbox_live_callback& rhs) noexcept
     {
-        if (m_callable != nullptr)
+        if (rhs.m_operations != nullptr)
         {
-            (*m_callable)();
+            rhs.m_operations->move(rhs.m_storage, m_storage);
+            m_operations = rhs.m_operations;
+            rhs.m_operations = nullptr;
         }
     }
 
-    bool operator==(std::nullptr_t) noexcept
+    void reset()
     {
-        return m_callable == nullptr;
+        if (m_operations != nullptr)
+        {
+            m_operations->destroy(m_storage);
+            m_operations = nullptr;
+        }
     }
 
-    bool operator!=(std::nullptr_t) noexcept
+    const operations* m_operations;
+    storage m_storage;
+};
+
+// xbox_live_callback<void> is the no argument form
+template<>
+class xbox_live_callback<void> : public xbox_live_callback<>
+{
+public:
+    xbox_live_callback() {}
+    xbox_live_callback(nullptr_t) {}
+
+    template <typename Functor, typename = typename std::enable_if<!std::is_base_of<xbox_live_callback<>, typename std::decay<Functor>::type>::value>::type>
+    xbox_live_callback(Functor functor) : xbox_live_callback<>(std::move(functor))
     {
-        return m_callable != nullptr;
     }
 
-private:
-    struct ICallable
+    template <typename Functor, typename = typename std::enable_if<!std::is_base_of<xbox_live_callback<>, typename std::decay<Functor>::type>::value>::type>
+    xbox_live_callback& operator=(Functor functor)
     {
-        virtual ~ICallable() = default;
-        virtual void operator()() = 0;
-        virtual xsapi_unique_ptr<ICallable> copy() = 0;
-    };
+        xbox_live_callback<>::operator=(std::move(functor));
+        return *this;
+    }
 
-    template <typename Functor>
-    struct callable : public ICallable
+    xbox_live_callback& operator=(nullptr_t)
     {
-        callable(const Functor& functor) : m_functor(functor) { }
-        ~callable() override = default;
-
-        void operator()() override
-        {
-            m_functor();
-        }
-
-        xsapi_unique_ptr<ICallable> copy() override
-        {
-            return xsapi_unique_ptr<ICallable>(xsapi_allocate_unique<callable<Functor>>(m_functor).release());
-        }
-
-        Functor m_functor;
-    };
-
-    xsapi_unique_ptr<ICallable> m_callable;
+        xbox_live_callback<>::operator=(nullptr);
+        return *this;
+    }
 };
 
 struct xsapi_singleton
@@ -397,6 +485,19 @@ struct xsapi_singleton
     // from Shared\http_call_impl.cpp
     std::shared_ptr<http_retry_after_manager> m_httpRetryPolicyManagerSingleton;
 
+    // from Shared\http_call_metrics.cpp
+    std::shared_ptr<http_call_metrics_internal> m_httpCallMetricsSingleton;
+    std::shared_ptr<http_call_metrics> m_httpCallMetricsConfigSingleton;
+
+    // from Shared\http_call_hedging.cpp
+    std::shared_ptr<http_call_hedging_policy> m_httpCallHedgingPolicySingleton;
+
+    // from Shared\http_call_dispatcher.cpp
+    std::shared_ptr<http_call_dispatcher> m_httpCallDispatcherSingleton;
+
+    // from Shared\http_compression.cpp
+    std::shared_ptr<http_compression_policy> m_httpCompressionPolicySingleton;
+
     // from Services\Presence\presence_service_internal.cpp
     std::function<void(int heartBeatDelayInMins)> m_onSetPresenceFinish;
 
@@ -1156,6 +1257,40 @@ public:
     static string_t string_t_from_internal_string(_In_ const xsapi_internal_string& internalString);
     static string_t string_t_from_utf8(_In_z_ PCSTR utf8);
 
+    /// <summary>
+    /// Parses a UTF-8 document without first widening it to string_t.
+    /// </summary>
+    static web::json::value json_parse_utf8(
+        _In_reads_bytes_(size) const char* utf8,
+        _In_ size_t size,
+        _Out_ std::error_code& errc
+        );
+
+    static web::json::value json_parse_utf8(
+        _In_ const xsapi_internal_string& utf8,
+        _Out_ std::error_code& errc
+        );
+
+    /// <summary>
+    /// Serializes straight to UTF-8 without an intermediate string_t.
+    /// </summary>
+    static xsapi_internal_string json_serialize_utf8(_In_ const web::json::value& json);
+
+    /// <summary>
+    /// Structural hash of a JSON value.  Object members are combined independent of their order,
+    /// so two values that compare equal always hash equal.
+    /// </summary>
+    static uint64_t json_hash(_In_ const web::json::value& json);
+
+    /// <summary>
+    /// Top level keys whose values differ between two objects, including keys present in only one of them.
+    /// A value that is not an object is treated as an empty object.
+    /// </summary>
+    static std::vector<string_t> json_changed_keys(
+        _In_ const web::json::value& current,
+        _In_ const web::json::value& previous
+        );
+
     static int utf8_from_char_t(_In_z_ const char_t* inArray, _Out_writes_z_(cchOutArray) char* outArray, _In_ int cchOutArray);
     static int char_t_from_utf8(_In_z_ const char* inArray, _Out_writes_z_(cchOutArray) char_t* outArray, _In_ int cchOutArray);
 
@@ -1510,6 +1645,10 @@ private:
         std::weak_ptr<T> m_weakPtr;
     };
 
+    // Containers are the same size for every T, so all async contexts are recycled through one pool
+    template<typename T>
+    using smart_ptr_container_pool = xbox::services::system::xsapi_fixed_block_pool<sizeof(shared_ptr_container<T>)>;
+
 public:
 
     // Returns a handle that can be used to later retrieve the stored shared_ptr.
@@ -1517,8 +1656,8 @@ public:
     template<typename T>
     static void* store_shared_ptr(std::shared_ptr<T> contextSharedPtr)
     {
-        auto buffer = xbox::services::system::xsapi_memory::mem_alloc(sizeof(shared_ptr_container<T>));
-        return new (buffer) shared_ptr_container<T>(contextSharedPtr);
+        auto buffer = smart_ptr_container_pool<T>::alloc();
+        return new (buffer) shared_ptr_container<T>(std::move(contextSharedPtr));
     }
 
     // Returns a handle that can be used to later retrieve the stored weak_ptr (as a shared_ptr, so
@@ -1526,8 +1665,9 @@ public:
     template<typename T>
     static void* store_weak_ptr(std::weak_ptr<T> contextWeakPtr)
     {
-        auto buffer = xbox::services::system::xsapi_memory::mem_alloc(sizeof(weak_ptr_container<T>));
-        return new (buffer) weak_ptr_container<T>(contextWeakPtr);
+        static_assert(sizeof(weak_ptr_container<T>) <= sizeof(shared_ptr_container<T>), "Both containers share one pool");
+        auto buffer = smart_ptr_container_pool<T>::alloc();
+        return new (buffer) weak_ptr_container<T>(std::move(contextWeakPtr));
     }
 
     // Retrieves a shared previouly stored with store_shared_ptr or store_weak_ptr. If releaseContext is true
@@ -1540,11 +1680,16 @@ public:
         if (releaseContext)
         {
             smartPtrContainer->~smart_ptr_container();
-            xbox::services::system::xsapi_memory::mem_free(context);
+            smart_ptr_container_pool<T>::free(context);
         }
         return sharedPtr;
     }
 
+    // AsyncBlocks are created on every async hop, so they are recycled rather than freed.
+    // Blocks from allocate_async_block must be released with free_async_block.
+    static AsyncBlock* allocate_async_block();
+    static void free_async_block(_In_ AsyncBlock* asyncBlock);
+
     static time_t time_t_from_datetime(const utility::datetime& datetime);
 
     static utility::datetime datetime_from_time_t(const time_t* time);
@@ -3,6 +3,7 @@
 
 #include "pch.h"
 #include "build_version.h"
+#include "http_compression.h"
 #include "user_context.h"
 #include "web_socket_client.h"
 #include "utils.h"
@@ -13,7 +14,8 @@ NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
 using namespace xbox::services::system;
 
 xbox_web_socket_client::xbox_web_socket_client()
-    : m_websocket(nullptr)
+    : m_websocket(nullptr),
+    m_inflateMessages(false)
 {
 }
 
@@ -78,6 +80,11 @@ void xbox_web_socket_client::connect(
         }
         HCWebSocketSetHeader(pThis->m_websocket, "User-Agent", userAgent.data());
 
+        if (!pThis->m_requestedExtensions.empty())
+        {
+            HCWebSocketSetHeader(pThis->m_websocket, "Sec-WebSocket-Extensions", pThis->m_requestedExtensions.data());
+        }
+
         HCWebSocketSetFunctions([](hc_websocket_handle_t websocket, _In_z_ const char* incomingBodyString)
         {
             try
@@ -131,16 +138,52 @@ void xbox_web_socket_client::connect(
             }
         });
 
-        AsyncBlock *asyncBlock = new (xsapi_memory::mem_alloc(sizeof(AsyncBlock))) AsyncBlock{};
+        HCWebSocketSetBinaryMessageFunction([](hc_websocket_handle_t websocket, _In_reads_bytes_(payloadSize) const uint8_t* payloadBytes, _In_ uint32_t payloadSize)
+        {
+            try
+            {
+                auto singleton = get_xsapi_singleton();
+                auto iter = singleton->m_websocketHandles.find(websocket);
+                if (iter != singleton->m_websocketHandles.end())
+                {
+                    auto pThis = iter->second.lock();
+                    if (pThis != nullptr)
+                    {
+                        pThis->on_binary_message(payloadBytes, payloadSize);
+                    }
+                }
+                else
+                {
+#ifndef UNIT_TEST_SERVICES
+                    XSAPI_ASSERT(false && "Could not find web_socket_client associated with HC_WEBSOCKET_HANDLER");
+#endif
+                }
+            }
+            catch (...)
+            {
+                LOG_ERROR("Exception happened in web socket binary receiving handler.");
+            }
+        });
+
+        AsyncBlock *asyncBlock = utils::allocate_async_block();
         asyncBlock->queue = get_xsapi_singleton()->m_asyncQueue;
-        asyncBlock->context = utils::store_shared_ptr(xsapi_allocate_shared<xbox_live_callback<WebSocketCompletionResult>>(callback));
+        asyncBlock->context = utils::store_shared_ptr(xsapi_allocate_shared<xbox_live_callback<WebSocketCompletionResult>>(
+            [thisWeakPtr, callback](WebSocketCompletionResult result)
+        {
+            std::shared_ptr<xbox_web_socket_client> pThis(thisWeakPtr.lock());
+            if (pThis != nullptr)
+            {
+                pThis->on_connected(result);
+            }
+            callback(result);
+        }));
         asyncBlock->callback = [](_Inout_ AsyncBlock* asyncBlock)
         {
             WebSocketCompletionResult result = {};
             HCGetWebSocketConnectResult(asyncBlock, &result);
             auto callback = utils::get_shared_ptr<xbox_live_callback<WebSocketCompletionResult>>(asyncBlock->context);
             (*callback)(result);
-            xsapi_memory::mem_free(asyncBlock);
+            utils::free_async_block(asyncBlock);
         };
 
         HCWebSocketConnectAsync(asyncBlock, uri.data(), subProtocol.data(), pThis->m_websocket);
@@ -152,7 +195,7 @@ void xbox_web_socket_client::send(
     _In_ xbox::services::xbox_live_callback<WebSocketCompletionResult> callback
     )
 {
-    AsyncBlock* asyncBlock = new (xsapi_memory::mem_alloc(sizeof(AsyncBlock))) AsyncBlock{};
+    AsyncBlock* asyncBlock = utils::allocate_async_block();
     asyncBlock->context = utils::store_shared_ptr(xsapi_allocate_shared<xbox_live_callback<WebSocketCompletionResult>>(callback));
     asyncBlock->callback = [](_Inout_ AsyncBlock* asyncBlock)
     {
@@ -160,7 +203,7 @@ void xbox_web_socket_client::send(
         HCGetWebSocketSendMessageResult(asyncBlock, &result);
         auto callback = utils::get_shared_ptr<xbox_live_callback<WebSocketCompletionResult>>(asyncBlock->context);
         (*callback)(result);
-        xsapi_memory::mem_free(asyncBlock);
+        utils::free_async_block(asyncBlock);
     };
     HCWebSocketSendMessageAsync(asyncBlock, m_websocket, message.data());
 }
@@ -170,6 +213,77 @@ void xbox_web_socket_client::close()
     HCWebSocketDisconnect(m_websocket);
 }
 
+web_socket_capabilities xbox_web_socket_client::capabilities() const
+{
+    return web_socket_capabilities{ true, true };
+}
+
+void xbox_web_socket_client::send_binary(
+    _In_ const xsapi_internal_vector<uint8_t>& payload,
+    _In_ xbox::services::xbox_live_callback<WebSocketCompletionResult> callback
+    )
+{
+    AsyncBlock* asyncBlock = utils::allocate_async_block();
+    asyncBlock->context = utils::store_shared_ptr(xsapi_allocate_shared<xbox_live_callback<WebSocketCompletionResult>>(callback));
+    asyncBlock->callback = [](_Inout_ AsyncBlock* asyncBlock)
+    {
+        WebSocketCompletionResult result = {};
+        HCGetWebSocketSendMessageResult(asyncBlock, &result);
+        auto callback = utils::get_shared_ptr<xbox_live_callback<WebSocketCompletionResult>>(asyncBlock->context);
+        (*callback)(result);
+        utils::free_async_block(asyncBlock);
+    };
+    HCWebSocketSendBinaryMessageAsync(asyncBlock, m_websocket, payload.data(), static_cast<uint32_t>(payload.size()));
+}
+
+void xbox_web_socket_client::set_requested_extensions(
+    _In_ const xsapi_internal_string& extensions
+    )
+{
+    m_requestedExtensions = extensions;
+}
+
+xsapi_internal_string xbox_web_socket_client::negotiated_extensions() const
+{
+    std::lock_guard<std::mutex> lock(m_extensionsLock);
+    return m_negotiatedExtensions;
+}
+
+void xbox_web_socket_client::on_connected(_In_ const WebSocketCompletionResult& result)
+{
+    if (FAILED(result.errorCode))
+    {
+        return;
+    }
+
+    // libHttpClient doesn't surface the handshake response, so an offer is taken as accepted.  A binary message
+    // that isn't a valid DEFLATE stream is handed on as it arrived.
+    std::lock_guard<std::mutex> lock(m_extensionsLock);
+    m_negotiatedExtensions = m_requestedExtensions;
+    m_inflateMessages = m_requestedExtensions.find(WEB_SOCKET_PERMESSAGE_DEFLATE) != xsapi_internal_string::npos;
+    m_inflateHistory.clear();
+}
+
+void xbox_web_socket_client::on_binary_message(
+    _In_reads_bytes_(payloadSize) const uint8_t* payload,
+    _In_ size_t payloadSize
+    )
+{
+    xsapi_internal_vector<uint8_t> message;
+    {
+        std::lock_guard<std::mutex> lock(m_extensionsLock);
+        if (!m_inflateMessages || !http_compression::inflate_message(payload, payloadSize, m_inflateHistory, message))
+        {
+            message.assign(payload, payload + payloadSize);
+        }
+    }
+
+    if (m_binaryReceiveHandler != nullptr)
+    {
+        m_binaryReceiveHandler(message);
+    }
+}
+
 void xbox_web_socket_client::set_received_handler(
     _In_ xbox_live_callback<xsapi_internal_string> handler
     )
@@ -177,6 +291,13 @@ void xbox_web_socket_client::set_received_handler(
     m_receiveHandler = handler;
 }
 
+void xbox_web_socket_client::set_binary_received_handler(
+    _In_ xbox_live_callback<xsapi_internal_vector<uint8_t>> handler
+    )
+{
+    m_binaryReceiveHandler = handler;
+}
+
 void xbox_web_socket_client::set_closed_handler(
     _In_ xbox_live_callback<HCWebSocketCloseStatus> handler
     )
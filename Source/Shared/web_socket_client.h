@@ -5,6 +5,18 @@
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
 
+// Offered in Sec-WebSocket-Extensions when the transport can inflate compressed messages (RFC 7692)
+#define WEB_SOCKET_PERMESSAGE_DEFLATE "permessage-deflate"
+
+/// <summary>
+/// Transport features beyond UTF-8 text frames.  Callers only use the features the client reports.
+/// </summary>
+struct web_socket_capabilities
+{
+    bool binaryFrames;
+    bool permessageDeflate;
+};
+
 class xbox_web_socket_client : public std::enable_shared_from_this<xbox_web_socket_client>
 {
 public:
@@ -25,18 +37,60 @@ public:
 
     virtual void close();
 
+    virtual web_socket_capabilities capabilities() const;
+
+    /// <summary>
+    /// Sends a binary frame.  Outgoing messages are never compressed, which permessage-deflate allows.
+    /// </summary>
+    virtual void send_binary(
+        _In_ const xsapi_internal_vector<uint8_t>& payload,
+        _In_ xbox::services::xbox_live_callback<WebSocketCompletionResult> callback
+        );
+
+    /// <summary>
+    /// Extensions to offer in the Sec-WebSocket-Extensions header of the next connect.
+    /// </summary>
+    virtual void set_requested_extensions(
+        _In_ const xsapi_internal_string& extensions
+        );
+
+    /// <summary>
+    /// Extensions in effect since the last connect.  Empty if none were offered.
+    /// </summary>
+    virtual xsapi_internal_string negotiated_extensions() const;
+
     virtual void set_received_handler(
         _In_ xbox_live_callback<xsapi_internal_string> handler
         );
 
+    virtual void set_binary_received_handler(
+        _In_ xbox_live_callback<xsapi_internal_vector<uint8_t>> handler
+        );
+
     virtual void set_closed_handler(
         _In_ xbox_live_callback<HCWebSocketCloseStatus> handler
         );
 
 private:
+    void on_connected(_In_ const WebSocketCompletionResult& result);
+
+    void on_binary_message(
+        _In_reads_bytes_(payloadSize) const uint8_t* payload,
+        _In_ size_t payloadSize
+        );
+
     hc_websocket_handle_t m_websocket;
+    xsapi_internal_string m_requestedExtensions;
+
+    mutable std::mutex m_extensionsLock;
+    xsapi_internal_string m_negotiatedExtensions;
+    bool m_inflateMessages;
+
+    // Output of the messages inflated so far on this connection; compressed messages may refer back into it
+    xsapi_internal_vector<uint8_t> m_inflateHistory;
 
     xbox_live_callback<xsapi_internal_string> m_receiveHandler;
+    xbox_live_callback<xsapi_internal_vector<uint8_t>> m_binaryReceiveHandler;
     xbox_live_callback<HCWebSocketCloseStatus> m_closeHandler;
 };
 
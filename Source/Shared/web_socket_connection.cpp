@@ -25,7 +25,8 @@ web_socket_connection::web_socket_connection(
     m_state(web_socket_connection_state::disconnected),
     m_client(system::xbox_system_factory::get_factory()->create_web_socket_client()),
     m_closeRequested(false),
-    m_attemptingConnection(false)
+    m_attemptingConnection(false),
+    m_compressionNegotiated(false)
 {
     XSAPI_ASSERT(m_httpSetting != nullptr);
 }
@@ -62,7 +63,7 @@ HRESULT web_socket_connection::attempt_connect(retry_context* retryContext, Asyn
 
 void web_socket_connection::retry_until_connected(retry_context* context)
 {
-    AsyncBlock* nestedAsyncBlock = new (xsapi_memory::mem_alloc(sizeof(AsyncBlock))) AsyncBlock{};
+    AsyncBlock* nestedAsyncBlock = utils::allocate_async_block();
     nestedAsyncBlock->context = context;
     CreateNestedAsyncQueue(context->asyncProviderData->queue, &nestedAsyncBlock->queue);
     
@@ -73,6 +74,7 @@ void web_socket_connection::retry_until_connected(retry_context* context)
         if (SUCCEEDED(retryContext->result.errorCode))
         {
             pThis->m_attemptingConnection = false;
+            pThis->on_connected();
             pThis->set_state_helper(web_socket_connection_state::connected);
 
             pThis->m_client->set_closed_handler([pThis](HCWebSocketCloseStatus closeStatus)
@@ -110,7 +112,7 @@ void web_socket_connection::retry_until_connected(retry_context* context)
         }
 
         CloseAsyncQueue(async->queue);
-        xsapi_memory::mem_free(async);
+        utils::free_async_block(async);
     };
 
     HRESULT hr = attempt_connect(context, nestedAsyncBlock);
@@ -140,12 +142,12 @@ void web_socket_connection::ensure_connected()
     m_attemptingConnection = true;
     set_state_helper(web_socket_connection_state::connecting);
 
-    AsyncBlock* outerAsync = new (xsapi_memory::mem_alloc(sizeof(AsyncBlock))) AsyncBlock{};
+    AsyncBlock* outerAsync = utils::allocate_async_block();
     outerAsync->queue = get_xsapi_singleton()->m_asyncQueue;
     outerAsync->callback = [](AsyncBlock* async)
     {
         LOG_DEBUG("Web socket connection completed.");
-        xsapi_memory::mem_free(async);
+        utils::free_async_block(async);
     };
 
     auto retryContext = xsapi_allocate_shared<retry_context>();
@@ -187,6 +189,15 @@ web_socket_connection::send(
     m_client->send(message, callback);
 }
 
+void
+web_socket_connection::send_binary(
+    _In_ const xsapi_internal_vector<uint8_t>& payload,
+    _In_ xbox::services::xbox_live_callback<WebSocketCompletionResult> callback
+    )
+{
+    m_client->send_binary(payload, callback);
+}
+
 void
 web_socket_connection::close()
 {
@@ -194,6 +205,60 @@ web_socket_connection::close()
     m_client->close();
 }
 
+bool
+web_socket_connection::binary_frames_supported() const
+{
+    return m_client->capabilities().binaryFrames;
+}
+
+bool
+web_socket_connection::request_compression()
+{
+    if (!m_client->capabilities().permessageDeflate)
+    {
+        return false;
+    }
+
+    // Let the endpoint pick its window size; the transport inflates with whatever it chooses
+    m_client->set_requested_extensions(WEB_SOCKET_PERMESSAGE_DEFLATE "; client_max_window_bits");
+    return true;
+}
+
+bool
+web_socket_connection::compression_negotiated()
+{
+    std::lock_guard<std::mutex> lock(m_stateLocker);
+    return m_compressionNegotiated;
+}
+
+void
+web_socket_connection::on_connected()
+{
+    // The accepted extension list is comma separated, each entry starting with its name followed by optional parameters
+    bool compressionNegotiated = false;
+    auto extensions = utils::string_split(m_client->negotiated_extensions(), ',');
+    for (auto& extension : extensions)
+    {
+        size_t nameBegin = extension.find_first_not_of(" \t");
+        if (nameBegin == xsapi_internal_string::npos)
+        {
+            continue;
+        }
+        size_t nameEnd = extension.find_first_of(" \t;", nameBegin);
+        xsapi_internal_string name = extension.substr(nameBegin, nameEnd == xsapi_internal_string::npos ? xsapi_internal_string::npos : nameEnd - nameBegin);
+        if (utils::str_icmp(name, WEB_SOCKET_PERMESSAGE_DEFLATE) == 0)
+        {
+            compressionNegotiated = true;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_stateLocker);
+        m_compressionNegotiated = compressionNegotiated;
+    }
+    LOGS_DEBUG << "Websocket connected, compression " << (compressionNegotiated ? "negotiated" : "not negotiated");
+}
+
 void 
 web_socket_connection::set_received_handler(
     _In_ xbox::services::xbox_live_callback<xsapi_internal_string> handler
@@ -205,6 +270,17 @@ web_socket_connection::set_received_handler(
     }
 }
 
+void
+web_socket_connection::set_binary_received_handler(
+    _In_ xbox::services::xbox_live_callback<xsapi_internal_vector<uint8_t>> handler
+    )
+{
+    if (m_client != nullptr)
+    {
+        m_client->set_binary_received_handler(handler);
+    }
+}
+
 void
 web_socket_connection::on_close(HCWebSocketCloseStatus closeStatus)
 {
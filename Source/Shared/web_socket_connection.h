@@ -25,15 +25,33 @@ public:
         _In_ xbox::services::xbox_live_callback<WebSocketCompletionResult> callback = nullptr
         );
 
+    // Completes with E_NOTIMPL if the transport cannot send binary frames; check binary_frames_supported() first.
+    void send_binary(
+        _In_ const xsapi_internal_vector<uint8_t>& payload,
+        _In_ xbox::services::xbox_live_callback<WebSocketCompletionResult> callback = nullptr
+        );
+
     void close();
 
     // current connection state of the web_socket_connection
     web_socket_connection_state state();
 
+    bool binary_frames_supported() const;
+
+    // Offers permessage-deflate on the next connect if the transport supports it. Returns whether it was offered.
+    bool request_compression();
+
+    // Whether the endpoint accepted permessage-deflate on the current connection
+    bool compression_negotiated();
+
     void set_received_handler(
         _In_ xbox::services::xbox_live_callback<xsapi_internal_string> handler
         );
 
+    void set_binary_received_handler(
+        _In_ xbox::services::xbox_live_callback<xsapi_internal_vector<uint8_t>> handler
+        );
+
     void set_connection_state_change_handler(
         _In_ xbox::services::xbox_live_callback<web_socket_connection_state, web_socket_connection_state> handler
         );
@@ -54,6 +72,9 @@ private:
 
     void set_state_helper(_In_ web_socket_connection_state newState);
 
+    // Records what the handshake negotiated, before the connected state is published
+    void on_connected();
+
     // Close callback. It could because of client call, network issue or service termination
     void on_close(HCWebSocketCloseStatus closeStatus);
 
@@ -73,6 +94,7 @@ private:
     bool m_connectionActive;
     bool m_closeRequested;
     bool m_attemptingConnection;
+    bool m_compressionNegotiated;
 };
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
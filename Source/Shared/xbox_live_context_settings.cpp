@@ -67,10 +67,12 @@ xbox_live_context_settings::xbox_live_context_settings() :
     m_httpTimeoutWindow(std::chrono::seconds(DEFAULT_HTTP_RETRY_WINDOW_SECONDS)),
     m_useCoreDispatcherForEventRouting(false),
 #if TV_API
-    m_useXplatQosServer(false)
+    m_useXplatQosServer(false),
 #else
-    m_useXplatQosServer(true)
+    m_useXplatQosServer(true),
 #endif
+    m_useHttpRequestHedging(false),
+    m_useHttpCompression(false)
 {
 }
 
@@ -235,4 +237,24 @@ void xbox_live_context_settings::set_use_crossplatform_qos_servers(_In_ bool val
     m_useXplatQosServer = value;
 }
 
+bool xbox_live_context_settings::use_http_request_hedging() const
+{
+    return m_useHttpRequestHedging;
+}
+
+void xbox_live_context_settings::set_use_http_request_hedging(_In_ bool value)
+{
+    m_useHttpRequestHedging = value;
+}
+
+bool xbox_live_context_settings::use_http_compression() const
+{
+    return m_useHttpCompression;
+}
+
+void xbox_live_context_settings::set_use_http_compression(_In_ bool value)
+{
+    m_useHttpCompression = value;
+}
+
 NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
@@ -4,6 +4,7 @@
 #include "pch.h"
 #include "xsapi/system.h"
 #include "xsapi/social_manager.h"
+#include "mem_pool.h"
 #if XSAPI_A
 #include "Logger/android/logcat_output.h"
 #else
@@ -96,6 +97,9 @@ void xbox_live_services_settings::set_memory_allocation_hooks(
         THROW_CPP_INVALIDARGUMENT_IF(memAllocHandler == nullptr || memFreeHandler == nullptr);
     }
 
+    // Blocks cached by the pool must go back through the hooks that allocated them
+    xsapi_memory_pool::trim();
+
     m_pCustomMemAllocHook = memAllocHandler;
     m_pCustomMemFreeHook = memFreeHandler;
 
@@ -105,6 +109,31 @@ void xbox_live_services_settings::set_memory_allocation_hooks(
     HCMemSetFunctions(g_pMemAllocHook, g_pMemFreeHook);
 }
 
+void xbox_live_services_settings::set_memory_tracking_mode(_In_ xsapi_memory_tracking_mode mode)
+{
+    xsapi_memory_pool::set_tracking_mode(mode);
+}
+
+xsapi_memory_tracking_mode xbox_live_services_settings::memory_tracking_mode() const
+{
+    return xsapi_memory_pool::tracking_mode();
+}
+
+xsapi_memory_stats xbox_live_services_settings::memory_stats(_In_ xsapi_memory_subsystem subsystem) const
+{
+    return xsapi_memory_pool::stats(subsystem);
+}
+
+std::vector<std::pair<std::string, xsapi_memory_stats>> xbox_live_services_settings::memory_stats_by_call_site() const
+{
+    return xsapi_memory_pool::call_site_stats();
+}
+
+void xbox_live_services_settings::reset_memory_high_water_marks()
+{
+    xsapi_memory_pool::reset_high_water_marks();
+}
+
 function_context xbox_live_services_settings::add_logging_handler(_In_ std::function<void(xbox_services_diagnostics_trace_level, const std::string&, const std::string&)> handler)
 {
     std::lock_guard<std::mutex> lock(m_loggingWriteLock);
@@ -161,7 +161,7 @@ void user_impl_idp::sign_in_impl(
                     presence_title_request request(true,presence_data());
 
                     httpCall->set_retry_allowed(false);
-                    httpCall->set_request_body(utils::internal_string_from_string_t(request.serialize().serialize()));
+                    httpCall->set_request_body(utils::json_serialize_utf8(request.serialize()));
                     httpCall->set_xbox_contract_version_header_value(_T("3"));
                     httpCall->set_custom_header("Authorization", payload.token(), false);
                     if (!payload.signature().empty())
@@ -233,14 +233,14 @@ void user_impl_idp::initialize_provider(
 {
     std::weak_ptr<user_impl_idp> thisWeakPtr = std::dynamic_pointer_cast<user_impl_idp>(shared_from_this());
 
-    AsyncBlock* async = new (xsapi_memory::mem_alloc(sizeof(AsyncBlock))) AsyncBlock{};
+    AsyncBlock* async = utils::allocate_async_block();
     async->queue = queue;
     async->context = utils::store_shared_ptr(xsapi_allocate_shared<xbox_live_callback<void>>(callback));
     async->callback = [](AsyncBlock* async)
     {
         auto callbackPtr = utils::get_shared_ptr<xbox_live_callback<void>>(async->context);
         (*callbackPtr)();
-        xsapi_memory::mem_free(async);
+        utils::free_async_block(async);
     };
 
     BeginAsync(async, utils::store_weak_ptr(thisWeakPtr), nullptr, __FUNCTION__,
@@ -347,14 +347,14 @@ void user_impl_idp::internal_get_token_and_signature(
     context->forceRefresh = forceRefresh;
     context->callback = callback;
 
-    AsyncBlock* internalAsyncBlock = new (xsapi_memory::mem_alloc(sizeof(AsyncBlock))) AsyncBlock{};
+    AsyncBlock* internalAsyncBlock = utils::allocate_async_block();
     internalAsyncBlock->context = utils::store_shared_ptr(context);
     internalAsyncBlock->queue = queue;
     internalAsyncBlock->callback = [](_In_ struct AsyncBlock* asyncBlock)
     {
         auto context = utils::get_shared_ptr<get_token_and_signature_context>(asyncBlock->context, true);
         context->callback(context->result);
-        xsapi_memory::mem_free(asyncBlock);
+        utils::free_async_block(asyncBlock);
     };
 
     auto hresult = BeginAsync(internalAsyncBlock, internalAsyncBlock->context, nullptr, __FUNCTION__,
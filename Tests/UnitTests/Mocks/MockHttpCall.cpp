@@ -9,6 +9,7 @@ NAMESPACE_MICROSOFT_XBOX_SERVICES_SYSTEM_CPP_BEGIN
 
 MockHttpCall::MockHttpCall() :
     ResultHR(S_OK),
+    Priority(http_call_priority::interactive),
     CallCounter(0)
 {
     reinit();
@@ -22,6 +23,7 @@ void MockHttpCall::reinit()
     ServerName = std::wstring();
     HttpMethod = std::wstring();
     PathQueryFragment = web::uri();
+    RequestHeaders.clear();
     ResultHR = S_OK;
     CallCounter = 0;
 }
@@ -119,7 +121,6 @@ MockHttpCall::get_response(
     )
 {
     UNREFERENCED_PARAMETER(queue);
-    UNREFERENCED_PARAMETER(httpCallResponseBodyType);
     if (FAILED(ResultHR))
     {
         throw ResultHR;
@@ -129,6 +130,7 @@ MockHttpCall::get_response(
     {
         fRequestPostFuncInternal(ResultValueInternal, m_requestBody.request_message_string());
     }
+    apply_response_body_type(httpCallResponseBodyType);
     ResultValueInternal->set_full_url(utils::internal_string_from_string_t(ServerName));
     ResultValueInternal->route_service_call();
     callback(ResultValueInternal);
@@ -146,7 +148,11 @@ pplx::task<std::shared_ptr<http_call_response>> MockHttpCall::get_response_with_
         throw ResultHR;
     }
     CallCounter++;
-    if (fRequestPostFunc != nullptr)
+    if (fRequestHandlerFunc != nullptr)
+    {
+        fRequestHandlerFunc(ResultValue, utils::string_t_from_internal_string(m_requestBody.request_message_string()), RequestHeaders);
+    }
+    else if (fRequestPostFunc != nullptr)
     {
         fRequestPostFunc(ResultValue, utils::string_t_from_internal_string(m_requestBody.request_message_string()));
     }
@@ -168,7 +174,11 @@ MockHttpCall::get_response_with_auth(
         throw ResultHR;
     }
     CallCounter++;
-    if (fRequestPostFunc != nullptr)
+    if (fRequestHandlerFunc != nullptr)
+    {
+        fRequestHandlerFunc(ResultValue, utils::string_t_from_internal_string(m_requestBody.request_message_string()), RequestHeaders);
+    }
+    else if (fRequestPostFunc != nullptr)
     {
         fRequestPostFunc(ResultValue, utils::string_t_from_internal_string(m_requestBody.request_message_string()));
     }
@@ -187,7 +197,6 @@ xbox_live_result<void> MockHttpCall::get_response_with_auth(
 {
     UNREFERENCED_PARAMETER(userContext);
     UNREFERENCED_PARAMETER(queue);
-    UNREFERENCED_PARAMETER(httpCallResponseBodyType);
     UNREFERENCED_PARAMETER(allUsersAuthRequired);
     if (FAILED(ResultHR))
     {
@@ -198,6 +207,7 @@ xbox_live_result<void> MockHttpCall::get_response_with_auth(
     {
         fRequestPostFuncInternal(ResultValueInternal, m_requestBody.request_message_string());
     }
+    apply_response_body_type(httpCallResponseBodyType);
     ResultValueInternal->set_full_url(utils::internal_string_from_string_t(ServerName));
     ResultValueInternal->route_service_call();
     callback(ResultValueInternal);
@@ -329,6 +339,16 @@ bool MockHttpCall::add_default_headers() const
     return false;
 }
 
+void MockHttpCall::set_priority(_In_ http_call_priority value)
+{
+    Priority = value;
+}
+
+http_call_priority MockHttpCall::priority() const
+{
+    return Priority;
+}
+
 void MockHttpCall::set_custom_header(
     _In_ const std::wstring& headerName,
     _In_ const std::wstring& headerValue
@@ -347,6 +367,7 @@ void MockHttpCall::set_custom_header(
     )
 {
     UNREFERENCED_PARAMETER(allowTracing);
+    RequestHeaders[headerName] = headerValue;
 #if UNIT_TEST_SERVICES
     ResultValueInternal->add_response_header(headerName, headerValue);
 #endif
@@ -361,4 +382,16 @@ void MockHttpCall::remove_custom_header(
 #endif
 }
 
+void MockHttpCall::apply_response_body_type(
+    _In_ http_call_response_body_type httpCallResponseBodyType
+    )
+{
+    // Stock responses are built from JSON; callers that stream the raw body get the serialized document instead
+    if (httpCallResponseBodyType == http_call_response_body_type::string_body &&
+        ResultValueInternal->body_type() == http_call_response_body_type::json_body)
+    {
+        ResultValueInternal->set_response_body(utils::internal_string_from_string_t(ResultValueInternal->response_body_json().serialize()));
+    }
+}
+
 NAMESPACE_MICROSOFT_XBOX_SERVICES_SYSTEM_CPP_END
@@ -110,6 +110,9 @@ public:
         _In_ bool allowTracing
         ) override;
 
+    virtual void set_priority(_In_ http_call_priority value) override;
+    virtual http_call_priority priority() const override;
+
     void remove_custom_header(
         _In_ const xsapi_internal_string& headerName
         );
@@ -126,13 +129,20 @@ public:
     std::wstring ServerName;
     web::uri PathQueryFragment;
     xbox_live_api XboxLiveApi;
+    http_call_priority Priority;
 
     int CallCounter;
 
     std::function<void(std::shared_ptr<http_call_response>&, const string_t& requestPost)> fRequestPostFunc; // TODO remove eventually
     xbox_live_callback<std::shared_ptr<http_call_response_internal>, const xsapi_internal_string&> fRequestPostFuncInternal; 
 
+    // Custom headers set on the request, for handlers that model conditional requests
+    http_headers RequestHeaders;
+    std::function<void(std::shared_ptr<http_call_response>&, const string_t& requestPost, const http_headers& requestHeaders)> fRequestHandlerFunc;
+
 private:
+    void apply_response_body_type(_In_ http_call_response_body_type httpCallResponseBodyType);
+
     http_call_request_message_internal m_requestBody;
 };
 
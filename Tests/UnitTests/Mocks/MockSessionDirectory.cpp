@@ -0,0 +1,455 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "pch.h"
+#include "MockSessionDirectory.h"
+#include "StockMocks.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_SYSTEM_CPP_BEGIN
+
+MockSessionDirectory::MockSessionDirectory(
+    _In_ web::json::value session,
+    _In_ string_t contentLocation,
+    _In_ string_t localXboxUserId,
+    _In_ std::chrono::milliseconds latency
+    ) :
+    m_session(std::move(session)),
+    m_contentLocation(std::move(contentLocation)),
+    m_localXboxUserId(std::move(localXboxUserId)),
+    m_changeNumber(0),
+    m_nextMemberId(0),
+    m_latency(latency),
+    m_writes(0),
+    m_conflicts(0),
+    m_reads(0),
+    m_notModifiedReads(0)
+{
+    if (m_session.has_field(_T("changeNumber")))
+    {
+        m_changeNumber = m_session.at(_T("changeNumber")).as_number().to_uint64();
+    }
+    if (m_session.has_field(_T("membersInfo")) && m_session.at(_T("membersInfo")).has_field(_T("next")))
+    {
+        m_nextMemberId = m_session.at(_T("membersInfo")).at(_T("next")).as_number().to_uint32();
+    }
+
+    stringstream_t eTag;
+    eTag << _T("\"") << m_changeNumber << _T("\"");
+    m_eTag = eTag.str();
+}
+
+void
+MockSessionDirectory::install(
+    _In_ const std::shared_ptr<MockXboxSystemFactory>& mockFactory
+    )
+{
+    std::weak_ptr<MockSessionDirectory> thisWeakPtr = shared_from_this();
+
+    // The response list only selects the handler; the handler replaces the response
+    auto placeholderResponse = StockMocks::CreateMockHttpCallResponse(web::json::value::object());
+
+    auto writeResponseStruct = std::make_shared<HttpResponseStruct>();
+    writeResponseStruct->responseList = { placeholderResponse };
+    writeResponseStruct->fRequestHandlerFunc = [thisWeakPtr](std::shared_ptr<http_call_response>& response, const string_t& requestPost, const http_headers& requestHeaders)
+    {
+        auto pThis = thisWeakPtr.lock();
+        if (pThis != nullptr)
+        {
+            pThis->handle_write(response, requestPost, requestHeaders);
+        }
+    };
+
+    auto readResponseStruct = std::make_shared<HttpResponseStruct>();
+    readResponseStruct->responseList = { placeholderResponse };
+    readResponseStruct->fRequestHandlerFunc = [thisWeakPtr](std::shared_ptr<http_call_response>& response, const string_t&, const http_headers& requestHeaders)
+    {
+        auto pThis = thisWeakPtr.lock();
+        if (pThis != nullptr)
+        {
+            pThis->handle_read(response, requestHeaders);
+        }
+    };
+
+    std::unordered_map<xbox_live_api, std::shared_ptr<HttpResponseStruct>> responses;
+    responses[xbox_live_api::write_session_using_subpath] = writeResponseStruct;
+    responses[xbox_live_api::get_current_session] = readResponseStruct;
+    responses[xbox_live_api::get_current_session_by_handle] = readResponseStruct;
+    mockFactory->add_http_api_state_response(responses, false);
+}
+
+void
+MockSessionDirectory::set_session_changed_handler(
+    _In_ std::function<void(uint64_t)> handler
+    )
+{
+    std::lock_guard<std::mutex> lock(m_lock.get());
+    m_sessionChangedHandler = std::move(handler);
+}
+
+uint64_t
+MockSessionDirectory::add_remote_member(
+    _In_ const string_t& xboxUserId
+    )
+{
+    uint64_t changeNumber = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_lock.get());
+        if (find_member(xboxUserId, nullptr) != nullptr)
+        {
+            return 0;
+        }
+
+        uint32_t memberId = m_nextMemberId++;
+        web::json::value member;
+        member[_T("constants")][_T("system")][_T("xuid")] = web::json::value::string(xboxUserId);
+        member[_T("constants")][_T("system")][_T("index")] = web::json::value::number(memberId);
+        member[_T("constants")][_T("custom")] = web::json::value::object();
+        member[_T("properties")][_T("system")][_T("active")] = web::json::value::boolean(true);
+        member[_T("properties")][_T("custom")] = web::json::value::object();
+        member[_T("gamertag")] = web::json::value::string(xboxUserId);
+        member[_T("deviceToken")] = web::json::value::string(xboxUserId);
+
+        stringstream_t memberKey;
+        memberKey << memberId;
+        m_session[_T("members")][memberKey.str()] = member;
+        changeNumber = commit_change();
+    }
+
+    notify(changeNumber);
+    return changeNumber;
+}
+
+uint64_t
+MockSessionDirectory::remove_remote_member(
+    _In_ const string_t& xboxUserId
+    )
+{
+    uint64_t changeNumber = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_lock.get());
+        string_t memberId;
+        if (find_member(xboxUserId, &memberId) == nullptr)
+        {
+            return 0;
+        }
+
+        m_session[_T("members")].erase(memberId);
+        changeNumber = commit_change();
+    }
+
+    notify(changeNumber);
+    return changeNumber;
+}
+
+uint64_t
+MockSessionDirectory::set_remote_member_property(
+    _In_ const string_t& xboxUserId,
+    _In_ const string_t& name,
+    _In_ const web::json::value& value
+    )
+{
+    uint64_t changeNumber = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_lock.get());
+        auto member = find_member(xboxUserId, nullptr);
+        if (member == nullptr)
+        {
+            return 0;
+        }
+
+        (*member)[_T("properties")][_T("custom")][name] = value;
+        changeNumber = commit_change();
+    }
+
+    notify(changeNumber);
+    return changeNumber;
+}
+
+uint64_t
+MockSessionDirectory::change_number() const
+{
+    std::lock_guard<std::mutex> lock(m_lock.get());
+    return m_changeNumber;
+}
+
+uint32_t
+MockSessionDirectory::member_count() const
+{
+    std::lock_guard<std::mutex> lock(m_lock.get());
+    if (!m_session.has_field(_T("members")))
+    {
+        return 0;
+    }
+    return static_cast<uint32_t>(m_session.at(_T("members")).size());
+}
+
+web::json::value
+MockSessionDirectory::session() const
+{
+    std::lock_guard<std::mutex> lock(m_lock.get());
+    return m_session;
+}
+
+uint32_t
+MockSessionDirectory::writes() const
+{
+    std::lock_guard<std::mutex> lock(m_lock.get());
+    return m_writes;
+}
+
+uint32_t
+MockSessionDirectory::conflicts() const
+{
+    std::lock_guard<std::mutex> lock(m_lock.get());
+    return m_conflicts;
+}
+
+uint32_t
+MockSessionDirectory::reads() const
+{
+    std::lock_guard<std::mutex> lock(m_lock.get());
+    return m_reads;
+}
+
+uint32_t
+MockSessionDirectory::not_modified_reads() const
+{
+    std::lock_guard<std::mutex> lock(m_lock.get());
+    return m_notModifiedReads;
+}
+
+void
+MockSessionDirectory::handle_write(
+    _Inout_ std::shared_ptr<http_call_response>& response,
+    _In_ const string_t& requestPost,
+    _In_ const http_headers& requestHeaders
+    )
+{
+    std::this_thread::sleep_for(m_latency);
+
+    web::json::value request = requestPost.empty() ? web::json::value::object() : web::json::value::parse(requestPost);
+    uint64_t changeNumber = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_lock.get());
+        auto eTag = utils::internal_string_from_string_t(m_eTag);
+        auto ifMatch = requestHeaders.find("If-Match");
+        auto ifNoneMatch = requestHeaders.find("If-None-Match");
+
+        // The session always exists, so create-only writes conflict as well as stale ETags
+        bool conflict =
+            (ifMatch != requestHeaders.end() && ifMatch->second != "*" && ifMatch->second != eTag) ||
+            (ifNoneMatch != requestHeaders.end() && ifNoneMatch->second == "*");
+        if (conflict)
+        {
+            ++m_conflicts;
+            response = create_response(412, m_session);
+            return;
+        }
+
+        for (const auto& field : request.as_object())
+        {
+            if (field.first == _T("members"))
+            {
+                apply_member_request(field.second);
+            }
+            else if (field.second.is_null())
+            {
+                if (m_session.has_field(field.first))
+                {
+                    m_session.erase(field.first);
+                }
+            }
+            else
+            {
+                merge(m_session[field.first], field.second);
+            }
+        }
+
+        ++m_writes;
+        changeNumber = commit_change();
+        response = create_response(200, m_session);
+    }
+
+    notify(changeNumber);
+}
+
+void
+MockSessionDirectory::handle_read(
+    _Inout_ std::shared_ptr<http_call_response>& response,
+    _In_ const http_headers& requestHeaders
+    )
+{
+    std::this_thread::sleep_for(m_latency);
+
+    std::lock_guard<std::mutex> lock(m_lock.get());
+    ++m_reads;
+
+    auto ifNoneMatch = requestHeaders.find("If-None-Match");
+    if (ifNoneMatch != requestHeaders.end() && ifNoneMatch->second == utils::internal_string_from_string_t(m_eTag))
+    {
+        ++m_notModifiedReads;
+        response = create_response(304, web::json::value());
+        return;
+    }
+
+    response = create_response(200, m_session);
+}
+
+void
+MockSessionDirectory::apply_member_request(
+    _In_ const web::json::value& memberRequest
+    )
+{
+    if (!memberRequest.is_object())
+    {
+        return;
+    }
+
+    for (const auto& field : memberRequest.as_object())
+    {
+        // Only the local member is written through "me"; reservations are not simulated
+        if (field.first != _T("me"))
+        {
+            continue;
+        }
+
+        string_t memberId;
+        auto member = find_member(m_localXboxUserId, &memberId);
+        if (field.second.is_null())
+        {
+            if (member != nullptr)
+            {
+                m_session[_T("members")].erase(memberId);
+            }
+            continue;
+        }
+
+        if (member == nullptr)
+        {
+            uint32_t newMemberId = m_nextMemberId++;
+            stringstream_t memberKey;
+            memberKey << newMemberId;
+            member = &m_session[_T("members")][memberKey.str()];
+            (*member)[_T("constants")][_T("system")][_T("xuid")] = web::json::value::string(m_localXboxUserId);
+            (*member)[_T("constants")][_T("system")][_T("index")] = web::json::value::number(newMemberId);
+        }
+
+        merge(*member, field.second);
+    }
+}
+
+web::json::value*
+MockSessionDirectory::find_member(
+    _In_ const string_t& xboxUserId,
+    _Out_opt_ string_t* memberId
+    )
+{
+    if (!m_session.has_field(_T("members")))
+    {
+        return nullptr;
+    }
+
+    for (auto& member : m_session[_T("members")].as_object())
+    {
+        auto& memberJson = member.second;
+        if (memberJson.has_field(_T("constants")) &&
+            memberJson.at(_T("constants")).has_field(_T("system")) &&
+            memberJson.at(_T("constants")).at(_T("system")).has_field(_T("xuid")) &&
+            memberJson.at(_T("constants")).at(_T("system")).at(_T("xuid")).as_string() == xboxUserId)
+        {
+            if (memberId != nullptr)
+            {
+                *memberId = member.first;
+            }
+            return &memberJson;
+        }
+    }
+
+    return nullptr;
+}
+
+uint64_t
+MockSessionDirectory::commit_change()
+{
+    ++m_changeNumber;
+    m_session[_T("changeNumber")] = web::json::value::number(m_changeNumber);
+
+    uint32_t firstMemberId = m_nextMemberId;
+    uint32_t memberCount = 0;
+    if (m_session.has_field(_T("members")))
+    {
+        for (const auto& member : m_session.at(_T("members")).as_object())
+        {
+            firstMemberId = std::min<uint32_t>(firstMemberId, static_cast<uint32_t>(std::stoul(member.first)));
+            ++memberCount;
+        }
+    }
+    m_session[_T("membersInfo")][_T("first")] = web::json::value::number(firstMemberId);
+    m_session[_T("membersInfo")][_T("next")] = web::json::value::number(m_nextMemberId);
+    m_session[_T("membersInfo")][_T("count")] = web::json::value::number(memberCount);
+
+    stringstream_t eTag;
+    eTag << _T("\"") << m_changeNumber << _T("\"");
+    m_eTag = eTag.str();
+    return m_changeNumber;
+}
+
+std::shared_ptr<http_call_response>
+MockSessionDirectory::create_response(
+    _In_ int statusCode,
+    _In_ const web::json::value& body
+    ) const
+{
+    web::http::http_response httpResponse;
+    httpResponse.headers().add(_T("ETag"), m_eTag);
+    httpResponse.headers().add(_T("Retry-After"), _T("1"));
+    httpResponse.headers().add(_T("Content-Location"), m_contentLocation);
+    return StockMocks::CreateMockHttpCallResponse(body, statusCode, httpResponse);
+}
+
+void
+MockSessionDirectory::notify(
+    _In_ uint64_t changeNumber
+    )
+{
+    std::function<void(uint64_t)> handler;
+    {
+        std::lock_guard<std::mutex> lock(m_lock.get());
+        handler = m_sessionChangedHandler;
+    }
+
+    if (handler)
+    {
+        handler(changeNumber);
+    }
+}
+
+void
+MockSessionDirectory::merge(
+    _Inout_ web::json::value& target,
+    _In_ const web::json::value& patch
+    )
+{
+    if (!patch.is_object() || !target.is_object())
+    {
+        target = patch;
+        return;
+    }
+
+    for (const auto& field : patch.as_object())
+    {
+        if (field.second.is_null())
+        {
+            if (target.has_field(field.first))
+            {
+                target.erase(field.first);
+            }
+        }
+        else
+        {
+            merge(target[field.first], field.second);
+        }
+    }
+}
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_SYSTEM_CPP_END
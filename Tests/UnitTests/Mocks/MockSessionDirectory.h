@@ -0,0 +1,87 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#pragma once
+#include "pch.h"
+#include "MockXboxSystemFactory.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_SYSTEM_CPP_BEGIN
+
+// In process stand-in for the session directory that serves a single session.
+// Writes are merged into the session the way MPSD does (objects merge, null deletes) and every
+// accepted write bumps the change number, which is also used as the ETag. If-Match and If-None-Match
+// are honoured with 412 and 304 responses. Remote members can join, leave and write properties directly.
+class MockSessionDirectory : public std::enable_shared_from_this<MockSessionDirectory>
+{
+public:
+    MockSessionDirectory(
+        _In_ web::json::value session,
+        _In_ string_t contentLocation,
+        _In_ string_t localXboxUserId,
+        _In_ std::chrono::milliseconds latency
+        );
+
+    // Routes session reads and writes made through the factory to this stand-in
+    void install(_In_ const std::shared_ptr<MockXboxSystemFactory>& mockFactory);
+
+    // Called outside the lock with the new change number after every change
+    void set_session_changed_handler(_In_ std::function<void(uint64_t)> handler);
+
+    // These return the new change number, or 0 if nothing changed
+    uint64_t add_remote_member(_In_ const string_t& xboxUserId);
+    uint64_t remove_remote_member(_In_ const string_t& xboxUserId);
+    uint64_t set_remote_member_property(
+        _In_ const string_t& xboxUserId,
+        _In_ const string_t& name,
+        _In_ const web::json::value& value
+        );
+
+    uint64_t change_number() const;
+    uint32_t member_count() const;
+    web::json::value session() const;
+
+    uint32_t writes() const;
+    uint32_t conflicts() const;
+    uint32_t reads() const;
+    uint32_t not_modified_reads() const;
+
+private:
+    void handle_write(
+        _Inout_ std::shared_ptr<http_call_response>& response,
+        _In_ const string_t& requestPost,
+        _In_ const http_headers& requestHeaders
+        );
+
+    void handle_read(
+        _Inout_ std::shared_ptr<http_call_response>& response,
+        _In_ const http_headers& requestHeaders
+        );
+
+    // The following require m_lock
+    void apply_member_request(_In_ const web::json::value& memberRequest);
+    web::json::value* find_member(_In_ const string_t& xboxUserId, _Out_opt_ string_t* memberId);
+    uint64_t commit_change();
+    std::shared_ptr<http_call_response> create_response(_In_ int statusCode, _In_ const web::json::value& body) const;
+
+    void notify(_In_ uint64_t changeNumber);
+
+    static void merge(_Inout_ web::json::value& target, _In_ const web::json::value& patch);
+
+    web::json::value m_session;
+    string_t m_contentLocation;
+    string_t m_localXboxUserId;
+    string_t m_eTag;
+    uint64_t m_changeNumber;
+    uint32_t m_nextMemberId;
+    std::chrono::milliseconds m_latency;
+    std::function<void(uint64_t)> m_sessionChangedHandler;
+
+    uint32_t m_writes;
+    uint32_t m_conflicts;
+    uint32_t m_reads;
+    uint32_t m_notModifiedReads;
+
+    mutable xbox_live_mutex m_lock;
+};
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_SYSTEM_CPP_END
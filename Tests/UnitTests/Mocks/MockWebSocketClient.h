@@ -57,6 +57,49 @@ public:
         });
     }
 
+    web_socket_capabilities capabilities() const override
+    {
+        return m_capabilities;
+    }
+
+    void send_binary(
+        _In_ const xsapi_internal_vector<uint8_t>& payload,
+        _In_ xbox::services::xbox_live_callback<WebSocketCompletionResult> callback
+        ) override
+    {
+        if (!m_capabilities.binaryFrames)
+        {
+            callback(WebSocketCompletionResult{ nullptr, E_NOTIMPL, 0 });
+            return;
+        }
+        if (m_binarySendHandler != nullptr)
+        {
+            m_binarySendHandler(payload);
+        }
+        callback(WebSocketCompletionResult{
+            nullptr,
+            S_OK,
+            0
+        });
+    }
+
+    void set_requested_extensions(
+        _In_ const xsapi_internal_string& extensions
+        ) override
+    {
+        m_requestedExtensions = extensions;
+    }
+
+    xsapi_internal_string negotiated_extensions() const override
+    {
+        // Like a real endpoint, only accept permessage-deflate if the client offered it
+        if (m_endpointOffersDeflate && m_requestedExtensions.find(WEB_SOCKET_PERMESSAGE_DEFLATE) != xsapi_internal_string::npos)
+        {
+            return "permessage-deflate; client_max_window_bits=15";
+        }
+        return xsapi_internal_string();
+    }
+
     void close() override 
     {
         std::lock_guard<std::mutex> lock(m_lock);
@@ -73,6 +116,13 @@ public:
         m_receiveHandler = handler;
     }
 
+    void set_binary_received_handler(
+        _In_ xbox_live_callback<xsapi_internal_vector<uint8_t>> handler
+        ) override
+    {
+        m_binaryReceiveHandler = handler;
+    }
+
     void set_closed_handler(
         _In_ xbox_live_callback<HCWebSocketCloseStatus> handler
         ) override
@@ -110,6 +160,16 @@ public:
         }
     }
 
+    void receive_binary_message(
+        _In_ xsapi_internal_vector<uint8_t> payload
+        )
+    {
+        if (m_binaryReceiveHandler != nullptr)
+        {
+            m_binaryReceiveHandler(std::move(payload));
+        }
+    }
+
     void receive_rta_event_from_uri(const string_t& uri, const string_t& eventData, xbox::services::real_time_activity::real_time_activity_message_type dataType, bool isError)
     {
         receive_rta_event_from_uri(
@@ -208,6 +268,11 @@ public:
         m_closeHandler = nullptr;
         m_sendHandler = nullptr;
         m_receiveHandler = nullptr;
+        m_binarySendHandler = nullptr;
+        m_binaryReceiveHandler = nullptr;
+        m_capabilities = web_socket_capabilities{ false, false };
+        m_endpointOffersDeflate = false;
+        m_requestedExtensions.clear();
         m_connectEvent.reset();
         m_sequenceNum = 0;
     }
@@ -217,12 +282,19 @@ public:
     HCWebSocketCloseStatus m_closeStatus = HCWebSocketCloseStatus_Normal;
     concurrency::event m_connectEvent;
 
+    // Stands in for a local websocket server: which frame types and extensions the transport and endpoint support
+    web_socket_capabilities m_capabilities = web_socket_capabilities{ false, false };
+    bool m_endpointOffersDeflate = false;
+    xsapi_internal_string m_requestedExtensions;
+
     std::unordered_map<xsapi_internal_string, uint32_t> m_subUriToIdMap;
     std::unordered_map<xsapi_internal_string, uint32_t> m_eventUriToIdMap;
     uint32_t m_sequenceNum = 0;
     xbox_live_callback<HCWebSocketCloseStatus> m_closeHandler;
     xbox_live_callback<xsapi_internal_string> m_sendHandler;
     xbox_live_callback<xsapi_internal_string> m_receiveHandler;
+    xbox_live_callback<xsapi_internal_vector<uint8_t>> m_binarySendHandler;
+    xbox_live_callback<xsapi_internal_vector<uint8_t>> m_binaryReceiveHandler;
     std::mutex m_lock;
 };
 
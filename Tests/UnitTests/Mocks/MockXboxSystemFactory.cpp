@@ -98,6 +98,7 @@ std::shared_ptr<http_call> MockXboxSystemFactory::create_http_call(
             m_mockHttpCall->ServerName = serverName;
             m_mockHttpCall->ResultValue = std::make_shared<http_call_response>(*httpStateResponses->responseList[httpStateResponses->counter]);
             m_mockHttpCall->fRequestPostFunc = httpStateResponses->fRequestPostFunc;
+            m_mockHttpCall->fRequestHandlerFunc = httpStateResponses->fRequestHandlerFunc;
 
             if (httpStateResponses->counter + 1 < httpStateResponses->responseList.size())
             {
@@ -109,6 +110,7 @@ std::shared_ptr<http_call> MockXboxSystemFactory::create_http_call(
     }
 
     m_mockHttpCall->fRequestPostFunc = nullptr;
+    m_mockHttpCall->fRequestHandlerFunc = nullptr;
     m_mockHttpCall->HttpMethod = httpMethod;
     m_mockHttpCall->ServerName = serverName;
     m_mockHttpCall->PathQueryFragment = pathQueryFragment;
@@ -161,9 +163,28 @@ std::shared_ptr<http_call_internal> MockXboxSystemFactory::create_http_call(
 
             return m_mockHttpCall;
         }
+
+        // Calls made through the internal overload but completed through the task based
+        // get_response_with_auth, such as session writes, use the public response list
+        if (httpStateResponses != nullptr && httpStateResponses->responseList.size() > 0)
+        {
+            m_mockHttpCall->ServerName = utils::string_t_from_internal_string(serverName);
+            m_mockHttpCall->ResultValue = std::make_shared<http_call_response>(*httpStateResponses->responseList[httpStateResponses->counter]);
+            m_mockHttpCall->fRequestPostFunc = httpStateResponses->fRequestPostFunc;
+            m_mockHttpCall->fRequestHandlerFunc = httpStateResponses->fRequestHandlerFunc;
+
+            if (httpStateResponses->counter + 1 < httpStateResponses->responseList.size())
+            {
+                ++httpStateResponses->counter;
+            }
+
+            return m_mockHttpCall;
+        }
     }
 
+    m_mockHttpCall->fRequestPostFunc = nullptr;
     m_mockHttpCall->fRequestPostFuncInternal = nullptr;
+    m_mockHttpCall->fRequestHandlerFunc = nullptr;
     m_mockHttpCall->HttpMethod = utils::string_t_from_internal_string(httpMethod);
     m_mockHttpCall->ServerName = utils::string_t_from_internal_string(serverName);
     m_mockHttpCall->PathQueryFragment = pathQueryFragment;
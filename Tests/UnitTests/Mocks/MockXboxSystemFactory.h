@@ -23,6 +23,9 @@ struct HttpResponseStruct
 
     std::function<void(std::shared_ptr<http_call_response>&, const string_t& requestPost)> fRequestPostFunc;
     xbox_live_callback<std::shared_ptr<http_call_response_internal>, const xsapi_internal_string&> fRequestPostFuncInternal;
+
+    // Used instead of fRequestPostFunc when set, for handlers that also need the request's custom headers
+    std::function<void(std::shared_ptr<http_call_response>&, const string_t& requestPost, const http_headers& requestHeaders)> fRequestHandlerFunc;
 };
 
 struct WebsocketMockResponse
@@ -10,6 +10,9 @@
 #include "multiplayer_manager_internal.h"
 #include "FindMatchCompletedEventArgs_WinRT.h"
 #include "JoinLobbyCompletedEventArgs_WinRT.h"
+#include "MockSessionDirectory.h"
+#include <random>
+#include <numeric>
 
 using namespace Microsoft::Xbox::Services;
 using namespace Microsoft::Xbox::Services::Multiplayer;
@@ -803,6 +806,55 @@ public:
         DestructManager(xboxLiveContext);
     }
 
+    DEFINE_TEST_CASE(TestCoalescedLobbyWrites)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestCoalescedLobbyWrites);
+        InitializeManager();
+        auto xboxLiveContext = GetMockXboxLiveContext_WinRT();
+        AddLocalUserHelper(xboxLiveContext);
+
+        int writeCount = 0;
+        std::shared_ptr<HttpResponseStruct> writeResponseStruct = std::make_shared<HttpResponseStruct>();
+        writeResponseStruct->responseList = { sessionChangeNum4Response };
+        writeResponseStruct->fRequestPostFunc = [&writeCount](std::shared_ptr<http_call_response>&, const string_t&)
+        {
+            ++writeCount;
+        };
+
+        std::unordered_map<xbox_live_api, std::shared_ptr<HttpResponseStruct>> responses;
+        responses[xbox_live_api::write_session_using_subpath] = writeResponseStruct;
+        m_mockXboxSystemFactory->add_http_api_state_response(responses);
+
+        // Four changes queued in the same frame need one update and one synchronized write
+        auto mpInstance = MultiplayerManager::SingletonInstance;
+        mpInstance->LobbySession->SetProperties(L"Map", L"1", (Platform::Object^) 1);
+        mpInstance->LobbySession->SetProperties(L"GameMode", L"2", (Platform::Object^) 2);
+        mpInstance->LobbySession->SetSynchronizedProperties(L"Map", L"3", (Platform::Object^) 3);
+        mpInstance->LobbySession->SetSynchronizedProperties(L"GameMode", L"4", (Platform::Object^) 4);
+
+        // Fails rather than hangs if a completion never arrives
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        int expectedContext = 1;
+        while (expectedContext <= 4)
+        {
+            VERIFY_IS_TRUE(std::chrono::steady_clock::now() < deadline);
+            auto events = mpInstance->DoWork();
+            for (auto ev : events)
+            {
+                if (ev->EventType == MultiplayerEventType::SessionPropertyWriteCompleted ||
+                    ev->EventType == MultiplayerEventType::SessionSynchronizedPropertyWriteCompleted)
+                {
+                    // Completion events keep the order the changes were made in
+                    VERIFY_ARE_EQUAL_INT(expectedContext, safe_cast<int>(ev->Context));
+                    ++expectedContext;
+                }
+            }
+        }
+
+        VERIFY_ARE_EQUAL_INT(2, writeCount);
+        DestructManager(xboxLiveContext);
+    }
+
     DEFINE_TEST_CASE(TestLeaveGame)
     {
         DEFINE_TEST_CASE_PROPERTIES(TestLeaveGame);
@@ -2183,9 +2235,8 @@ public:
 
     /*
         multiplayer_session_writer: Multiple Taps:
-        (fix existing code such that you do only 1 GET for multiple changed events)
         1. call multiple on_session_changed with same change #s (#3, #2, #1, etc); ensure we only do 1 GET
-        2. call multiple on_session_changed with updated change #s (#1, #2, #3, etc); ensure we do multiple GETs
+        2. call multiple on_session_changed with updated change #s (#1, #2, #3, etc); ensure taps during the first GET collapse into 1 more GET
     */
 
     void LogSessionWriterState(const std::shared_ptr<multiplayer_session_writer>& sessionWriter, uint64_t sessionChangeNum, multiplayer_session_change_event_args eventArgs)
@@ -2197,12 +2248,18 @@ public:
             << " Args change #: " << eventArgs.change_number();
     }
 
-    void MultipleTapsHelper(std::shared_ptr<HttpResponseStruct> getResponseStruct, std::vector<uint64_t> tapChangeNumberList, uint64_t maxTapChangeNumber)
+    void MultipleTapsHelper(std::shared_ptr<HttpResponseStruct> getResponseStruct, std::vector<uint64_t> tapChangeNumberList, uint64_t maxTapChangeNumber, int expectedGetCount)
     {
         InitializeManager();
         auto xboxLiveContext = GetMockXboxLiveContext_WinRT();
         AddLocalUserHelper(xboxLiveContext);
 
+        int getCount = 0;
+        getResponseStruct->fRequestPostFunc = [&getCount](std::shared_ptr<http_call_response>&, const string_t&)
+        {
+            ++getCount;
+        };
+
         std::unordered_map<xbox_live_api, std::shared_ptr<HttpResponseStruct>> responses;
         responses[xbox_live_api::get_current_session] = getResponseStruct;
         m_mockXboxSystemFactory->add_http_api_state_response(responses);
@@ -2229,6 +2286,7 @@ public:
         }
 
         VERIFY_IS_TRUE(mpInstance->LobbySession->GetCppObj()->_Change_number() == maxTapChangeNumber);
+        VERIFY_ARE_EQUAL_INT(expectedGetCount, getCount);
         VerifyLobby(mpInstance->LobbySession, lobbyCompletedHandleResponseJson);
         DestructManager(xboxLiveContext);
     }
@@ -2249,12 +2307,12 @@ public:
         };
 
         std::vector<uint64_t> tapChangeNUmberList = {3, 2, 1};
-        MultipleTapsHelper(getResponseStruct, tapChangeNUmberList, 3);
+        MultipleTapsHelper(getResponseStruct, tapChangeNUmberList, 3, 1);
     }
 
     DEFINE_TEST_CASE(TestMultipleTaps_2)
     {
-        DEFINE_TEST_CASE_PROPERTIES_FAILING(TestMultipleTaps_2);
+        DEFINE_TEST_CASE_PROPERTIES(TestMultipleTaps_2);
 
         std::shared_ptr<HttpResponseStruct> getResponseStruct = std::make_shared<HttpResponseStruct>();
         getResponseStruct->responseList =
@@ -2264,14 +2322,14 @@ public:
         };
 
         std::vector<uint64_t> tapChangeNUmberList = {1, 2, 3};
-        MultipleTapsHelper(getResponseStruct, tapChangeNUmberList, 3);
+        MultipleTapsHelper(getResponseStruct, tapChangeNUmberList, 3, 2);
     }
 
     /*
         multiplayer_session_writer:
         Write Session + Taps (write_session & on_session_changed)
         1. call multiple different writes with shoulder taps in between; ensure that the fianl session # is correct.
-        Note: MPM currently does not optimize to ensure that only 1 GET is in flight for multiple shoulder taps.
+        Note: taps that arrive during a write are resolved when the write completes rather than by a separate GET.
         2. call write (ch. #6) followed with multiple different writes with shoulder taps; ensure that GET is never called.
         3. call write (ch. #2, #4) followed with shoulder tap (ch. #6); ensure that GET is called.
     */
@@ -2687,16 +2745,15 @@ public:
         else
             VERIFY_IS_TRUE(mpInstance->GameSession->GetCppObj()->_Change_number() == 1);
 
-        // Test deep_copy_if_updated
-        clientManager->last_pending_read()->deep_copy_if_updated(*clientManager->latest_pending_read());
+        // The published snapshot only moves forward in DoWork()
         if (isLobbyTest)
         {
-            VERIFY_IS_TRUE(clientManager->last_pending_read()->lobby_client()->lobby()->_Change_number() == 1);     // no DoWork() so the actual lobby obj is still stale
+            VERIFY_IS_TRUE(clientManager->last_snapshot()->lobby->_Change_number() == 1);     // no DoWork() so the actual lobby obj is still stale
             VERIFY_IS_TRUE(sessionWriter->session()->change_number() == 2);
         }
         else
         {
-            VERIFY_IS_TRUE(clientManager->last_pending_read()->game_client()->game()->_Change_number() == 1);     // no DoWork() so the actual lobby obj is still stale
+            VERIFY_IS_TRUE(clientManager->last_snapshot()->game->_Change_number() == 1);     // no DoWork() so the actual lobby obj is still stale
             VERIFY_IS_TRUE(sessionWriter->session()->change_number() == 2);
         }
 
@@ -2713,12 +2770,12 @@ public:
         mpInstance->DoWork();
         if (isLobbyTest)
         {
-            VERIFY_IS_TRUE(clientManager->last_pending_read()->lobby_client()->lobby()->_Change_number() == 4);     // called DoWork(), should update
+            VERIFY_IS_TRUE(clientManager->last_snapshot()->lobby->_Change_number() == 4);     // called DoWork(), should update
             VERIFY_IS_TRUE(mpInstance->LobbySession->GetCppObj()->_Change_number() == 4);
         }
         else
         {
-            VERIFY_IS_TRUE(clientManager->last_pending_read()->game_client()->game()->_Change_number() == 4);       // called DoWork(), should update
+            VERIFY_IS_TRUE(clientManager->last_snapshot()->game->_Change_number() == 4);       // called DoWork(), should update
             VERIFY_IS_TRUE(mpInstance->GameSession->GetCppObj()->_Change_number() == 4);
         }
     }
@@ -2840,31 +2897,30 @@ public:
         mpInstance->DoWork();
         if (isLobbyTest)
         {
-            VERIFY_IS_TRUE(clientManager->last_pending_read()->lobby_client()->lobby()->_Change_number() == 4);
+            VERIFY_IS_TRUE(clientManager->last_snapshot()->lobby->_Change_number() == 4);
             VERIFY_IS_TRUE(mpInstance->LobbySession->GetCppObj()->_Change_number() == 4);
         }
         else
         {
-            VERIFY_IS_TRUE(clientManager->last_pending_read()->game_client()->game()->_Change_number() == 4);
+            VERIFY_IS_TRUE(clientManager->last_snapshot()->game->_Change_number() == 4);
             VERIFY_IS_TRUE(mpInstance->GameSession->GetCppObj()->_Change_number() == 4);
         }
 
         sessionWriter->write_session(primaryContext, mpsdSession, multiplayer::multiplayer_session_write_mode::update_existing).get();
         VERIFY_IS_TRUE(clientManager->is_update_avaialable());
-        clientManager->last_pending_read()->deep_copy_if_updated(*clientManager->latest_pending_read());
         if (isLobbyTest)
         {
-            VERIFY_IS_TRUE(clientManager->last_pending_read()->lobby_client()->lobby()->_Change_number() == 4);     // no DoWork() so the actual lobby obj is still stale
+            VERIFY_IS_TRUE(clientManager->last_snapshot()->lobby->_Change_number() == 4);     // no DoWork() so the actual lobby obj is still stale
             VERIFY_IS_TRUE(sessionWriter->session()->change_number() == 6);
         }
         else
         {
-            VERIFY_IS_TRUE(clientManager->last_pending_read()->game_client()->game()->_Change_number() == 4);     // no DoWork() so the actual lobby obj is still stale
+            VERIFY_IS_TRUE(clientManager->last_snapshot()->game->_Change_number() == 4);     // no DoWork() so the actual lobby obj is still stale
             VERIFY_IS_TRUE(sessionWriter->session()->change_number() == 6);
         }
         VERIFY_IS_TRUE(clientManager->is_update_avaialable());
 
-        // Even though I manually deep copied the objects, this will update the MPM session objects as is_update_avaialable() will return true.
+        // DoWork() publishes the newer session, as is_update_avaialable() returns true.
         mpInstance->DoWork();
         if (isLobbyTest)
             VERIFY_IS_TRUE(mpInstance->LobbySession->GetCppObj()->_Change_number() == 6);
@@ -3828,7 +3884,7 @@ public:
         DestructManager(xboxLiveContext);
     }
 
-    void FindMatchWithQoSHelper(MatchCallingPatternType callingPattern)
+    void FindMatchWithQoSHelper(MatchCallingPatternType callingPattern, bool automaticQos = false)
     {
         InitializeManager();
         auto xboxLiveContext = GetMockXboxLiveContext_WinRT();
@@ -3851,6 +3907,16 @@ public:
             gameResponseStruct->responseList = { matchJoin_1_Response, matchMeasuringResponse, matchMeasuringWithQoSResponse, matchMeasuringWithQoSCompleteResponse };
         }
 
+        bool measurementsUploaded = false;
+        gameResponseStruct->fRequestPostFunc = [&measurementsUploaded](std::shared_ptr<http_call_response>&, const string_t& requestPost)
+        {
+            if (requestPost.find(L"\"measurements\"") != string_t::npos &&
+                requestPost.find(L"e7c221cbe5228043c39865281047b178") != string_t::npos)
+            {
+                measurementsUploaded = true;
+            }
+        };
+
         std::shared_ptr<HttpResponseStruct> lobbyResponseStruct = std::make_shared<HttpResponseStruct>();
         lobbyResponseStruct->responseList = { matchStatusSearchingResponse, matchStatusFoundResponse, matchStatusFoundWithTransHandleResponse };
 
@@ -3872,6 +3938,18 @@ public:
         auto mpsdLobbySession = clientManager->latest_pending_read()->lobby_client()->session();
         auto lobbySessionWriter = clientManager->latest_pending_read()->lobby_client()->session_writer();
 
+        // Every remote address is probed at a loopback responder
+        multiplayer_qos_responder responder;
+        if (automaticQos)
+        {
+            VERIFY_IS_TRUE(!responder.start(L"127.0.0.1", 0));
+            string_t endpoint = L"127.0.0.1:" + utils::uint32_to_string_t(responder.port());
+            mpInstance->GetCppObj()->set_automatic_qos_measurements(true, 2, std::chrono::milliseconds(500), [endpoint](const string_t&)
+            {
+                return endpoint;
+            });
+        }
+
         auto timeSpan = Windows::Foundation::TimeSpan();
         timeSpan.Duration = 1 * TICKS_PER_SECOND;
         mpInstance->FindMatch(HOPPER_NAME_NO_QOS, ref new Platform::String(), timeSpan);
@@ -3882,7 +3960,7 @@ public:
         // GS: PUT to join
         // GS: Shoulder tap with a GET with both players joined
         // GS: Trigger set qos
-        // title: set qos metrics
+        // title (or the manager when measuring automatically): set qos metrics
         // match completed
         // Create Transfer handle
         // LB: PUT Transfer handle
@@ -3942,6 +4020,7 @@ public:
             {
                 if (ev->EventType == MultiplayerEventType::PerformQosMeasurements)
                 {
+                    VERIFY_IS_TRUE(!automaticQos);
                     auto measurments = ref new Vector<MultiplayerQualityOfServiceMeasurements^>();
                     mpInstance->SetQualityOfServiceMeasurements(measurments->GetView());
                 }
@@ -3979,6 +4058,11 @@ public:
             }
         }
 
+        if (automaticQos)
+        {
+            VERIFY_IS_TRUE(measurementsUploaded);
+        }
+
         DestructManager(xboxLiveContext);
     }
 
@@ -4006,6 +4090,86 @@ public:
         FindMatchNoQoSHelper(MatchCallingPatternType::ExpiredByService);
     }
 
+    DEFINE_TEST_CASE(TestFindMatchAcrossHoppers)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestFindMatchAcrossHoppers);
+        InitializeManager();
+        auto xboxLiveContext = GetMockXboxLiveContext_WinRT();
+        AddLocalUserHelper(xboxLiveContext, lobbyWithNoTransferHandleResponse);
+
+        std::unordered_map<string_t, std::shared_ptr<HttpResponseStruct>> responses;
+        auto addHopper = [&responses](const string_t& hopperName, const string_t& statistics)
+        {
+            auto statisticsStruct = std::make_shared<HttpResponseStruct>();
+            statisticsStruct->responseList = { StockMocks::CreateMockHttpCallResponse(web::json::value::parse(statistics)) };
+            responses[L"/serviceconfigs/MockScid/hoppers/" + hopperName + L"/stats"] = statisticsStruct;
+        };
+        addHopper(L"SlowHopper", L"{\"name\":\"SlowHopper\",\"waitTime\":120,\"population\":4}");
+        addHopper(L"FastHopper", L"{\"name\":\"FastHopper\",\"waitTime\":6,\"population\":12}");
+        addHopper(L"EmptyHopper", L"{\"name\":\"EmptyHopper\",\"waitTime\":0,\"population\":0}");
+
+        // Records the order tickets are submitted in, and how long each one is given
+        std::vector<string_t> submittedHoppers;
+        std::vector<int32_t> ticketTimeouts;
+        for (const string_t& hopperName : { string_t(L"SlowHopper"), string_t(L"FastHopper"), string_t(L"EmptyHopper") })
+        {
+            auto ticketStruct = std::make_shared<HttpResponseStruct>();
+            ticketStruct->responseList = { matchTicketResponse };
+            ticketStruct->fRequestPostFunc = [hopperName, &submittedHoppers, &ticketTimeouts](std::shared_ptr<http_call_response>&, const string_t& requestPost)
+            {
+                submittedHoppers.push_back(hopperName);
+                ticketTimeouts.push_back(web::json::value::parse(requestPost)[L"giveUpDuration"].as_integer());
+            };
+            responses[L"/serviceconfigs/MockScid/hoppers/" + hopperName] = ticketStruct;
+        }
+
+        std::shared_ptr<HttpResponseStruct> lobbyResponseStruct = std::make_shared<HttpResponseStruct>();
+        lobbyResponseStruct->responseList = { matchStatusSearchingResponse, matchStatusExpiredByServiceResponse };
+        responses[defaultMpsdUri] = lobbyResponseStruct;
+        m_mockXboxSystemFactory->add_http_state_response(responses);
+
+        auto mpInstance = MultiplayerManager::SingletonInstance;
+        auto clientManager = mpInstance->GetCppObj()->_Get_multiplayer_client_manager();
+        auto mpsdLobbySession = clientManager->latest_pending_read()->lobby_client()->session();
+        auto lobbySessionWriter = clientManager->latest_pending_read()->lobby_client()->session_writer();
+
+        std::vector<string_t> hopperNames = { L"SlowHopper", L"FastHopper", L"EmptyHopper" };
+        VERIFY_IS_TRUE(!mpInstance->GetCppObj()->find_match(hopperNames, web::json::value(), std::chrono::seconds(60)).err());
+        clientManager->match_client()->disable_next_timer(true);
+
+        // The fastest hopper is tried first, for twice its estimated wait
+        while (mpInstance->MatchStatus != MatchStatus::Searching)
+        {
+            mpInstance->DoWork();
+        }
+        VERIFY_ARE_EQUAL_UINT(1, submittedHoppers.size());
+        VERIFY_ARE_EQUAL_STR(L"FastHopper", submittedHoppers[0]);
+        VERIFY_ARE_EQUAL_INT(12, ticketTimeouts[0]);
+
+        // LB: Shoulder tap with a Get: status to searching
+        // LB: Shoulder tap with a Get: status to expired, which falls back to the next hopper
+        lobbySessionWriter->on_session_changed(multiplayer_session_change_event_args(mpsdLobbySession->session_reference(), L"", 4));
+        while (mpInstance->LobbySession->GetCppObj()->_Change_number() != 4)
+        {
+            mpInstance->DoWork();
+        }
+        lobbySessionWriter->on_session_changed(multiplayer_session_change_event_args(mpsdLobbySession->session_reference(), L"", 6));
+        while (submittedHoppers.size() < 2 || mpInstance->MatchStatus != MatchStatus::Searching)
+        {
+            auto events = mpInstance->DoWork();
+            for (auto ev : events)
+            {
+                VERIFY_IS_TRUE(ev->EventType != MultiplayerEventType::FindMatchCompleted);
+            }
+        }
+
+        // Twice the slow hopper's estimate is more than the time left, so it gets the rest of the search
+        VERIFY_ARE_EQUAL_STR(L"SlowHopper", submittedHoppers[1]);
+        VERIFY_IS_TRUE(ticketTimeouts[1] > 50 && ticketTimeouts[1] <= 60);
+
+        DestructManager(xboxLiveContext);
+    }
+
     DEFINE_TEST_CASE(TestFindMatchWithQoSCompleted)
     {
         DEFINE_TEST_CASE_PROPERTIES(TestFindMatchWithQoSCompleted);
@@ -4018,6 +4182,47 @@ public:
         FindMatchWithQoSHelper(MatchCallingPatternType::RemoteClientFailedToUploadQoS);
     }
 
+    DEFINE_TEST_CASE(TestFindMatchWithAutomaticQoS)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestFindMatchWithAutomaticQoS);
+        FindMatchWithQoSHelper(MatchCallingPatternType::Completed, true);
+    }
+
+    DEFINE_TEST_CASE(TestQosProberLoopback)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestQosProberLoopback);
+
+        multiplayer_qos_responder responder1;
+        multiplayer_qos_responder responder2;
+        multiplayer_qos_responder stoppedResponder;
+        VERIFY_IS_TRUE(!responder1.start(L"127.0.0.1", 0));
+        VERIFY_IS_TRUE(!responder2.start(L"127.0.0.1", 0));
+        VERIFY_IS_TRUE(!stoppedResponder.start(L"127.0.0.1", 0));
+        stoppedResponder.stop();
+
+        std::vector<string_t> endpoints =
+        {
+            L"127.0.0.1:" + utils::uint32_to_string_t(responder1.port()),
+            L"127.0.0.1:" + utils::uint32_to_string_t(stoppedResponder.port()),
+            L"not an endpoint",
+            L"127.0.0.1:" + utils::uint32_to_string_t(responder2.port())
+        };
+
+        // All endpoints are probed at once, so the unanswered ones cost one timeout rather than one each
+        multiplayer_qos_prober prober(3, std::chrono::milliseconds(300));
+        auto start = std::chrono::steady_clock::now();
+        auto results = prober.measure(endpoints);
+        auto elapsed = std::chrono::steady_clock::now() - start;
+
+        VERIFY_ARE_EQUAL_UINT(4, results.size());
+        VERIFY_ARE_EQUAL_UINT(3, results[0].probesReceived);
+        VERIFY_ARE_EQUAL_UINT(0, results[1].probesReceived);
+        VERIFY_ARE_EQUAL_UINT(0, results[2].probesReceived);
+        VERIFY_ARE_EQUAL_UINT(3, results[3].probesReceived);
+        VERIFY_IS_TRUE(results[0].latency < std::chrono::milliseconds(300));
+        VERIFY_IS_TRUE(elapsed < std::chrono::milliseconds(600));
+    }
+
     void FindMatchNoQoSRemoteClientJoiningMatchSessionHelper()
     {
         InitializeManager();
@@ -4249,6 +4454,179 @@ public:
         DEFINE_TEST_CASE_PROPERTIES(TestCancelMatchByService);
         CancelMatchHelper(MatchCallingPatternType::CanceledByService);
     }
+
+    /*
+        Lobby under load: the lobby is served by MockSessionDirectory while remote members join, leave and
+        write properties, shoulder taps arrive late and out of order, and the local member writes every frame.
+        Once the load stops the lobby must converge on the directory's change number.
+        Ignored by default since it runs for over 30 seconds; reports write rate, conflict rate and DoWork timings.
+    */
+    DEFINE_TEST_CASE(TestLobbyUnderLoad)
+    {
+        DEFINE_TEST_CASE_PROPERTIES_IGNORE(TestLobbyUnderLoad);
+
+        const std::chrono::seconds loadDuration(30);
+        const std::chrono::seconds convergenceTimeout(10);
+        const std::chrono::milliseconds serviceLatency(20);
+        const std::chrono::milliseconds remoteChangeInterval(15);
+        const std::chrono::milliseconds frameInterval(16);
+        const size_t maxRemoteMembers = 15;
+
+        InitializeManager();
+        auto xboxLiveContext = GetMockXboxLiveContext_WinRT();
+        auto sessionDirectory = std::make_shared<MockSessionDirectory>(
+            defaultLobbySessionResponseJson,
+            _T("/serviceconfigs/MockScid/sessionTemplates/MockLobbySessionTemplateName/sessions/MockLobbySessionName"),
+            _T("TestXboxUserId"),
+            serviceLatency
+            );
+        sessionDirectory->install(m_mockXboxSystemFactory);
+
+        auto mpInstance = MultiplayerManager::SingletonInstance;
+        mpInstance->LobbySession->AddLocalUser(xboxLiveContext->User);
+
+        bool userAdded = false;
+        while (!userAdded)
+        {
+            auto events = mpInstance->DoWork();
+            for (auto ev : events)
+            {
+                if (ev->EventType == MultiplayerEventType::UserAdded)
+                {
+                    userAdded = true;
+                }
+            }
+        }
+
+        auto clientManager = mpInstance->GetCppObj()->_Get_multiplayer_client_manager();
+        auto sessionReference = clientManager->latest_pending_read()->lobby_client()->session()->session_reference();
+        auto sessionWriter = clientManager->latest_pending_read()->lobby_client()->session_writer();
+
+        std::mutex tapLock;
+        std::vector<uint64_t> pendingTaps;
+        sessionDirectory->set_session_changed_handler([&tapLock, &pendingTaps](uint64_t changeNumber)
+        {
+            std::lock_guard<std::mutex> lock(tapLock);
+            pendingTaps.push_back(changeNumber);
+        });
+
+        std::atomic<bool> loadRunning(true);
+        std::atomic<bool> tapsRunning(true);
+
+        auto remoteTask = pplx::create_task([&]()
+        {
+            std::mt19937 random(1);
+            std::vector<string_t> remoteMembers;
+            uint32_t nextRemoteMember = 0;
+            while (loadRunning)
+            {
+                std::this_thread::sleep_for(remoteChangeInterval);
+                auto action = random() % 10;
+                if (remoteMembers.empty() || (action == 0 && remoteMembers.size() < maxRemoteMembers))
+                {
+                    stringstream_t xboxUserId;
+                    xboxUserId << _T("RemoteXboxUserId") << nextRemoteMember++;
+                    remoteMembers.push_back(xboxUserId.str());
+                    sessionDirectory->add_remote_member(remoteMembers.back());
+                }
+                else if (action == 1)
+                {
+                    auto index = random() % remoteMembers.size();
+                    sessionDirectory->remove_remote_member(remoteMembers[index]);
+                    remoteMembers.erase(remoteMembers.begin() + index);
+                }
+                else
+                {
+                    auto& xboxUserId = remoteMembers[random() % remoteMembers.size()];
+                    sessionDirectory->set_remote_member_property(xboxUserId, _T("Score"), web::json::value::number(random() % 1000));
+                }
+            }
+        });
+
+        // Taps are held back for up to 50ms and delivered in random order, as RTA may do
+        auto tapTask = pplx::create_task([&]()
+        {
+            std::mt19937 random(2);
+            while (tapsRunning)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(random() % 50));
+
+                std::vector<uint64_t> taps;
+                {
+                    std::lock_guard<std::mutex> lock(tapLock);
+                    taps.swap(pendingTaps);
+                }
+
+                std::shuffle(taps.begin(), taps.end(), random);
+                for (auto changeNumber : taps)
+                {
+                    sessionWriter->on_session_changed(multiplayer_session_change_event_args(sessionReference, L"", changeNumber));
+                }
+            }
+        });
+
+        std::mt19937 random(3);
+        std::vector<double> doWorkMilliseconds;
+        auto loadStart = std::chrono::steady_clock::now();
+        while (std::chrono::steady_clock::now() - loadStart < loadDuration)
+        {
+            auto value = ref new Platform::String(std::to_wstring(random() % 1000).c_str());
+            switch (random() % 3)
+            {
+            case 0:
+                mpInstance->LobbySession->SetLocalMemberProperties(xboxLiveContext->User, L"Health", value, nullptr);
+                break;
+            case 1:
+                mpInstance->LobbySession->SetSynchronizedProperties(L"Round", value, nullptr);
+                break;
+            default:
+                break;
+            }
+
+            auto frameStart = std::chrono::steady_clock::now();
+            mpInstance->DoWork();
+            doWorkMilliseconds.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frameStart).count());
+            std::this_thread::sleep_for(frameInterval);
+        }
+
+        loadRunning = false;
+        remoteTask.wait();
+
+        auto convergenceStart = std::chrono::steady_clock::now();
+        bool converged = false;
+        while (!converged && std::chrono::steady_clock::now() - convergenceStart < convergenceTimeout)
+        {
+            mpInstance->DoWork();
+            converged = !sessionWriter->is_write_in_progress() &&
+                mpInstance->LobbySession->GetCppObj()->_Change_number() == sessionDirectory->change_number();
+            std::this_thread::sleep_for(frameInterval);
+        }
+        auto convergenceMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - convergenceStart).count();
+
+        tapsRunning = false;
+        tapTask.wait();
+
+        std::sort(doWorkMilliseconds.begin(), doWorkMilliseconds.end());
+        double loadSeconds = std::chrono::duration<double>(loadDuration).count();
+        double attemptedWrites = std::max<double>(1, sessionDirectory->writes() + sessionDirectory->conflicts());
+        TEST_LOG(FormatString(L" [MPM] TestLobbyUnderLoad - Writes/sec: %.1f Conflicts: %u (%.1f%%) Reads: %u (%u not modified) Members: %u",
+            sessionDirectory->writes() / loadSeconds,
+            sessionDirectory->conflicts(),
+            100.0 * sessionDirectory->conflicts() / attemptedWrites,
+            sessionDirectory->reads(),
+            sessionDirectory->not_modified_reads(),
+            sessionDirectory->member_count()
+            ).c_str());
+        TEST_LOG(FormatString(L" [MPM] TestLobbyUnderLoad - DoWork ms mean: %.3f p99: %.3f max: %.3f Convergence ms: %.0f",
+            std::accumulate(doWorkMilliseconds.begin(), doWorkMilliseconds.end(), 0.0) / doWorkMilliseconds.size(),
+            doWorkMilliseconds[doWorkMilliseconds.size() * 99 / 100],
+            doWorkMilliseconds.back(),
+            convergenceMilliseconds
+            ).c_str());
+
+        VERIFY_IS_TRUE(converged);
+        DestructManager(xboxLiveContext);
+    }
 };
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_SYSTEM_CPP_END
\ No newline at end of file
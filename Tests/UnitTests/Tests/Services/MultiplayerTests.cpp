@@ -12,6 +12,7 @@
 #include "xsapi/xbox_live_context.h"
 #include "XboxLiveContext_WinRT.h"
 #include "utils.h"
+#include "multiplayer_internal.h"
 #include "Utils_WinRT.h"
 #include "MultiplayerSessionWriteMode_WinRT.h"
 #include "RtaTestHelper.h"
@@ -1528,6 +1529,133 @@ public:
         VerifyMultiplayerSession(result, responseJson);
     }
 
+    DEFINE_TEST_CASE(TestGetCurrentSessionNotModified)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestGetCurrentSessionNotModified);
+        auto responseJson = web::json::value::parse(defaultMultiplayerResponse);
+
+        auto httpCall = m_mockXboxSystemFactory->GetMockHttpCall();
+        httpCall->ResultValue = StockMocks::CreateMockHttpCallResponse(responseJson);
+
+        auto sessionReference = ref new MultiplayerSessionReference(
+            L"8d050174-412b-4d51-a29b-d55a34edfdb7",
+            L"integration",
+            L"19de0095d8bb41048f19edbbb6bc6b04"
+            );
+
+        XboxLiveContext^ xboxLiveContext = GetMockXboxLiveContext_WinRT();
+        MultiplayerSession^ first = create_task(xboxLiveContext->MultiplayerService->GetCurrentSessionAsync(sessionReference)).get();
+        VERIFY_IS_TRUE(httpCall->ResultValueInternal->response_headers().count("If-None-Match") == 0);
+
+        // The second read is conditional on the cached ETag and is answered without a body
+        httpCall->ResultValue = StockMocks::CreateMockHttpCallResponse(web::json::value(), 304);
+        MultiplayerSession^ second = create_task(xboxLiveContext->MultiplayerService->GetCurrentSessionAsync(sessionReference)).get();
+        VERIFY_ARE_EQUAL_STR(xsapi_internal_string("MockETag"), httpCall->ResultValueInternal->response_headers().at("If-None-Match"));
+
+        VerifyMultiplayerSession(second, responseJson);
+        VERIFY_IS_TRUE(first != second);
+        VERIFY_ARE_EQUAL_STR(L"MockETag", second->ETag);
+    }
+
+    DEFINE_TEST_CASE(TestLazySessionFields)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestLazySessionFields);
+        auto responseJson = web::json::value::parse(defaultMultiplayerResponse);
+
+        auto sessionResult = multiplayer_session::_Deserialize(responseJson);
+        VERIFY_IS_TRUE(!sessionResult.err());
+        auto session = std::make_shared<multiplayer_session>(sessionResult.payload());
+        auto copy = session->_Create_deep_copy();
+
+        // Decoded on first access from either session, then shared between them
+        auto roleTypes = copy->session_role_types();
+        VERIFY_IS_TRUE(roleTypes == session->session_role_types());
+        VERIFY_ARE_EQUAL_UINT(1, roleTypes->role_types().size());
+        VERIFY_ARE_EQUAL_UINT(2, roleTypes->role_types().at(L"lfg").roles().size());
+
+        VERIFY_IS_TRUE(session->matchmaking_server().status() == matchmaking_status::searching);
+        VERIFY_IS_TRUE(&session->matchmaking_server() == &copy->matchmaking_server());
+        VERIFY_ARE_EQUAL_STR(L"capture-the-flag", copy->matchmaking_server().target_session_ref().session_template_name());
+    }
+
+    DEFINE_TEST_CASE(TestMemberIndex)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestMemberIndex);
+        auto responseJson = web::json::value::parse(defaultMultiplayerResponse);
+
+        auto sessionResult = multiplayer_session::_Deserialize(responseJson);
+        VERIFY_IS_TRUE(!sessionResult.err());
+        auto session = std::make_shared<multiplayer_session>(sessionResult.payload());
+
+        VERIFY_ARE_EQUAL_UINT(1, session->_Member_by_xbox_user_id(L"1234")->member_id());
+        VERIFY_ARE_EQUAL_STR(L"TestXboxUserId", session->_Member_by_member_id(0)->xbox_user_id());
+        VERIFY_IS_TRUE(session->_Member_by_xbox_user_id(L"5678") == nullptr);
+        VERIFY_IS_TRUE(session->_Member_by_member_id(2) == nullptr);
+
+        // Local reservations are found by xbox user id until the service assigns them a member id
+        VERIFY_IS_TRUE(!session->add_member_reservation(L"5678"));
+        VERIFY_IS_TRUE(session->_Member_by_xbox_user_id(L"5678") == session->members().back());
+        VERIFY_IS_TRUE(session->_Member_by_member_id(0)->xbox_user_id() == L"TestXboxUserId");
+
+        auto copy = session->_Create_deep_copy();
+        VERIFY_IS_TRUE(copy->_Member_by_xbox_user_id(L"5678") == copy->members().back());
+        VERIFY_ARE_EQUAL_UINT(1, copy->_Member_by_xbox_user_id(L"1234")->member_id());
+
+        // Turns and initialization groups resolve through the index, skipping ids with no member
+        VERIFY_ARE_EQUAL_UINT(1, copy->session_properties()->turn_collection().size());
+        VERIFY_IS_TRUE(copy->session_properties()->turn_collection()[0] == copy->_Member_by_member_id(0));
+        VERIFY_ARE_EQUAL_UINT(0, session->_Member_by_member_id(1)->members_in_group().size());
+    }
+
+    DEFINE_TEST_CASE(TestMemberRequestFragments)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestMemberRequestFragments);
+
+        std::unordered_map<string_t, string_t> roles;
+        roles[L"lfg"] = L"confirmed";
+        auto setRequestValues = [&roles](multiplayer_session_member_request& request)
+        {
+            request.set_role_info(roles);
+            request.set_secure_device_address_base64(L"AQD+/w==");
+            request.set_write_secure_device_address_base64(true);
+            request.set_subscribed_change_types(multiplayer_session_change_types::everything);
+            request.set_subscription_id(L"2E8FB3F8-1E6B-4D5B-9C2F-3A9A5C5D3F1A");
+            request.set_write_subscribed_change_types(true);
+        };
+        auto serialize = [](const multiplayer_session_member_request& request)
+        {
+            json_writer writer;
+            request.serialize(writer);
+            return writer.output();
+        };
+
+        web::json::value constants;
+        constants[L"skill"] = web::json::value::number(12);
+        multiplayer_session_member_request request(true, L"me", L"1234", constants, false, false);
+        setRequestValues(request);
+        auto uncached = serialize(request);
+        VERIFY_ARE_EQUAL_STR(uncached, serialize(request));
+
+        // The next write's request takes the fragments and serializes the same as one built without them
+        multiplayer_session_member_request nextRequest(false, L"me", L"1234", web::json::value(), false, false);
+        multiplayer_session_member_request uncachedRequest(false, L"me", L"1234", web::json::value(), false, false);
+        nextRequest.copy_fragments_from(request);
+        setRequestValues(nextRequest);
+        setRequestValues(uncachedRequest);
+        VERIFY_ARE_EQUAL_STR(serialize(uncachedRequest), serialize(nextRequest));
+
+        // Changed values are serialized again
+        for (auto memberRequest : { &nextRequest, &uncachedRequest })
+        {
+            memberRequest->set_secure_device_address_base64(L"BQE=");
+            memberRequest->set_subscribed_change_types(multiplayer_session_change_types::host_device_token_change);
+        }
+        auto changed = serialize(nextRequest);
+        VERIFY_ARE_EQUAL_STR(serialize(uncachedRequest), changed);
+        VERIFY_IS_TRUE(changed.find("\"BQE=\"") != xsapi_internal_string::npos);
+        VERIFY_IS_TRUE(changed.find("\"changeTypes\":[\"host\"]") != xsapi_internal_string::npos);
+    }
+
     DEFINE_TEST_CASE(TestGetCurrentSessionWithHandleAsync)
     {
         DEFINE_TEST_CASE_PROPERTIES(TestGetCurrentSessionWithHandleAsync);
@@ -2770,6 +2898,62 @@ public:
         }
     }
 
+    DEFINE_TEST_CASE(TestGetActivitiesForUsersByPage)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestGetActivitiesForUsersByPage);
+        const string_t activitiesForUserResponseJson = testResponseJsonFromFile[L"activitiesForUserResponseJson"].serialize();
+
+        auto xboxLiveContext = GetMockXboxLiveContext_Cpp();
+        auto httpCall = m_mockXboxSystemFactory->GetMockHttpCall();
+        httpCall->ResultValue = StockMocks::CreateMockHttpCallResponse(web::json::value::parse(activitiesForUserResponseJson));
+
+        // Every page returns one activity, so the cap of two is reached on the second of three pages
+        std::vector<string_t> xuids = { L"1", L"2", L"3", L"4", L"5" };
+        auto firstPage = xboxLiveContext->multiplayer_service().get_activities_for_users_by_page(L"MockScid", xuids, 2, 2).get();
+        VERIFY_IS_TRUE(!firstPage.err());
+        VERIFY_ARE_EQUAL_UINT(1, firstPage.payload().items().size());
+        VERIFY_IS_TRUE(firstPage.payload().has_next());
+
+        auto secondPage = firstPage.payload().get_next().get();
+        VERIFY_IS_TRUE(!secondPage.err());
+        VERIFY_ARE_EQUAL_UINT(1, secondPage.payload().items().size());
+        VERIFY_IS_TRUE(!secondPage.payload().has_next());
+        VERIFY_IS_TRUE(secondPage.payload().get_next().get().err() == xbox_live_error_code::out_of_range);
+
+        auto lastRequestJson = web::json::value::parse(utils::string_t_from_internal_string(httpCall->request_body().request_message_string()));
+        VERIFY_ARE_EQUAL_STR(L"[\"3\",\"4\"]", lastRequestJson[L"owners"][L"xuids"].serialize());
+    }
+
+    DEFINE_TEST_CASE(TestGetActivitiesForUsersByPagePrefetch)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestGetActivitiesForUsersByPagePrefetch);
+        const string_t activitiesForUserResponseJson = testResponseJsonFromFile[L"activitiesForUserResponseJson"].serialize();
+
+        auto xboxLiveContext = GetMockXboxLiveContext_Cpp();
+        auto httpCall = m_mockXboxSystemFactory->GetMockHttpCall();
+        httpCall->ResultValue = StockMocks::CreateMockHttpCallResponse(web::json::value::parse(activitiesForUserResponseJson));
+
+        // Four pages; only the page after the one just received is requested ahead of get_next
+        std::vector<string_t> xuids = { L"1", L"2", L"3", L"4", L"5", L"6", L"7" };
+        auto page = xboxLiveContext->multiplayer_service().get_activities_for_users_by_page(L"MockScid", xuids, 2).get();
+        VERIFY_IS_TRUE(!page.err());
+        VERIFY_ARE_EQUAL_INT(2, httpCall->CallCounter);
+
+        for (int expectedCalls : { 3, 4, 4 })
+        {
+            VERIFY_IS_TRUE(page.payload().has_next());
+            auto nextPage = page.payload().get_next().get();
+            VERIFY_IS_TRUE(!nextPage.err());
+            VERIFY_ARE_EQUAL_INT(expectedCalls, httpCall->CallCounter);
+
+            // Asking for the same page again doesn't send anything
+            VERIFY_IS_TRUE(!page.payload().get_next().get().err());
+            VERIFY_ARE_EQUAL_INT(expectedCalls, httpCall->CallCounter);
+            page = nextPage;
+        }
+        VERIFY_IS_TRUE(!page.payload().has_next());
+    }
+
     DEFINE_TEST_CASE(TestGetActivitiesForSocialGroupAsync)
     {
         DEFINE_TEST_CASE_PROPERTIES(TestGetActivitiesForSocialGroupAsync);
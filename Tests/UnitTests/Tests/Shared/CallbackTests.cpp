@@ -0,0 +1,172 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "pch.h"
+#define TEST_CLASS_OWNER L"jasonsa"
+#define TEST_CLASS_AREA L"Callback"
+#include "UnitTestIncludes.h"
+#include "mem_pool.h"
+
+using namespace xbox::services::system;
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
+
+// The previous heap allocated xbox_live_callback, kept as the microbenchmark baseline
+template<typename... Args>
+class legacy_callback
+{
+public:
+    template <typename Functor>
+    legacy_callback(Functor functor)
+    {
+        m_callable = xsapi_unique_ptr<ICallable>(xsapi_allocate_unique<callable<Functor>>(functor).release());
+    }
+
+    legacy_callback(legacy_callback&& rhs) : m_callable(std::move(rhs.m_callable)) {}
+
+    void operator()(Args... args) const
+    {
+        (*m_callable)(args...);
+    }
+
+private:
+    struct ICallable
+    {
+        virtual ~ICallable() = default;
+        virtual void operator()(Args...) = 0;
+    };
+
+    template <typename Functor>
+    struct callable : public ICallable
+    {
+        callable(const Functor& functor) : m_functor(functor) {}
+        void operator()(Args... args) override { m_functor(args...); }
+        Functor m_functor;
+    };
+
+    xsapi_unique_ptr<ICallable> m_callable;
+};
+
+DEFINE_TEST_CLASS(CallbackTests)
+{
+public:
+    DEFINE_TEST_CLASS_PROPS(CallbackTests)
+
+    uint64_t TotalAllocations()
+    {
+        XblMemoryStats stats;
+        VERIFY_ARE_EQUAL(S_OK, XblMemGetStats(XblMemorySubsystem_Rta, &stats));
+        return stats.totalAllocationCount;
+    }
+
+    DEFINE_TEST_CASE(TestInlineStorage)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestInlineStorage);
+
+        VERIFY_ARE_EQUAL(S_OK, XblMemSetTrackingMode(XblMemoryTrackingMode_Full));
+        xsapi_memory_subsystem_scope scope(xsapi_memory_subsystem::rta);
+
+        auto owner = std::make_shared<int>(2);
+        int total = 0;
+
+        // A typical completion capture is stored inline and moved without allocating
+        uint64_t allocations = TotalAllocations();
+        {
+            xbox_live_callback<int> callback([owner, &total](int value) { total += value * *owner; });
+            xbox_live_callback<int> moved(std::move(callback));
+            VERIFY_IS_TRUE(callback == nullptr);
+            moved(1);
+            xbox_live_callback<int> copied(moved);
+            copied(2);
+        }
+        VERIFY_ARE_EQUAL_UINT(allocations, TotalAllocations());
+        VERIFY_ARE_EQUAL_INT(6, total);
+        VERIFY_ARE_EQUAL_INT(1, owner.use_count());
+
+        // Captures larger than the inline buffer fall back to xsapi_memory
+        char large[XSAPI_CALLBACK_INLINE_SIZE + 1] = { 1 };
+        {
+            xbox_live_callback<int> callback([large, &total](int value) { total += value + large[0]; });
+            VERIFY_ARE_EQUAL_UINT(allocations + 1, TotalAllocations());
+            xbox_live_callback<int> moved(std::move(callback));
+            VERIFY_ARE_EQUAL_UINT(allocations + 1, TotalAllocations());
+            moved(1);
+        }
+        VERIFY_ARE_EQUAL_INT(8, total);
+
+        VERIFY_ARE_EQUAL(S_OK, XblMemSetTrackingMode(XblMemoryTrackingMode_Disabled));
+    }
+
+    DEFINE_TEST_CASE(TestCopyAndAssign)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestCopyAndAssign);
+
+        // State that cannot be copied is shared instead
+        auto value = std::make_shared<std::unique_ptr<int>>(new int(3));
+        int total = 0;
+        xbox_live_callback<void> callback([value, &total]() { total += **value; });
+        callback();
+
+        xbox_live_callback<void> copy(callback);
+        copy();
+        VERIFY_ARE_EQUAL_INT(3, value.use_count());
+
+        xbox_live_callback<void> moved;
+        moved = std::move(callback);
+        moved();
+        VERIFY_ARE_EQUAL_INT(9, total);
+
+        moved = nullptr;
+        VERIFY_IS_TRUE(moved == nullptr);
+        moved();
+    }
+
+    template<typename Callback, typename Functor>
+    double TimeCallbacks(uint32_t iterations, const Functor& functor)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        for (uint32_t i = 0; i < iterations; ++i)
+        {
+            Callback callback(functor);
+            Callback moved(std::move(callback));
+            moved(1);
+        }
+        auto elapsed = std::chrono::high_resolution_clock::now() - start;
+        return std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+    }
+
+    DEFINE_TEST_CASE(TestMicrobenchmark)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestMicrobenchmark);
+
+        auto owner = std::make_shared<int>(1);
+        xsapi_internal_string name("completion");
+        int total = 0;
+        auto completion = [owner, name, &total](int value) { total += value + *owner; };
+        xbox_live_callback<int> inner(completion);
+        auto nested = [owner, inner](int value) { inner(value); };
+
+        // The typical capture must take the inline path for the comparison to mean anything
+        VERIFY_ARE_EQUAL(S_OK, XblMemSetTrackingMode(XblMemoryTrackingMode_Full));
+        {
+            xsapi_memory_subsystem_scope scope(xsapi_memory_subsystem::rta);
+            uint64_t allocations = TotalAllocations();
+            xbox_live_callback<int> callback(completion);
+            VERIFY_ARE_EQUAL_UINT(allocations, TotalAllocations());
+        }
+        VERIFY_ARE_EQUAL(S_OK, XblMemSetTrackingMode(XblMemoryTrackingMode_Disabled));
+
+        // Construct, move and invoke, as on an async completion hop
+        const uint32_t iterations = 100000;
+        double legacyNs = TimeCallbacks<legacy_callback<int>>(iterations, completion);
+        double inlineNs = TimeCallbacks<xbox_live_callback<int>>(iterations, completion);
+        double nestedNs = TimeCallbacks<xbox_live_callback<int>>(iterations, nested);
+        VERIFY_ARE_EQUAL_INT(static_cast<int>(iterations) * 2 * 3, total);
+
+        TEST_LOG(FormatString(L"legacy_callback: %.1f ns per callback", legacyNs).c_str());
+        TEST_LOG(FormatString(L"xbox_live_callback, %u byte capture: %.1f ns per callback", static_cast<uint32_t>(sizeof(completion)), inlineNs).c_str());
+        TEST_LOG(FormatString(L"xbox_live_callback, nested callback capture: %.1f ns per callback", nestedNs).c_str());
+    }
+};
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
@@ -0,0 +1,134 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "pch.h"
+#define TEST_CLASS_OWNER L"jasonsa"
+#define TEST_CLASS_AREA L"HttpCallDispatcher"
+#include "UnitTestIncludes.h"
+#include "http_call_dispatcher.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
+
+static std::vector<AsyncBlock*> s_performedCalls;
+static std::vector<std::pair<AsyncBlock*, HRESULT>> s_failedCalls;
+static AsyncBlock* s_failingCall = nullptr;
+
+static HRESULT RecordPerform(_Inout_ AsyncBlock* asyncBlock, _In_ hc_call_handle_t callHandle)
+{
+    UNREFERENCED_PARAMETER(callHandle);
+    if (asyncBlock == s_failingCall)
+    {
+        return E_OUTOFMEMORY;
+    }
+    s_performedCalls.push_back(asyncBlock);
+    return S_OK;
+}
+
+static void RecordFailure(_Inout_ AsyncBlock* asyncBlock, _In_ HRESULT hr)
+{
+    s_failedCalls.push_back(std::make_pair(asyncBlock, hr));
+}
+
+DEFINE_TEST_CLASS(HttpCallDispatcherTests)
+{
+public:
+    DEFINE_TEST_CLASS_PROPS(HttpCallDispatcherTests)
+
+    DEFINE_TEST_CASE(TestDefaultPriorities)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestDefaultPriorities);
+
+        VERIFY_IS_TRUE(default_http_call_priority(xbox_live_api::write_session_using_subpath) == http_call_priority::gameplay_critical);
+        VERIFY_IS_TRUE(default_http_call_priority(xbox_live_api::get_match_ticket_details) == http_call_priority::gameplay_critical);
+        VERIFY_IS_TRUE(default_http_call_priority(xbox_live_api::update_stats_value_document) == http_call_priority::background);
+        VERIFY_IS_TRUE(default_http_call_priority(xbox_live_api::get_social_graph) == http_call_priority::background);
+        VERIFY_IS_TRUE(default_http_call_priority(xbox_live_api::get_user_profiles) == http_call_priority::interactive);
+        VERIFY_IS_TRUE(default_http_call_priority(xbox_live_api::unspecified) == http_call_priority::interactive);
+    }
+
+    DEFINE_TEST_CASE(TestConcurrencyLimits)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestConcurrencyLimits);
+
+        s_performedCalls.clear();
+        http_call_dispatcher dispatcher(RecordPerform);
+        dispatcher.set_concurrency_limit(http_call_priority::background, 1);
+
+        AsyncBlock background[3] = {};
+        VERIFY_IS_TRUE(dispatcher.perform(http_call_priority::background, &background[0], nullptr));
+        VERIFY_IS_TRUE(!dispatcher.perform(http_call_priority::background, &background[1], nullptr));
+        VERIFY_IS_TRUE(!dispatcher.perform(http_call_priority::background, &background[2], nullptr));
+        VERIFY_ARE_EQUAL_UINT(1, s_performedCalls.size());
+        VERIFY_ARE_EQUAL_UINT(1, dispatcher.in_flight_count(http_call_priority::background));
+        VERIFY_ARE_EQUAL_UINT(2, dispatcher.queued_count(http_call_priority::background));
+
+        // Gameplay critical calls are never held back by background traffic
+        AsyncBlock critical[10] = {};
+        for (auto& asyncBlock : critical)
+        {
+            dispatcher.perform(http_call_priority::gameplay_critical, &asyncBlock, nullptr);
+        }
+        VERIFY_ARE_EQUAL_UINT(11, s_performedCalls.size());
+        VERIFY_IS_TRUE(s_performedCalls.back() == &critical[9]);
+
+        // Completing a background call starts the next one in FIFO order
+        dispatcher.on_complete(&background[0]);
+        VERIFY_ARE_EQUAL_UINT(12, s_performedCalls.size());
+        VERIFY_IS_TRUE(s_performedCalls.back() == &background[1]);
+
+        // Completing a call of another class does not release background slots
+        dispatcher.on_complete(&critical[0]);
+        VERIFY_ARE_EQUAL_UINT(12, s_performedCalls.size());
+
+        // A call that was never started holds no slot
+        dispatcher.on_complete(&background[0]);
+        VERIFY_ARE_EQUAL_UINT(1, dispatcher.in_flight_count(http_call_priority::background));
+
+        dispatcher.set_concurrency_limit(http_call_priority::background, 2);
+        VERIFY_ARE_EQUAL_UINT(13, s_performedCalls.size());
+        VERIFY_IS_TRUE(s_performedCalls.back() == &background[2]);
+        VERIFY_ARE_EQUAL_UINT(0, dispatcher.queued_count(http_call_priority::background));
+    }
+
+    DEFINE_TEST_CASE(TestFailedCalls)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestFailedCalls);
+
+        s_performedCalls.clear();
+        s_failedCalls.clear();
+        AsyncBlock background[4] = {};
+        {
+            http_call_dispatcher dispatcher(RecordPerform, RecordFailure);
+            dispatcher.set_concurrency_limit(http_call_priority::background, 1);
+
+            // A call that fails to start gives its slot back and is completed with the error
+            s_failingCall = &background[0];
+            VERIFY_IS_TRUE(!dispatcher.perform(http_call_priority::background, &background[0], nullptr));
+            VERIFY_ARE_EQUAL_UINT(1, s_failedCalls.size());
+            VERIFY_IS_TRUE(s_failedCalls[0].first == &background[0]);
+            VERIFY_IS_TRUE(s_failedCalls[0].second == E_OUTOFMEMORY);
+            VERIFY_ARE_EQUAL_UINT(0, dispatcher.in_flight_count(http_call_priority::background));
+
+            // A queued call that fails to start passes its slot on to the next one
+            VERIFY_IS_TRUE(dispatcher.perform(http_call_priority::background, &background[1], nullptr));
+            s_failingCall = &background[2];
+            VERIFY_IS_TRUE(!dispatcher.perform(http_call_priority::background, &background[2], nullptr));
+            VERIFY_IS_TRUE(!dispatcher.perform(http_call_priority::background, &background[3], nullptr));
+            dispatcher.on_complete(&background[1]);
+            VERIFY_ARE_EQUAL_UINT(2, s_failedCalls.size());
+            VERIFY_IS_TRUE(s_failedCalls[1].first == &background[2]);
+            VERIFY_IS_TRUE(s_performedCalls.back() == &background[3]);
+            VERIFY_ARE_EQUAL_UINT(1, dispatcher.in_flight_count(http_call_priority::background));
+
+            VERIFY_IS_TRUE(!dispatcher.perform(http_call_priority::background, &background[1], nullptr));
+        }
+        s_failingCall = nullptr;
+
+        // Calls still queued when the dispatcher goes away are aborted rather than dropped
+        VERIFY_ARE_EQUAL_UINT(3, s_failedCalls.size());
+        VERIFY_IS_TRUE(s_failedCalls[2].first == &background[1]);
+        VERIFY_IS_TRUE(s_failedCalls[2].second == E_ABORT);
+    }
+};
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
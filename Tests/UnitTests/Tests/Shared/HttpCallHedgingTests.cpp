@@ -0,0 +1,120 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "pch.h"
+#define TEST_CLASS_OWNER L"jasonsa"
+#define TEST_CLASS_AREA L"HttpCallHedging"
+#include "UnitTestIncludes.h"
+#include "http_call_hedging.h"
+#include "http_call_metrics.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
+
+DEFINE_TEST_CLASS(HttpCallHedgingTests)
+{
+public:
+    DEFINE_TEST_CLASS_PROPS(HttpCallHedgingTests)
+
+    std::shared_ptr<http_call_data> CreateCallData(
+        _In_ const std::shared_ptr<xbox_live_context_settings>& settings,
+        _In_ const xsapi_internal_string& httpMethod,
+        _In_ xbox_live_api xboxLiveApi
+        )
+    {
+        return xsapi_allocate_shared<http_call_data>(
+            settings,
+            httpMethod,
+            "https://sessiondirectory.xboxlive.com",
+            web::uri(_T("/serviceconfigs/123/sessionTemplates/abc/sessions/def")),
+            xboxLiveApi
+            );
+    }
+
+    DEFINE_TEST_CASE(TestHedgeDelay)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestHedgeDelay);
+
+        auto metrics = http_call_metrics_internal::get_singleton_instance();
+        metrics->reset();
+        auto policy = xsapi_allocate_shared<http_call_hedging_policy>();
+        auto settings = std::make_shared<xbox_live_context_settings>();
+        auto callData = CreateCallData(settings, "GET", xbox_live_api::get_current_session);
+
+        // Off by default
+        VERIFY_ARE_EQUAL_INT(0, policy->hedge_delay(callData).count());
+
+        // Not enough samples yet
+        settings->set_use_http_request_hedging(true);
+        VERIFY_ARE_EQUAL_INT(0, policy->hedge_delay(callData).count());
+
+        for (uint32_t i = 1; i <= 100; ++i)
+        {
+            metrics->record_response(xbox_live_api::get_current_session, std::chrono::milliseconds(i), 200, false, 0);
+        }
+
+        auto delay = policy->hedge_delay(callData).count();
+        VERIFY_IS_TRUE(delay >= 95 && delay <= 95 + 95 / LATENCY_HISTOGRAM_SUB_BUCKET_COUNT + 1);
+
+        policy->set_delay_bounds(std::chrono::milliseconds(10), std::chrono::milliseconds(50));
+        VERIFY_ARE_EQUAL_INT(50, policy->hedge_delay(callData).count());
+
+        // Only idempotent reads on configured APIs are hedged
+        VERIFY_ARE_EQUAL_INT(0, policy->hedge_delay(CreateCallData(settings, "POST", xbox_live_api::get_current_session)).count());
+        VERIFY_ARE_EQUAL_INT(0, policy->hedge_delay(CreateCallData(settings, "GET", xbox_live_api::get_sessions)).count());
+        policy->remove_api(xbox_live_api::get_current_session);
+        VERIFY_ARE_EQUAL_INT(0, policy->hedge_delay(callData).count());
+
+        metrics->reset();
+    }
+
+    DEFINE_TEST_CASE(TestHedgeBudget)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestHedgeBudget);
+
+        auto policy = xsapi_allocate_shared<http_call_hedging_policy>();
+        auto settings = std::make_shared<xbox_live_context_settings>();
+        settings->set_use_http_request_hedging(true);
+        auto callData = CreateCallData(settings, "GET", xbox_live_api::get_match_ticket_details);
+
+        policy->set_budget(0.5, 2);
+        VERIFY_IS_TRUE(policy->try_acquire_budget());
+        VERIFY_IS_TRUE(policy->try_acquire_budget());
+        VERIFY_IS_TRUE(!policy->try_acquire_budget());
+
+        // Two eligible calls at a 50% ratio earn one hedge
+        policy->hedge_delay(callData);
+        VERIFY_IS_TRUE(!policy->try_acquire_budget());
+        policy->hedge_delay(callData);
+        VERIFY_IS_TRUE(policy->try_acquire_budget());
+        VERIFY_ARE_EQUAL_UINT(3, policy->hedges_sent());
+
+        // The bucket never holds more than the burst
+        for (uint32_t i = 0; i < 100; ++i)
+        {
+            policy->hedge_delay(callData);
+        }
+        VERIFY_IS_TRUE(policy->try_acquire_budget());
+        VERIFY_IS_TRUE(policy->try_acquire_budget());
+        VERIFY_IS_TRUE(!policy->try_acquire_budget());
+    }
+
+    DEFINE_TEST_CASE(TestHedgeRace)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestHedgeRace);
+
+        AsyncBlock primary = {};
+        AsyncBlock hedge = {};
+        http_call_hedge_state state;
+
+        VERIFY_IS_TRUE(state.attach(&primary, false));
+        VERIFY_IS_TRUE(state.try_complete(&primary));
+        state.release(&primary);
+        VERIFY_IS_TRUE(state.primaryAsyncBlock == nullptr);
+
+        // Once the race is decided the hedge is not sent and cannot win
+        VERIFY_IS_TRUE(!state.attach(&hedge, true));
+        VERIFY_IS_TRUE(!state.try_complete(&hedge));
+    }
+};
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
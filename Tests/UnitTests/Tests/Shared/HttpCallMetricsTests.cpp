@@ -0,0 +1,110 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "pch.h"
+#define TEST_CLASS_OWNER L"jasonsa"
+#define TEST_CLASS_AREA L"HttpCallMetrics"
+#include "UnitTestIncludes.h"
+#include "http_call_metrics.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
+
+DEFINE_TEST_CLASS(HttpCallMetricsTests)
+{
+public:
+    DEFINE_TEST_CLASS_PROPS(HttpCallMetricsTests)
+
+    DEFINE_TEST_CASE(TestHistogramBuckets)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestHistogramBuckets);
+
+        // Small values are exact
+        for (uint64_t v = 0; v < LATENCY_HISTOGRAM_SUB_BUCKET_COUNT * 2; ++v)
+        {
+            VERIFY_ARE_EQUAL_UINT(v, latency_histogram::bucket_index(v));
+        }
+
+        // Every value falls within the bounds of its bucket
+        for (uint64_t v = 1; v < (1ULL << LATENCY_HISTOGRAM_MAX_EXPONENT); v = v * 3 + 1)
+        {
+            uint32_t index = latency_histogram::bucket_index(v);
+            VERIFY_IS_TRUE(latency_histogram::bucket_lower_bound(index) <= v);
+            VERIFY_IS_TRUE(latency_histogram::bucket_upper_bound(index) >= v);
+        }
+
+        // Values past the range land in the last bucket
+        VERIFY_ARE_EQUAL_UINT(LATENCY_HISTOGRAM_BUCKET_COUNT - 1, latency_histogram::bucket_index((1ULL << LATENCY_HISTOGRAM_MAX_EXPONENT) - 1));
+        VERIFY_ARE_EQUAL_UINT(LATENCY_HISTOGRAM_BUCKET_COUNT - 1, latency_histogram::bucket_index(1ULL << LATENCY_HISTOGRAM_MAX_EXPONENT));
+        VERIFY_ARE_EQUAL_UINT(LATENCY_HISTOGRAM_BUCKET_COUNT - 1, latency_histogram::bucket_index((1ULL << (LATENCY_HISTOGRAM_MAX_EXPONENT + 1)) - 1));
+        VERIFY_ARE_EQUAL_UINT(LATENCY_HISTOGRAM_BUCKET_COUNT - 1, latency_histogram::bucket_index(UINT64_MAX));
+
+        auto histogram = xsapi_allocate_unique<latency_histogram>();
+        histogram->record(1ULL << LATENCY_HISTOGRAM_MAX_EXPONENT);
+        histogram->record((1ULL << (LATENCY_HISTOGRAM_MAX_EXPONENT + 1)) - 1);
+        VERIFY_ARE_EQUAL_UINT(2, histogram->total_count());
+        VERIFY_ARE_EQUAL_UINT((1ULL << (LATENCY_HISTOGRAM_MAX_EXPONENT + 1)) - 1, histogram->max_value());
+    }
+
+    DEFINE_TEST_CASE(TestHistogramPercentiles)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestHistogramPercentiles);
+
+        auto histogram = xsapi_allocate_unique<latency_histogram>();
+        VERIFY_ARE_EQUAL_UINT(0, histogram->value_at_percentile(50.0));
+
+        for (uint64_t v = 1; v <= 1000; ++v)
+        {
+            histogram->record(v * 1000);
+        }
+
+        VERIFY_ARE_EQUAL_UINT(1000, histogram->total_count());
+        VERIFY_ARE_EQUAL_UINT(1000000, histogram->max_value());
+        VERIFY_ARE_EQUAL_UINT(1000000, histogram->value_at_percentile(100.0));
+
+        // Relative error is bounded by the sub bucket resolution
+        uint64_t p50 = histogram->value_at_percentile(50.0);
+        VERIFY_IS_TRUE(p50 >= 500000 && p50 <= 500000 + 500000 / LATENCY_HISTOGRAM_SUB_BUCKET_COUNT);
+        uint64_t p99 = histogram->value_at_percentile(99.0);
+        VERIFY_IS_TRUE(p99 >= 990000 && p99 <= 1000000);
+
+        histogram->reset();
+        VERIFY_ARE_EQUAL_UINT(0, histogram->total_count());
+        VERIFY_ARE_EQUAL_UINT(0, histogram->value_at_percentile(99.0));
+    }
+
+    DEFINE_TEST_CASE(TestMetricsRegistry)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestMetricsRegistry);
+
+        auto metrics = http_call_metrics_internal::get_singleton_instance();
+        metrics->reset();
+
+        metrics->record_request(xbox_live_api::get_current_session, 100, false);
+        metrics->record_response(xbox_live_api::get_current_session, std::chrono::microseconds(2000), 401, true, 10);
+        metrics->record_token_refresh(xbox_live_api::get_current_session);
+        metrics->record_request(xbox_live_api::get_current_session, 100, true);
+        metrics->record_response(xbox_live_api::get_current_session, std::chrono::microseconds(3000), 429, true, 20);
+
+        auto counters = metrics->peek_counters(xbox_live_api::get_current_session);
+        VERIFY_IS_NOT_NULL(counters);
+        VERIFY_ARE_EQUAL_UINT(2, counters->requestCount);
+        VERIFY_ARE_EQUAL_UINT(1, counters->retryCount);
+        VERIFY_ARE_EQUAL_UINT(2, counters->failureCount);
+        VERIFY_ARE_EQUAL_UINT(1, counters->tokenRefreshCount);
+        VERIFY_ARE_EQUAL_UINT(1, counters->throttledCount);
+        VERIFY_ARE_EQUAL_UINT(200, counters->bytesSent);
+        VERIFY_ARE_EQUAL_UINT(30, counters->bytesReceived);
+
+        auto snapshot = http_call_metrics::get_singleton_instance()->snapshot();
+        VERIFY_ARE_EQUAL_UINT(1, snapshot.size());
+        VERIFY_ARE_EQUAL_STR(L"get_current_session", snapshot[0].api_name());
+        VERIFY_ARE_EQUAL_UINT(3000, snapshot[0].latency_max().count());
+
+        metrics->set_enabled(false);
+        metrics->record_request(xbox_live_api::get_current_session, 100, false);
+        VERIFY_ARE_EQUAL_UINT(2, counters->requestCount);
+        metrics->set_enabled(true);
+    }
+};
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
@@ -0,0 +1,132 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "pch.h"
+#define TEST_CLASS_OWNER L"jasonsa"
+#define TEST_CLASS_AREA L"HttpCompression"
+#include "UnitTestIncludes.h"
+#include "http_compression.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
+
+DEFINE_TEST_CLASS(HttpCompressionTests)
+{
+public:
+    DEFINE_TEST_CLASS_PROPS(HttpCompressionTests)
+
+    xsapi_internal_string CreateStatsDocument()
+    {
+        xsapi_internal_stringstream stream;
+        stream << "{\"stats\":[";
+        for (int i = 0; i < 12; ++i)
+        {
+            stream << (i > 0 ? "," : "") << "{\"name\":\"kills_" << i << "\",\"type\":\"integer\",\"value\":" << i * 7 << "}";
+        }
+        stream << "]}";
+        return stream.str();
+    }
+
+    DEFINE_TEST_CASE(TestRoundTrip)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestRoundTrip);
+
+        auto document = CreateStatsDocument();
+        auto data = reinterpret_cast<const uint8_t*>(document.data());
+
+        for (auto encoding : { http_content_encoding::gzip, http_content_encoding::deflate })
+        {
+            auto encoded = http_compression::compress(encoding, data, document.size());
+            VERIFY_IS_TRUE(encoded.size() < document.size() / 2);
+
+            xsapi_internal_vector<uint8_t> decoded;
+            VERIFY_IS_TRUE(http_compression::decompress(encoding, encoded.data(), encoded.size(), decoded));
+            VERIFY_ARE_EQUAL_STR(document, xsapi_internal_string(decoded.begin(), decoded.end()));
+        }
+
+        // Empty bodies are valid streams too
+        auto encoded = http_compression::compress(http_content_encoding::gzip, nullptr, 0);
+        xsapi_internal_vector<uint8_t> decoded;
+        VERIFY_IS_TRUE(http_compression::decompress(http_content_encoding::gzip, encoded.data(), encoded.size(), decoded));
+        VERIFY_ARE_EQUAL_UINT(0, decoded.size());
+    }
+
+    DEFINE_TEST_CASE(TestDecodeDynamicHuffman)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestDecodeDynamicHuffman);
+
+        // CreateStatsDocument() compressed by zlib at level 9, which uses a dynamic Huffman block
+        const uint8_t gzipBody[] = {
+            0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x7d, 0xd1, 0x4b, 0x0a, 0xc2, 0x30,
+            0x18, 0x45, 0xe1, 0xbd, 0xfc, 0xe3, 0x0e, 0x9a, 0x77, 0xdb, 0xad, 0x88, 0x94, 0x0c, 0x82, 0x14,
+            0x63, 0x11, 0x13, 0x05, 0x29, 0xd9, 0xbb, 0x75, 0xda, 0x5b, 0xee, 0xf4, 0xf0, 0xcd, 0xce, 0x26,
+            0xa5, 0xc6, 0x5a, 0x64, 0xba, 0x6c, 0xb2, 0xc6, 0x47, 0x92, 0x49, 0xee, 0x4b, 0xce, 0x65, 0xee,
+            0xa5, 0x93, 0xfa, 0x7d, 0xfe, 0xc3, 0xb2, 0xd6, 0x74, 0x4b, 0xaf, 0x3d, 0x7c, 0x62, 0x7e, 0xef,
+            0xa5, 0x6f, 0xdd, 0x41, 0x2b, 0xa2, 0x03, 0x68, 0x4d, 0xb4, 0xb2, 0xc0, 0x0d, 0xe1, 0x5a, 0x01,
+            0xb7, 0x8c, 0x0f, 0xc0, 0x1d, 0xe1, 0xc6, 0x01, 0xf7, 0x84, 0x5b, 0x0d, 0x3c, 0x30, 0x3e, 0x02,
+            0x1f, 0x08, 0x77, 0x1e, 0xf8, 0x48, 0xb8, 0x37, 0x78, 0x89, 0x4d, 0x0d, 0x27, 0x57, 0xe9, 0xd6,
+            0xd0, 0xae, 0xed, 0x07, 0x0f, 0x4d, 0x64, 0x88, 0x3f, 0x02, 0x00, 0x00 };
+
+        xsapi_internal_vector<uint8_t> decoded;
+        VERIFY_IS_TRUE(http_compression::decompress(http_content_encoding::gzip, gzipBody, sizeof(gzipBody), decoded));
+        VERIFY_ARE_EQUAL_STR(CreateStatsDocument(), xsapi_internal_string(decoded.begin(), decoded.end()));
+
+        // A flipped bit must fail the CRC or the stream itself
+        xsapi_internal_vector<uint8_t> corrupted(gzipBody, gzipBody + sizeof(gzipBody));
+        corrupted[40] ^= 0x10;
+        VERIFY_IS_TRUE(!http_compression::decompress(http_content_encoding::gzip, corrupted.data(), corrupted.size(), decoded));
+
+        // Truncated input
+        VERIFY_IS_TRUE(!http_compression::decompress(http_content_encoding::gzip, gzipBody, sizeof(gzipBody) - 10, decoded));
+    }
+
+    DEFINE_TEST_CASE(TestInflateWebSocketMessages)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestInflateWebSocketMessages);
+
+        // Two RTA change events deflated by zlib with context takeover and their sync flush tails removed.
+        // The second one is mostly a back reference into the first.
+        const uint8_t firstMessage[] = {
+            0x8a, 0x36, 0xd6, 0x31, 0xd4, 0xa9, 0x56, 0x2a, 0x28, 0x4a, 0x2d, 0x4e, 0xcd, 0x4b, 0x4e, 0x55,
+            0xb2, 0x52, 0xca, 0xcf, 0xcb, 0xc9, 0xcc, 0x4b, 0x55, 0xd2, 0x51, 0x2a, 0xc9, 0x2c, 0xc9, 0x49,
+            0xf5, 0x4c, 0x51, 0xb2, 0x32, 0x34, 0x32, 0x36, 0x31, 0x35, 0x33, 0xaf, 0x8d, 0x05, 0x00 };
+        const uint8_t secondMessage[] = { 0x8a, 0x26, 0x5a, 0xb1, 0x45, 0x6d, 0x2c, 0x00 };
+
+        xsapi_internal_vector<uint8_t> history;
+        xsapi_internal_vector<uint8_t> decoded;
+        VERIFY_IS_TRUE(http_compression::inflate_message(firstMessage, sizeof(firstMessage), history, decoded));
+        VERIFY_ARE_EQUAL_STR("[3,1,{\"presence\":\"online\",\"titleId\":1234567}]", xsapi_internal_string(decoded.begin(), decoded.end()));
+
+        // A message that doesn't inflate leaves the window as it was
+        const uint8_t reservedBlockType[] = { 0x07, 0x00, 0x00 };
+        VERIFY_IS_TRUE(!http_compression::inflate_message(reservedBlockType, sizeof(reservedBlockType), history, decoded));
+        VERIFY_ARE_EQUAL_UINT(45, history.size());
+
+        VERIFY_IS_TRUE(http_compression::inflate_message(secondMessage, sizeof(secondMessage), history, decoded));
+        VERIFY_ARE_EQUAL_STR("[3,1,{\"presence\":\"online\",\"titleId\":1234568}]", xsapi_internal_string(decoded.begin(), decoded.end()));
+
+        // Without the first message's output the back reference can't resolve
+        xsapi_internal_vector<uint8_t> emptyHistory;
+        VERIFY_IS_TRUE(!http_compression::inflate_message(secondMessage, sizeof(secondMessage), emptyHistory, decoded));
+    }
+
+    DEFINE_TEST_CASE(TestCompressionPolicy)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestCompressionPolicy);
+
+        http_compression_policy policy;
+        VERIFY_IS_TRUE(policy.compress_request(xbox_live_api::update_stats_value_document));
+        VERIFY_IS_TRUE(policy.compress_request(xbox_live_api::write_session_using_subpath));
+        VERIFY_IS_TRUE(!policy.compress_request(xbox_live_api::get_social_graph));
+        VERIFY_IS_TRUE(policy.accept_compressed_response(xbox_live_api::get_social_graph));
+        VERIFY_IS_TRUE(!policy.accept_compressed_response(xbox_live_api::get_current_session));
+
+        policy.set_compress_request(xbox_live_api::update_stats_value_document, false);
+        VERIFY_IS_TRUE(!policy.compress_request(xbox_live_api::update_stats_value_document));
+
+        VERIFY_IS_TRUE(http_compression::content_encoding_from_string("GZIP") == http_content_encoding::gzip);
+        VERIFY_IS_TRUE(http_compression::content_encoding_from_string("deflate") == http_content_encoding::deflate);
+        VERIFY_IS_TRUE(http_compression::content_encoding_from_string("br") == http_content_encoding::identity);
+    }
+};
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
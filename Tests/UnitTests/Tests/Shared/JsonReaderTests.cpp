@@ -0,0 +1,146 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "pch.h"
+#define TEST_CLASS_OWNER L"jasonsa"
+#define TEST_CLASS_AREA L"JsonReader"
+#include "UnitTestIncludes.h"
+#include "json_deserializer.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
+
+struct test_color
+{
+    char_t primary[8];
+    xsapi_internal_string secondary;
+};
+
+struct test_player
+{
+    char_t xuid[21];
+    bool isFavorite;
+    uint32_t rank;
+    double percentile;
+    test_color color;
+    xsapi_internal_vector<xsapi_internal_string> tags;
+};
+
+static const json_field<test_color> s_colorFields[] =
+{
+    { "primary", [](json_reader& r, test_color& c) { return json_read_value(r, c.primary); } },
+    { "secondary", [](json_reader& r, test_color& c) { return json_read_value(r, c.secondary); } },
+};
+
+static const json_field<test_player> s_playerFields[] =
+{
+    { "xuid", [](json_reader& r, test_player& p) { return json_read_value(r, p.xuid); } },
+    { "isFavorite", [](json_reader& r, test_player& p) { return json_read_value(r, p.isFavorite); } },
+    { "rank", [](json_reader& r, test_player& p) { return json_read_value(r, p.rank); } },
+    { "percentile", [](json_reader& r, test_player& p) { return json_read_value(r, p.percentile); } },
+    { "color", [](json_reader& r, test_player& p) { return json_read_object(r, p.color, s_colorFields); } },
+    { "tags", [](json_reader& r, test_player& p)
+    {
+        return json_read_array(r, [&p](json_reader& element)
+        {
+            p.tags.push_back(xsapi_internal_string());
+            return json_read_value(element, p.tags.back());
+        });
+    } },
+};
+
+DEFINE_TEST_CLASS(JsonReaderTests)
+{
+public:
+    DEFINE_TEST_CLASS_PROPS(JsonReaderTests)
+
+    bool IsMalformed(const char* document)
+    {
+        json_reader reader(document, strlen(document));
+        json_token token;
+        do
+        {
+            token = reader.next();
+        } while (token != json_token::error && token != json_token::end_of_input);
+        return token == json_token::error;
+    }
+
+    DEFINE_TEST_CASE(TestTokens)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestTokens);
+
+        json_reader reader(xsapi_internal_string("{ \"a\" : [1, -2.5e1, true, null, \"x\\\"\\u00e9\\ud83d\\ude00\"] }"));
+        VERIFY_IS_TRUE(reader.next() == json_token::begin_object);
+        VERIFY_IS_TRUE(reader.next() == json_token::key);
+        VERIFY_IS_TRUE(reader.string_equals("a"));
+        VERIFY_IS_TRUE(reader.next() == json_token::begin_array);
+        VERIFY_IS_TRUE(reader.next() == json_token::number);
+        VERIFY_ARE_EQUAL_INT(1, reader.int64_value());
+        VERIFY_IS_TRUE(reader.next() == json_token::number);
+        VERIFY_IS_TRUE(reader.double_value() == -25.0);
+        VERIFY_IS_TRUE(reader.next() == json_token::boolean);
+        VERIFY_IS_TRUE(reader.bool_value());
+        VERIFY_IS_TRUE(reader.next() == json_token::null);
+        VERIFY_IS_TRUE(reader.next() == json_token::string);
+        VERIFY_ARE_EQUAL_STR(xsapi_internal_string("x\"\xc3\xa9\xf0\x9f\x98\x80"), reader.string_value());
+        VERIFY_IS_TRUE(reader.next() == json_token::end_array);
+        VERIFY_IS_TRUE(reader.next() == json_token::end_object);
+        VERIFY_IS_TRUE(reader.next() == json_token::end_of_input);
+
+        VERIFY_IS_TRUE(IsMalformed("{\"a\":}"));
+        VERIFY_IS_TRUE(IsMalformed("[1,]"));
+        VERIFY_IS_TRUE(IsMalformed("[01]"));
+        VERIFY_IS_TRUE(IsMalformed("[1] 2"));
+        VERIFY_IS_TRUE(IsMalformed("\"unterminated"));
+        VERIFY_IS_TRUE(IsMalformed("[\"\\ud800\"]"));
+        VERIFY_IS_TRUE(IsMalformed(xsapi_internal_string(MAX_JSON_READER_DEPTH + 1, '[').c_str()));
+        VERIFY_IS_TRUE(!IsMalformed("[[[]], {}, \"\", 0, -0.5E-3]"));
+    }
+
+    DEFINE_TEST_CASE(TestFieldTables)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestFieldTables);
+
+        xsapi_internal_string document =
+            "{\"pagingInfo\":{\"continuationToken\":\"abc\",\"nested\":[[{}]]},"
+            "\"players\":["
+            "{\"xuid\":\"2533274790395904\",\"unknown\":{\"a\":[1,2]},\"isFavorite\":true,\"rank\":7,\"percentile\":0.25,"
+            "\"color\":{\"primary\":\"ff107c10ff\",\"secondary\":\"193e91\"},\"tags\":[\"a\",\"b\"]},"
+            "{\"xuid\":\"2\",\"rank\":\"not a number\",\"color\":null}"
+            "]}";
+
+        json_reader reader(document);
+        VERIFY_IS_TRUE(reader.next() == json_token::begin_object);
+        VERIFY_IS_TRUE(reader.find_member("players"));
+
+        xsapi_internal_vector<test_player> players;
+        VERIFY_IS_TRUE(json_read_array(reader, [&players](json_reader& element)
+        {
+            players.push_back(test_player());
+            return json_read_object(element, players.back(), s_playerFields);
+        }));
+
+        VERIFY_ARE_EQUAL_UINT(2, players.size());
+        VERIFY_ARE_EQUAL_STR(_T("2533274790395904"), players[0].xuid);
+        VERIFY_IS_TRUE(players[0].isFavorite);
+        VERIFY_ARE_EQUAL_UINT(7, players[0].rank);
+        VERIFY_IS_TRUE(players[0].percentile == 0.25);
+        VERIFY_ARE_EQUAL_STR(_T("ff107c1"), players[0].color.primary);
+        VERIFY_ARE_EQUAL_STR(xsapi_internal_string("193e91"), players[0].color.secondary);
+        VERIFY_ARE_EQUAL_UINT(2, players[0].tags.size());
+
+        // Values of the wrong type leave the member at its default
+        VERIFY_ARE_EQUAL_STR(_T("2"), players[1].xuid);
+        VERIFY_ARE_EQUAL_UINT(0, players[1].rank);
+
+        VERIFY_IS_TRUE(reader.next() == json_token::end_object);
+        VERIFY_IS_TRUE(reader.next() == json_token::end_of_input);
+
+        // Errors inside a nested value fail the whole read
+        json_reader badReader(xsapi_internal_string("{\"color\":{\"primary\":\"x\",}}"));
+        badReader.next();
+        test_player player = test_player();
+        VERIFY_IS_TRUE(!json_read_object(badReader, player, s_playerFields));
+    }
+};
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
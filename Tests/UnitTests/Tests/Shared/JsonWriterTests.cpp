@@ -0,0 +1,65 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "pch.h"
+#define TEST_CLASS_OWNER L"jasonsa"
+#define TEST_CLASS_AREA L"JsonWriter"
+#include "UnitTestIncludes.h"
+#include "json_writer.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
+
+DEFINE_TEST_CLASS(JsonWriterTests)
+{
+public:
+    DEFINE_TEST_CLASS_PROPS(JsonWriterTests)
+
+    DEFINE_TEST_CASE(TestValues)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestValues);
+
+        web::json::value custom;
+        custom[_T("level")] = web::json::value::number(3);
+
+        json_writer writer;
+        writer.begin_object();
+        writer.member("bool", true);
+        writer.member("int", -7);
+        writer.member("uint64", static_cast<uint64_t>(9007199254740993));
+        writer.member("double", 0.5);
+        writer.member("narrow", "q\"\\\n\x01");
+        writer.member("wide", string_t(_T("caf\u00e9 \U0001F600")));
+        writer.key("array");
+        writer.begin_array();
+        writer.null_value();
+        writer.begin_object();
+        writer.end_object();
+        writer.begin_array();
+        writer.end_array();
+        writer.end_array();
+        writer.key("custom");
+        writer.json_value(custom);
+        writer.end_object();
+
+        VERIFY_ARE_EQUAL_STR(
+            xsapi_internal_string("{\"bool\":true,\"int\":-7,\"uint64\":9007199254740993,\"double\":0.5,"
+                "\"narrow\":\"q\\\"\\\\\\n\\u0001\",\"wide\":\"caf\xc3\xa9 \xf0\x9f\x98\x80\","
+                "\"array\":[null,{},[]],\"custom\":{\"level\":3}}"),
+            writer.output()
+            );
+
+        // Output must round trip through the DOM parser
+        std::error_code errc;
+        auto parsed = utils::json_parse_utf8(writer.output(), errc);
+        VERIFY_IS_TRUE(!errc);
+        VERIFY_ARE_EQUAL_STR(_T("caf\u00e9 \U0001F600"), parsed[_T("wide")].as_string());
+
+        writer.reset();
+        writer.begin_array();
+        writer.value(1);
+        writer.end_array();
+        VERIFY_ARE_EQUAL_STR(xsapi_internal_string("[1]"), writer.output());
+    }
+};
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
@@ -0,0 +1,205 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "pch.h"
+#define TEST_CLASS_OWNER L"jasonsa"
+#define TEST_CLASS_AREA L"MemPool"
+#include "UnitTestIncludes.h"
+#include "mem_pool.h"
+
+using namespace xbox::services::system;
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
+
+static uint32_t s_hookAllocCount = 0;
+static uint32_t s_hookFreeCount = 0;
+
+DEFINE_TEST_CLASS(MemPoolTests)
+{
+public:
+    DEFINE_TEST_CLASS_PROPS(MemPoolTests)
+
+    DEFINE_TEST_CASE(TestPooling)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestPooling);
+
+        xsapi_memory_pool::trim();
+        auto previousAllocHook = g_pMemAllocHook;
+        auto previousFreeHook = g_pMemFreeHook;
+        s_hookAllocCount = 0;
+        s_hookFreeCount = 0;
+        g_pMemAllocHook = [](size_t size, hc_memory_type) { ++s_hookAllocCount; return malloc(size); };
+        g_pMemFreeHook = [](void* pointer, hc_memory_type) { ++s_hookFreeCount; free(pointer); };
+
+        // Small blocks are recycled without going back to the hooks
+        for (uint32_t i = 0; i < 100; ++i)
+        {
+            void* pointer = xsapi_memory::mem_alloc(40);
+            VERIFY_IS_NOT_NULL(pointer);
+            memset(pointer, 0xab, 40);
+            xsapi_memory::mem_free(pointer);
+        }
+        VERIFY_ARE_EQUAL_UINT(1, s_hookAllocCount);
+        VERIFY_ARE_EQUAL_UINT(0, s_hookFreeCount);
+
+        // Large blocks go straight through
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            xsapi_memory::mem_free(xsapi_memory::mem_alloc(64 * 1024));
+        }
+        VERIFY_ARE_EQUAL_UINT(4, s_hookAllocCount);
+        VERIFY_ARE_EQUAL_UINT(3, s_hookFreeCount);
+
+        // Each subsystem is served from its own arena
+        {
+            xsapi_memory_subsystem_scope scope(xsapi_memory_subsystem::social);
+            xsapi_memory::mem_free(xsapi_memory::mem_alloc(40));
+        }
+        VERIFY_ARE_EQUAL_UINT(5, s_hookAllocCount);
+
+        // A burst of frees only stays cached up to the thread cache and arena limits
+        std::vector<void*> burst;
+        for (uint32_t i = 0; i < 1000; ++i)
+        {
+            burst.push_back(xsapi_memory::mem_alloc(1000));
+        }
+        uint32_t freesBeforeBurst = s_hookFreeCount;
+        for (void* pointer : burst)
+        {
+            xsapi_memory::mem_free(pointer);
+        }
+        VERIFY_IS_TRUE(s_hookFreeCount - freesBeforeBurst >= 900);
+
+        xsapi_memory_pool::trim();
+        VERIFY_ARE_EQUAL_UINT(s_hookAllocCount, s_hookFreeCount);
+
+        g_pMemAllocHook = previousAllocHook;
+        g_pMemFreeHook = previousFreeHook;
+    }
+
+    DEFINE_TEST_CASE(TestTracking)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestTracking);
+
+        VERIFY_ARE_EQUAL(S_OK, XblMemSetTrackingMode(XblMemoryTrackingMode_Full));
+
+        void* small;
+        void* large;
+        {
+            xsapi_memory_subsystem_scope scope(xsapi_memory_subsystem::rta, __FUNCTION__);
+            small = xsapi_memory::mem_alloc(100);
+            large = xsapi_memory::mem_alloc(5000);
+        }
+
+        XblMemoryStats stats;
+        VERIFY_ARE_EQUAL(S_OK, XblMemGetStats(XblMemorySubsystem_Rta, &stats));
+        uint64_t baseline = stats.liveBytes - 5100;
+        VERIFY_ARE_EQUAL_UINT(2, stats.liveAllocationCount);
+
+        xsapi_memory::mem_free(large);
+        VERIFY_ARE_EQUAL(S_OK, XblMemGetStats(XblMemorySubsystem_Rta, &stats));
+        VERIFY_ARE_EQUAL_UINT(baseline + 100, stats.liveBytes);
+        VERIFY_IS_TRUE(stats.highWaterBytes >= baseline + 5100);
+
+        XblMemResetHighWaterMarks();
+        VERIFY_ARE_EQUAL(S_OK, XblMemGetStats(XblMemorySubsystem_Rta, &stats));
+        VERIFY_ARE_EQUAL_UINT(stats.liveBytes, stats.highWaterBytes);
+
+        // Blocks allocated while tracking stay counted after it is turned off
+        VERIFY_ARE_EQUAL(S_OK, XblMemSetTrackingMode(XblMemoryTrackingMode_Disabled));
+        xsapi_memory::mem_free(small);
+        VERIFY_ARE_EQUAL(S_OK, XblMemGetStats(XblMemorySubsystem_Rta, &stats));
+        VERIFY_ARE_EQUAL_UINT(baseline, stats.liveBytes);
+
+        VERIFY_ARE_EQUAL(E_INVALIDARG, XblMemGetStats(XblMemorySubsystem_Rta, nullptr));
+    }
+
+    DEFINE_TEST_CASE(TestFixedBlockTracking)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestFixedBlockTracking);
+
+        typedef xsapi_fixed_block_pool<200> test_block_pool;
+        VERIFY_ARE_EQUAL(S_OK, XblMemSetTrackingMode(XblMemoryTrackingMode_Full));
+
+        XblMemoryStats before;
+        VERIFY_ARE_EQUAL(S_OK, XblMemGetStats(XblMemorySubsystem_Social, &before));
+        void* block;
+        {
+            xsapi_memory_subsystem_scope scope(xsapi_memory_subsystem::social);
+            block = test_block_pool::alloc();
+        }
+
+        XblMemoryStats stats;
+        VERIFY_ARE_EQUAL(S_OK, XblMemGetStats(XblMemorySubsystem_Social, &stats));
+        VERIFY_ARE_EQUAL_UINT(before.liveAllocationCount + 1, stats.liveAllocationCount);
+
+        // A cached block is not live, and is counted against whoever takes it next
+        test_block_pool::free(block);
+        VERIFY_ARE_EQUAL(S_OK, XblMemGetStats(XblMemorySubsystem_Social, &stats));
+        VERIFY_ARE_EQUAL_UINT(before.liveAllocationCount, stats.liveAllocationCount);
+
+        XblMemoryStats statsBeforeReuse;
+        VERIFY_ARE_EQUAL(S_OK, XblMemGetStats(XblMemorySubsystem_Multiplayer, &statsBeforeReuse));
+        {
+            xsapi_memory_subsystem_scope scope(xsapi_memory_subsystem::multiplayer);
+            VERIFY_IS_TRUE(test_block_pool::alloc() == block);
+        }
+        VERIFY_ARE_EQUAL(S_OK, XblMemGetStats(XblMemorySubsystem_Multiplayer, &stats));
+        VERIFY_ARE_EQUAL_UINT(statsBeforeReuse.liveAllocationCount + 1, stats.liveAllocationCount);
+        VERIFY_ARE_EQUAL(S_OK, XblMemGetStats(XblMemorySubsystem_Social, &stats));
+        VERIFY_ARE_EQUAL_UINT(before.liveAllocationCount, stats.liveAllocationCount);
+
+        xsapi_memory::mem_free(block);
+        VERIFY_ARE_EQUAL(S_OK, XblMemGetStats(XblMemorySubsystem_Multiplayer, &stats));
+        VERIFY_ARE_EQUAL_UINT(statsBeforeReuse.liveAllocationCount, stats.liveAllocationCount);
+        VERIFY_ARE_EQUAL(S_OK, XblMemSetTrackingMode(XblMemoryTrackingMode_Disabled));
+    }
+
+    DEFINE_TEST_CASE(TestAsyncBlockRecycling)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestAsyncBlockRecycling);
+
+        AsyncBlock* first = utils::allocate_async_block();
+        VERIFY_IS_NULL(first->callback);
+        first->context = first;
+        utils::free_async_block(first);
+
+        // The block is handed back out zeroed
+        AsyncBlock* second = utils::allocate_async_block();
+        VERIFY_IS_TRUE(first == second);
+        VERIFY_IS_NULL(second->context);
+        utils::free_async_block(second);
+
+        auto value = std::make_shared<int>(42);
+        void* context = utils::store_shared_ptr(value);
+        VERIFY_ARE_EQUAL_INT(42, *utils::get_shared_ptr<int>(context, false));
+        VERIFY_ARE_EQUAL_INT(2, value.use_count());
+        utils::get_shared_ptr<int>(context, true);
+        VERIFY_ARE_EQUAL_INT(1, value.use_count());
+
+        // Weak contexts share the same pool
+        void* weakContext = utils::store_weak_ptr(std::weak_ptr<int>(value));
+        VERIFY_IS_TRUE(weakContext == context);
+        value.reset();
+        VERIFY_IS_NULL(utils::get_shared_ptr<int>(weakContext, true));
+    }
+
+    DEFINE_TEST_CASE(TestSubsystemScope)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestSubsystemScope);
+
+        VERIFY_IS_TRUE(xsapi_memory_pool::current_subsystem() == xsapi_memory_subsystem::general);
+        {
+            xsapi_memory_subsystem_scope outer(xsapi_memory_subsystem::multiplayer);
+            VERIFY_IS_TRUE(xsapi_memory_pool::current_subsystem() == xsapi_memory_subsystem::multiplayer);
+            {
+                xsapi_memory_subsystem_scope inner(xsapi_memory_subsystem::http);
+                VERIFY_IS_TRUE(xsapi_memory_pool::current_subsystem() == xsapi_memory_subsystem::http);
+            }
+            VERIFY_IS_TRUE(xsapi_memory_pool::current_subsystem() == xsapi_memory_subsystem::multiplayer);
+        }
+        VERIFY_IS_TRUE(xsapi_memory_pool::current_subsystem() == xsapi_memory_subsystem::general);
+    }
+};
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
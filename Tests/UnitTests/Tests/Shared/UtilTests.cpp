@@ -194,6 +194,56 @@ public:
         values.push_back(L"3");
         web::json::value jsonArray = utils::serialize_string_vector_to_json(values);
     }
+
+    TEST_METHOD(TestJsonUtf8)
+    {
+        DEFINE_TEST_CASE_PROPERTIES();
+
+        // "gamertag":"Caf\u00e9 \u00bb" as raw UTF-8 bytes
+        xsapi_internal_string utf8 = "{\"gamertag\":\"Caf\xc3\xa9 \xc2\xbb\",\"score\":42}";
+        std::error_code errc;
+        web::json::value jsonValue = utils::json_parse_utf8(utf8, errc);
+        VERIFY_IS_TRUE(!errc);
+        VERIFY_ARE_EQUAL(L"Caf\u00e9 \u00bb", utils::extract_json_string(jsonValue, L"gamertag"));
+        VERIFY_ARE_EQUAL_INT(42, utils::extract_json_int(jsonValue, L"score"));
+
+        auto serialized = utils::json_serialize_utf8(jsonValue);
+        VERIFY_ARE_EQUAL_STR(utils::internal_string_from_string_t(jsonValue.serialize()), serialized);
+
+        utils::json_parse_utf8("{\"unterminated\":", errc);
+        VERIFY_IS_TRUE(errc);
+    }
+
+    TEST_METHOD(TestJsonHash)
+    {
+        DEFINE_TEST_CASE_PROPERTIES();
+
+        // Member order must not affect the hash
+        web::json::value first = web::json::value::object(true);
+        first[L"map"] = web::json::value::string(L"dunes");
+        first[L"rounds"] = web::json::value::number(3);
+        web::json::value second = web::json::value::object(true);
+        second[L"rounds"] = web::json::value::number(3);
+        second[L"map"] = web::json::value::string(L"dunes");
+        VERIFY_IS_TRUE(utils::json_hash(first) == utils::json_hash(second));
+        VERIFY_IS_TRUE(utils::json_changed_keys(first, second).empty());
+
+        second[L"rounds"] = web::json::value::number(4);
+        second[L"mode"] = web::json::value::string(L"ctf");
+        VERIFY_IS_TRUE(utils::json_hash(first) != utils::json_hash(second));
+        VERIFY_IS_TRUE(utils::json_hash(web::json::value::object()) != utils::json_hash(web::json::value::null()));
+        VERIFY_IS_TRUE(utils::json_hash(web::json::value::string(L"A")) != utils::json_hash(web::json::value::string(L"a")));
+
+        std::vector<string_t> changedKeys = utils::json_changed_keys(second, first);
+        std::sort(changedKeys.begin(), changedKeys.end());
+        VERIFY_ARE_EQUAL_UINT(2, changedKeys.size());
+        VERIFY_ARE_EQUAL(L"mode", changedKeys[0]);
+        VERIFY_ARE_EQUAL(L"rounds", changedKeys[1]);
+
+        // Keys only in the previous value count as changed too
+        changedKeys = utils::json_changed_keys(web::json::value::null(), first);
+        VERIFY_ARE_EQUAL_UINT(2, changedKeys.size());
+    }
 };
 
 NAMESPACE_MICROSOFT_XBOX_SYSTEM_CPP_END
@@ -119,6 +119,75 @@ public:
         connection->close();
     }
 
+    DEFINE_TEST_CASE(BinaryFramesAndCompression)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(BinaryFramesAndCompression);
+
+        auto user = SignInUserWithMocks_WinRT();
+        auto userContext = std::make_shared<user_context>(user);
+        std::shared_ptr<MockWebSocketClient> mockSocket = m_mockXboxSystemFactory->GetMockWebSocketClient();
+
+        // Text only transport: nothing is offered and binary sends fail
+        {
+            auto connection = std::make_shared<web_socket_connection>(userContext, "wss://rta.xboxlive.com/connect", "rta.xboxlive.com", GetDefaultHttpSetting());
+            auto stateChangeHelper = SetupStateChangeHelper(connection);
+            VERIFY_IS_TRUE(!connection->binary_frames_supported());
+            VERIFY_IS_TRUE(!connection->request_compression());
+            connection->ensure_connected();
+            stateChangeHelper->connectedEvent.wait();
+            VERIFY_IS_TRUE(mockSocket->m_requestedExtensions.empty());
+            VERIFY_IS_TRUE(!connection->compression_negotiated());
+
+            HRESULT sendResult = S_OK;
+            connection->send_binary(xsapi_internal_vector<uint8_t>(4, 0), [&sendResult](WebSocketCompletionResult result)
+            {
+                sendResult = result.errorCode;
+            });
+            VERIFY_ARE_EQUAL(E_NOTIMPL, sendResult);
+            connection->close();
+        }
+
+        // Transport and endpoint both support permessage-deflate and binary frames
+        mockSocket->reinit();
+        mockSocket->m_capabilities = web_socket_capabilities{ true, true };
+        mockSocket->m_endpointOffersDeflate = true;
+        {
+            auto connection = std::make_shared<web_socket_connection>(userContext, "wss://rta.xboxlive.com/connect", "rta.xboxlive.com", GetDefaultHttpSetting());
+            auto stateChangeHelper = SetupStateChangeHelper(connection);
+            VERIFY_IS_TRUE(connection->request_compression());
+            connection->ensure_connected();
+            stateChangeHelper->connectedEvent.wait();
+            VERIFY_ARE_EQUAL(xsapi_internal_string("permessage-deflate; client_max_window_bits"), mockSocket->m_requestedExtensions);
+            VERIFY_IS_TRUE(connection->compression_negotiated());
+
+            xsapi_internal_vector<uint8_t> payload = { 0x01, 0x00, 0xff };
+            xsapi_internal_vector<uint8_t> sent;
+            mockSocket->m_binarySendHandler = [&sent](xsapi_internal_vector<uint8_t> frame) { sent = frame; };
+            connection->send_binary(payload);
+            VERIFY_IS_TRUE(sent == payload);
+
+            xsapi_internal_vector<uint8_t> received;
+            connection->set_binary_received_handler([&received](xsapi_internal_vector<uint8_t> frame) { received = frame; });
+            mockSocket->receive_binary_message(payload);
+            VERIFY_IS_TRUE(received == payload);
+            connection->close();
+        }
+
+        // Endpoint declines the offer
+        mockSocket->reinit();
+        mockSocket->m_capabilities = web_socket_capabilities{ true, true };
+        {
+            auto connection = std::make_shared<web_socket_connection>(userContext, "wss://rta.xboxlive.com/connect", "rta.xboxlive.com", GetDefaultHttpSetting());
+            auto stateChangeHelper = SetupStateChangeHelper(connection);
+            VERIFY_IS_TRUE(connection->request_compression());
+            connection->ensure_connected();
+            stateChangeHelper->connectedEvent.wait();
+            VERIFY_IS_TRUE(!connection->compression_negotiated());
+            connection->close();
+        }
+        mockSocket->reinit();
+    }
+
     DEFINE_TEST_CASE(ConnectFail)
     {
         DEFINE_TEST_CASE_PROPERTIES(ConnectFail);
@@ -116,6 +116,80 @@ public:
         VERIFY_ARE_EQUAL(user->XboxUserId, userContext.user()->XboxUserId);
     }
 
+    DEFINE_TEST_CASE(TestUserAgent)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestUserAgent);
+
+        auto user = SignInUserWithMocks_WinRT();
+
+        xbox::services::user_context userContext(user);
+        VERIFY_ARE_EQUAL_STR(xsapi_internal_string(DEFAULT_USER_AGENT), userContext.user_agent());
+
+        userContext.set_caller_context_type(xbox::services::caller_context_type::multiplayer_manager);
+        VERIFY_ARE_EQUAL_STR(xsapi_internal_string(DEFAULT_USER_AGENT) + " MultiplayerManager", userContext.user_agent());
+
+        userContext.set_caller_api_type(xbox::services::caller_api_type::api_winrt);
+        VERIFY_ARE_EQUAL_STR(xsapi_internal_string(DEFAULT_USER_AGENT) + " MultiplayerManager winrt", userContext.user_agent());
+
+        // Readers on other threads always see a complete value while the caller context changes
+        std::atomic<bool> done(false);
+        auto reader = pplx::create_task([&userContext, &done]()
+        {
+            while (!done)
+            {
+                auto userAgent = userContext.user_agent();
+                VERIFY_IS_TRUE(userAgent.find(DEFAULT_USER_AGENT) == 0);
+            }
+        });
+        for (uint32_t i = 0; i < 1000; ++i)
+        {
+            userContext.set_caller_context_type(i % 2 == 0 ? xbox::services::caller_context_type::social_manager : xbox::services::caller_context_type::stats_manager);
+        }
+        done = true;
+        reader.wait();
+        VERIFY_ARE_EQUAL_STR(xsapi_internal_string(DEFAULT_USER_AGENT) + " StatManager winrt", userContext.user_agent());
+    }
+
+    DEFINE_TEST_CASE(TestRequestTemplates)
+    {
+        DEFINE_TEST_CASE_PROPERTIES(TestRequestTemplates);
+
+        auto user = SignInUserWithMocks_WinRT();
+        const xsapi_internal_string serverName = "https://userpresence.xboxlive.com";
+        const xsapi_internal_string contentType = "application/json; charset=utf-8";
+
+        xbox::services::user_context userContext(user);
+        VERIFY_IS_TRUE(userContext.request_template(xbox_live_api::set_presence_helper) == nullptr);
+
+        auto presenceTemplate = userContext.request_template(xbox_live_api::set_presence_helper, "POST", serverName, "3", contentType);
+        VERIFY_ARE_EQUAL_STR(serverName, presenceTemplate->server_name());
+        VERIFY_ARE_EQUAL_STR(xsapi_internal_string(DEFAULT_USER_AGENT), presenceTemplate->user_agent());
+        VERIFY_ARE_EQUAL_STR(xsapi_internal_string("3"), presenceTemplate->default_headers().at("x-xbl-contract-version"));
+        VERIFY_ARE_EQUAL_STR(utils::headers_to_string(presenceTemplate->default_headers()), presenceTemplate->default_headers_string());
+
+        // Calls that match reuse the template; each endpoint has its own
+        VERIFY_IS_TRUE(presenceTemplate == userContext.request_template(xbox_live_api::set_presence_helper, "POST", serverName, "3", contentType));
+        VERIFY_IS_TRUE(presenceTemplate == userContext.request_template(xbox_live_api::set_presence_helper));
+        auto statsTemplate = userContext.request_template(xbox_live_api::update_stats_value_document, "POST", "https://statswrite.xboxlive.com", "1", contentType);
+        VERIFY_IS_TRUE(statsTemplate != presenceTemplate);
+        VERIFY_IS_TRUE(presenceTemplate == userContext.request_template(xbox_live_api::set_presence_helper));
+
+        // A call that no longer matches rebuilds the template
+        auto rebuiltTemplate = userContext.request_template(xbox_live_api::set_presence_helper, "POST", serverName, "4", contentType);
+        VERIFY_IS_TRUE(rebuiltTemplate != presenceTemplate);
+        VERIFY_ARE_EQUAL_STR(xsapi_internal_string("4"), rebuiltTemplate->default_headers().at("x-xbl-contract-version"));
+
+        // Templates belong to the context they were built with
+        xbox::services::user_context otherContext(user);
+        VERIFY_IS_TRUE(otherContext.request_template(xbox_live_api::set_presence_helper) == nullptr);
+
+        // Changing the caller context drops templates built with the old User-Agent
+        userContext.set_caller_context_type(xbox::services::caller_context_type::stats_manager);
+        VERIFY_IS_TRUE(userContext.request_template(xbox_live_api::update_stats_value_document) == nullptr);
+        statsTemplate = userContext.request_template(xbox_live_api::update_stats_value_document, "POST", "https://statswrite.xboxlive.com", "1", contentType);
+        VERIFY_ARE_EQUAL_STR(xsapi_internal_string(DEFAULT_USER_AGENT) + " StatManager", statsTemplate->user_agent());
+    }
+
     DEFINE_TEST_CASE(TestXboxLiveContext)
     {
         DEFINE_TEST_CASE_PROPERTIES(TestXboxLiveContext);